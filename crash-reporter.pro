@@ -46,6 +46,9 @@ include(doc/doc.pri)
 scripts.path = $${CREPORTER_SYSTEM_SHARE}/crash-reporter
 scripts.files = scripts/crash-report-monitoring
 
+dictionaries.path = $${CREPORTER_SYSTEM_SHARE}/crash-reporter/dictionaries
+dictionaries.files = data/dictionaries/*.dict
+
 notifications.path = $${CREPORTER_SYSTEM_SHARE}/lipstick/notificationcategories/
 notifications.files = data/x-nemo.crash-reporter.autouploader.conf \
                       data/x-nemo.crash-reporter.notification.conf
@@ -79,5 +82,5 @@ endurance_script.files = scripts/endurance-collect
 oneshot.path = $${CREPORTER_SYSTEM_ONESHOT}
 oneshot.files = scripts/crash-reporter-service-default
 
-INSTALLS += scripts notifications settings systemd_service \
+INSTALLS += scripts dictionaries notifications settings systemd_service \
 	systemd_services endurance_script oneshot
@@ -21,7 +21,10 @@ BuildRequires:          qt5-qtxml-devel
 BuildRequires:          ssu-devel
 BuildRequires:          pkgconfig(dbus-1)
 BuildRequires:          pkgconfig(libiphb)
+BuildRequires:          pkgconfig(liblzma)
 BuildRequires:          pkgconfig(libudev)
+BuildRequires:          pkgconfig(libzstd)
+BuildRequires:          pkgconfig(lzo2)
 BuildRequires:          pkgconfig(mce)
 BuildRequires:          pkgconfig(qt5-boostable)
 Requires:               sp-rich-core >= 1.71.2
@@ -85,6 +88,7 @@ make %{_smp_mflags}
 %attr(4755,root,root) /usr/libexec/rich-core-helper
 %attr(4750,root,privileged) /usr/libexec/crashreporter-servicehelper
 %dir /usr/share/crash-reporter
+%dir /usr/share/crash-reporter/dictionaries
 /usr/share/crash-reporter/*
 /usr/share/dbus-1/services/*.service
 /usr/share/man/man1/*
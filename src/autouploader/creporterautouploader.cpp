@@ -27,6 +27,7 @@
 
 #include <QDebug>
 #include <QDBusConnection>
+#include <QFile>
 
 #include "creporterautouploader.h"
 #include "creporternamespace.h"
@@ -59,6 +60,8 @@ public:
     bool activated;
     //! @arg files that have been added to upload queue during this auto uploader session
     QStringList addedFiles;
+    //! @arg files whose triage records have been added to upload queue during this session
+    QStringList triageFiles;
     /*! Notification object giving user a notice that upload is in progress.*/
     CReporterNotification *progressNotification;
     /*! Notification object giving user a notice of successful uploads.*/
@@ -119,15 +122,39 @@ bool CReporterAutoUploader::uploadFiles(const QStringList &fileList,
         connect(d_ptr->engine, SIGNAL(finished(int, int, int)), SLOT(engineFinished(int, int, int)));
     }
 
-    if (obeyNetworkRestrictions &&
-            !CReporterNwSessionMgr::canUseNetworkConnection()) {
+    bool fullUploadAllowed = !obeyNetworkRestrictions ||
+                             CReporterNwSessionMgr::canUseNetworkConnection();
+    // Triage records are useless if the full reports are sent anyway.
+    bool triageUpload = !fullUploadAllowed &&
+                        CReporterPrivacySettingsModel::instance()->triageUploadEnabled();
+
+    if (!fullUploadAllowed && !triageUpload) {
         qCDebug(cr) << "No unpaid network connection available, aborting crash report upload.";
         QTimer::singleShot(0, this, SLOT(quit()));
         return false;
     }
 
+    QStringList triaged;
+    if (triageUpload) {
+        triaged = CReporterSavedState::instance()->triagedReports();
+    }
+
     foreach (QString filename, fileList) {
-        if (!d_ptr->addedFiles.contains(filename)) {
+        if (triageUpload && CReporterUtils::reportIncludesCrash(filename) &&
+                !triaged.contains(filename) && !d_ptr->triageFiles.contains(filename)) {
+            qCDebug(cr) << "Adding triage record to upload queue: " << filename;
+            CReporterUploadItem *item =
+                new CReporterUploadItem(filename, CReporterUploadItem::TriageRecord);
+            connect(item, SIGNAL(triageRecordUploaded(QString, bool)),
+                    SLOT(triageRecordUploaded(QString, bool)));
+            // Triage records go ahead of the full reports.
+            d_ptr->queue.enqueue(item, true);
+            d_ptr->triageFiles << filename;
+        }
+
+        if (!fullUploadAllowed) {
+            qCDebug(cr) << "No unpaid network connection available, deferring upload of" << filename;
+        } else if (!d_ptr->addedFiles.contains(filename)) {
             qCDebug(cr) << "Adding to upload queue: " << filename;
             // CReporterUploadQueue class will own the CReporterUploadItem instance.
             d_ptr->queue.enqueue(new CReporterUploadItem(filename));
@@ -137,6 +164,12 @@ bool CReporterAutoUploader::uploadFiles(const QStringList &fileList,
         }
     }
 
+    if (d_ptr->addedFiles.isEmpty() && d_ptr->triageFiles.isEmpty()) {
+        qCDebug(cr) << "Nothing to upload through this network connection.";
+        QTimer::singleShot(0, this, SLOT(quit()));
+        return false;
+    }
+
     if (CReporterPrivacySettingsModel::instance()->notificationsEnabled()) {
         d_ptr->progressNotification->update(
             //% "Uploading reports"
@@ -148,6 +181,36 @@ bool CReporterAutoUploader::uploadFiles(const QStringList &fileList,
     return true;
 }
 
+void CReporterAutoUploader::triageRecordUploaded(const QString &file, bool coreRequested)
+{
+    CReporterSavedState *state = CReporterSavedState::instance();
+
+    // Forget reports that have been uploaded or deleted meanwhile.
+    QStringList triaged;
+    foreach (const QString &path, state->triagedReports()) {
+        if (QFile::exists(path)) {
+            triaged << path;
+        }
+    }
+    if (!triaged.contains(file)) {
+        triaged << file;
+    }
+    state->setTriagedReports(triaged);
+
+    if (!coreRequested || d_ptr->addedFiles.contains(file)) {
+        return;
+    }
+
+    if (!CReporterNwSessionMgr::canUseNetworkConnection()) {
+        qCDebug(cr) << "Server requested full report, but no unpaid network connection"
+                    << "is available, deferring upload of" << file;
+    } else {
+        qCDebug(cr) << "Server requested full report, adding to upload queue:" << file;
+        d_ptr->queue.enqueue(new CReporterUploadItem(file));
+        d_ptr->addedFiles << file;
+    }
+}
+
 void CReporterAutoUploader::quit()
 {
     qCDebug(cr) << "Quit auto uploader.";
@@ -75,6 +75,14 @@ private Q_SLOTS:
       */
     void engineFinished(int error, int sent, int total);
 
+    /*!
+      * @brief Called, when triage record of a report has been uploaded.
+      *
+      * @param file Path to the report.
+      * @param coreRequested True, if the server wants the full report.
+      */
+    void triageRecordUploaded(const QString &file, bool coreRequested);
+
 private:
     Q_DECLARE_PRIVATE(CReporterAutoUploader)
 
@@ -0,0 +1,264 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creportercorecompressor.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <QDateTime>
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QtConcurrent>
+
+#include "creportercoreregistry.h"
+#include "creporterlzowriter.h"
+#include "creporternamespace.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+
+//! Suffix of the file a core is compressed into before replacing the original.
+const QString TEMP_SUFFIX(".compress");
+//! Lowest CPU priority.
+const int IDLE_NICE = 19;
+
+// From linux/ioprio.h, which isn't among the exported kernel headers.
+const int IOPRIO_WHO_PROCESS = 1;
+const int IOPRIO_CLASS_IDLE = 3;
+const int IOPRIO_CLASS_SHIFT = 13;
+
+/*!
+ * Moves the calling thread to the lowest CPU priority and to the idle I/O
+ * class. On Linux both are per thread, so the rest of the daemon isn't
+ * affected.
+ */
+void lowerThreadPriority()
+{
+    pid_t tid = syscall(SYS_gettid);
+
+    if (setpriority(PRIO_PROCESS, tid, IDLE_NICE) < 0) {
+        qCWarning(cr) << "Couldn't lower CPU priority:" << strerror(errno);
+    }
+    if (syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, tid,
+                IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT) < 0) {
+        qCWarning(cr) << "Couldn't lower I/O priority:" << strerror(errno);
+    }
+}
+
+/*!
+ * Compresses a core into a temporary file next to it. Runs in the
+ * compressor's worker thread.
+ */
+bool compressCore(const QString &filePath)
+{
+    lowerThreadPriority();
+
+    QFileInfo before(filePath);
+    QString tempPath(filePath + TEMP_SUFFIX);
+
+    if (!CReporterLzoWriter::compressFile(filePath, tempPath)) {
+        return false;
+    }
+
+    QFileInfo after(filePath);
+    if (!after.exists() || after.size() != before.size() ||
+            after.lastModified() != before.lastModified()) {
+        qCDebug(cr) << filePath << "changed during compression.";
+        QFile::remove(tempPath);
+        return false;
+    }
+
+    return true;
+}
+
+/*!
+ * Auto uploader may be reading any of the reports, they mustn't be replaced
+ * while it runs.
+ */
+bool isUploaderRunning()
+{
+    QDBusConnectionInterface *bus = QDBusConnection::sessionBus().interface();
+    return bus && bus->isServiceRegistered(CReporter::AutoUploaderServiceName);
+}
+
+}
+
+CReporterCoreCompressor::CReporterCoreCompressor(QObject *parent)
+    : QObject(parent)
+{
+    pool.setMaxThreadCount(1);
+
+    idleTimer.setSingleShot(true);
+    idleTimer.setInterval(DefaultIdleDelayMs);
+    connect(&idleTimer, &QTimer::timeout,
+            this, &CReporterCoreCompressor::startCompression);
+    connect(&watcher, &QFutureWatcher<bool>::finished,
+            this, &CReporterCoreCompressor::compressionFinished);
+
+    // Reports left uncompressed before the daemon started.
+    idleTimer.start();
+}
+
+CReporterCoreCompressor::~CReporterCoreCompressor()
+{
+    queue.clear();
+    pool.waitForDone();
+
+    if (!current.isEmpty()) {
+        QFile::remove(current + TEMP_SUFFIX);
+    }
+}
+
+void CReporterCoreCompressor::setIdleDelay(int ms)
+{
+    idleTimer.setInterval(ms);
+    if (idleTimer.isActive()) {
+        idleTimer.start();
+    }
+}
+
+int CReporterCoreCompressor::idleDelay() const
+{
+    return idleTimer.interval();
+}
+
+bool CReporterCoreCompressor::isBusy() const
+{
+    return !current.isEmpty();
+}
+
+void CReporterCoreCompressor::postpone()
+{
+    queue.clear();
+    idleTimer.start();
+}
+
+void CReporterCoreCompressor::startCompression()
+{
+    if (isBusy()) {
+        return;
+    }
+
+    if (isUploaderRunning()) {
+        qCDebug(cr) << "Auto uploader is running, postponing compression.";
+        idleTimer.start();
+        return;
+    }
+
+    CReporterCoreRegistry *registry = CReporterCoreRegistry::instance();
+
+    // Remove leftovers of compressions interrupted by a shutdown.
+    foreach (const QString &path, registry->getCoreLocationPaths()) {
+        QDir dir(path);
+        foreach (const QString &fileName,
+                 dir.entryList(QStringList() << '*' + TEMP_SUFFIX, QDir::Files)) {
+            dir.remove(fileName);
+        }
+    }
+
+    QDateTime settled = QDateTime::currentDateTime().addMSecs(-idleDelay());
+    bool unsettled = false;
+
+    foreach (const QString &filePath, registry->collectAllCoreFiles()) {
+        if (!filePath.endsWith(".rcore")) {
+            continue;
+        }
+        if (QFileInfo(filePath).lastModified() > settled) {
+            // Possibly still being written.
+            unsettled = true;
+            continue;
+        }
+        queue << filePath;
+    }
+
+    if (unsettled) {
+        idleTimer.start();
+    }
+
+    if (!queue.isEmpty()) {
+        qCDebug(cr) << "Compressing" << queue.count() << "reports in background.";
+        compressNext();
+    }
+}
+
+void CReporterCoreCompressor::compressNext()
+{
+    if (queue.isEmpty()) {
+        return;
+    }
+
+    current = queue.takeFirst();
+    watcher.setFuture(QtConcurrent::run(&pool, compressCore, current));
+}
+
+void CReporterCoreCompressor::compressionFinished()
+{
+    QString filePath(current);
+    QString tempPath(filePath + TEMP_SUFFIX);
+    QString targetPath(filePath + ".lzo");
+    current.clear();
+
+    bool ok = watcher.result();
+
+    if (ok && isUploaderRunning()) {
+        qCDebug(cr) << "Auto uploader started, discarding compressed" << filePath;
+        postpone();
+        ok = false;
+    }
+
+    // The report may have been uploaded or deleted meanwhile.
+    if (ok && !QFile::exists(filePath)) {
+        ok = false;
+    }
+
+    if (ok) {
+        CReporterCoreRegistry *registry = CReporterCoreRegistry::instance();
+
+        // Registered before it appears, so that it isn't taken for a new core.
+        registry->replaceCore(filePath, targetPath);
+
+        if (::rename(QFile::encodeName(tempPath).constData(),
+                     QFile::encodeName(targetPath).constData()) < 0) {
+            qCWarning(cr) << "Couldn't replace" << filePath << ":" << strerror(errno);
+            registry->replaceCore(targetPath, filePath);
+            ok = false;
+        }
+    }
+
+    if (ok) {
+        qCDebug(cr) << "Compressed" << filePath << "from" << QFileInfo(filePath).size()
+                    << "to" << QFileInfo(targetPath).size() << "bytes.";
+        CReporterUtils::removeFile(filePath);
+        emit coreCompressed(filePath, targetPath);
+    } else {
+        QFile::remove(tempPath);
+    }
+
+    compressNext();
+}
@@ -0,0 +1,113 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERCORECOMPRESSOR_H
+#define CREPORTERCORECOMPRESSOR_H
+
+#include <QFutureWatcher>
+#include <QObject>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+
+/*!
+ * @class CReporterCoreCompressor
+ * @brief Compresses uncompressed rich cores while the daemon is idle.
+ *
+ * Some reports, e.g. endurance packages, are written as plain *.rcore files.
+ * When no new cores have arrived for a while, they are compressed one at a
+ * time into *.rcore.lzo in a worker thread running with idle CPU and I/O
+ * priority. The compressed file replaces the original atomically and the
+ * core registry is updated, so the new file isn't reported as a new crash.
+ * Compression pauses whenever a new core arrives or the auto uploader runs.
+ */
+class CReporterCoreCompressor : public QObject
+{
+    Q_OBJECT
+
+public:
+    //! Default time in milliseconds without new cores before compression starts.
+    static const int DefaultIdleDelayMs = 60 * 1000;
+
+    /*!
+     * @brief Class constructor.
+     *
+     * @param parent Owner of this object.
+     */
+    explicit CReporterCoreCompressor(QObject *parent = 0);
+    ~CReporterCoreCompressor();
+
+    /*!
+     * @brief Sets time without new cores before compression starts.
+     *
+     * Files modified more recently than this are also left alone, they may
+     * still be written.
+     */
+    void setIdleDelay(int ms);
+    int idleDelay() const;
+
+    /*!
+     * @brief Whether a file is being compressed right now.
+     */
+    bool isBusy() const;
+
+public Q_SLOTS:
+    /*!
+     * @brief Restarts the idle period.
+     *
+     * Should be called whenever a new core is found. A file being compressed
+     * is finished, but no more are started until the daemon is idle again.
+     */
+    void postpone();
+
+Q_SIGNALS:
+    /*!
+     * @brief Emitted when a core file was replaced by its compressed version.
+     *
+     * @param oldPath Path of the removed uncompressed file.
+     * @param newPath Path of the compressed file.
+     */
+    void coreCompressed(const QString &oldPath, const QString &newPath);
+
+private Q_SLOTS:
+    void startCompression();
+    void compressionFinished();
+
+private:
+    Q_DISABLE_COPY(CReporterCoreCompressor)
+
+    /*!
+     * @brief Starts compression of the next queued file.
+     */
+    void compressNext();
+
+    //! Triggers compression when no new cores arrived for a while.
+    QTimer idleTimer;
+    //! Single low priority thread the files are compressed in.
+    QThreadPool pool;
+    //! Watches the compression in progress.
+    QFutureWatcher<bool> watcher;
+    //! Files waiting for compression.
+    QStringList queue;
+    //! File being compressed.
+    QString current;
+};
+
+#endif // CREPORTERCORECOMPRESSOR_H
@@ -25,6 +25,8 @@
  *
  */
 
+#include <QDir>
+
 #include "creporterdaemon.h"
 #include "creporterdaemon_p.h"
 #include "creporterdaemonadaptor.h"
@@ -104,7 +106,8 @@ bool CReporterDaemon::initiateDaemon()
         QStringList files = collectAllCoreFiles();
 
         if (!files.isEmpty() &&
-                CReporterNwSessionMgr::canUseNetworkConnection() &&
+                (CReporterNwSessionMgr::canUseNetworkConnection() ||
+                 CReporterPrivacySettingsModel::instance()->triageUploadEnabled()) &&
                 !CReporterUtils::notifyAutoUploader(files)) {
             qCDebug(cr) << "Failed to add files to the queue.";
         }
@@ -134,7 +137,8 @@ void CReporterDaemon::startCoreMonitoring(const bool fromDBus)
 
     if (!d->monitor) {
         // Create monitor instance and start monitoring cores.
-        d->monitor = new CReporterDaemonMonitor(this);
+        d->monitor = new CReporterDaemonMonitor(
+            QDir::homePath() + CReporter::HandledCoresFile, this);
         Q_CHECK_PTR(d->monitor);
 
         qCDebug(cr) << "Core monitoring started.";
@@ -31,54 +31,111 @@
 #include <QStringList>
 #include <QDebug>
 #include <QDir>
+#include <QFile>
 #include <QFileInfo>
+#include <QFutureWatcher>
 #include <QDBusReply>
+#include <QtConcurrent>
 
 #include "creporterdaemonmonitor.h"
 #include "creporterdaemonmonitor_p.h"
+#include "creportercorereducer.h"
 #include "creportercoreregistry.h"
+#include "creporterintegritychecker.h"
 #include "creporternwsessionmgr.h"
 #include "creportersavedstate.h"
 #include "creporterutils.h"
 #include "creporternamespace.h"
 #include "creporternotification.h"
 #include "creporterprivacysettingsmodel.h"
+#include "creporterrichcoreindex.h"
+#include "creporterstacksignature.h"
 #include "autouploader_interface.h" // generated
 
 using CReporter::LoggingCategory::cr;
 
-CReporterHandledRichCore::CReporterHandledRichCore(const QString &filePath)
-    : lastCountReset(QDateTime::currentDateTimeUtc())
+//! Time (ms) during which directory change events are collected into one batch.
+const int COALESCE_WINDOW_MS = 500;
+//! Maximum time (ms) spent processing new cores in one main loop iteration.
+const int BATCH_TIME_BUDGET_MS = 20;
+
+namespace {
+
+//! Outcome of preparing a new report in a worker thread.
+struct PreparedCore {
+    //! Path of the report.
+    QString filePath;
+    //! Whether the report was broken and quarantined.
+    bool quarantined;
+    //! Whether the report should be checked for being a duplicate.
+    bool checkDuplicates;
+    //! Stack signature of the report, if it was checked for duplicates.
+    QByteArray signature;
+};
+
+/*!
+ * Quarantines a new report if it's broken, otherwise shrinks its core dump,
+ * stores its section index and computes its stack signature. Runs in a
+ * worker thread, the report mustn't be uploaded meanwhile.
+ */
+PreparedCore prepareCore(const QString &filePath, bool reduce, bool checkDuplicates)
 {
-    // Parse needed info for file path.
-    QStringList rCoreInfo = CReporterUtils::parseCrashInfoFromFilename(filePath);
-
-    binaryName = rCoreInfo[0];
-    signalNumber = rCoreInfo[2].toInt();
+    PreparedCore core;
+    core.filePath = filePath;
+    core.quarantined = false;
+    core.checkDuplicates = checkDuplicates;
+
+    // The server would reject a broken report only after a full upload.
+    // Section index lets readers of the report skip to the part they need;
+    // it's built while the report is decoded for the check.
+    QString reason;
+    CReporterRichCoreIndex::Entries index;
+    if (!CReporterIntegrityChecker::check(filePath, &reason, &index)) {
+        CReporterIntegrityChecker::quarantine(filePath, reason);
+        core.quarantined = true;
+        core.checkDuplicates = false;
+        return core;
+    }
 
-    count = 0;
+    if (filePath.endsWith(".lzo")) {
+        // Reduction is the only rewrite of the report, the index has to be
+        // built again for the new file.
+        if (reduce && CReporterCoreReducer::reduce(filePath)) {
+            CReporterRichCoreIndex::ensure(filePath);
+        } else {
+            CReporterRichCoreIndex::save(filePath, index);
+        }
+    }
 
-    qCDebug(cr) << "Name:" << binaryName << ", Signal:" << signalNumber;
-}
+    if (checkDuplicates) {
+        /* Prefer the top frames of the stack trace so that different bugs in
+         * one binary are counted separately and the same bug is recognized
+         * when reached from different binaries. */
+        core.signature = CReporterStackSignature::fromRichCore(filePath);
+    }
 
-CReporterHandledRichCore::~CReporterHandledRichCore()
-{
+    return core;
 }
 
-bool CReporterHandledRichCore::operator==(const CReporterHandledRichCore &other) const
-{
-    return (binaryName == other.binaryName) &&
-           (signalNumber == other.signalNumber);
 }
 
-
-CReporterDaemonMonitorPrivate::CReporterDaemonMonitorPrivate()
-    : autoDeleteMaxSimilarCores(0),
+CReporterDaemonMonitorPrivate::CReporterDaemonMonitorPrivate(const QString &handledCoresFile)
+    : handledCoresFile(handledCoresFile),
+      autoDeleteMaxSimilarCores(0),
       crashNotification(new CReporterNotification(
                             CReporter::AutoUploaderNotificationEventType,
                             CReporterSavedState::instance()->crashNotificationId(), this)),
-      crashCount(0)
+      crashCount(0),
+      uploadPending(false),
+      pendingPreparations(0)
 {
+    coalesceTimer.setSingleShot(true);
+    connect(&coalesceTimer, &QTimer::timeout,
+            this, &CReporterDaemonMonitorPrivate::processPendingDirectories);
+    lastFlush.start();
+
+    duplicates.load(handledCoresFile);
+
     connect(crashNotification, &CReporterNotification::timeouted,
             this, &CReporterDaemonMonitorPrivate::resetCrashCount);
 
@@ -92,7 +149,9 @@ CReporterDaemonMonitorPrivate::~CReporterDaemonMonitorPrivate()
     CReporterSavedState *state = CReporterSavedState::instance();
     state->setCrashNotificationId(crashNotification->id());
 
-    qDeleteAll(handledRichCores);
+    if (duplicates.isDirty()) {
+        duplicates.save(handledCoresFile);
+    }
 }
 
 void CReporterDaemonMonitorPrivate::addDirectoryWatcher()
@@ -101,13 +160,15 @@ void CReporterDaemonMonitorPrivate::addDirectoryWatcher()
 
     // Subscribe to receive signals for changed directories.
     connect(&watcher, SIGNAL(directoryChanged(const QString &)),
-            this, SLOT(handleDirectoryChanged(const QString &)));
+            this, SLOT(handleDirectoryChanged(const QString &)),
+            Qt::UniqueConnection);
 
     CReporterCoreRegistry *registry = CReporterCoreRegistry::instance();
 
-    // Subscribe to receive signals for changes in core registry.
+    // Subscribe to receive signals for changes in core registry, which are
+    // emitted also when volumes with core locations are (un)mounted.
     connect(registry, SIGNAL(coreLocationsUpdated()),
-            this, SLOT(addDirectoryWatcher()));
+            this, SLOT(addDirectoryWatcher()), Qt::UniqueConnection);
 
     QStringList corePaths(registry->getCoreLocationPaths());
 
@@ -134,6 +195,15 @@ void CReporterDaemonMonitorPrivate::handleDirectoryChanged(const QString &path)
     QDir changedDir(path);
     // QFileSystemWatcher will send signal if monitored directory was removed.
     if (!changedDir.exists()) {
+        pendingDirectories.removeAll(path);
+
+        QMutableStringListIterator core(pendingCores);
+        while (core.hasNext()) {
+            if (QFileInfo(core.next()).absolutePath() == path) {
+                core.remove();
+            }
+        }
+
         /* Re-add core dirs when the parent dir changes, so that monitoring is
          * resumed after USB mass storage mode has been disconnected */
         if (changedDir.cd("../..")) {
@@ -148,20 +218,53 @@ void CReporterDaemonMonitorPrivate::handleDirectoryChanged(const QString &path)
         return;
     }
 
-    qCDebug(cr) << "Changed directory exists.";
+    if (!pendingDirectories.contains(path)) {
+        pendingDirectories << path;
+    }
 
+    // Don't postpone a batch that is already scheduled.
+    if (!coalesceTimer.isActive()) {
+        coalesceTimer.start(COALESCE_WINDOW_MS);
+    }
+}
+
+void CReporterDaemonMonitorPrivate::processPendingDirectories()
+{
     CReporterCoreRegistry *registry = CReporterCoreRegistry::instance();
 
-    // Check for new cores in changed directory.
-    QString filePath = registry->checkDirectoryForCores(path);
+    QElapsedTimer budget;
+    budget.start();
 
-    if (filePath.isEmpty()) {
-        return;
+    while (!budget.hasExpired(BATCH_TIME_BUDGET_MS)) {
+        if (!pendingCores.isEmpty()) {
+            handleNewCore(pendingCores.takeFirst());
+        } else if (!pendingDirectories.isEmpty()) {
+            // Check for new cores in changed directory.
+            pendingCores = registry->checkDirectoryForCores(pendingDirectories.takeFirst());
+        } else {
+            break;
+        }
+    }
+
+    if (pendingDirectories.isEmpty() && pendingCores.isEmpty()) {
+        flushBatch();
+    } else {
+        qCDebug(cr) << "Batch time budget exceeded, continuing in next iteration.";
+        if (lastFlush.hasExpired(COALESCE_WINDOW_MS)) {
+            flushBatch();
+        }
+        coalesceTimer.start(0);
     }
+}
 
+void CReporterDaemonMonitorPrivate::handleNewCore(const QString &filePath)
+{
     // New core found.
     qCDebug(cr) << "New rich-core file found: " << filePath;
 
+    // Keep the disk and CPU free for handling the crash.
+    compressor.postpone();
+
     QStringList details = CReporterUtils::parseCrashInfoFromFilename(filePath);
     bool isUserTerminated = (details[2].toInt() == SIGQUIT);
 
@@ -170,10 +273,84 @@ void CReporterDaemonMonitorPrivate::handleDirectoryChanged(const QString &path)
     CReporterPrivacySettingsModel &settings =
         *CReporterPrivacySettingsModel::instance();
 
-    /* Check for duplicates if auto-deleting is enabled. If Maximum number
-     * of duplicates is exceeded, delete the file. */
-    if (!isUserTerminated && settings.autoDeleteDuplicates() &&
-            checkForDuplicates(filePath)) {
+    /* Check for duplicates if auto-deleting is enabled, once the report is
+     * prepared. Ignore reports that don't contain core dumps. */
+    bool checkDuplicates = !isUserTerminated && settings.autoDeleteDuplicates() &&
+                           CReporterUtils::reportIncludesCrash(filePath);
+
+    bool reduce = settings.reduceCoreInDaemon() &&
+                  CReporterUtils::reportIncludesCrash(filePath);
+
+    QFutureWatcher<PreparedCore> *preparation = new QFutureWatcher<PreparedCore>(this);
+    connect(preparation, &QFutureWatcher<PreparedCore>::finished,
+            this, &CReporterDaemonMonitorPrivate::preparationFinished);
+    connect(preparation, &QFutureWatcher<PreparedCore>::finished,
+            preparation, &QObject::deleteLater);
+    preparation->setFuture(QtConcurrent::run(prepareCore, filePath, reduce,
+                                             checkDuplicates));
+    ++pendingPreparations;
+}
+
+void CReporterDaemonMonitorPrivate::notifyNewCore(const QString &filePath)
+{
+    CReporterPrivacySettingsModel &settings =
+        *CReporterPrivacySettingsModel::instance();
+
+    if (!settings.automaticSendingEnabled()) {
+        /* TODO: Here multiple-choice notification should be displayed
+         * with options to send or delete the crash report. So far
+         * disabling auto upload is not possible in the UI and we never
+         * get here. Standard Sailfish notifications don't support multiple
+         * actions so far. */
+        return;
+    }
+
+    if (settings.notificationsEnabled()) {
+        QStringList details = CReporterUtils::parseCrashInfoFromFilename(filePath);
+        bool isUserTerminated = (details[2].toInt() == SIGQUIT);
+        QString summary;
+
+        pendingBody.clear();
+
+        if (filePath.contains(CReporter::QuickFeedbackPrefix)) {
+            //% "New feedback message is ready."
+            summary = qtTrId("crash_reporter-notify-quickie_ready");
+        } else if (filePath.contains(CReporter::EndurancePackagePrefix)) {
+            //% "New endurance report is ready."
+            summary = qtTrId("crash_reporter-notify-endurance_ready");
+        } else if (filePath.contains(CReporter::PowerExcessPrefix)) {
+            //% "Power excess detected."
+            summary = qtTrId("crash_reporter-notify-power_excess_detected");
+        } else if (isUserTerminated) {
+            //% "%1 was terminated."
+            summary = qtTrId("crash_reporter-notify-app_terminated");
+        } else {
+            if (++crashCount > 1) {
+                //% "%1 crashes total"
+                pendingBody = qtTrId("crash_reporter-notify-total_crashes").arg(crashCount);
+            }
+            //% "%1 has crashed."
+            summary = qtTrId("crash_reporter-notify-app_crashed");
+        }
+
+        pendingSummary = summary.arg(details.at(0));
+    }
+
+    uploadPending = true;
+}
+
+void CReporterDaemonMonitorPrivate::flushBatch()
+{
+    lastFlush.restart();
+
+    if (duplicates.isDirty()) {
+        duplicates.save(handledCoresFile);
+    }
+
+    CReporterPrivacySettingsModel &settings =
+        *CReporterPrivacySettingsModel::instance();
+
+    if (!pendingDuplicateName.isEmpty()) {
         if (settings.notificationsEnabled()) {
             CReporterNotification *notification =
                 new CReporterNotification(
@@ -184,59 +361,65 @@ void CReporterDaemonMonitorPrivate::handleDirectoryChanged(const QString &path)
                     notification, &QObject::deleteLater);
             //% "%1 has crashed again."
             notification->update(
-                qtTrId("crash_reporter-notify-crashed_again").arg(details[0]),
+                qtTrId("crash_reporter-notify-crashed_again").arg(pendingDuplicateName),
                 //% "Duplicate crash report was deleted."
                 qtTrId("crash_reporter-notify-duplicate_deleted"));
         }
-        CReporterUtils::removeFile(filePath);
+        pendingDuplicateName.clear();
+    }
+
+    if (!pendingSummary.isEmpty()) {
+        crashNotification->update(pendingSummary, pendingBody, crashCount);
+        pendingSummary.clear();
+        pendingBody.clear();
+    }
+
+    if (!uploadPending) {
         return;
     }
 
-    if (!settings.automaticSendingEnabled()) {
-        /* TODO: Here multiple-choice notification should be displayed
-         * with options to send or delete the crash report. So far
-         * disabling auto upload is not possible in the UI and we never
-         * get here. Standard Sailfish notifications don't support multiple
-         * actions so far. */
+    if (pendingPreparations > 0) {
+        qCDebug(cr) << "Waiting for" << pendingPreparations
+                    << "reports to be prepared before upload.";
+        return;
+    }
+    uploadPending = false;
+
+    if (!CReporterNwSessionMgr::canUseNetworkConnection() &&
+            !CReporterPrivacySettingsModel::instance()->triageUploadEnabled()) {
+        qCDebug(cr) << "WiFi not available, not uploading now.";
     } else {
-        if (settings.notificationsEnabled()) {
+        /* In auto-upload mode try to upload all crash reports each
+         * time new ones appear. Without WiFi, the auto uploader sends
+         * only their triage records. */
+        CReporterCoreRegistry *registry = CReporterCoreRegistry::instance();
+        if (!CReporterUtils::notifyAutoUploader(registry->collectAllCoreFiles())) {
+            qCWarning(cr) << "Failed to start Auto Uploader.";
+        }
+    }
+}
 
-            QString body;
-            QString summary;
-
-            if (filePath.contains(CReporter::QuickFeedbackPrefix)) {
-                //% "New feedback message is ready."
-                summary = qtTrId("crash_reporter-notify-quickie_ready");
-            } else if (filePath.contains(CReporter::EndurancePackagePrefix)) {
-                //% "New endurance report is ready."
-                summary = qtTrId("crash_reporter-notify-endurance_ready");
-            } else if (filePath.contains(CReporter::PowerExcessPrefix)) {
-                //% "Power excess detected."
-                summary = qtTrId("crash_reporter-notify-power_excess_detected");
-            } else if (isUserTerminated) {
-                //% "%1 was terminated."
-                summary = qtTrId("crash_reporter-notify-app_terminated");
-            } else {
-                if (++crashCount > 1) {
-                    //% "%1 crashes total"
-                    body = qtTrId("crash_reporter-notify-total_crashes").arg(crashCount);
-                }
-                //% "%1 has crashed."
-                summary = qtTrId("crash_reporter-notify-app_crashed");
-            }
+void CReporterDaemonMonitorPrivate::preparationFinished()
+{
+    QFutureWatcher<PreparedCore> *preparation =
+        static_cast<QFutureWatcher<PreparedCore> *>(sender());
+    PreparedCore core = preparation->result();
+    --pendingPreparations;
+
+    /* If maximum number of duplicates is exceeded, delete the file. */
+    if (core.checkDuplicates && checkForDuplicates(core.filePath, core.signature)) {
+        pendingDuplicateName =
+            CReporterUtils::parseCrashInfoFromFilename(core.filePath).at(0);
+        CReporterUtils::removeFile(core.filePath);
+        QFile::remove(CReporterRichCoreIndex::indexPath(core.filePath));
+    } else {
+        notifyNewCore(core.filePath);
+    }
 
-            crashNotification->update(summary.arg(details.at(0)), body,
-                                      crashCount);
-        }
-        if (!CReporterNwSessionMgr::canUseNetworkConnection()) {
-            qCDebug(cr) << "WiFi not available, not uploading now.";
-        } else {
-            /* In auto-upload mode try to upload all crash reports each
-             * time a new one appears. */
-            if (!CReporterUtils::notifyAutoUploader(registry->collectAllCoreFiles())) {
-                qCWarning(cr) << "Failed to start Auto Uploader.";
-            }
-        }
+    // Don't hold notifications back for long while many reports are
+    // being prepared.
+    if (pendingPreparations == 0 || lastFlush.hasExpired(COALESCE_WINDOW_MS)) {
+        flushBatch();
     }
 }
 
@@ -263,52 +446,24 @@ void CReporterDaemonMonitorPrivate::handleParentDirectoryChanged()
     }
 }
 
-bool CReporterDaemonMonitorPrivate::checkForDuplicates(const QString &path)
+bool CReporterDaemonMonitorPrivate::checkForDuplicates(const QString &path,
+                                                       QByteArray signature)
 {
-    // Ignore reports that don't contain core dumps.
-    if (!CReporterUtils::reportIncludesCrash(path)) {
-        return false;
+    if (signature.isEmpty()) {
+        QStringList details = CReporterUtils::parseCrashInfoFromFilename(path);
+        signature = details[0].toUtf8() + '/' + details[2].toUtf8();
     }
 
-    qCDebug(cr) << "Checking, if" << path << "has been handled for"
-                << autoDeleteMaxSimilarCores << "times.";
-
-    // Create new entry.
-    CReporterHandledRichCore *rCore = new CReporterHandledRichCore(path);
-
-    foreach (CReporterHandledRichCore *handled, handledRichCores) {
-        // Loop through list to find duplicates.
-        qCDebug(cr) << "Compare to:"
-                    << "Name:" << handled->binaryName << ", Signal:" << handled->signalNumber;
-
-        if (*handled == *rCore) {
-            /* Check if more than a day has passed from last duplicate counter
-             * reset. */
-            QDateTime now(QDateTime::currentDateTimeUtc());
-            if (handled->lastCountReset.addDays(1) < now) {
-                qCDebug(cr) << "More than a day has passed, resetting duplicate counter";
-                handled->count = 0;
-                handled->lastCountReset = now;
-            }
+    int count = duplicates.hit(CReporterDuplicateTracker::key(signature));
 
-            handled->count++;
-            // Duplicate found. Increment counter.
-            qCDebug(cr) << "Matches. Count is now:" << handled->count;
+    qCDebug(cr) << path << "has been handled" << count << "times within"
+                << CReporterDuplicateTracker::WindowHours << "hours, maximum is"
+                << autoDeleteMaxSimilarCores;
 
-            if (handled->count > autoDeleteMaxSimilarCores) {
-                // Maximum exeeded.
-                qCDebug(cr) << "Maximum number of duplicates exceeded.";
-                delete rCore;
-                return true;
-            }
-            // Maximum not yet exeeded.
-            delete rCore;
-            return false;
-        }
+    if (count > autoDeleteMaxSimilarCores) {
+        qCDebug(cr) << "Maximum number of duplicates exceeded.";
+        return true;
     }
-    // Not found. Add to handled list.
-    rCore->count++;
-    handledRichCores << rCore;
 
     return false;
 }
@@ -341,8 +496,9 @@ void CReporterDaemonMonitorPrivate::onSetAutoUploadChanged()
     proxy.quit();
 }
 
-CReporterDaemonMonitor::CReporterDaemonMonitor(QObject *parent)
-    : QObject(parent), d_ptr(new CReporterDaemonMonitorPrivate())
+CReporterDaemonMonitor::CReporterDaemonMonitor(const QString &handledCoresFile,
+                                               QObject *parent)
+    : QObject(parent), d_ptr(new CReporterDaemonMonitorPrivate(handledCoresFile))
 {
     d_ptr->q_ptr = this;
 
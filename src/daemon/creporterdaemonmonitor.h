@@ -48,11 +48,13 @@ public:
     /*!
      * Creates new instance of coredump directory monitor.
      *
+     * @param handledCoresFile File where the handled crashes are stored
+     *    between daemon runs for recognizing duplicates.
      * @param parent the parent QObject.
      *
      * @sa CReporterCoreRegistry
      */
-    CReporterDaemonMonitor(QObject *parent);
+    CReporterDaemonMonitor(const QString &handledCoresFile, QObject *parent);
 
     ~CReporterDaemonMonitor();
 
@@ -25,48 +25,18 @@
 #ifndef CREPORTERDAEMONMONITOR_P_H
 #define CREPORTERDAEMONMONITOR_P_H
 
-#include <QDateTime>
+#include <QElapsedTimer>
 #include <QFileSystemWatcher>
+#include <QStringList>
+#include <QTimer>
+
+#include "creportercorecompressor.h"
+#include "creporterduplicatetracker.h"
 
 class CReporterCoreRegistry;
 class CReporterDaemonMonitor;
 class CReporterNotification;
 
-/*!
-  * @class CReporterHandledRichCore
-  * @brief This class represent handled rich-core file.
-  *
-  */
-class CReporterHandledRichCore
-{
-public:
-    /*!
-      * @brief Class constructor.
-      *
-      * @param filePath Rich-core file path.
-      */
-    CReporterHandledRichCore(const QString &filePath);
-
-    ~CReporterHandledRichCore();
-
-    /*!
-      * @brief Returns true, if @a other has similar information than this object.
-      *
-      * @param other CReporterHandledRichCore object.
-      */
-    bool operator==(const CReporterHandledRichCore &other) const;
-
-public:
-    //! @arg Binary file name of the application.
-    QString binaryName;
-    //! @arg Signal number (SIGNUM).
-    int signalNumber;
-    //! @arg Upper file size limit.
-    int count;
-    //! @arg When duplicate counter was last set to zero.
-    QDateTime lastCountReset;
-};
-
 /*!
  * @class CReporterDaemonMonitorPrivate
  * @brief Private CReporterDaemonMonitor class.
@@ -78,7 +48,7 @@ class CReporterDaemonMonitorPrivate : public QObject
     Q_OBJECT
 
 public:
-    CReporterDaemonMonitorPrivate();
+    CReporterDaemonMonitorPrivate(const QString &handledCoresFile);
     ~CReporterDaemonMonitorPrivate();
 
 public Q_SLOTS:
@@ -100,10 +70,23 @@ public Q_SLOTS:
     /*!
      * @brief Called when directoryChanged signal is received.
      *
+     * The directory is only queued for processing here. Events arriving
+     * within a short window are coalesced and handled together in
+     * processPendingDirectories().
+     *
      * @param Reference to changed directory.
      */
     void handleDirectoryChanged(const QString &path);
 
+    /*!
+     * @brief Processes new cores from the queued directories.
+     *
+     * Processing of one batch stops when its time budget is used up; the
+     * rest is handled on the next main loop iteration so that D-Bus calls
+     * to the daemon are served also during a crash storm.
+     */
+    void processPendingDirectories();
+
     /*!
      * @brief Re-enables monitoring of core-dump dir when USB mass storage has been disabled and MyDocs is back in use
      *
@@ -128,10 +111,20 @@ public:
     QFileSystemWatcher watcher;
     //! @arg Watcher for monitoring the return of an unmounted directory for when core-dumps dir has disappeared because of USB mass storage mode
     QFileSystemWatcher parentDirWatcher;
-    //! @arg List of handled rich-cores.
-    QList <CReporterHandledRichCore *> handledRichCores;
+    //! @arg Counts handled rich-cores by their signature.
+    CReporterDuplicateTracker duplicates;
+    //! @arg File where duplicates are stored between daemon runs.
+    QString handledCoresFile;
+    //! @arg Compresses plain rich cores while no new cores arrive.
+    CReporterCoreCompressor compressor;
     //! @arg Number of similar cores to keep when auto-delete is enabled
     int autoDeleteMaxSimilarCores;
+    //! @arg Collects directory change events into batches.
+    QTimer coalesceTimer;
+    //! @arg Changed directories waiting to be checked for new cores.
+    QStringList pendingDirectories;
+    //! @arg New cores found in the changed directories, not handled yet.
+    QStringList pendingCores;
 
     Q_DECLARE_PUBLIC(CReporterDaemonMonitor)
     //! @arg Pointer to public class.
@@ -146,16 +139,59 @@ private:
     //! Counts processed crash reports.
     int crashCount;
 
+    //! Summary of the crash notification to show when the batch is flushed.
+    QString pendingSummary;
+    //! Body of the crash notification to show when the batch is flushed.
+    QString pendingBody;
+    //! Name of the last application whose duplicate report was deleted.
+    QString pendingDuplicateName;
+    //! Whether auto uploader should be notified when the batch is flushed.
+    bool uploadPending;
+    //! Number of new reports being prepared in worker threads.
+    int pendingPreparations;
+    //! Measures time since the results of processing were last flushed.
+    QElapsedTimer lastFlush;
+
+    /**
+     * Handles a single new rich core found in one of the core directories.
+     *
+     * @param filePath Path of the new rich core.
+     */
+    void handleNewCore(const QString &filePath);
+
+    /**
+     * Queues notification of a new rich core and its upload, done when the
+     * batch is flushed.
+     *
+     * @param filePath Path of the new rich core.
+     */
+    void notifyNewCore(const QString &filePath);
+
+    /**
+     * Publishes the notifications and the upload request accumulated while
+     * processing the current batch of new cores.
+     */
+    void flushBatch();
+
     /**
      * Checks whether 'similar' rich core was already handled.
      *
      * @param path File path of rich core to check.
+     * @param signature Stack signature of the rich core. If empty, the
+     *        application name and signal from the file name are used.
      * @return @c true if duplicate was found, otherwise @c false.
      */
-    bool checkForDuplicates(const QString &path);
+    bool checkForDuplicates(const QString &path, QByteArray signature);
 
 private slots:
     void onSetAutoUploadChanged();
+
+    /**
+     * Finishes handling of a prepared report: deletes it if it's a
+     * duplicate, otherwise queues its notification. Flushes the batch once
+     * all new reports are prepared.
+     */
+    void preparationFinished();
 };
 
 #endif // CREPORTERDAEMONMONITOR_P_H
@@ -0,0 +1,341 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creporterduplicatetracker.h"
+
+#include <cstring>
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QVector>
+
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+
+//! Identifies the file format of saved tables ("CRDT").
+const quint32 FILE_MAGIC = 0x43524454;
+const quint32 FILE_VERSION = 1;
+
+const int NONE = -1;
+
+quint32 hoursSinceEpoch(const QDateTime &time)
+{
+    return time.toMSecsSinceEpoch() / (60 * 60 * 1000);
+}
+
+}
+
+class CReporterDuplicateTrackerPrivate
+{
+public:
+    struct Entry {
+        quint64 key;
+        //! Hour of the most recent occurrence.
+        quint32 lastHour;
+        //! Occurrences per hour, ring indexed by hour modulo window length.
+        quint16 buckets[CReporterDuplicateTracker::WindowHours];
+        //! Neighbours in the recently used list.
+        qint32 prev;
+        qint32 next;
+    };
+
+    int capacity;
+    QVector<Entry> entries;
+    QHash<quint64, qint32> index;
+    //! Most recently used entry.
+    qint32 head;
+    //! Least recently used entry, evicted first.
+    qint32 tail;
+    bool dirty;
+
+    void clear();
+    void unlink(qint32 i);
+    void pushFront(qint32 i);
+    qint32 insert(quint64 key, quint32 hour);
+    static void advance(Entry &entry, quint32 hour);
+    static int sum(const Entry &entry, quint32 hour);
+};
+
+void CReporterDuplicateTrackerPrivate::clear()
+{
+    entries.clear();
+    index.clear();
+    head = tail = NONE;
+}
+
+void CReporterDuplicateTrackerPrivate::unlink(qint32 i)
+{
+    Entry &e = entries[i];
+    if (e.prev != NONE) {
+        entries[e.prev].next = e.next;
+    } else {
+        head = e.next;
+    }
+    if (e.next != NONE) {
+        entries[e.next].prev = e.prev;
+    } else {
+        tail = e.prev;
+    }
+    e.prev = e.next = NONE;
+}
+
+void CReporterDuplicateTrackerPrivate::pushFront(qint32 i)
+{
+    Entry &e = entries[i];
+    e.prev = NONE;
+    e.next = head;
+    if (head != NONE) {
+        entries[head].prev = i;
+    }
+    head = i;
+    if (tail == NONE) {
+        tail = i;
+    }
+}
+
+qint32 CReporterDuplicateTrackerPrivate::insert(quint64 key, quint32 hour)
+{
+    qint32 i;
+    if (entries.size() < capacity) {
+        i = entries.size();
+        entries.append(Entry());
+    } else {
+        // Table is full, reuse the least recently used entry.
+        i = tail;
+        unlink(i);
+        index.remove(entries[i].key);
+    }
+
+    Entry &e = entries[i];
+    e.key = key;
+    e.lastHour = hour;
+    memset(e.buckets, 0, sizeof(e.buckets));
+    index.insert(key, i);
+    pushFront(i);
+
+    return i;
+}
+
+void CReporterDuplicateTrackerPrivate::advance(Entry &entry, quint32 hour)
+{
+    // Clock going backwards is counted to the latest recorded hour.
+    if (hour <= entry.lastHour) {
+        return;
+    }
+
+    quint32 elapsed = qMin<quint32>(hour - entry.lastHour,
+                                    CReporterDuplicateTracker::WindowHours);
+    for (quint32 h = hour - elapsed + 1; h <= hour; ++h) {
+        entry.buckets[h % CReporterDuplicateTracker::WindowHours] = 0;
+    }
+    entry.lastHour = hour;
+}
+
+int CReporterDuplicateTrackerPrivate::sum(const Entry &entry, quint32 hour)
+{
+    const qint64 window = CReporterDuplicateTracker::WindowHours;
+
+    // Sum the buckets of hours that are both recorded and inside the window.
+    qint64 first = qMax<qint64>(qint64(hour), entry.lastHour) - window + 1;
+    first = qMax<qint64>(first, qint64(entry.lastHour) - window + 1);
+    first = qMax<qint64>(first, 0);
+
+    int total = 0;
+    for (qint64 h = first; h <= entry.lastHour; ++h) {
+        total += entry.buckets[h % window];
+    }
+    return total;
+}
+
+CReporterDuplicateTracker::CReporterDuplicateTracker(int capacity)
+    : d_ptr(new CReporterDuplicateTrackerPrivate)
+{
+    Q_D(CReporterDuplicateTracker);
+
+    d->capacity = qMax(1, capacity);
+    d->entries.reserve(d->capacity);
+    d->index.reserve(d->capacity);
+    d->head = d->tail = NONE;
+    d->dirty = false;
+}
+
+CReporterDuplicateTracker::~CReporterDuplicateTracker()
+{
+}
+
+quint64 CReporterDuplicateTracker::key(const QByteArray &signature)
+{
+    quint64 hash = Q_UINT64_C(14695981039346656037);
+    for (int i = 0; i < signature.size(); ++i) {
+        hash ^= static_cast<uchar>(signature.at(i));
+        hash *= Q_UINT64_C(1099511628211);
+    }
+    return hash;
+}
+
+int CReporterDuplicateTracker::hit(quint64 key, const QDateTime &now)
+{
+    Q_D(CReporterDuplicateTracker);
+
+    quint32 hour = hoursSinceEpoch(now);
+
+    qint32 i = d->index.value(key, NONE);
+    if (i == NONE) {
+        i = d->insert(key, hour);
+    } else {
+        d->unlink(i);
+        d->pushFront(i);
+    }
+
+    CReporterDuplicateTrackerPrivate::Entry &e = d->entries[i];
+    d->advance(e, hour);
+    quint16 &bucket = e.buckets[e.lastHour % WindowHours];
+    if (bucket < 0xffff) {
+        ++bucket;
+    }
+    d->dirty = true;
+
+    return d->sum(e, e.lastHour);
+}
+
+int CReporterDuplicateTracker::count(quint64 key, const QDateTime &now) const
+{
+    Q_D(const CReporterDuplicateTracker);
+
+    qint32 i = d->index.value(key, NONE);
+    if (i == NONE) {
+        return 0;
+    }
+
+    const CReporterDuplicateTrackerPrivate::Entry &e = d->entries.at(i);
+    return d->sum(e, qMax(e.lastHour, hoursSinceEpoch(now)));
+}
+
+int CReporterDuplicateTracker::size() const
+{
+    Q_D(const CReporterDuplicateTracker);
+    return d->entries.size();
+}
+
+int CReporterDuplicateTracker::capacity() const
+{
+    Q_D(const CReporterDuplicateTracker);
+    return d->capacity;
+}
+
+bool CReporterDuplicateTracker::isDirty() const
+{
+    Q_D(const CReporterDuplicateTracker);
+    return d->dirty;
+}
+
+bool CReporterDuplicateTracker::load(const QString &path)
+{
+    Q_D(CReporterDuplicateTracker);
+
+    d->clear();
+    d->dirty = false;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCDebug(cr) << "No handled cores loaded from" << path;
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic, version, count;
+    stream >> magic >> version >> count;
+    if (stream.status() != QDataStream::Ok || magic != FILE_MAGIC ||
+            version != FILE_VERSION) {
+        qCWarning(cr) << "Invalid handled cores file" << path;
+        return false;
+    }
+
+    // Entries are stored from the least recently used, inserting them in
+    // order restores the recently used list and keeps the table in capacity.
+    for (quint32 n = 0; n < count; ++n) {
+        quint64 key;
+        quint32 lastHour;
+        stream >> key >> lastHour;
+
+        qint32 i = d->index.value(key, NONE);
+        if (i == NONE) {
+            i = d->insert(key, lastHour);
+        }
+        CReporterDuplicateTrackerPrivate::Entry &e = d->entries[i];
+        e.lastHour = lastHour;
+        for (int b = 0; b < WindowHours; ++b) {
+            stream >> e.buckets[b];
+        }
+
+        if (stream.status() != QDataStream::Ok) {
+            qCWarning(cr) << "Truncated handled cores file" << path;
+            d->clear();
+            return false;
+        }
+    }
+
+    qCDebug(cr) << "Loaded" << d->entries.size() << "handled cores from" << path;
+
+    return true;
+}
+
+bool CReporterDuplicateTracker::save(const QString &path)
+{
+    Q_D(CReporterDuplicateTracker);
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(cr) << "Cannot write handled cores to" << path;
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream << FILE_MAGIC << FILE_VERSION << quint32(d->entries.size());
+    for (qint32 i = d->tail; i != NONE; i = d->entries.at(i).prev) {
+        const CReporterDuplicateTrackerPrivate::Entry &e = d->entries.at(i);
+        stream << e.key << e.lastHour;
+        for (int b = 0; b < WindowHours; ++b) {
+            stream << e.buckets[b];
+        }
+    }
+
+    if (!file.commit()) {
+        qCWarning(cr) << "Cannot write handled cores to" << path;
+        return false;
+    }
+
+    d->dirty = false;
+
+    return true;
+}
@@ -0,0 +1,117 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERDUPLICATETRACKER_H
+#define CREPORTERDUPLICATETRACKER_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QScopedPointer>
+#include <QString>
+
+class CReporterDuplicateTrackerPrivate;
+
+/*!
+ * @class CReporterDuplicateTracker
+ * @brief Counts occurrences of similar crashes within a sliding time window.
+ *
+ * Crashes are identified by a 64-bit key computed from their signature.
+ * Lookup is a single hash probe and the table never grows over its
+ * capacity; when full, the least recently seen crash is forgotten. The
+ * table can be saved to and restored from a file, so the counters survive
+ * restarts of the daemon.
+ */
+class CReporterDuplicateTracker
+{
+public:
+    //! Default maximum number of distinct crashes tracked.
+    static const int DefaultCapacity = 512;
+    //! Length of the counting window in hours.
+    static const int WindowHours = 24;
+
+    /*!
+     * @brief Class constructor.
+     *
+     * @param capacity Maximum number of distinct crashes to track.
+     */
+    explicit CReporterDuplicateTracker(int capacity = DefaultCapacity);
+    ~CReporterDuplicateTracker();
+
+    /*!
+     * @brief Computes the key identifying a crash signature.
+     *
+     * Unlike qHash() the result is stable across processes, so it can be
+     * persisted.
+     *
+     * @param signature Crash signature.
+     * @return 64-bit FNV-1a hash of @a signature.
+     */
+    static quint64 key(const QByteArray &signature);
+
+    /*!
+     * @brief Records one occurrence of a crash.
+     *
+     * @param key Key of the crash signature.
+     * @param now Time of the occurrence.
+     * @return Number of occurrences of the crash within the window, including
+     *         this one.
+     */
+    int hit(quint64 key, const QDateTime &now = QDateTime::currentDateTimeUtc());
+
+    /*!
+     * @brief Number of occurrences of a crash within the window.
+     *
+     * @param key Key of the crash signature.
+     * @param now Current time.
+     */
+    int count(quint64 key, const QDateTime &now = QDateTime::currentDateTimeUtc()) const;
+
+    //! Number of distinct crashes currently tracked.
+    int size() const;
+
+    //! Maximum number of distinct crashes tracked.
+    int capacity() const;
+
+    //! Returns @c true if the table changed since it was last loaded or saved.
+    bool isDirty() const;
+
+    /*!
+     * @brief Replaces the table with the content of a file saved by save().
+     *
+     * @param path File to read.
+     * @return @c true on success. On failure the table is left empty.
+     */
+    bool load(const QString &path);
+
+    /*!
+     * @brief Atomically writes the table into a file.
+     *
+     * @param path File to write. Missing parent directories are created.
+     * @return @c true on success.
+     */
+    bool save(const QString &path);
+
+private:
+    Q_DISABLE_COPY(CReporterDuplicateTracker)
+    Q_DECLARE_PRIVATE(CReporterDuplicateTracker)
+    QScopedPointer<CReporterDuplicateTrackerPrivate> d_ptr;
+};
+
+#endif // CREPORTERDUPLICATETRACKER_H
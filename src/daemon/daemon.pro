@@ -47,24 +47,29 @@ INCLUDEPATH += . \
                ../libs/settings \
                ../libs \
                ../libs/notification \
+               ../libs/richcore \
 
 
 LIBS += ../../lib/libcrashreporter.so \
 
-QT += dbus network
+QT += dbus network concurrent
 QT -= gui
 
 SOURCES += main.cpp \
+           creportercorecompressor.cpp \
            creporterdaemon.cpp \
            creporterdaemonadaptor.cpp \
            creporterdaemonmonitor.cpp \
+           creporterduplicatetracker.cpp \
            powerexcesshandler.cpp \
 
-HEADERS += creporterdaemon.h \
+HEADERS += creportercorecompressor.h \
+           creporterdaemon.h \
            creporterdaemon_p.h \
            creporterdaemonadaptor.h \
            creporterdaemonmonitor.h \
            creporterdaemonmonitor_p.h \
+           creporterduplicatetracker.h \
            powerexcesshandler.h \
 
 service.files = com.nokia.CrashReporter.Daemon.service
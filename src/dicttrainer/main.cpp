@@ -0,0 +1,182 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+
+#include <zstd.h>
+
+#include "creporterrichcorereader.h"
+#include "creportersectionencoder.h"
+
+namespace {
+
+QTextStream out(stdout);
+QTextStream err(stderr);
+
+QStringList reportFiles(const QStringList &paths)
+{
+    QStringList files;
+    foreach (const QString &path, paths) {
+        QFileInfo fi(path);
+        if (!fi.isDir()) {
+            files << path;
+            continue;
+        }
+
+        QDir dir(path);
+        foreach (const QString &name,
+                 dir.entryList(QStringList() << "*.rcore.lzo" << "*.rcore", QDir::Files)) {
+            files << dir.filePath(name);
+        }
+    }
+    return files;
+}
+
+/*!
+ * Collects text sections of a report the way the encoder would see them.
+ * Sections already encoded are skipped, train with reports as they are
+ * stored on the device.
+ */
+void collectSamples(const QString &filePath, QList<QByteArray> *samples)
+{
+    CReporterRichCoreReader reader(filePath);
+
+    while (reader.nextSection()) {
+        QString name = reader.sectionName();
+
+        if (name.endsWith(CReporterSectionEncoder::EncodedSuffix)) {
+            // Encoded input is not supported: the id of the dictionary is
+            // sent along the upload only, not stored in the report.
+            continue;
+        }
+
+        if (!CReporterSectionEncoder::isEncodable(name, QByteArray())) {
+            continue;
+        }
+
+        QByteArray data = reader.readSection(CReporterSectionEncoder::MaxSectionSize + 1);
+        if (data.size() <= CReporterSectionEncoder::MaxSectionSize &&
+                CReporterSectionEncoder::isEncodable(name, data)) {
+            *samples << data;
+        }
+    }
+
+    if (reader.hasError()) {
+        err << "Skipping " << filePath << ": " << reader.errorString() << endl;
+    }
+}
+
+qint64 compressedSize(const QList<QByteArray> &samples, const QByteArray &dictionary)
+{
+    ZSTD_CCtx *cctx = ZSTD_createCCtx();
+    QByteArray buffer;
+    qint64 total = 0;
+
+    foreach (const QByteArray &sample, samples) {
+        buffer.resize(ZSTD_compressBound(sample.size()));
+        size_t size = ZSTD_compress_usingDict(cctx, buffer.data(), buffer.size(),
+                                              sample.constData(), sample.size(),
+                                              dictionary.constData(), dictionary.size(), 9);
+        total += ZSTD_isError(size) ? sample.size() : size;
+    }
+
+    ZSTD_freeCCtx(cctx);
+    return total;
+}
+
+}
+
+/*!
+ * @brief Trains a zstd dictionary for encoding text sections of reports.
+ *
+ * The dictionary is to be installed to CReporter::SectionDictionaryLocation.
+ */
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Trains zstd dictionary from text sections of past crash reports.");
+    parser.addHelpOption();
+    QCommandLineOption sizeOption(QStringList() << "s" << "size",
+        "Maximum dictionary size in bytes.", "bytes",
+        QString::number(CReporterSectionEncoder::DefaultDictionarySize));
+    parser.addOption(sizeOption);
+    parser.addPositionalArgument("output", "Dictionary file to write, e.g. "
+                                 "sections-20151001.dict.");
+    parser.addPositionalArgument("reports", "Rich core files or directories "
+                                 "containing them.", "reports...");
+    parser.process(app);
+
+    QStringList args = parser.positionalArguments();
+    if (args.size() < 2) {
+        parser.showHelp(EXIT_FAILURE);
+    }
+
+    int maxSize = parser.value(sizeOption).toInt();
+    if (maxSize <= 0) {
+        err << "Invalid dictionary size." << endl;
+        return EXIT_FAILURE;
+    }
+
+    QString output = args.takeFirst();
+    QList<QByteArray> samples;
+    qint64 sampleBytes = 0;
+
+    QStringList files = reportFiles(args);
+    foreach (const QString &filePath, files) {
+        collectSamples(filePath, &samples);
+    }
+    foreach (const QByteArray &sample, samples) {
+        sampleBytes += sample.size();
+    }
+
+    out << "Collected " << samples.size() << " sections, " << sampleBytes
+        << " bytes from " << files.size() << " reports." << endl;
+
+    QByteArray dictionary = CReporterSectionEncoder::trainDictionary(samples, maxSize);
+    if (dictionary.isEmpty()) {
+        err << "Training failed, more samples are needed." << endl;
+        return EXIT_FAILURE;
+    }
+
+    QFile file(output);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+            file.write(dictionary) != dictionary.size()) {
+        err << "Couldn't write " << output << ": " << file.errorString() << endl;
+        return EXIT_FAILURE;
+    }
+    file.close();
+
+    qint64 plain = compressedSize(samples, QByteArray());
+    qint64 trained = compressedSize(samples, dictionary);
+    out << "Dictionary " << ZSTD_getDictID_fromDict(dictionary.constData(), dictionary.size())
+        << " of " << dictionary.size() << " bytes written to " << output << "." << endl;
+    out << "Sections compress to " << plain << " bytes without and " << trained
+        << " bytes with the dictionary." << endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,469 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "endurancecollect.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syslog.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+#include <sys/wait.h>
+
+#include "mce.h"
+#include "snapshot.h"
+
+static const time_t SNAPSHOT_INTERVAL = IPHB_GS_WAIT_1_HOUR; // seconds
+static const time_t MIN_SNAPSHOT_INTERVAL = IPHB_GS_WAIT_1_HOUR / 2; // seconds
+static const time_t MAX_SNAPSHOT_INTERVAL = 4 * IPHB_GS_WAIT_1_HOUR; // seconds
+// Change scores in permille per hour, see snapshot_change_score(). Above
+// FAST_CHANGE the interval halves, below SLOW_CHANGE it doubles, so that
+// it stays aligned with the iphb slots.
+static const int FAST_CHANGE = 20;
+static const int SLOW_CHANGE = 5;
+static const time_t KEEPALIVE_TIMER = 30; // seconds
+// Tolerance of iphb wakeups around the interval.
+static const time_t WAKEUP_SLACK = 10; // seconds
+
+static const char ENDURANCE_DIR[] = "/var/cache/core-dumps/endurance";
+static const char BOOT_MARK_FILE[] = "/tmp/endurance-collect-boot-mark";
+static const char PACK_COMMAND[] = "/usr/libexec/endurance-collect pack";
+static const char SNAPSHOT_COUNT_FILE[] = "snapshot_count";
+static const char BOOT_TIME_FILE[] = "boot_time";
+
+// Same limits as in the endurance-collect script.
+static const int SNAPSHOTS_TO_PACK = 12;
+static const int MIN_SESSION_LENGTH = 2;
+
+#define MAX_EVENTS 4
+
+static void set_timer(int fd, time_t seconds)
+{
+    struct itimerspec its;
+    its.it_value.tv_sec = seconds;
+    its.it_value.tv_nsec = 0;
+    its.it_interval.tv_sec = seconds;
+    its.it_interval.tv_nsec = 0;
+
+    timerfd_settime(fd, 0, &its, NULL);
+}
+
+// Descriptors are edge-triggered, so they have to be drained completely.
+static void discard_input(int fd)
+{
+    // Reading from SIGCHLD signal fd returns EINVAL with smaller buffer
+    char buf[sizeof (struct signalfd_siginfo)];
+    while (1) {
+        ssize_t bytes_read = read(fd, buf, sizeof buf);
+        if (bytes_read > 0 || (bytes_read == -1 && errno == EINTR)) {
+            continue;
+        }
+        if (bytes_read == -1 && errno != EAGAIN) {
+            syslog(LOG_ERR, "Error reading from fd %d, errno %d.", fd, errno);
+        }
+        break;
+    }
+}
+
+static int watch(struct endurance_collect *ec, int fd)
+{
+    struct epoll_event event;
+    memset(&event, 0, sizeof event);
+    event.events = EPOLLIN | EPOLLET;
+    event.data.fd = fd;
+
+    if (epoll_ctl(ec->epollfd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        syslog(LOG_CRIT, "Couldn't watch fd %d, errno %d.", fd, errno);
+        return -1;
+    }
+    return 0;
+}
+
+static int wait_for_next_snapshot(struct endurance_collect *ec)
+{
+    time_t min = ec->interval > WAKEUP_SLACK ? ec->interval - WAKEUP_SLACK : 1;
+
+    if (iphb_wait(ec->iphb, min, ec->interval + WAKEUP_SLACK, 0) < 0) {
+        syslog(LOG_CRIT, "Couldn't wait for heartbeat timer.");
+        return -1;
+    }
+    return 0;
+}
+
+static int finish_collection(struct endurance_collect *ec)
+{
+    syslog(LOG_DEBUG, "Snapshot collection finished.");
+    set_timer(ec->keepalivefd, 0);
+    mce_cpu_keepalive_stop();
+
+    return wait_for_next_snapshot(ec);
+}
+
+static int spawn(struct endurance_collect *ec, const char *command)
+{
+    pid_t pid = fork();
+    if (pid == -1) {
+        syslog(LOG_ERR, "Error on fork().");
+        return -1;
+    } else if (pid == 0) {
+        sigprocmask(SIG_SETMASK, &ec->old_sigmask, NULL);
+
+        char *args[] = { "/bin/sh", "-c", (char *)command, NULL };
+        execv(args[0], args);
+        syslog(LOG_CRIT, "Couldn't invoke %s", command);
+        _exit(EXIT_FAILURE);
+    }
+
+    ec->child_pid = pid;
+    return 0;
+}
+
+// Returns the number stored in a file of the endurance directory, or -1.
+static long read_number(struct endurance_collect *ec, const char *name)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof path, "%s/%s", ec->endurance_dir, name);
+
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        return -1;
+    }
+    long value;
+    if (fscanf(file, "%ld", &value) != 1) {
+        value = -1;
+    }
+    fclose(file);
+
+    return value;
+}
+
+static void write_number(struct endurance_collect *ec, const char *name,
+        long value)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof path, "%s/%s", ec->endurance_dir, name);
+
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        syslog(LOG_ERR, "Couldn't write %s, errno %d.", path, errno);
+        return;
+    }
+    fprintf(file, "%ld", value);
+    fclose(file);
+}
+
+// Checks whether the snapshots in the endurance directory come from before
+// the last reboot. Returns 1 if they have to be packed before starting a new
+// session, 0 otherwise.
+static int begin_session(struct endurance_collect *ec, int allow_pack)
+{
+    if (access(ec->boot_mark_file, F_OK) == 0) {
+        return 0;
+    }
+
+    long count = read_number(ec, SNAPSHOT_COUNT_FILE);
+    if (count < 0) {
+        count = snapshot_count(ec->endurance_dir);
+    }
+
+    if (count >= MIN_SESSION_LENGTH) {
+        if (allow_pack && snapshot_count(ec->endurance_dir) > 0) {
+            syslog(LOG_DEBUG, "Packing snapshots of the previous boot.");
+            return 1;
+        }
+    } else if (count > 0) {
+        syslog(LOG_DEBUG, "Discarding %ld snapshots of the previous boot.",
+                count);
+    }
+
+    // Whatever packing left behind is not part of the new session.
+    remove_tree(ec->endurance_dir);
+    if (mkdir(ec->endurance_dir, 0755) < 0 && errno != EEXIST) {
+        syslog(LOG_ERR, "Couldn't create %s, errno %d.", ec->endurance_dir,
+                errno);
+        return 0;
+    }
+
+    int fd = open(ec->boot_mark_file, O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    if (fd >= 0) {
+        close(fd);
+    }
+
+    write_number(ec, BOOT_TIME_FILE,
+            snapshot_collector_boot_time(ec->collector));
+    write_number(ec, SNAPSHOT_COUNT_FILE, 0);
+
+    return 0;
+}
+
+static time_t boot_time_now(void)
+{
+    struct timespec ts;
+    if (clock_gettime(CLOCK_BOOTTIME, &ts) < 0) {
+        return 0;
+    }
+    return ts.tv_sec;
+}
+
+static void schedule(struct endurance_collect *ec)
+{
+    time_t now = boot_time_now();
+
+    if (ec->last_snapshot_time != 0 && now > 0) {
+        int score = snapshot_change_score(&ec->last_summary,
+                &ec->collector->summary, now - ec->last_snapshot_time);
+        endurance_collect_adapt_interval(ec, score);
+    }
+
+    ec->last_summary = ec->collector->summary;
+    ec->last_snapshot_time = now;
+}
+
+static int collect_natively(struct endurance_collect *ec)
+{
+    if (snapshot_collector_collect(ec->collector, ec->endurance_dir) >= 0) {
+        long count = read_number(ec, SNAPSHOT_COUNT_FILE);
+        write_number(ec, SNAPSHOT_COUNT_FILE, count < 0 ? 1 : count + 1);
+        schedule(ec);
+    }
+
+    if (snapshot_count(ec->endurance_dir) >= SNAPSHOTS_TO_PACK) {
+        syslog(LOG_DEBUG, "Packing endurance snapshots.");
+        if (spawn(ec, ec->pack_command) == 0) {
+            return 0;
+        }
+    }
+
+    return finish_collection(ec);
+}
+
+static int handle_child_exit(struct endurance_collect *ec)
+{
+    discard_input(ec->childexitfd);
+
+    // Signals coalesce, so check whether the child really exited.
+    if (ec->child_pid == 0 || waitpid(ec->child_pid, NULL, WNOHANG) != ec->child_pid) {
+        return 0;
+    }
+
+    ec->child_pid = 0;
+
+    if (ec->snapshot_pending) {
+        // The previous session is packed, continue with the snapshot.
+        ec->snapshot_pending = 0;
+        begin_session(ec, 0);
+        return collect_natively(ec);
+    }
+
+    return finish_collection(ec);
+}
+
+int endurance_collect_init(struct endurance_collect *ec, iphb_t iphb,
+        const char *command)
+{
+    memset(ec, 0, sizeof *ec);
+    ec->iphb = iphb;
+    ec->command = command;
+    ec->endurance_dir = ENDURANCE_DIR;
+    ec->boot_mark_file = BOOT_MARK_FILE;
+    ec->pack_command = PACK_COMMAND;
+    ec->interval = SNAPSHOT_INTERVAL;
+    ec->min_interval = MIN_SNAPSHOT_INTERVAL;
+    ec->max_interval = MAX_SNAPSHOT_INTERVAL;
+    ec->keepalive_period = KEEPALIVE_TIMER;
+    ec->epollfd = ec->sigfd = ec->childexitfd = ec->keepalivefd = -1;
+
+    ec->iphbfd = iphb_get_fd(iphb);
+    if (ec->iphbfd == -1) {
+        syslog(LOG_CRIT, "Couldn't get iphb file descriptor.");
+        return -1;
+    }
+    fcntl(ec->iphbfd, F_SETFL, O_NONBLOCK);
+    fcntl(ec->iphbfd, F_SETFD, FD_CLOEXEC);
+
+    sigset_t sigset;
+    sigemptyset(&sigset);
+    sigaddset(&sigset, SIGTERM);
+    sigaddset(&sigset, SIGINT);
+    sigaddset(&sigset, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &sigset, &ec->old_sigmask);
+
+    sigdelset(&sigset, SIGCHLD);
+    ec->sigfd = signalfd(-1, &sigset, SFD_NONBLOCK | SFD_CLOEXEC);
+
+    sigemptyset(&sigset);
+    sigaddset(&sigset, SIGCHLD);
+    ec->childexitfd = signalfd(-1, &sigset, SFD_NONBLOCK | SFD_CLOEXEC);
+
+    ec->keepalivefd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    ec->epollfd = epoll_create1(EPOLL_CLOEXEC);
+
+    if (ec->sigfd < 0 || ec->childexitfd < 0 || ec->keepalivefd < 0 ||
+            ec->epollfd < 0) {
+        syslog(LOG_CRIT, "Couldn't create file descriptors, errno %d.", errno);
+        endurance_collect_cleanup(ec);
+        return -1;
+    }
+
+    if (watch(ec, ec->iphbfd) < 0 || watch(ec, ec->sigfd) < 0 ||
+            watch(ec, ec->childexitfd) < 0 || watch(ec, ec->keepalivefd) < 0) {
+        endurance_collect_cleanup(ec);
+        return -1;
+    }
+
+    syslog(LOG_DEBUG, "Opened file descriptors: %d %d %d %d %d",
+            ec->iphbfd, ec->sigfd, ec->childexitfd, ec->keepalivefd,
+            ec->epollfd);
+
+    return 0;
+}
+
+int endurance_collect_snapshot(struct endurance_collect *ec)
+{
+    if (ec->child_pid != 0) {
+        syslog(LOG_WARNING, "Previous snapshot collection is still running, "
+                "not starting a new one.");
+        return 0;
+    }
+
+    syslog(LOG_DEBUG, "Collecting endurance snapshot...");
+
+    mce_cpu_keepalive_start();
+    set_timer(ec->keepalivefd, ec->keepalive_period);
+
+    if (!ec->collector) {
+        if (spawn(ec, ec->command) < 0) {
+            return finish_collection(ec);
+        }
+        return 0;
+    }
+
+    if (begin_session(ec, 1)) {
+        if (spawn(ec, ec->pack_command) == 0) {
+            ec->snapshot_pending = 1;
+            return 0;
+        }
+        begin_session(ec, 0);
+    }
+
+    return collect_natively(ec);
+}
+
+int endurance_collect_set_interval_bounds(struct endurance_collect *ec,
+        time_t min_interval, time_t max_interval)
+{
+    // iphb takes the wakeup window in unsigned short.
+    if (min_interval <= WAKEUP_SLACK || min_interval > max_interval ||
+            max_interval > 0xffff - WAKEUP_SLACK) {
+        return -1;
+    }
+
+    ec->min_interval = min_interval;
+    ec->max_interval = max_interval;
+    if (ec->interval < min_interval) {
+        ec->interval = min_interval;
+    } else if (ec->interval > max_interval) {
+        ec->interval = max_interval;
+    }
+    return 0;
+}
+
+void endurance_collect_adapt_interval(struct endurance_collect *ec, int score)
+{
+    time_t interval = ec->interval;
+
+    if (score > FAST_CHANGE) {
+        interval /= 2;
+    } else if (score < SLOW_CHANGE) {
+        interval *= 2;
+    }
+
+    if (interval < ec->min_interval) {
+        interval = ec->min_interval;
+    } else if (interval > ec->max_interval) {
+        interval = ec->max_interval;
+    }
+
+    if (interval != ec->interval) {
+        syslog(LOG_DEBUG, "Change score %d, next snapshot in %ld seconds.",
+                score, (long)interval);
+        ec->interval = interval;
+    }
+}
+
+int endurance_collect_dispatch(struct endurance_collect *ec, int timeout_ms)
+{
+    struct epoll_event events[MAX_EVENTS];
+
+    int count = epoll_wait(ec->epollfd, events, MAX_EVENTS, timeout_ms);
+    if (count < 0) {
+        if (errno == EINTR) {
+            return 0;
+        }
+        syslog(LOG_CRIT, "Error on epoll_wait(), errno %d.", errno);
+        return -1;
+    }
+
+    int i;
+    for (i = 0; i < count; ++i) {
+        int fd = events[i].data.fd;
+
+        if (fd == ec->iphbfd) {
+            discard_input(ec->iphbfd);
+            if (endurance_collect_snapshot(ec) < 0) {
+                return -1;
+            }
+        } else if (fd == ec->childexitfd) {
+            if (handle_child_exit(ec) < 0) {
+                return -1;
+            }
+        } else if (fd == ec->sigfd) {
+            discard_input(ec->sigfd);
+            syslog(LOG_NOTICE, "Exiting.");
+            ec->quit = 1;
+        } else if (fd == ec->keepalivefd) {
+            discard_input(ec->keepalivefd);
+            mce_cpu_keepalive_start();
+        }
+    }
+
+    return count;
+}
+
+void endurance_collect_cleanup(struct endurance_collect *ec)
+{
+    int *fds[] = { &ec->epollfd, &ec->sigfd, &ec->childexitfd, &ec->keepalivefd };
+    size_t i;
+    for (i = 0; i < sizeof fds / sizeof fds[0]; ++i) {
+        if (*fds[i] >= 0) {
+            close(*fds[i]);
+            *fds[i] = -1;
+        }
+    }
+
+    sigprocmask(SIG_SETMASK, &ec->old_sigmask, NULL);
+}
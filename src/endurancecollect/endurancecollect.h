@@ -0,0 +1,115 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef ENDURANCECOLLECT_H
+#define ENDURANCECOLLECT_H
+
+#include <signal.h>
+#include <time.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <iphbd/libiphb.h>
+
+#include "snapshot.h"
+
+// Event loop of the endurance collection daemon. Every iphb wakeup
+// collects a snapshot under an MCE CPU keepalive, the next wakeup is
+// requested once the collection is done.
+//
+// With a snapshot collector, snapshots are collected in-process and a
+// child is spawned only to pack a session into a report. Otherwise the
+// collection command, which does both, runs for every snapshot.
+
+struct endurance_collect {
+    iphb_t iphb;
+    // Shell command collecting one snapshot, used without a collector.
+    const char *command;
+    // Collects snapshots in-process when set.
+    struct snapshot_collector *collector;
+    // Directory of the snapshots of the current session.
+    const char *endurance_dir;
+    // Marks that the session belongs to the current boot, so it has to be
+    // on a filesystem that doesn't survive reboot.
+    const char *boot_mark_file;
+    // Shell command packing the snapshots into an endurance report.
+    const char *pack_command;
+    // Seconds until the next snapshot. With a collector, it adapts to the
+    // change rate of the system between min_interval and max_interval.
+    time_t interval;
+    time_t min_interval;
+    time_t max_interval;
+    // Seconds between renewals of the CPU keepalive.
+    time_t keepalive_period;
+
+    int epollfd;
+    int iphbfd;
+    int sigfd;
+    int childexitfd;
+    int keepalivefd;
+    sigset_t old_sigmask;
+
+    pid_t child_pid;
+    // Set while packing the previous session, a snapshot follows.
+    int snapshot_pending;
+    // Summary of the last snapshot and CLOCK_BOOTTIME when it was taken,
+    // valid if last_snapshot_time is not 0.
+    struct snapshot_summary last_summary;
+    time_t last_snapshot_time;
+    // Set when a termination signal arrives.
+    int quit;
+};
+
+// Blocks the handled signals and sets up the descriptors. Returns 0 on
+// success, -1 on failure.
+int endurance_collect_init(struct endurance_collect *ec, iphb_t iphb,
+        const char *command);
+
+// Starts snapshot collection unless one is already running. Returns -1 on
+// a fatal error.
+int endurance_collect_snapshot(struct endurance_collect *ec);
+
+// Sets the bounds of the adaptive interval in seconds. Returns -1 if they
+// are out of range.
+int endurance_collect_set_interval_bounds(struct endurance_collect *ec,
+        time_t min_interval, time_t max_interval);
+
+// Shortens the interval when the system changes fast and lengthens it
+// when the system is idle. score is the change rate of the last snapshot
+// as computed by snapshot_change_score().
+void endurance_collect_adapt_interval(struct endurance_collect *ec, int score);
+
+// Waits at most timeout_ms milliseconds, -1 meaning forever, and handles
+// the events that arrived. Returns the number of events handled, or -1 on
+// a fatal error.
+int endurance_collect_dispatch(struct endurance_collect *ec, int timeout_ms);
+
+// Closes the descriptors and restores the signal mask. The iphb handle is
+// left to the caller.
+void endurance_collect_cleanup(struct endurance_collect *ec);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ENDURANCECOLLECT_H
@@ -25,11 +25,25 @@ TARGET = endurance-collect-daemon
 CONFIG -= qt
 CONFIG += link_pkgconfig
 
-SOURCES = main.c
+SOURCES = \
+    main.c \
+    endurancecollect.c \
+    mce.c \
+    snapshot.c \
+
+HEADERS = \
+    endurancecollect.h \
+    mce.h \
+    snapshot.h \
+
+INCLUDEPATH += \
+    ../libs/richcore \
+    ../libs/endurance \
 
 PKGCONFIG += \
     dbus-1 \
-    libiphb
+    libiphb \
+    lzo2
 
 LIBS += -lrt
 
@@ -19,125 +19,39 @@
  * 02110-1301 USA
  */
 
-#include <errno.h>
 #include <fcntl.h>
+#include <getopt.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <syslog.h>
 #include <unistd.h>
-#include <dbus/dbus.h>
 #include <iphbd/libiphb.h>
-#include <mce/dbus-names.h>
-#include <sys/signalfd.h>
-#include <sys/timerfd.h>
-#include <sys/wait.h>
 
-static const time_t SNAPSHOT_INTERVAL = IPHB_GS_WAIT_1_HOUR; // seconds
-static const time_t KEEPALIVE_TIMER = 30; // seconds
-static const time_t AFTER_BOOT_DELAY = 5 * 60; // seconds
-
-DBusConnection *system_bus;
-pid_t child_pid = 0;
-
-static void invoke_endurance_collect()
-{
-    if (child_pid != 0) {
-        syslog(LOG_WARNING, "Previous snapshot collection is still running, "
-                "not spawning a new one.");
-        return;
-    }
-
-    syslog(LOG_DEBUG, "Collecting endurance snapshot...");
-
-    child_pid = fork();
-    if (child_pid == -1) {
-        syslog(LOG_ERR, "Error on fork().");
-    } else if (child_pid == 0) {
-        char *args[] =
-                { "/bin/sh", "-c", "/usr/libexec/endurance-collect", NULL };
-
-        if (execvp(args[0], args)) {
-            syslog(LOG_CRIT, "Couldn't invoke %s", args[2]);
-            exit(EXIT_FAILURE);
-        }
-    }
-}
-
-static void set_timer(int fd, time_t seconds)
-{
-    struct itimerspec its;
-    its.it_value.tv_sec = seconds;
-    its.it_value.tv_nsec = 0;
-    its.it_interval.tv_sec = seconds;
-    its.it_interval.tv_nsec = 0;
-
-    timerfd_settime(fd, 0, &its, NULL);
-}
+#include "endurancecollect.h"
+#include "mce.h"
+#include "snapshot.h"
 
-static int mce_method(const char *method)
-{
-    if (!system_bus) {
-        return FALSE;
-    }
-
-    DBusMessage *req = dbus_message_new_method_call(MCE_SERVICE,
-            MCE_REQUEST_PATH, MCE_REQUEST_IF, method);
-    if(!req) {
-        return FALSE;
-    }
-
-    dbus_message_set_no_reply(req, TRUE);
-
-    int result = TRUE;
-    if (!dbus_connection_send(system_bus, req, 0)) {
-        syslog(LOG_ERR, "Failed to send %s.%s.", MCE_REQUEST_IF, method);
-        result = FALSE;
-    }
-
-    dbus_message_unref(req);
-
-    return result;
-}
+static const time_t AFTER_BOOT_DELAY = 5 * 60; // seconds
+// Written by crash-reporter from the reply to an upload.
+static const char ENDURANCE_FORMATS_FILE[] =
+    "/var/cache/core-dumps/endurance-formats";
 
-static int dbus_connect()
+static int server_reads_native_format(void)
 {
-    DBusError err = DBUS_ERROR_INIT;
-
-    system_bus = dbus_bus_get(DBUS_BUS_SYSTEM, &err);
-    if (!system_bus) {
-        syslog(LOG_CRIT, "Couldn't connect to DBus: %s: %s",
-                err.name, err.message);
+    FILE *file = fopen(ENDURANCE_FORMATS_FILE, "re");
+    if (!file) {
+        return 0;
     }
 
-    dbus_error_free(&err);
-    return system_bus != NULL;
-}
-
-static void dbus_disconnect()
-{
-    if (system_bus) {
-        dbus_connection_unref(system_bus);
-        system_bus = NULL;
+    char line[128];
+    int found = 0;
+    while (!found && fgets(line, sizeof line, file)) {
+        found = strcmp(line, SNAPSHOT_FORMAT) == 0;
     }
-}
-
-static void send_keepalive()
-{
-    syslog(LOG_NOTICE, "Sending MCE CPU keepalive.");
-    mce_method(MCE_CPU_KEEPALIVE_START_REQ);
-}
 
-static void discard_input(int fd)
-{
-    // Reading from SIGCHLD signal fd returns EINVAL with smaller buffer
-    char buf[sizeof (struct signalfd_siginfo)];
-    ssize_t bytes_read;
-    do {
-        bytes_read = read(fd, buf, sizeof buf);
-        if ((bytes_read == -1) && (errno != EAGAIN)) {
-            syslog(LOG_ERR, "Error reading from fd %d, errno %d.", fd, errno);
-        }
-    } while (bytes_read > 0);
+    fclose(file);
+    return found;
 }
 
 static void after_boot_delay(iphb_t iphb)
@@ -174,94 +88,98 @@ static void after_boot_delay(iphb_t iphb)
     }
 }
 
-int main()
+static void usage(const char *program)
+{
+    fprintf(stderr, "Usage: %s [--native] [--min-interval SECONDS] "
+            "[--max-interval SECONDS]\n", program);
+}
+
+int main(int argc, char **argv)
 {
     int result = EXIT_SUCCESS;
+    long min_interval = 0;
+    long max_interval = 0;
+    int native = 0;
+
+    static const struct option options[] = {
+        { "native", no_argument, NULL, 'n' },
+        { "min-interval", required_argument, NULL, 'm' },
+        { "max-interval", required_argument, NULL, 'M' },
+        { NULL, 0, NULL, 0 }
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "", options, NULL)) != -1) {
+        switch (opt) {
+        case 'n':
+            native = 1;
+            break;
+        case 'm':
+            min_interval = atol(optarg);
+            break;
+        case 'M':
+            max_interval = atol(optarg);
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
 
     openlog("endurance-collect-daemon", LOG_PID, LOG_USER);
     syslog(LOG_NOTICE, "Starting.");
 
-    if (!dbus_connect()) {
+    if (!mce_connect()) {
         return EXIT_FAILURE;
     }
 
     iphb_t iphb = iphb_open(NULL);
-    int iphbfd = iphb_get_fd(iphb);
-    if (iphbfd == -1) {
-        syslog(LOG_CRIT, "Couldn't get iphb file descriptor.");
+    struct endurance_collect ec;
+    if (endurance_collect_init(&ec, iphb, "/usr/libexec/endurance-collect") < 0) {
         return EXIT_FAILURE;
     }
-    fcntl(iphbfd, F_SETFL, O_NONBLOCK | O_CLOEXEC);
-
-    after_boot_delay(iphb);
-
-    sigset_t sigset;
-    sigemptyset(&sigset);
-    sigaddset(&sigset, SIGTERM);
-    sigaddset(&sigset, SIGINT);
-    sigprocmask(SIG_BLOCK, &sigset, NULL);
-    int sigfd = signalfd(-1, &sigset, SFD_NONBLOCK | SFD_CLOEXEC);
-
-    sigemptyset(&sigset);
-    sigaddset(&sigset, SIGCHLD);
-    sigprocmask(SIG_BLOCK, &sigset, NULL);
-    int childexitfd = signalfd(-1, &sigset, SFD_NONBLOCK);
-
-    int keepalivefd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
 
-    syslog(LOG_DEBUG, "Opened file descriptors: %d %d %d %d",
-            iphbfd, sigfd, childexitfd, keepalivefd);
+    if ((min_interval || max_interval) &&
+            endurance_collect_set_interval_bounds(&ec,
+                min_interval ? min_interval : ec.min_interval,
+                max_interval ? max_interval : ec.max_interval) < 0) {
+        fprintf(stderr, "Invalid snapshot interval bounds.\n");
+        return EXIT_FAILURE;
+    }
 
-    fd_set fdset;
-    FD_ZERO(&fdset);
-    FD_SET(iphbfd, &fdset);
+    // Without the collector, the script collects the snapshots itself with
+    // endurance-snapshot. The native collector writes a different set of
+    // files, so it's used only when the server has announced it reads them.
+    // The format is chosen at start only, a session never mixes formats.
+    struct snapshot_collector sc;
+    if (!native || !server_reads_native_format()) {
+        syslog(LOG_INFO, "Collecting snapshots with the collection script.");
+    } else if (snapshot_collector_init(&sc) == 0) {
+        ec.collector = &sc;
+    } else {
+        syslog(LOG_WARNING, "Falling back to snapshot collection script.");
+    }
 
-    while (1) {
-        if (FD_ISSET(iphbfd, &fdset)) {
-            send_keepalive();
-            invoke_endurance_collect();
-            set_timer(keepalivefd, KEEPALIVE_TIMER);
-            discard_input(iphbfd);
-        }
-        if (FD_ISSET(childexitfd, &fdset)) {
-            syslog(LOG_DEBUG, "Snapshot collection finished.");
-            wait(NULL);
-            child_pid = 0;
-            set_timer(keepalivefd, 0);
-            discard_input(childexitfd);
-            mce_method(MCE_CPU_KEEPALIVE_STOP_REQ);
-            if (iphb_wait(iphb, SNAPSHOT_INTERVAL - 10, SNAPSHOT_INTERVAL + 10, 0) < 0) {
-                syslog(LOG_CRIT, "Couldn't wait for heartbeat timer.");
-                break;
-            }
-        }
-        if (FD_ISSET(sigfd, &fdset)) {
-            syslog(LOG_NOTICE, "Exiting.");
-            break;
-        }
-        if (FD_ISSET(keepalivefd, &fdset)) {
-            send_keepalive();
-            discard_input(keepalivefd);
-        }
+    after_boot_delay(iphb);
 
-        FD_ZERO(&fdset);
-        FD_SET(iphbfd, &fdset);
-        FD_SET(sigfd, &fdset);
-        FD_SET(childexitfd, &fdset);
-        FD_SET(keepalivefd, &fdset);
+    // First snapshot right away, the following ones on iphb wakeups.
+    if (endurance_collect_snapshot(&ec) < 0) {
+        result = EXIT_FAILURE;
+        ec.quit = 1;
+    }
 
-        if (select(keepalivefd + 1, &fdset, NULL, NULL, NULL) == -1) {
-            syslog(LOG_CRIT, "Error on select().");
+    while (!ec.quit) {
+        if (endurance_collect_dispatch(&ec, -1) < 0) {
             result = EXIT_FAILURE;
             break;
         }
-
-        // If we ending up while true loop, sleep a bit to avoid busy loop
-        sleep(1);
     }
 
+    endurance_collect_cleanup(&ec);
+    if (ec.collector) {
+        snapshot_collector_cleanup(ec.collector);
+    }
     iphb_close(iphb);
-    dbus_disconnect();
+    mce_disconnect();
 
     return result;
 }
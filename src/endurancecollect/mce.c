@@ -0,0 +1,86 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "mce.h"
+
+#include <stddef.h>
+#include <syslog.h>
+#include <dbus/dbus.h>
+#include <mce/dbus-names.h>
+
+static DBusConnection *system_bus;
+
+static int mce_method(const char *method)
+{
+    if (!system_bus) {
+        return FALSE;
+    }
+
+    DBusMessage *req = dbus_message_new_method_call(MCE_SERVICE,
+            MCE_REQUEST_PATH, MCE_REQUEST_IF, method);
+    if(!req) {
+        return FALSE;
+    }
+
+    dbus_message_set_no_reply(req, TRUE);
+
+    int result = TRUE;
+    if (!dbus_connection_send(system_bus, req, 0)) {
+        syslog(LOG_ERR, "Failed to send %s.%s.", MCE_REQUEST_IF, method);
+        result = FALSE;
+    }
+
+    dbus_message_unref(req);
+
+    return result;
+}
+
+int mce_connect(void)
+{
+    DBusError err = DBUS_ERROR_INIT;
+
+    system_bus = dbus_bus_get(DBUS_BUS_SYSTEM, &err);
+    if (!system_bus) {
+        syslog(LOG_CRIT, "Couldn't connect to DBus: %s: %s",
+                err.name, err.message);
+    }
+
+    dbus_error_free(&err);
+    return system_bus != NULL;
+}
+
+void mce_disconnect(void)
+{
+    if (system_bus) {
+        dbus_connection_unref(system_bus);
+        system_bus = NULL;
+    }
+}
+
+int mce_cpu_keepalive_start(void)
+{
+    syslog(LOG_NOTICE, "Sending MCE CPU keepalive.");
+    return mce_method(MCE_CPU_KEEPALIVE_START_REQ);
+}
+
+int mce_cpu_keepalive_stop(void)
+{
+    return mce_method(MCE_CPU_KEEPALIVE_STOP_REQ);
+}
@@ -0,0 +1,41 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef ENDURANCECOLLECT_MCE_H
+#define ENDURANCECOLLECT_MCE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Requests to MCE over the system bus. Unit tests link a stand-in instead.
+
+int mce_connect(void);
+void mce_disconnect(void);
+
+// Keeps the CPU from suspending for the next 60 seconds.
+int mce_cpu_keepalive_start(void);
+int mce_cpu_keepalive_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ENDURANCECOLLECT_MCE_H
@@ -0,0 +1,765 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+// For nftw().
+#define _GNU_SOURCE
+
+#include "snapshot.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syslog.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <lzo/lzo1x.h>
+
+#include "creporterlzop_p.h"
+#include "creportersnapshotstore_p.h"
+
+static const struct {
+    const char *path;
+    const char *name;
+} SOURCES[] = {
+    { "/proc/meminfo", "meminfo" },
+    { "/proc/stat", "stat" },
+    { "/proc/vmstat", "vmstat" },
+    { "/proc/slabinfo", "slabinfo" },
+    { "/proc/loadavg", "loadavg" },
+    { "/proc/uptime", "uptime" },
+    { "/proc/interrupts", "interrupts" },
+    { "/proc/diskstats", "diskstats" },
+    { "/proc/buddyinfo", "buddyinfo" },
+    { "/proc/pagetypeinfo", "pagetypeinfo" },
+    { "/proc/sys/fs/file-nr", "file-nr" },
+};
+
+// Row of the per-process columns of the snapshot store.
+struct process_row {
+    unsigned long pid;
+    unsigned long vm_rss_kb;
+    unsigned long vm_size_kb;
+    unsigned threads;
+    unsigned fds;
+    unsigned char state;
+};
+
+// Same block size and header fields as CReporterLzoWriter.
+static const size_t LZOP_BLOCK_SIZE = 256 * 1024;
+static const unsigned char LZOP_FILE_MAGIC[9] =
+        { 0x89, 'L', 'Z', 'O', 0x00, '\r', '\n', 0x1a, '\n' };
+static const unsigned LZOP_VERSION = 0x1030;
+static const unsigned LZOP_LEVEL = 3;
+static const unsigned LZOP_FILE_MODE = 0100644;
+
+// Snapshots taken in quick succession, e.g. after packing, would make
+// tiny changes look fast.
+static const time_t MIN_SCORE_ELAPSED = 60; // seconds
+static const int MAX_SCORE = 1000000;
+
+static int reserve(struct snapshot_buffer *buf, size_t size)
+{
+    if (buf->capacity >= size) {
+        return 0;
+    }
+
+    size_t capacity = buf->capacity ? buf->capacity : 4096;
+    while (capacity < size) {
+        capacity *= 2;
+    }
+
+    char *data = realloc(buf->data, capacity);
+    if (!data) {
+        syslog(LOG_ERR, "Out of memory.");
+        return -1;
+    }
+    buf->data = data;
+    buf->capacity = capacity;
+    return 0;
+}
+
+static int append(struct snapshot_buffer *buf, const void *data, size_t size)
+{
+    if (reserve(buf, buf->length + size) < 0) {
+        return -1;
+    }
+    memcpy(buf->data + buf->length, data, size);
+    buf->length += size;
+    return 0;
+}
+
+static int append_u8(struct snapshot_buffer *buf, unsigned value)
+{
+    unsigned char byte = value;
+    return append(buf, &byte, 1);
+}
+
+static int append_u16(struct snapshot_buffer *buf, unsigned value)
+{
+    unsigned char bytes[2] = { value >> 8, value };
+    return append(buf, bytes, sizeof bytes);
+}
+
+static int append_u32(struct snapshot_buffer *buf, unsigned long value)
+{
+    unsigned char bytes[4] = { value >> 24, value >> 16, value >> 8, value };
+    return append(buf, bytes, sizeof bytes);
+}
+
+// Snapshot store is little endian unlike lzop.
+static void put_le32(char *p, unsigned long value)
+{
+    p[0] = value;
+    p[1] = value >> 8;
+    p[2] = value >> 16;
+    p[3] = value >> 24;
+}
+
+static int append_le16(struct snapshot_buffer *buf, unsigned value)
+{
+    unsigned char bytes[2] = { value, value >> 8 };
+    return append(buf, bytes, sizeof bytes);
+}
+
+static int append_le32(struct snapshot_buffer *buf, unsigned long value)
+{
+    char bytes[4];
+    put_le32(bytes, value);
+    return append(buf, bytes, sizeof bytes);
+}
+
+static int append_padding(struct snapshot_buffer *buf)
+{
+    static const char zeros[4] = { 0, 0, 0, 0 };
+    return append(buf, zeros, (4 - buf->length % 4) % 4);
+}
+
+static void free_buffer(struct snapshot_buffer *buf)
+{
+    free(buf->data);
+    memset(buf, 0, sizeof *buf);
+}
+
+// Reads the whole file from the beginning, which makes /proc and /sys
+// files generate their content anew.
+static int read_fd(int fd, struct snapshot_buffer *buf)
+{
+    buf->length = 0;
+    while (1) {
+        if (reserve(buf, buf->length + 4096) < 0) {
+            return -1;
+        }
+        ssize_t bytes_read = pread(fd, buf->data + buf->length,
+                buf->capacity - buf->length, buf->length);
+        if (bytes_read < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (bytes_read == 0) {
+            return 0;
+        }
+        buf->length += bytes_read;
+    }
+}
+
+// Compresses data into a complete lzop stream in sc->output.
+static int lzop_compress(struct snapshot_collector *sc, const char *name,
+        const char *data, size_t size)
+{
+    struct snapshot_buffer *out = &sc->output;
+    struct snapshot_buffer header = { 0, 0, 0 };
+    size_t name_length = strlen(name);
+    time_t now = time(NULL);
+    int ok;
+
+    out->length = 0;
+    ok = append(out, LZOP_FILE_MAGIC, sizeof LZOP_FILE_MAGIC) == 0 &&
+         append_u16(&header, LZOP_VERSION) == 0 &&
+         append_u16(&header, lzo_version() & 0xffff) == 0 &&
+         append_u16(&header, LZOP_VERSION_0940) == 0 &&
+         append_u8(&header, LZOP_M_LZO1X_1) == 0 &&
+         append_u8(&header, LZOP_LEVEL) == 0 &&
+         append_u32(&header, LZOP_F_ADLER32_D | LZOP_F_ADLER32_C | LZOP_F_OS_UNIX) == 0 &&
+         append_u32(&header, LZOP_FILE_MODE) == 0 &&
+         append_u32(&header, now & 0xffffffff) == 0 &&
+         append_u32(&header, (unsigned long long)now >> 32) == 0 &&
+         append_u8(&header, name_length) == 0 &&
+         append(&header, name, name_length) == 0 &&
+         append_u32(&header, lzo_adler32(1, (const lzo_bytep)header.data,
+                                         header.length)) == 0 &&
+         append(out, header.data, header.length) == 0;
+    free_buffer(&header);
+
+    size_t pos;
+    for (pos = 0; ok && pos < size; pos += LZOP_BLOCK_SIZE) {
+        size_t block = size - pos < LZOP_BLOCK_SIZE ? size - pos : LZOP_BLOCK_SIZE;
+        const lzo_bytep src = (const lzo_bytep)data + pos;
+        // Header and the worst case expansion of LZO1X.
+        size_t block_header = out->length;
+        if (reserve(out, out->length + 16 + block + block / 16 + 64 + 3) < 0) {
+            return -1;
+        }
+
+        lzo_uint compressed = block;
+        lzo_bytep dst = (lzo_bytep)out->data + block_header + 16;
+        if (lzo1x_1_compress(src, block, dst, &compressed, sc->work_memory) != LZO_E_OK) {
+            syslog(LOG_ERR, "LZO compression failed.");
+            return -1;
+        }
+
+        out->length = block_header;
+        append_u32(out, block);
+        if (compressed < block) {
+            append_u32(out, compressed);
+            append_u32(out, lzo_adler32(1, src, block));
+            append_u32(out, lzo_adler32(1, dst, compressed));
+            out->length += compressed;
+        } else {
+            // Incompressible data are stored as they are.
+            append_u32(out, block);
+            append_u32(out, lzo_adler32(1, src, block));
+            ok = append(out, src, block) == 0;
+        }
+    }
+
+    // Block with zero length terminates the stream.
+    return ok && append_u32(out, 0) == 0 ? 0 : -1;
+}
+
+static int write_file(struct snapshot_collector *sc, int dirfd, const char *name,
+        const char *data, size_t size)
+{
+    char file_name[NAME_MAX];
+    snprintf(file_name, sizeof file_name, "%s.lzo", name);
+
+    if (lzop_compress(sc, name, data, size) < 0) {
+        return -1;
+    }
+
+    int fd = openat(dirfd, file_name, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        syslog(LOG_ERR, "Couldn't create %s, errno %d.", file_name, errno);
+        return -1;
+    }
+
+    const char *pos = sc->output.data;
+    size_t remaining = sc->output.length;
+    while (remaining > 0) {
+        ssize_t written = write(fd, pos, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            syslog(LOG_ERR, "Couldn't write %s, errno %d.", file_name, errno);
+            close(fd);
+            return -1;
+        }
+        pos += written;
+        remaining -= written;
+    }
+
+    return close(fd);
+}
+
+// Value of a "Key:\tvalue" line of /proc/<pid>/status.
+static const char *status_field(const struct snapshot_buffer *status,
+        const char *key, size_t *length)
+{
+    size_t key_length = strlen(key);
+    const char *line = status->data;
+    const char *end = status->data + status->length;
+
+    while (line < end) {
+        const char *eol = memchr(line, '\n', end - line);
+        if (!eol) {
+            eol = end;
+        }
+        if ((size_t)(eol - line) > key_length && memcmp(line, key, key_length) == 0 &&
+                line[key_length] == ':') {
+            const char *value = line + key_length + 1;
+            while (value < eol && isspace((unsigned char)*value)) {
+                ++value;
+            }
+            *length = eol - value;
+            return value;
+        }
+        line = eol + 1;
+    }
+
+    *length = 0;
+    return "";
+}
+
+// Also reads "Key:  value kB" lines of /proc/meminfo.
+static long status_number(const struct snapshot_buffer *status, const char *key)
+{
+    size_t length;
+    const char *value = status_field(status, key, &length);
+    return length > 0 ? strtol(value, NULL, 10) : 0;
+}
+
+static int count_fds(int procfd, const char *pid)
+{
+    char path[NAME_MAX + 16];
+    snprintf(path, sizeof path, "%s/fd", pid);
+
+    int fd = openat(procfd, path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    DIR *dir = fdopendir(fd);
+    if (!dir) {
+        close(fd);
+        return -1;
+    }
+
+    int count = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir))) {
+        if (entry->d_name[0] != '.') {
+            ++count;
+        }
+    }
+    closedir(dir);
+    return count;
+}
+
+static int is_number(const char *name)
+{
+    if (!*name) {
+        return 0;
+    }
+    for (; *name; ++name) {
+        if (!isdigit((unsigned char)*name)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// The most telling per-process figures of each process, instead of the
+// large smaps of all of them. Rows go to sc->rows, names to sc->text.
+static int collect_processes(struct snapshot_collector *sc)
+{
+    int procfd = dirfd(sc->procdir);
+    struct dirent *entry;
+
+    sc->rows.length = 0;
+    sc->text.length = 0;
+    sc->summary.rss_kb = 0;
+    sc->summary.fds = 0;
+
+    rewinddir(sc->procdir);
+    while ((entry = readdir(sc->procdir))) {
+        if (!is_number(entry->d_name)) {
+            continue;
+        }
+
+        char path[NAME_MAX + 16];
+        snprintf(path, sizeof path, "%s/status", entry->d_name);
+        int fd = openat(procfd, path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            // Process exited meanwhile.
+            continue;
+        }
+        int result = read_fd(fd, &sc->input);
+        close(fd);
+        if (result < 0) {
+            continue;
+        }
+
+        size_t name_length;
+        const char *name = status_field(&sc->input, "Name", &name_length);
+        size_t state_length;
+        const char *state = status_field(&sc->input, "State", &state_length);
+        long threads = status_number(&sc->input, "Threads");
+        int fds = count_fds(procfd, entry->d_name);
+
+        struct process_row row;
+        row.pid = strtoul(entry->d_name, NULL, 10);
+        row.vm_rss_kb = status_number(&sc->input, "VmRSS");
+        row.vm_size_kb = status_number(&sc->input, "VmSize");
+        row.threads = threads < 0xffff ? threads : 0xffff;
+        row.fds = fds < 0 ? SNAPSHOT_STORE_FDS_UNKNOWN :
+                  fds < SNAPSHOT_STORE_FDS_UNKNOWN ? fds : SNAPSHOT_STORE_FDS_UNKNOWN - 1;
+        row.state = state_length ? *state : '?';
+
+        sc->summary.rss_kb += row.vm_rss_kb;
+        if (fds > 0) {
+            sc->summary.fds += fds;
+        }
+
+        // Names end with '\0', the CSV export quotes them.
+        size_t i;
+        int ok = append(&sc->rows, &row, sizeof row) == 0;
+        for (i = 0; ok && i < name_length; ++i) {
+            char c = name[i] == '"' ? '\'' : name[i];
+            ok = append(&sc->text, &c, 1) == 0;
+        }
+        if (!ok || append_u8(&sc->text, 0) < 0) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+// Encodes the collected processes into sc->output as one segment.
+static int encode_segment(struct snapshot_collector *sc, int number)
+{
+    struct snapshot_buffer *out = &sc->output;
+    const struct process_row *rows = (const struct process_row *)sc->rows.data;
+    size_t count = sc->rows.length / sizeof *rows;
+    size_t i;
+
+    out->length = 0;
+    int ok = append_le32(out, SNAPSHOT_STORE_MAGIC) == 0 &&
+             append_le32(out, 0) == 0 &&
+             append_le32(out, number) == 0 &&
+             append_le32(out, sc->uptime) == 0 &&
+             append_le32(out, time(NULL)) == 0 &&
+             append_le32(out, count) == 0 &&
+             append_le32(out, sc->text.length) == 0;
+
+    // Column by column, values of one metric are next to each other.
+    for (i = 0; ok && i < count; ++i) {
+        ok = append_le32(out, rows[i].pid) == 0;
+    }
+    for (i = 0; ok && i < count; ++i) {
+        ok = append_le32(out, rows[i].vm_rss_kb) == 0;
+    }
+    for (i = 0; ok && i < count; ++i) {
+        ok = append_le32(out, rows[i].vm_size_kb) == 0;
+    }
+    for (i = 0; ok && i < count; ++i) {
+        ok = append_le16(out, rows[i].threads) == 0;
+    }
+    for (i = 0; ok && i < count; ++i) {
+        ok = append_le16(out, rows[i].fds) == 0;
+    }
+    for (i = 0; ok && i < count; ++i) {
+        ok = append_u8(out, rows[i].state) == 0;
+    }
+
+    ok = ok && append_padding(out) == 0 &&
+         append(out, sc->text.data, sc->text.length) == 0 &&
+         append_padding(out) == 0;
+    if (!ok) {
+        return -1;
+    }
+
+    put_le32(out->data + SNAPSHOT_STORE_SIZE, out->length + 4);
+    return append_le32(out, lzo_adler32(1, (const lzo_bytep)out->data, out->length));
+}
+
+static unsigned long get_le32(const unsigned char *p)
+{
+    return p[0] | (p[1] << 8) | ((unsigned long)p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+// Appends sc->output to the store. Whatever follows the last complete
+// segment, left by an interrupted append, is cut off first.
+static int append_segment(struct snapshot_collector *sc, const char *dir)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof path, "%s/%s", dir, SNAPSHOT_STORE_FILE_NAME);
+
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        syslog(LOG_ERR, "Couldn't open %s, errno %d.", path, errno);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    off_t end = 0;
+    unsigned char header[8];
+    while (end + (off_t)sizeof header <= st.st_size &&
+            pread(fd, header, sizeof header, end) == sizeof header) {
+        unsigned long size = get_le32(header + SNAPSHOT_STORE_SIZE);
+        if (get_le32(header) != SNAPSHOT_STORE_MAGIC ||
+                size < SNAPSHOT_STORE_HEADER_SIZE || (off_t)size > st.st_size - end) {
+            break;
+        }
+        end += size;
+    }
+    if (end < st.st_size && ftruncate(fd, end) < 0) {
+        syslog(LOG_ERR, "Couldn't truncate %s, errno %d.", path, errno);
+        close(fd);
+        return -1;
+    }
+
+    const char *pos = sc->output.data;
+    size_t remaining = sc->output.length;
+    while (remaining > 0) {
+        ssize_t written = pwrite(fd, pos, remaining, end);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            syslog(LOG_ERR, "Couldn't write %s, errno %d.", path, errno);
+            close(fd);
+            return -1;
+        }
+        pos += written;
+        remaining -= written;
+        end += written;
+    }
+
+    return close(fd);
+}
+
+static int next_snapshot_number(const char *dir)
+{
+    DIR *d = opendir(dir);
+    if (!d) {
+        return -1;
+    }
+
+    int last = -1;
+    struct dirent *entry;
+    while ((entry = readdir(d))) {
+        if (strlen(entry->d_name) == 3 && is_number(entry->d_name)) {
+            int number = atoi(entry->d_name);
+            if (number > last) {
+                last = number;
+            }
+        }
+    }
+    closedir(d);
+
+    return last + 1;
+}
+
+int snapshot_collector_init(struct snapshot_collector *sc)
+{
+    memset(sc, 0, sizeof *sc);
+
+    if (lzo_init() != LZO_E_OK) {
+        syslog(LOG_CRIT, "Failed to initialize LZO library.");
+        return -1;
+    }
+
+    sc->procdir = opendir("/proc");
+    sc->work_memory = malloc(LZO1X_1_MEM_COMPRESS);
+    if (!sc->procdir || !sc->work_memory) {
+        syslog(LOG_CRIT, "Couldn't initialize snapshot collector, errno %d.", errno);
+        snapshot_collector_cleanup(sc);
+        return -1;
+    }
+
+    size_t i;
+    for (i = 0; i < sizeof SOURCES / sizeof SOURCES[0]; ++i) {
+        int fd = open(SOURCES[i].path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            syslog(LOG_DEBUG, "Not collecting %s, errno %d.", SOURCES[i].path, errno);
+            continue;
+        }
+        sc->sources[sc->source_count].name = SOURCES[i].name;
+        sc->sources[sc->source_count].fd = fd;
+        ++sc->source_count;
+    }
+
+    return 0;
+}
+
+int snapshot_collector_collect(struct snapshot_collector *sc, const char *dir)
+{
+    int number = next_snapshot_number(dir);
+    if (number < 0 || number > 999) {
+        syslog(LOG_ERR, "Couldn't number snapshot in %s.", dir);
+        return -1;
+    }
+
+    char name[8];
+    char path[PATH_MAX];
+    char temp_path[PATH_MAX + 8];
+    snprintf(name, sizeof name, "%03d", number);
+    snprintf(path, sizeof path, "%s/%s", dir, name);
+    snprintf(temp_path, sizeof temp_path, "%s.tmp", path);
+
+    // Leftover of an interrupted collection.
+    remove_tree(temp_path);
+
+    if (mkdir(temp_path, 0755) < 0) {
+        syslog(LOG_ERR, "Couldn't create %s, errno %d.", temp_path, errno);
+        return -1;
+    }
+    int dirfd = open(temp_path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirfd < 0) {
+        remove_tree(temp_path);
+        return -1;
+    }
+
+    int ok = 1;
+    int i;
+    for (i = 0; ok && i < sc->source_count; ++i) {
+        if (read_fd(sc->sources[i].fd, &sc->input) < 0) {
+            syslog(LOG_WARNING, "Couldn't read %s, errno %d.",
+                    sc->sources[i].name, errno);
+            continue;
+        }
+        if (strcmp(sc->sources[i].name, "meminfo") == 0) {
+            sc->summary.slab_kb = status_number(&sc->input, "Slab");
+        } else if (strcmp(sc->sources[i].name, "uptime") == 0 &&
+                reserve(&sc->input, sc->input.length + 1) == 0) {
+            sc->input.data[sc->input.length] = '\0';
+            sc->uptime = strtoul(sc->input.data, NULL, 10);
+        }
+        ok = write_file(sc, dirfd, sc->sources[i].name,
+                sc->input.data, sc->input.length) == 0;
+    }
+
+    ok = ok && write_file(sc, dirfd, SNAPSHOT_FORMAT_FILE, SNAPSHOT_FORMAT,
+            strlen(SNAPSHOT_FORMAT)) == 0;
+
+    close(dirfd);
+
+    if (!ok || rename(temp_path, path) < 0) {
+        syslog(LOG_ERR, "Couldn't write snapshot %s.", path);
+        remove_tree(temp_path);
+        return -1;
+    }
+
+    // Snapshot stays usable without per-process data.
+    if (collect_processes(sc) < 0 || encode_segment(sc, number) < 0 ||
+            append_segment(sc, dir) < 0) {
+        syslog(LOG_WARNING, "Couldn't store processes of snapshot %s.", path);
+    }
+
+    return number;
+}
+
+time_t snapshot_collector_boot_time(struct snapshot_collector *sc)
+{
+    int i;
+    for (i = 0; i < sc->source_count; ++i) {
+        if (strcmp(sc->sources[i].name, "stat") != 0) {
+            continue;
+        }
+        if (read_fd(sc->sources[i].fd, &sc->input) < 0 ||
+                reserve(&sc->input, sc->input.length + 1) < 0) {
+            return 0;
+        }
+        sc->input.data[sc->input.length] = '\0';
+        const char *btime = strstr(sc->input.data, "\nbtime ");
+        return btime ? strtol(btime + 7, NULL, 10) : 0;
+    }
+    return 0;
+}
+
+void snapshot_collector_cleanup(struct snapshot_collector *sc)
+{
+    int i;
+    for (i = 0; i < sc->source_count; ++i) {
+        close(sc->sources[i].fd);
+    }
+    sc->source_count = 0;
+
+    if (sc->procdir) {
+        closedir(sc->procdir);
+        sc->procdir = NULL;
+    }
+
+    free_buffer(&sc->input);
+    free_buffer(&sc->rows);
+    free_buffer(&sc->text);
+    free_buffer(&sc->output);
+    free(sc->work_memory);
+    sc->work_memory = NULL;
+}
+
+static int growth(long previous, long current, time_t elapsed)
+{
+    if (previous <= 0 || current <= previous) {
+        return 0;
+    }
+
+    // Permille per hour.
+    double rate = (current - previous) * 3600000.0 / ((double)previous * elapsed);
+    return rate < MAX_SCORE ? (int)rate : MAX_SCORE;
+}
+
+int snapshot_change_score(const struct snapshot_summary *previous,
+        const struct snapshot_summary *current, time_t elapsed)
+{
+    if (elapsed < MIN_SCORE_ELAPSED) {
+        elapsed = MIN_SCORE_ELAPSED;
+    }
+
+    int score = growth(previous->rss_kb, current->rss_kb, elapsed);
+    int fds = growth(previous->fds, current->fds, elapsed);
+    int slab = growth(previous->slab_kb, current->slab_kb, elapsed);
+    if (fds > score) {
+        score = fds;
+    }
+    if (slab > score) {
+        score = slab;
+    }
+    return score;
+}
+
+int snapshot_count(const char *dir)
+{
+    DIR *d = opendir(dir);
+    if (!d) {
+        return 0;
+    }
+
+    int count = 0;
+    struct dirent *entry;
+    while ((entry = readdir(d))) {
+        struct stat st;
+        if (strlen(entry->d_name) == 3 && is_number(entry->d_name) &&
+                fstatat(dirfd(d), entry->d_name, &st, AT_SYMLINK_NOFOLLOW) == 0 &&
+                S_ISDIR(st.st_mode)) {
+            ++count;
+        }
+    }
+    closedir(d);
+
+    return count;
+}
+
+static int remove_entry(const char *path, const struct stat *st, int flag,
+        struct FTW *ftw)
+{
+    (void)st;
+    (void)ftw;
+    return (flag == FTW_DP ? rmdir(path) : unlink(path)) < 0 && errno != ENOENT ? -1 : 0;
+}
+
+int remove_tree(const char *path)
+{
+    if (access(path, F_OK) < 0) {
+        return 0;
+    }
+    return nftw(path, remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+}
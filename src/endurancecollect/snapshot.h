@@ -0,0 +1,117 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef ENDURANCECOLLECT_SNAPSHOT_H
+#define ENDURANCECOLLECT_SNAPSHOT_H
+
+#include <dirent.h>
+#include <stddef.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Native collector of endurance snapshots. The system files are opened
+// once and re-read with pread() for every snapshot. Every file of a
+// snapshot is written as an lzop stream with .lzo suffix, which the
+// endurance packer decompresses. Per-process figures are appended to the
+// columnar snapshot store shared by all snapshots of the directory, see
+// creportersnapshotstore_p.h.
+
+#define SNAPSHOT_MAX_SOURCES 16
+
+// The snapshots differ from those of endurance-snapshot, so every one of
+// them names its format in this file, see
+// CReporterEndurancePacker::FormatFile. The version is raised whenever the
+// set of files or their content changes.
+#define SNAPSHOT_FORMAT_FILE "snapshot-format"
+#define SNAPSHOT_FORMAT "crash-reporter-native 1\n"
+
+struct snapshot_source {
+    // Name of the file in the snapshot, without the .lzo suffix.
+    const char *name;
+    int fd;
+};
+
+struct snapshot_buffer {
+    char *data;
+    size_t length;
+    size_t capacity;
+};
+
+// Figures of a snapshot that tell how fast the system changes.
+struct snapshot_summary {
+    // Sum of VmRSS of all processes.
+    long rss_kb;
+    // Open file descriptors of all processes.
+    long fds;
+    // Slab of /proc/meminfo.
+    long slab_kb;
+};
+
+struct snapshot_collector {
+    struct snapshot_source sources[SNAPSHOT_MAX_SOURCES];
+    int source_count;
+    DIR *procdir;
+
+    // Buffers are reused between files and snapshots.
+    struct snapshot_buffer input;
+    struct snapshot_buffer rows;
+    struct snapshot_buffer text;
+    struct snapshot_buffer output;
+    void *work_memory;
+
+    // Summary and uptime in seconds of the last collected snapshot.
+    struct snapshot_summary summary;
+    unsigned long uptime;
+};
+
+// Opens the system files, those that don't exist on the device are
+// skipped. Returns 0 on success, -1 on failure.
+int snapshot_collector_init(struct snapshot_collector *sc);
+
+// Writes a new snapshot directory into dir, named with the next free
+// three-digit number. The directory appears complete or not at all.
+// Returns the number of the snapshot, or -1 on failure.
+int snapshot_collector_collect(struct snapshot_collector *sc, const char *dir);
+
+// Boot time of the system as in btime of /proc/stat, 0 if not known.
+time_t snapshot_collector_boot_time(struct snapshot_collector *sc);
+
+void snapshot_collector_cleanup(struct snapshot_collector *sc);
+
+// Change rate between two snapshots taken elapsed seconds apart, as the
+// fastest relative growth of the summary figures in permille per hour.
+// Shrinking figures don't count, as leaks only grow.
+int snapshot_change_score(const struct snapshot_summary *previous,
+        const struct snapshot_summary *current, time_t elapsed);
+
+// Number of snapshot directories in dir.
+int snapshot_count(const char *dir);
+
+// Removes path with everything in it, like rm -rf. Returns 0 on success.
+int remove_tree(const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ENDURANCECOLLECT_SNAPSHOT_H
@@ -0,0 +1,38 @@
+# This file is a part of crash-reporter.
+#
+# Copyright (C) 2026 Jolla Ltd.
+#
+# This program is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public License
+# version 2.1 as published by the Free Software Foundation.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+# 02110-1301 USA
+
+include(../../crash-reporter-conf.pri)
+
+TEMPLATE = app
+TARGET = crash-reporter-endurance-decoder
+
+QT -= gui
+
+INCLUDEPATH += \
+	../libs \
+	../libs/endurance \
+
+SOURCES = \
+	main.cpp \
+
+LIBS += \
+	../../lib/libcrashreporter.so \
+
+target.path = $$CREPORTER_SYSTEM_BIN
+
+INSTALLS = target
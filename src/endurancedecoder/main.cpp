@@ -0,0 +1,65 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QTextStream>
+
+#include "creportersnapshotdelta.h"
+
+/*!
+ * @brief Turns endurance reports with delta encoded snapshots into reports
+ * with plain snapshot packs, as expected by the analysis tools.
+ */
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Decodes delta encoded endurance snapshots of endurance reports.");
+    parser.addHelpOption();
+    QCommandLineOption outputOption(QStringList() << "o" << "output",
+        "Report to create, only with a single input.", "file");
+    parser.addOption(outputOption);
+    parser.addPositionalArgument("reports", "Endurance reports to decode. "
+                                 "Unless --output is given, each is replaced "
+                                 "with the decoded version.", "reports...");
+    parser.process(app);
+
+    QStringList reports = parser.positionalArguments();
+    if (reports.isEmpty() || (parser.isSet(outputOption) && reports.size() > 1)) {
+        parser.showHelp(EXIT_FAILURE);
+    }
+
+    int result = EXIT_SUCCESS;
+    foreach (const QString &report, reports) {
+        QString target = parser.isSet(outputOption) ? parser.value(outputOption)
+                                                    : report;
+        QString error;
+        if (!CReporterSnapshotDelta::decodeReport(report, target, &error)) {
+            QTextStream(stderr) << "Couldn't decode " << report << ": "
+                                << error << endl;
+            result = EXIT_FAILURE;
+        }
+    }
+
+    return result;
+}
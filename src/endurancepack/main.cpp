@@ -0,0 +1,138 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QTextStream>
+
+#include <unistd.h>
+
+#include "creportercoreregistry.h"
+#include "creporterenduranceanalyzer.h"
+#include "creporterendurancepacker.h"
+#include "creportersnapshotstore.h"
+
+namespace {
+
+bool sampled(double rate)
+{
+    qsrand(QDateTime::currentMSecsSinceEpoch() ^ getpid());
+    return rate >= 1 || (rate > 0 && qrand() < rate * RAND_MAX);
+}
+
+}
+
+/*!
+ * @brief Packs endurance snapshots into an endurance report.
+ *
+ * Used by the endurance-collect script instead of decompressing the
+ * snapshots in place and piping them through tar, xz and lzop. The session
+ * is analyzed first, snapshots are packed only if it is anomalous or
+ * sampled, otherwise the report carries just the summary.
+ */
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Packs endurance snapshot directories into an endurance rich core.");
+    parser.addHelpOption();
+    QCommandLineOption uidOption("device-uid", "Device UID to include.", "uid");
+    parser.addOption(uidOption);
+    QCommandLineOption bootTimeOption("boot-time",
+        "Boot time of the session the snapshots are from.", "btime");
+    parser.addOption(bootTimeOption);
+    QCommandLineOption presetOption("preset", "xz compression preset, 0-9.",
+        "preset", QString::number(CReporterEndurancePacker::DefaultPreset));
+    parser.addOption(presetOption);
+    QCommandLineOption threadsOption("threads",
+        "Maximum number of compressing threads.", "threads", "1");
+    parser.addOption(threadsOption);
+    QCommandLineOption deltaOption("delta",
+        "Store snapshot files as deltas against the previous snapshot.");
+    parser.addOption(deltaOption);
+    QCommandLineOption samplingOption("sampling-rate",
+        "Fraction of sessions without anomalies to pack in full, 0-1.",
+        "rate", "1");
+    parser.addOption(samplingOption);
+    QCommandLineOption storeOption("store",
+        "Snapshot store with per-process data of the snapshots.", "file");
+    parser.addOption(storeOption);
+    parser.addPositionalArgument("output", "Report to create, e.g. "
+                                 "Endurance-<hwid>-<time>-<btime>.rcore.lzo. "
+                                 "A bare file name is placed in the core "
+                                 "location with most free space.");
+    parser.addPositionalArgument("snapshots", "Snapshot directories.",
+                                 "snapshots...");
+    parser.process(app);
+
+    QStringList args = parser.positionalArguments();
+    if (args.size() < 2) {
+        parser.showHelp(EXIT_FAILURE);
+    }
+
+    QString output = args.takeFirst();
+    if (!output.contains('/')) {
+        // Endurance reports are large and not urgent, they go where there
+        // is most room.
+        QString location = CReporterCoreRegistry::instance()->preferredCoreLocation(
+                               CReporterCoreRegistry::PreferEmptiest);
+        if (!location.isEmpty()) {
+            output = location + '/' + output;
+        }
+    }
+
+    CReporterEndurancePacker packer;
+    packer.setDeviceUid(parser.value(uidOption).toUtf8());
+    packer.setBootTime(parser.value(bootTimeOption).toUtf8());
+    packer.setPreset(parser.value(presetOption).toInt());
+    packer.setCompressionThreads(parser.value(threadsOption).toInt());
+    packer.setDeltaEncoding(parser.isSet(deltaOption));
+
+    CReporterEnduranceAnalyzer analyzer;
+    if (parser.isSet(storeOption)) {
+        CReporterSnapshotStore store;
+        if (store.open(parser.value(storeOption))) {
+            analyzer.addSnapshotStore(store);
+        }
+        packer.setSnapshotStore(parser.value(storeOption));
+    } else {
+        foreach (const QString &dir, args) {
+            analyzer.addSnapshot(dir);
+        }
+    }
+
+    // Sessions without per-process data can't be judged, they go in full.
+    bool full = analyzer.snapshotCount() == 0 || analyzer.isAnomalous() ||
+                sampled(parser.value(samplingOption).toDouble());
+    if (analyzer.snapshotCount() > 0) {
+        packer.setSummary(analyzer.summary());
+    }
+
+    if (!packer.pack(full ? args : QStringList(), output)) {
+        QTextStream(stderr) << "Couldn't create " << output << ": "
+                            << packer.errorString() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,410 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <string.h>
+
+#include <QQueue>
+#include <QVarLengthArray>
+#include <QVector>
+
+#include "journalmatcher.h"
+
+namespace {
+
+//! Escaped letters that stand for a single character class or assertion.
+const QString SimpleEscapes("dDsSwWbBAzZGhHvVRXntrfea");
+
+/*!
+ * Skips character class starting at @a pos.
+ *
+ * @return Position of the closing bracket, -1 if there is none.
+ */
+int skipClass(const QString &pattern, int pos)
+{
+    int i = pos + 1;
+    if (i < pattern.length() && pattern.at(i) == '^') {
+        ++i;
+    }
+    if (i < pattern.length() && pattern.at(i) == ']') {
+        ++i;
+    }
+    while (i < pattern.length() && pattern.at(i) != ']') {
+        if (pattern.at(i) == '\\') {
+            ++i;
+        } else if (pattern.midRef(i, 2) == "[:") {
+            // POSIX class like [:alpha:].
+            i = pattern.indexOf(":]", i + 2);
+            if (i < 0) {
+                return -1;
+            }
+            ++i;
+        }
+        ++i;
+    }
+    return (i < pattern.length()) ? i : -1;
+}
+
+/*!
+ * Finds the longest literal every match of @a rexp contains.
+ *
+ * Only the top level sequence of the pattern is inspected, anything not
+ * understood just ends a literal. Empty result means there is no literal
+ * to look for, e.g. with top level alternation.
+ */
+QByteArray requiredLiteral(const QRegularExpression &rexp)
+{
+    if (rexp.patternOptions() & (QRegularExpression::CaseInsensitiveOption |
+                                 QRegularExpression::ExtendedPatternSyntaxOption)) {
+        return QByteArray();
+    }
+
+    const QString pattern(rexp.pattern());
+    QString longest;
+    QString run;
+    int depth = 0;
+
+    for (int i = 0; i < pattern.length(); ++i) {
+        QChar c = pattern.at(i);
+
+        if (c == '\\') {
+            if (++i == pattern.length()) {
+                return QByteArray();
+            }
+            c = pattern.at(i);
+            if (c.isLetterOrNumber()) {
+                // \k<name>, \x{41}, \Q...\E and others take arguments.
+                if (!SimpleEscapes.contains(c) && (c < '1' || c > '9')) {
+                    return QByteArray();
+                }
+                c = QChar();
+            }
+        } else if (c == '[') {
+            i = skipClass(pattern, i);
+            if (i < 0) {
+                return QByteArray();
+            }
+            c = QChar();
+        } else if (c == '(') {
+            // Inline options like (?i) change how the rest matches.
+            if (pattern.midRef(i, 2) == "(?" &&
+                    !QString(":=!<>").contains(pattern.midRef(i + 2, 1))) {
+                return QByteArray();
+            }
+            ++depth;
+            c = QChar();
+        } else if (c == ')') {
+            --depth;
+            c = QChar();
+        } else if (depth == 0) {
+            if (c == '|') {
+                return QByteArray();
+            } else if (c == '?' || c == '*' || c == '{') {
+                // The previous character may not be there at all.
+                run.chop(1);
+                if (c == '{') {
+                    i = pattern.indexOf('}', i);
+                    if (i < 0) {
+                        return QByteArray();
+                    }
+                }
+                c = QChar();
+            } else if (c == '+' || c == '.' || c == '^' || c == '$') {
+                c = QChar();
+            }
+        }
+
+        if (depth > 0) {
+            continue;
+        }
+
+        if (!c.isNull()) {
+            run += c;
+        } else {
+            if (run.length() > longest.length()) {
+                longest = run;
+            }
+            run.clear();
+        }
+    }
+
+    if (run.length() > longest.length()) {
+        longest = run;
+    }
+    return longest.toUtf8();
+}
+
+}
+
+/*!
+ * @class JournalMatcherPrivate
+ * @brief Private JournalMatcher class.
+ *
+ * @sa JournalMatcher
+ */
+class JournalMatcherPrivate
+{
+public:
+    struct Pattern
+    {
+        int expression;
+        QRegularExpression rexp;
+    };
+
+    /*!
+     * Aho-Corasick automaton with every transition resolved. Bytes not in
+     * any literal share one class, so a state takes one int per distinct
+     * byte of the literals.
+     */
+    struct Automaton
+    {
+        //! @arg Class of every byte value.
+        QVector<int> byteClasses;
+        int classCount;
+        //! @arg Next state, indexed by state * classCount + class.
+        QVector<int> transitions;
+        //! @arg Patterns whose literal ends in the state.
+        QVector<QVector<int> > outputs;
+
+        void build(const QVector<QByteArray> &literals);
+    };
+
+    struct Field
+    {
+        QString name;
+        QVector<Pattern> patterns;
+        //! @arg Patterns evaluated for every value.
+        QVector<int> unfiltered;
+        Automaton automaton;
+    };
+
+    JournalMatcherPrivate();
+
+    QVector<Field> fields;
+    //! @arg Number of fields of every expression.
+    QVector<int> fieldCounts;
+    bool compiled;
+};
+
+JournalMatcherPrivate::JournalMatcherPrivate()
+    : compiled(false)
+{
+}
+
+void JournalMatcherPrivate::Automaton::build(const QVector<QByteArray> &literals)
+{
+    byteClasses.fill(0, 256);
+    classCount = 1;
+    foreach (const QByteArray &literal, literals) {
+        for (int i = 0; i < literal.size(); ++i) {
+            int &byteClass = byteClasses[static_cast<uchar>(literal.at(i))];
+            if (byteClass == 0) {
+                byteClass = classCount++;
+            }
+        }
+    }
+
+    // Trie of the literals, -1 for missing transitions.
+    transitions.fill(-1, classCount);
+    outputs.resize(1);
+    for (int pattern = 0; pattern < literals.size(); ++pattern) {
+        const QByteArray &literal = literals.at(pattern);
+        if (literal.isEmpty()) {
+            continue;
+        }
+
+        int state = 0;
+        for (int i = 0; i < literal.size(); ++i) {
+            int &next = transitions[state * classCount +
+                                    byteClasses.at(static_cast<uchar>(literal.at(i)))];
+            if (next < 0) {
+                next = outputs.size();
+                outputs.resize(outputs.size() + 1);
+                transitions.insert(transitions.end(), classCount, -1);
+            }
+            // Both containers may have been reallocated.
+            state = transitions.at(state * classCount +
+                                   byteClasses.at(static_cast<uchar>(literal.at(i))));
+        }
+        outputs[state] << pattern;
+    }
+
+    // Breadth-first, the failure state is complete before it's needed.
+    QVector<int> failures(outputs.size(), 0);
+    QQueue<int> queue;
+    for (int c = 0; c < classCount; ++c) {
+        int &next = transitions[c];
+        if (next < 0) {
+            next = 0;
+        } else {
+            queue.enqueue(next);
+        }
+    }
+    while (!queue.isEmpty()) {
+        int state = queue.dequeue();
+        int failure = failures.at(state);
+        outputs[state] += outputs.at(failure);
+
+        for (int c = 0; c < classCount; ++c) {
+            int fallback = transitions.at(failure * classCount + c);
+            int &next = transitions[state * classCount + c];
+            if (next < 0) {
+                next = fallback;
+            } else {
+                failures[next] = fallback;
+                queue.enqueue(next);
+            }
+        }
+    }
+}
+
+JournalMatcher::JournalMatcher()
+    : d_ptr(new JournalMatcherPrivate)
+{
+}
+
+JournalMatcher::~JournalMatcher()
+{
+}
+
+int JournalMatcher::addExpression(const QHash<QString, QRegularExpression> &fields)
+{
+    Q_D(JournalMatcher);
+
+    int expression = d->fieldCounts.size();
+    d->fieldCounts << fields.size();
+    d->compiled = false;
+
+    QHash<QString, QRegularExpression>::const_iterator it;
+    for (it = fields.constBegin(); it != fields.constEnd(); ++it) {
+        int index = 0;
+        while (index < d->fields.size() && d->fields.at(index).name != it.key()) {
+            ++index;
+        }
+        if (index == d->fields.size()) {
+            d->fields.resize(index + 1);
+            d->fields[index].name = it.key();
+        }
+
+        JournalMatcherPrivate::Pattern pattern;
+        pattern.expression = expression;
+        pattern.rexp = it.value();
+        d->fields[index].patterns << pattern;
+    }
+
+    return expression;
+}
+
+void JournalMatcher::compile()
+{
+    Q_D(JournalMatcher);
+
+    for (int f = 0; f < d->fields.size(); ++f) {
+        JournalMatcherPrivate::Field &field = d->fields[f];
+
+        QVector<QByteArray> literals;
+        field.unfiltered.clear();
+        for (int i = 0; i < field.patterns.size(); ++i) {
+            QRegularExpression &rexp = field.patterns[i].rexp;
+            rexp.optimize();
+
+            QByteArray literal(requiredLiteral(rexp));
+            if (literal.isEmpty()) {
+                field.unfiltered << i;
+            }
+            literals << literal;
+        }
+        field.automaton.build(literals);
+    }
+
+    d->compiled = true;
+}
+
+QStringList JournalMatcher::fields() const
+{
+    QStringList names;
+    foreach (const JournalMatcherPrivate::Field &field, d_ptr->fields) {
+        names << field.name;
+    }
+    return names;
+}
+
+QList<int> JournalMatcher::match(const QList<QByteArray> &values) const
+{
+    Q_D(const JournalMatcher);
+    Q_ASSERT(d->compiled);
+    Q_ASSERT(values.size() == d->fields.size());
+
+    // Fields of an expression matched so far.
+    QVarLengthArray<int, 256> hits(d->fieldCounts.size());
+    memset(hits.data(), 0, hits.size() * sizeof(int));
+
+    for (int f = 0; f < d->fields.size(); ++f) {
+        const QByteArray &value = values.at(f);
+        if (value.isNull()) {
+            continue;
+        }
+
+        const JournalMatcherPrivate::Field &field = d->fields.at(f);
+        const JournalMatcherPrivate::Automaton &automaton = field.automaton;
+
+        QVarLengthArray<char, 256> seen(field.patterns.size());
+        memset(seen.data(), 0, seen.size());
+        QVarLengthArray<int, 64> candidates;
+        foreach (int pattern, field.unfiltered) {
+            candidates.append(pattern);
+        }
+
+        const int *transitions = automaton.transitions.constData();
+        const int *byteClasses = automaton.byteClasses.constData();
+        int state = 0;
+        for (int i = 0; i < value.size(); ++i) {
+            state = transitions[state * automaton.classCount +
+                                byteClasses[static_cast<uchar>(value.at(i))]];
+            const QVector<int> &outputs = automaton.outputs.at(state);
+            for (int j = 0; j < outputs.size(); ++j) {
+                if (!seen[outputs.at(j)]) {
+                    seen[outputs.at(j)] = 1;
+                    candidates.append(outputs.at(j));
+                }
+            }
+        }
+
+        if (candidates.isEmpty()) {
+            continue;
+        }
+
+        QString text(QString::fromUtf8(value));
+        for (int i = 0; i < candidates.size(); ++i) {
+            const JournalMatcherPrivate::Pattern &pattern = field.patterns.at(candidates.at(i));
+            if (pattern.rexp.match(text).hasMatch()) {
+                ++hits[pattern.expression];
+            }
+        }
+    }
+
+    QList<int> matches;
+    for (int expression = 0; expression < hits.size(); ++expression) {
+        int fieldCount = d->fieldCounts.at(expression);
+        if (fieldCount > 0 && hits.at(expression) == fieldCount) {
+            matches << expression;
+        }
+    }
+    return matches;
+}
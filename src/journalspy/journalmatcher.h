@@ -0,0 +1,85 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef JOURNALMATCHER_H
+#define JOURNALMATCHER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QRegularExpression>
+#include <QScopedPointer>
+#include <QStringList>
+
+class JournalMatcherPrivate;
+
+/*!
+ * @class JournalMatcher
+ * @brief Matches journal entries against all JournalSpy expressions at once.
+ *
+ * Patterns are grouped by journal field. For every pattern, a literal
+ * string that any match has to contain is extracted, and the literals of
+ * a field are compiled into one Aho-Corasick automaton. A single scan of
+ * the field value finds the patterns that can match, only those are
+ * evaluated as regular expressions. Patterns without such a literal, e.g.
+ * alternations, are always evaluated.
+ */
+class JournalMatcher
+{
+public:
+    JournalMatcher();
+    ~JournalMatcher();
+
+    /*!
+     * @brief Adds expression, all its fields have to match.
+     *
+     * @param fields Patterns keyed by journal field.
+     * @return Id of the expression, ids are assigned in order from 0.
+     */
+    int addExpression(const QHash<QString, QRegularExpression> &fields);
+
+    /*!
+     * @brief Builds the automata, call once all expressions are added.
+     */
+    void compile();
+
+    /*!
+     * @brief Journal fields inspected by the expressions.
+     *
+     * match() takes the values of the fields in this order.
+     */
+    QStringList fields() const;
+
+    /*!
+     * @brief Finds expressions matching journal entry.
+     *
+     * @param values Values of fields() without the "FIELD=" prefix, null
+     *        for fields missing from the entry.
+     * @return Ids of all matching expressions in ascending order.
+     */
+    QList<int> match(const QList<QByteArray> &values) const;
+
+private:
+    Q_DISABLE_COPY(JournalMatcher)
+    Q_DECLARE_PRIVATE(JournalMatcher)
+    QScopedPointer<JournalMatcherPrivate> d_ptr;
+};
+
+#endif // JOURNALMATCHER_H
@@ -28,10 +28,49 @@
 
 #include "creporternamespace.h"
 #include "creporterutils.h"
+#include "journalmatcher.h"
 #include "journalspy.h"
 
 using CReporter::LoggingCategory::cr;
 
+namespace {
+
+/*!
+ * Checks whether @a pattern only matches one exact value, i.e. it's
+ * anchored with ^ and $ and contains no other special characters than
+ * escaped ones.
+ *
+ * @param literal Receives the value matched.
+ */
+bool exactValue(const QString &pattern, QString *literal)
+{
+    if (pattern.length() < 2 || !pattern.startsWith('^') || !pattern.endsWith('$')) {
+        return false;
+    }
+
+    static const QString specialChars("^$.|?*+()[]{}\\");
+    QString value;
+    for (int i = 1; i < pattern.length() - 1; ++i) {
+        QChar c = pattern.at(i);
+        if (c == '\\') {
+            // Only escapes of punctuation stand for the character itself,
+            // \d, \s and the like are character classes.
+            if (++i == pattern.length() - 1 || pattern.at(i).isLetterOrNumber()) {
+                return false;
+            }
+            c = pattern.at(i);
+        } else if (specialChars.contains(c)) {
+            return false;
+        }
+        value += c;
+    }
+
+    *literal = value;
+    return true;
+}
+
+}
+
 class JournalSpyPrivate
 {
 public:
@@ -43,6 +82,7 @@ public:
 private:
     void loadExpressions();
     void parsePattern(const QString &name, QIODevice &io);
+    void addMatches();
 
     JournalSpy *q_ptr;
     sd_journal *journal;
@@ -50,16 +90,21 @@ private:
     struct Expression {
         QString name;
         QHash<QString, QRegularExpression> rexp;
+        // Fields whose expression matches only one exact value.
+        QHash<QString, QString> exactValues;
         qint64 lastHit;
 
         Expression(const QString &name)
             : name(name), lastHit(0)
         {
         }
-        bool matches(sd_journal *journal) const;
     };
 
     QList<Expression> expressions;
+    // Ids of the expressions are their indexes in expressions.
+    JournalMatcher matcher;
+    // Fields to read for matcher, in the order it expects them.
+    QList<QByteArray> fields;
 
     Q_DECLARE_PUBLIC(JournalSpy)
 };
@@ -75,6 +120,14 @@ JournalSpyPrivate::JournalSpyPrivate(JournalSpy *parent)
         return;
     }
 
+    foreach (const Expression &expression, expressions) {
+        matcher.addExpression(expression.rexp);
+    }
+    matcher.compile();
+    foreach (const QString &field, matcher.fields()) {
+        fields << field.toUtf8();
+    }
+
     if (sd_journal_open(&journal, SD_JOURNAL_LOCAL_ONLY | SD_JOURNAL_SYSTEM)) {
         qCWarning(cr) << "Failed to open systemd journal.";
         return;
@@ -86,6 +139,8 @@ JournalSpyPrivate::JournalSpyPrivate(JournalSpy *parent)
         return;
     }
 
+    addMatches();
+
     if (sd_journal_seek_tail(journal)) {
         qCWarning(cr) << "sd_journal_seek_tail() failed.";
         return;
@@ -103,46 +158,77 @@ void JournalSpyPrivate::handleJournalEntries()
 {
     sd_journal_process(journal);
 
+    QList<QByteArray> values;
     while (sd_journal_next(journal)) {
-        QList<Expression>::iterator it;
-        for (it = expressions.begin(); it != expressions.end(); ++it) {
-            Expression &e = *it;
-            if (e.matches(journal)) {
-                qint64 previousHit = e.lastHit;
-                e.lastHit = QDateTime::currentMSecsSinceEpoch();
-                if (e.lastHit - previousHit > JournalSpy::SILENT_PERIOD_MS) {
-                    qCDebug(cr) << "Triggering log collection upon found match in "
-                                "the journal:" << e.name;
-                    CReporterUtils::invokeLogCollection("JournalSpy-" + e.name);
-                }
-                break;
+        values.clear();
+        foreach (const QByteArray &field, fields) {
+            const char *val;
+            std::size_t len;
+            if (sd_journal_get_data(journal, field.constData(),
+                                    reinterpret_cast<const void **>(&val), &len) < 0) {
+                values << QByteArray();
+                continue;
             }
+
+            // Cut off "FIELD=" at the beginning of the message.
+            values << QByteArray(val + field.size() + 1, len - field.size() - 1);
+        }
+
+        // An entry triggers at most one log collection, for the first
+        // matching expression in the configuration.
+        QList<int> matches = matcher.match(values);
+        if (matches.isEmpty()) {
+            continue;
+        }
+
+        Expression &e = expressions[matches.first()];
+        qint64 previousHit = e.lastHit;
+        e.lastHit = QDateTime::currentMSecsSinceEpoch();
+        if (e.lastHit - previousHit > JournalSpy::SILENT_PERIOD_MS) {
+            qCDebug(cr) << "Triggering log collection upon found match in "
+                        "the journal:" << e.name;
+            CReporterUtils::invokeLogCollection("JournalSpy-" + e.name);
         }
     }
 }
 
-bool JournalSpyPrivate::Expression::matches(sd_journal *journal) const
+void JournalSpyPrivate::addMatches()
 {
-    QHash<QString, QRegularExpression>::const_iterator it;
-    for (it = rexp.begin(); it != rexp.end(); ++it) {
-        const char *val;
-        std::size_t len;
-        if (sd_journal_get_data(journal, it.key().toUtf8(),
-                                reinterpret_cast<const void **>(&val), &len) < 0) {
-            return false;
+    // An expression without exact fields can match any entry, so the whole
+    // journal has to be read.
+    QList<Expression>::const_iterator it;
+    for (it = expressions.constBegin(); it != expressions.constEnd(); ++it) {
+        if (it->exactValues.isEmpty()) {
+            qCDebug(cr) << "Expression" << it->name << "has no exact field values, "
+                        "reading all journal entries.";
+            return;
         }
+    }
 
-        // Cut off "FIELD=" at the beginning of the message.
-        val += it.key().length() + 1;
-        len -= it.key().length() + 1;
+    // Fields of an expression are ANDed, expressions separated by
+    // disjunctions ORed. Entries that can't match any expression are
+    // skipped by libsystemd, the expressions are still checked in full.
+    for (it = expressions.constBegin(); it != expressions.constEnd(); ++it) {
+        QHash<QString, QString>::const_iterator field;
+        for (field = it->exactValues.constBegin(); field != it->exactValues.constEnd();
+                ++field) {
+            QByteArray match = (field.key() + '=' + field.value()).toUtf8();
+            if (sd_journal_add_match(journal, match.constData(), match.size()) < 0) {
+                qCWarning(cr) << "sd_journal_add_match() failed for" << match;
+                sd_journal_flush_matches(journal);
+                return;
+            }
+        }
 
-        QRegularExpressionMatch match = it.value().match(QByteArray(val, len));
-        if (!match.hasMatch()) {
-            return false;
+        if (sd_journal_add_disjunction(journal) < 0) {
+            qCWarning(cr) << "sd_journal_add_disjunction() failed.";
+            sd_journal_flush_matches(journal);
+            return;
         }
     }
 
-    return true;
+    qCDebug(cr) << "Reading journal entries matching" << expressions.size()
+                << "expressions only.";
 }
 
 void JournalSpyPrivate::loadExpressions()
@@ -199,6 +285,11 @@ void JournalSpyPrivate::parsePattern(const QString &name, QIODevice &io)
                     << qPrintable(journalField) << '='
                     << qPrintable(pattern.pattern());
         expression.rexp.insert(journalField, pattern);
+
+        QString value;
+        if (exactValue(pattern.pattern(), &value)) {
+            expression.exactValues.insert(journalField, value);
+        }
     }
 
     if (!expression.rexp.isEmpty()) {
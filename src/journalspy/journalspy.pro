@@ -31,10 +31,12 @@ INCLUDEPATH += \
 	../libs/utils \
 
 HEADERS = \
-	journalspy.h
+	journalmatcher.h \
+	journalspy.h \
 
 SOURCES = \
 	main.cpp \
+	journalmatcher.cpp \
 	journalspy.cpp \
 
 LIBS += \
@@ -27,10 +27,11 @@
 
 #include <QDir>
 #include <QDebug>
-#include <QDirIterator>
+#include <QSet>
 
 #include "creportercoredir.h"
 #include "creportercoredir_p.h"
+#include "creportercorescanner.h"
 #include "creporterutils.h"
 
 using CReporter::LoggingCategory::cr;
@@ -38,10 +39,6 @@ using CReporter::LoggingCategory::cr;
 
 #define FILE_PERMISSION     0777
 
-const char rcore_file_name_filter[] = "*.rcore";
-const char rcore_lzo_file_name_filter[] = "*.rcore.lzo";
-
-
 CReporterCoreDir::CReporterCoreDir(QString &mpoint, QObject *parent)
     : QObject(parent), d_ptr(new CReporterCoreDirPrivate())
 {
@@ -86,56 +83,49 @@ void CReporterCoreDir::collectAllCoreFilesAtLocation(QStringList &coreList)
 
     qCDebug(cr) << "Collecting cores from:" << d->directory;
 
-    QStringList filters;
-    filters << QString(rcore_file_name_filter) << QString(rcore_lzo_file_name_filter);
-
-    // Construct iterator for core-dumps directory.
-    QDirIterator iter(d->directory, filters, QDir::Files | QDir::NoDotAndDotDot);
-
-    while (iter.hasNext()) {
-        QString filePath = iter.next();
-
-        if (CReporterUtils::validateCore(filePath)) {
-            coreList << filePath;
-        }
-    }
+    coreList += CReporterCoreScanner::collectCoreFiles(QStringList() << d->directory);
 }
 
-QString CReporterCoreDir::checkDirectoryForCores()
+QStringList CReporterCoreDir::checkDirectoryForCores()
 {
     Q_D(CReporterCoreDir);
 
-    QFileInfo fi;
-    QString coreFilePath;
+    QStringList coreFilePaths;
 
-    QStringList filters;
-    filters << QString(rcore_file_name_filter) << QString(rcore_lzo_file_name_filter);
+    QStringList fileNames;
+    CReporterCoreScanner::scanDirectory(d->directory, fileNames);
 
-    // Construct iterator for core-dumps directory.
-    QDirIterator iter(d->directory, filters, QDir::Files | QDir::NoDotAndDotDot);
+    const QSet<QString> knownNames = d->coresAtDirectory.toSet();
 
     // Iterate over files in the core-dumps directory.
-    while (iter.hasNext()) {
-        iter.next();
-        fi = iter.fileInfo();
-
-        if (!d->coresAtDirectory.contains(fi.fileName()) &&
-                CReporterUtils::validateCore(fi.fileName())) {
+    foreach (const QString &fileName, fileNames) {
+        if (!knownNames.contains(fileName)) {
             // This is valid rich core file, which hasn't been processed before.
-            d->coresAtDirectory << fi.fileName();
-            coreFilePath = fi.absoluteFilePath();
-            qCDebug(cr) << "New core file:" << fi.fileName();
-            break;
+            d->coresAtDirectory << fileName;
+            coreFilePaths << d->directory + '/' + fileName;
+            qCDebug(cr) << "New core file:" << fileName;
         }
     }
 
-    if (coreFilePath.isEmpty()) {
+    if (coreFilePaths.isEmpty()) {
         // File was deleted by the user or client from the directory.
-        // Refresh directory list.
-        updateCoreList();
+        // Refresh directory list from the scan that was just done.
+        d->coresAtDirectory = fileNames;
     }
 
-    return coreFilePath;
+    return coreFilePaths;
+}
+
+void CReporterCoreDir::replaceCore(const QString &oldName, const QString &newName)
+{
+    Q_D(CReporterCoreDir);
+
+    d->coresAtDirectory.removeAll(oldName);
+    if (!d->coresAtDirectory.contains(newName)) {
+        d->coresAtDirectory << newName;
+    }
+
+    qCDebug(cr) << "Core file" << oldName << "replaced by" << newName;
 }
 
 void CReporterCoreDir::createCoreDirectory()
@@ -171,16 +161,8 @@ void CReporterCoreDir::updateCoreList()
 
     qCDebug(cr) << "Refreshing core directory list.";
 
-    QDir dir(d->directory);
-    dir.setFilter(QDir::Files | QDir::NoDotAndDotDot);
-    dir.setNameFilters(QStringList() << rcore_file_name_filter << rcore_lzo_file_name_filter);
-
     // Remove old entries.
     d->coresAtDirectory.clear();
 
-    QDirIterator it(dir);
-    while (it.hasNext()) {
-        it.next();
-        d->coresAtDirectory.append(it.fileName());
-    }
+    CReporterCoreScanner::scanDirectory(d->directory, d->coresAtDirectory);
 }
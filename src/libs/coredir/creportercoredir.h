@@ -92,10 +92,23 @@ public:
     /*!
      * @brief Checks directory for new core files.
      *
-     * @return Absolute path to core file. String is NULL, if new valid
-     *  core file was not found.
+     * The directory is scanned once per call.
+     *
+     * @return Absolute paths to all new valid core files. Empty, if none
+     *  was found.
+     */
+    QStringList checkDirectoryForCores();
+
+    /*!
+     * @brief Records that a core file in this directory was replaced.
+     *
+     * Should be called before the new file appears in the directory, so that
+     * it isn't reported as a new core.
+     *
+     * @param oldName Name of the core file being replaced.
+     * @param newName Name of the file replacing it.
      */
-    QString checkDirectoryForCores();
+    void replaceCore(const QString &oldName, const QString &newName);
 
 public Q_SLOTS:
     /*!
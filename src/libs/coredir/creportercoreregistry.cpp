@@ -28,14 +28,15 @@
 #include <stdlib.h> // for getenv()
 
 #include <QCoreApplication>
-#include <QTimer>
 #include <QDebug>
 #include <QDir>
-#include <QSignalMapper>
+#include <QFileInfo>
 
 #include "creportercoreregistry.h"
 #include "creportercoreregistry_p.h"
 #include "creportercoredir.h"
+#include "creportercorescanner.h"
+#include "creportermounttracker.h"
 #include "creporterutils.h"
 
 using CReporter::LoggingCategory::cr;
@@ -45,7 +46,7 @@ using CReporter::LoggingCategory::cr;
 #define MAX_CORE_DIRS (NUM_ENV_MOUNTPOINTS + NUM_STATIC_MOUNTPOINTS + 1)
 #define MAX_MOUNTPOINT_NAMELEN (128)
 
-#define MMC_EVENT_TIMEOUT   5000 // Time to wait (ms) after mmc state has changed.
+#define MIN_FREE_SPACE (10 * 1024 * 1024) // Space (bytes) to leave free on a core location.
 
 static const char
 mountpoint_env_names[NUM_ENV_MOUNTPOINTS][MAX_MOUNTPOINT_NAMELEN] = {
@@ -69,24 +70,25 @@ const char core_dumps_suffix[] = "/core-dumps";
 
 
 CReporterCoreRegistryPrivate::CReporterCoreRegistryPrivate()
+    : mountTracker(0)
 {
-    mapper = new QSignalMapper();
 }
 
 CReporterCoreRegistryPrivate::~CReporterCoreRegistryPrivate()
 {
-    delete mapper;
 }
 
 CReporterCoreRegistry::CReporterCoreRegistry(QObject *parent)
     : QObject(parent), d_ptr(new CReporterCoreRegistryPrivate())
 {
+    d_ptr->mountTracker = new CReporterMountTracker("/proc/self/mountinfo", this);
+
     createCoreLocationRegistry();
 
-    /* TODO: status of MMC card used to be monitored here, and mmcStateChanged()
-     * triggered when card was inserted/removed/mounted via USB. We might need
-     * to re-implement this functionality also for Sailfish. */
-    // Cache keys under /system/osso/af and map state change signals to single slot.
+    connect(d_ptr->mountTracker, SIGNAL(mountAdded(QString)),
+            this, SLOT(handleMountAdded(QString)));
+    connect(d_ptr->mountTracker, SIGNAL(mountRemoved(QString)),
+            this, SLOT(handleMountRemoved(QString)));
 }
 
 CReporterCoreRegistry::~CReporterCoreRegistry()
@@ -103,14 +105,12 @@ QStringList CReporterCoreRegistry::collectAllCoreFiles() const
 {
     Q_D(const CReporterCoreRegistry);
 
-    QStringList out;
-    QListIterator<CReporterCoreDir *> iter(d->coreDirs);
-
-    while (iter.hasNext()) {
-        CReporterCoreDir *dir = (CReporterCoreDir *) iter.next();
-        dir->collectAllCoreFilesAtLocation(out);
+    QStringList directories;
+    foreach (CReporterCoreDir *dir, d->coreDirs) {
+        directories << dir->getDirectory();
     }
-    return out;
+
+    return CReporterCoreScanner::collectCoreFiles(directories);
 }
 
 QStringList CReporterCoreRegistry::getCoreLocationPaths()
@@ -137,21 +137,39 @@ QStringList CReporterCoreRegistry::getCoreLocationPaths()
     return paths;
 }
 
-QString CReporterCoreRegistry::checkDirectoryForCores(const QString &path)
+QStringList CReporterCoreRegistry::checkDirectoryForCores(const QString &path)
 {
     Q_D(CReporterCoreRegistry);
 
-    QString coreFilePath;
+    QStringList coreFilePaths;
     QListIterator<CReporterCoreDir *> iter(d->coreDirs);
 
     while (iter.hasNext()) {
         CReporterCoreDir *pCoreDir =  (CReporterCoreDir *) iter.next();
         // Find the correct location.
         if (pCoreDir->getDirectory() == path) {
-            coreFilePath = pCoreDir->checkDirectoryForCores();
+            coreFilePaths = pCoreDir->checkDirectoryForCores();
+        }
+    }
+    return coreFilePaths;
+}
+
+void CReporterCoreRegistry::replaceCore(const QString &oldPath,
+                                        const QString &newPath)
+{
+    Q_D(CReporterCoreRegistry);
+
+    QFileInfo oldFile(oldPath);
+    QFileInfo newFile(newPath);
+
+    foreach (CReporterCoreDir *dir, d->coreDirs) {
+        if (dir->getDirectory() == oldFile.absolutePath()) {
+            dir->replaceCore(oldFile.fileName(), newFile.fileName());
+            return;
         }
     }
-    return coreFilePath;
+
+    qCWarning(cr) << "No core location for" << oldPath;
 }
 
 void CReporterCoreRegistry::refreshRegistry()
@@ -161,10 +179,147 @@ void CReporterCoreRegistry::refreshRegistry()
 }
 
 
-void CReporterCoreRegistry::mmcStateChanged(const QString &key)
+QString CReporterCoreRegistry::preferredCoreLocation(LocationPreference preference,
+        qint64 requiredBytes) const
+{
+    Q_D(const CReporterCoreRegistry);
+
+    QString best;
+    int bestRank = 0;
+    qint64 bestFree = 0;
+
+    foreach (CReporterCoreDir *dir, d->coreDirs) {
+        QString path(dir->getDirectory());
+        if (!QDir(path).exists()) {
+            continue;
+        }
+
+        CReporterMountTracker::Mount mount;
+        CReporterMountTracker::DeviceClass deviceClass = CReporterMountTracker::UnknownDevice;
+        if (d->mountTracker->mountForPath(path, &mount)) {
+            if (mount.readOnly) {
+                continue;
+            }
+            deviceClass = mount.deviceClass;
+        }
+
+        qint64 free = CReporterMountTracker::freeSpace(path);
+        if (free < requiredBytes + MIN_FREE_SPACE) {
+            qCDebug(cr) << "Not enough free space in" << path << ":" << free;
+            continue;
+        }
+
+        int rank = 0;
+        if (preference == PreferFastest) {
+            switch (deviceClass) {
+            case CReporterMountTracker::InternalFlash:
+                rank = 0;
+                break;
+            case CReporterMountTracker::RemovableCard:
+                rank = 1;
+                break;
+            case CReporterMountTracker::UsbStorage:
+                rank = 2;
+                break;
+            default:
+                rank = 3;
+                break;
+            }
+        }
+
+        if (best.isEmpty() || rank < bestRank || (rank == bestRank && free > bestFree)) {
+            best = path;
+            bestRank = rank;
+            bestFree = free;
+        }
+    }
+
+    qCDebug(cr) << "Preferred core location:" << best;
+    return best;
+}
+
+CReporterMountTracker *CReporterCoreRegistry::mountTracker() const
+{
+    Q_D(const CReporterCoreRegistry);
+    return d->mountTracker;
+}
+
+void CReporterCoreRegistry::handleMountAdded(const QString &mountPoint)
+{
+    if (addMountedCoreDir(mountPoint)) {
+        emit coreLocationsUpdated();
+    }
+}
+
+bool CReporterCoreRegistry::addMountedCoreDir(const QString &mountPoint)
 {
-    qCDebug(cr) << "Key:" << key << "has changed.";
-    QTimer::singleShot(MMC_EVENT_TIMEOUT, this, SIGNAL(coreLocationsUpdated()));
+    Q_D(CReporterCoreRegistry);
+
+    foreach (CReporterCoreDir *dir, d->coreDirs) {
+        if (dir->getMountpoint() == mountPoint) {
+            return false;
+        }
+    }
+
+    CReporterMountTracker::Mount mount;
+    if (!d->mountTracker->mountForPath(mountPoint, &mount) ||
+            mount.mountPoint != mountPoint || mount.readOnly) {
+        return false;
+    }
+
+    switch (mount.deviceClass) {
+    case CReporterMountTracker::InternalFlash:
+    case CReporterMountTracker::RemovableCard:
+    case CReporterMountTracker::UsbStorage:
+        break;
+    default:
+        return false;
+    }
+
+    if (!QDir(mountPoint + core_dumps_suffix).exists()) {
+        return false;
+    }
+
+    qCDebug(cr) << "Adding core location on mounted volume" << mountPoint;
+
+    d->mountedCoreDirs << addCoreDir(mountPoint);
+
+    return true;
+}
+
+void CReporterCoreRegistry::handleMountRemoved(const QString &mountPoint)
+{
+    Q_D(CReporterCoreRegistry);
+
+    foreach (CReporterCoreDir *dir, d->mountedCoreDirs) {
+        if (dir->getMountpoint() == mountPoint) {
+            qCDebug(cr) << "Removing core location on unmounted volume" << mountPoint;
+
+            d->mountedCoreDirs.removeOne(dir);
+            d->coreDirs.removeOne(dir);
+            dir->deleteLater();
+
+            emit coreLocationsUpdated();
+            return;
+        }
+    }
+}
+
+CReporterCoreDir *CReporterCoreRegistry::addCoreDir(const QString &mountpoint)
+{
+    Q_D(CReporterCoreRegistry);
+
+    QString mpoint(mountpoint);
+    CReporterCoreDir *dir = new CReporterCoreDir(mpoint, this);
+    d->coreDirs << dir;
+
+    // Set directory for core location.
+    connect(this, SIGNAL(coreLocationsUpdated()), dir, SLOT(createCoreDirectory()));
+    connect(this, SIGNAL(registryRefreshNeeded()), dir, SLOT(updateCoreList()));
+
+    dir->setDirectory(mpoint + core_dumps_suffix);
+
+    return dir;
 }
 
 void CReporterCoreRegistry::createCoreLocationRegistry()
@@ -180,8 +335,7 @@ void CReporterCoreRegistry::createCoreLocationRegistry()
         QString mpoint(getenv(name));
 
         if (!mpoint.isEmpty()) {
-            CReporterCoreDir *dir = new CReporterCoreDir(mpoint, this);
-            d->coreDirs << dir;
+            addCoreDir(mpoint);
         }
     }
 #endif
@@ -197,22 +351,14 @@ void CReporterCoreRegistry::createCoreLocationRegistry()
             mpoint.prepend(QDir::homePath());
 #endif
 
-            CReporterCoreDir *dir = new CReporterCoreDir(mpoint, this);
-            d->coreDirs << dir;
+            addCoreDir(mpoint);
         }
     }
 
-    qCDebug(cr) << "Set core location directories.";
-
-    for (int i = 0; i < d->coreDirs.count(); i++) {
-        // Set directory for core locations.
-        CReporterCoreDir *dir = (CReporterCoreDir *) d->coreDirs.at(i);
-        connect(this, SIGNAL(coreLocationsUpdated()), dir, SLOT(createCoreDirectory()));
-        connect(this, SIGNAL(registryRefreshNeeded()), dir, SLOT(updateCoreList()));
+    qCDebug(cr) << "Looking for core locations on mounted volumes.";
 
-        QString tmp(dir->getMountpoint());
-        tmp.append(core_dumps_suffix);
-        dir->setDirectory(tmp);
+    foreach (const CReporterMountTracker::Mount &mount, d->mountTracker->mounts()) {
+        addMountedCoreDir(mount.mountPoint);
     }
 
     // Emit this signal to create directories for core dumps.
@@ -29,6 +29,8 @@
 #include <QStringList>
 
 class CReporterCoreRegistryPrivate;
+class CReporterCoreDir;
+class CReporterMountTracker;
 
 /*!
  * @class CReporterCoreRegistry
@@ -41,6 +43,17 @@ class CReporterCoreRegistry : public QObject
     Q_OBJECT
 
 public:
+    /*!
+     * @enum LocationPreference
+     * @brief Criterion for choosing where to write new files.
+     */
+    enum LocationPreference {
+        //! Prefer internal flash over removable media.
+        PreferFastest,
+        //! Prefer the location with most free space.
+        PreferEmptiest
+    };
+
     static CReporterCoreRegistry *instance();
 
     ~CReporterCoreRegistry();
@@ -66,10 +79,43 @@ public:
      *
      * @param path Reference to directory to be checked.
      *
-     * @return Absolute path to core file. String is NULL, if new valid
-     *  core file was not found.
+     * @return Absolute paths to all new valid core files. Empty, if none
+     *  was found.
+     */
+    QStringList checkDirectoryForCores(const QString &path);
+
+    /*!
+     * @brief Records that a core file was replaced by another one.
+     *
+     * Used when a report is rewritten in place, e.g. compressed, so that the
+     * new file isn't treated as a new crash.
+     *
+     * @param oldPath Absolute path of the core file being replaced.
+     * @param newPath Absolute path of the file replacing it. Must be in the
+     *        same directory.
      */
-    QString checkDirectoryForCores(const QString &path);
+    void replaceCore(const QString &oldPath, const QString &newPath);
+
+    /*!
+     * @brief Chooses core directory new files should be written to.
+     *
+     * Only writable locations with at least @a requiredBytes of free space
+     * are considered.
+     *
+     * @param preference Criterion for choosing among the locations.
+     * @param requiredBytes Space needed for the files to be written.
+     * @return Path to core directory, or empty string if there is no
+     *         suitable location.
+     */
+    QString preferredCoreLocation(LocationPreference preference = PreferFastest,
+                                  qint64 requiredBytes = 0) const;
+
+    /*!
+     * @brief Returns tracker of mounted file systems.
+     *
+     * Can be used to query free space and device class of core locations.
+     */
+    CReporterMountTracker *mountTracker() const;
 
 public Q_SLOTS:
     /*!
@@ -81,7 +127,7 @@ public Q_SLOTS:
 
 Q_SIGNALS:
     /*!
-     * @brief This signal is emission is caused by mmc event.
+     * @brief This signal is emitted when core locations are added or removed.
      *
      */
     void coreLocationsUpdated();
@@ -94,15 +140,22 @@ Q_SIGNALS:
 
 private Q_SLOTS:
     /*!
-     * @brief This function is called, when mmc gconf status changes.
+     * @brief Adds core location on a newly mounted volume.
      *
-     * Timer is started to add some wait time. This is needed because gconf change events
-     * come before mounting, but our actions need to be carried out after mounting.
-     * After timer elapses, coreLocationsUpdated signal is emitted.
+     * Volumes that have "core-dumps" directory in their root are used as
+     * core locations. coreLocationsUpdated signal is emitted if the location
+     * was added.
      *
-     * @param key Changed setting.
+     * @param mountPoint Mount point of the volume.
      */
-    void mmcStateChanged(const QString &key);
+    void handleMountAdded(const QString &mountPoint);
+
+    /*!
+     * @brief Removes core location on a volume that was unmounted.
+     *
+     * @param mountPoint Mount point of the volume.
+     */
+    void handleMountRemoved(const QString &mountPoint);
 
 private:
     /**
@@ -119,6 +172,22 @@ private:
       */
     void createCoreLocationRegistry();
 
+    /*!
+      * @brief Instantiates CReporterCoreDir for a mount point.
+      *
+      * @param mountpoint Mount point of the core location.
+      * @return New core location.
+      */
+    CReporterCoreDir *addCoreDir(const QString &mountpoint);
+
+    /*!
+      * @brief Adds core location on a mounted volume, if it has one.
+      *
+      * @param mountPoint Mount point of the volume.
+      * @return @c true if core location was added.
+      */
+    bool addMountedCoreDir(const QString &mountPoint);
+
 private:
     Q_DECLARE_PRIVATE(CReporterCoreRegistry)
 
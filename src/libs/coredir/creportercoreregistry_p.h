@@ -28,7 +28,7 @@
 #include <QList>
 
 class CReporterCoreDir;
-class QSignalMapper;
+class CReporterMountTracker;
 
 /*!
  * \class CReporterCoreRegistry
@@ -43,10 +43,12 @@ public:
     virtual ~CReporterCoreRegistryPrivate();
 
 public:
-    //! @arg Signal mapper to map gconf value changes.
-    QSignalMapper *mapper;
     //! @arg List of CReporterCoreDir instances.
     QList<CReporterCoreDir *> coreDirs;
+    //! @arg Core locations discovered on mounted volumes.
+    QList<CReporterCoreDir *> mountedCoreDirs;
+    //! @arg Watches for volumes being mounted and unmounted.
+    CReporterMountTracker *mountTracker;
 };
 
 #endif // CREPORTERCOREREGISTRY_P_H
@@ -0,0 +1,152 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <QDebug>
+#include <QFile>
+#include <QtConcurrentMap>
+
+#include "creportercorescanner.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+
+//! Size of the buffer directory entries are read into.
+const int DIRENT_BUFFER_SIZE = 32 * 1024;
+
+const char RCORE_SUFFIX[] = ".rcore";
+const char RCORE_LZO_SUFFIX[] = ".rcore.lzo";
+
+struct linux_dirent64 {
+    quint64 d_ino;
+    qint64 d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+bool hasSuffix(const char *name, int length, const char *suffix, int suffixLength)
+{
+    return length > suffixLength &&
+           strncasecmp(name + length - suffixLength, suffix, suffixLength) == 0;
+}
+
+QStringList collectAtDirectory(const QString &directory)
+{
+    QStringList fileNames;
+    CReporterCoreScanner::scanDirectory(directory, fileNames);
+
+    QString prefix(directory + '/');
+    for (int i = 0; i < fileNames.count(); ++i) {
+        fileNames[i].prepend(prefix);
+    }
+
+    return fileNames;
+}
+
+}
+
+bool CReporterCoreScanner::isCoreFileName(const char *name, int length)
+{
+    return hasSuffix(name, length, RCORE_SUFFIX, sizeof(RCORE_SUFFIX) - 1) ||
+           hasSuffix(name, length, RCORE_LZO_SUFFIX, sizeof(RCORE_LZO_SUFFIX) - 1);
+}
+
+bool CReporterCoreScanner::scanDirectory(const QString &directory,
+        QStringList &fileNames)
+{
+    int fd = open(QFile::encodeName(directory).constData(),
+                  O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        qCDebug(cr) << "Cannot open directory" << directory;
+        return false;
+    }
+
+    QByteArray buffer(DIRENT_BUFFER_SIZE, Qt::Uninitialized);
+    bool ok = true;
+
+    for (;;) {
+        long n = syscall(SYS_getdents64, fd, buffer.data(), buffer.size());
+        if (n < 0) {
+            qCWarning(cr) << "Error reading directory" << directory;
+            ok = false;
+            break;
+        } else if (n == 0) {
+            break;
+        }
+
+        for (long offset = 0; offset < n;) {
+            const linux_dirent64 *entry =
+                reinterpret_cast<const linux_dirent64 *>(buffer.constData() + offset);
+            offset += entry->d_reclen;
+
+            const char *name = entry->d_name;
+            if (name[0] == '.') {
+                continue;
+            }
+
+            int length = strlen(name);
+            if (!isCoreFileName(name, length)) {
+                continue;
+            }
+
+            if (entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK) {
+                // Type is not known from the entry or it has to be resolved.
+                struct stat st;
+                if (fstatat(fd, name, &st, 0) != 0 || !S_ISREG(st.st_mode)) {
+                    continue;
+                }
+            } else if (entry->d_type != DT_REG) {
+                continue;
+            }
+
+            fileNames << QFile::decodeName(QByteArray::fromRawData(name, length));
+        }
+    }
+
+    close(fd);
+
+    return ok;
+}
+
+QStringList CReporterCoreScanner::collectCoreFiles(const QStringList &directories)
+{
+    if (directories.count() == 1) {
+        return collectAtDirectory(directories.first());
+    }
+
+    QList<QStringList> results =
+        QtConcurrent::blockingMapped<QList<QStringList> >(directories, collectAtDirectory);
+
+    QStringList coreFiles;
+    foreach (const QStringList &result, results) {
+        coreFiles += result;
+    }
+
+    return coreFiles;
+}
@@ -0,0 +1,72 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERCORESCANNER_H
+#define CREPORTERCORESCANNER_H
+
+#include <QStringList>
+
+/*!
+ * @class CReporterCoreScanner
+ * @brief Lists rich core files in core directories.
+ *
+ * Directory entries are read in bulk with getdents64() and matched by file
+ * name suffix without allocating memory or stat'ing the entries. Several
+ * directories are scanned in parallel.
+ */
+class CReporterCoreScanner
+{
+public:
+    /*!
+     * @brief Appends names of rich core files in a directory to a list.
+     *
+     * Hidden files and entries that are not regular files are skipped.
+     *
+     * @param directory Directory to scan.
+     * @param fileNames List the file names are appended to.
+     * @return @c false if the directory could not be read.
+     */
+    static bool scanDirectory(const QString &directory, QStringList &fileNames);
+
+    /*!
+     * @brief Lists rich core files in multiple directories.
+     *
+     * Directories are scanned concurrently on the global thread pool.
+     *
+     * @param directories Directories to scan.
+     * @return Absolute paths of rich core files, in the order of
+     *         @a directories.
+     */
+    static QStringList collectCoreFiles(const QStringList &directories);
+
+    /*!
+     * @brief Checks whether a file name has a rich core suffix.
+     *
+     * @param name File name.
+     * @param length Length of @a name.
+     * @return @c true for *.rcore and *.rcore.lzo, ignoring case.
+     */
+    static bool isCoreFileName(const char *name, int length);
+
+private:
+    CReporterCoreScanner();
+};
+
+#endif // CREPORTERCORESCANNER_H
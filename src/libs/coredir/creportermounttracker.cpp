@@ -0,0 +1,268 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <sys/statvfs.h>
+
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSet>
+#include <QSocketNotifier>
+#include <QStringList>
+
+#include "creportermounttracker.h"
+#include "creportermounttracker_p.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+
+//! Decodes octal escapes (\040 for space etc.) used in mountinfo fields.
+QString unescape(const QByteArray &field)
+{
+    QByteArray out;
+    out.reserve(field.size());
+
+    for (int i = 0; i < field.size(); ++i) {
+        if (field.at(i) == '\\' && i + 3 < field.size() &&
+                field.at(i + 1) >= '0' && field.at(i + 1) <= '3') {
+            out += char(((field.at(i + 1) - '0') << 6) |
+                        ((field.at(i + 2) - '0') << 3) |
+                        (field.at(i + 3) - '0'));
+            i += 3;
+        } else {
+            out += field.at(i);
+        }
+    }
+
+    return QString::fromUtf8(out);
+}
+
+QByteArray readSysfsAttribute(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll().trimmed();
+}
+
+}
+
+CReporterMountTracker::CReporterMountTracker(const QString &mountInfoPath,
+        QObject *parent)
+    : QObject(parent), d_ptr(new CReporterMountTrackerPrivate())
+{
+    Q_D(CReporterMountTracker);
+
+    d->notifier = 0;
+    d->mountInfo.setFileName(mountInfoPath);
+
+    if (!d->mountInfo.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        qCWarning(cr) << "Cannot open" << mountInfoPath << ":"
+                      << d->mountInfo.errorString();
+        return;
+    }
+
+    // The kernel signals changes of the mount table as an exceptional
+    // condition on the file descriptor.
+    d->notifier = new QSocketNotifier(d->mountInfo.handle(),
+                                      QSocketNotifier::Exception, this);
+    connect(d->notifier, SIGNAL(activated(int)), this, SLOT(refresh()));
+
+    refresh();
+}
+
+CReporterMountTracker::~CReporterMountTracker()
+{
+    delete d_ptr;
+}
+
+QList<CReporterMountTracker::Mount> CReporterMountTracker::mounts() const
+{
+    Q_D(const CReporterMountTracker);
+    return d->mounts;
+}
+
+bool CReporterMountTracker::isMountPoint(const QString &mountPoint) const
+{
+    Q_D(const CReporterMountTracker);
+
+    QString path = QDir::cleanPath(mountPoint);
+    foreach (const Mount &mount, d->mounts) {
+        if (mount.mountPoint == path) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CReporterMountTracker::mountForPath(const QString &path, Mount *mount) const
+{
+    Q_D(const CReporterMountTracker);
+
+    QString cleanPath = QDir::cleanPath(path);
+    int best = -1;
+    int bestLength = -1;
+
+    for (int i = 0; i < d->mounts.count(); ++i) {
+        const QString &mountPoint = d->mounts.at(i).mountPoint;
+        bool contains = (mountPoint == "/") || (cleanPath == mountPoint) ||
+                        cleanPath.startsWith(mountPoint + '/');
+        // Later entries are stacked on top of the earlier ones.
+        if (contains && mountPoint.length() >= bestLength) {
+            best = i;
+            bestLength = mountPoint.length();
+        }
+    }
+
+    if (best < 0) {
+        return false;
+    }
+
+    if (mount) {
+        *mount = d->mounts.at(best);
+    }
+    return true;
+}
+
+QList<CReporterMountTracker::Mount> CReporterMountTracker::parseMountInfo(const QByteArray &data)
+{
+    QList<Mount> mounts;
+
+    foreach (const QByteArray &line, data.split('\n')) {
+        // 36 35 98:0 /mnt1 /mnt/parent rw,noatime master:1 - ext3 /dev/root rw
+        QList<QByteArray> fields = line.split(' ');
+        int separator = fields.indexOf("-", 6);
+        if (fields.count() < 6 || separator < 0 || separator + 2 >= fields.count()) {
+            continue;
+        }
+
+        QList<QByteArray> device = fields.at(2).split(':');
+        if (device.count() != 2) {
+            continue;
+        }
+
+        Mount mount;
+        mount.major = device.at(0).toUInt();
+        mount.minor = device.at(1).toUInt();
+        mount.root = unescape(fields.at(3));
+        mount.mountPoint = unescape(fields.at(4));
+        mount.readOnly = fields.at(5).split(',').contains("ro");
+        mount.fsType = unescape(fields.at(separator + 1));
+        mount.source = unescape(fields.at(separator + 2));
+        mount.deviceClass = UnknownDevice;
+
+        mounts << mount;
+    }
+
+    return mounts;
+}
+
+CReporterMountTracker::DeviceClass CReporterMountTracker::classify(const Mount &mount,
+        const QString &sysfsRoot)
+{
+    static const QSet<QString> ramFileSystems = QSet<QString>()
+        << "tmpfs" << "ramfs" << "devtmpfs";
+    static const QSet<QString> networkFileSystems = QSet<QString>()
+        << "nfs" << "nfs4" << "cifs" << "smbfs" << "9p" << "fuse.sshfs";
+
+    if (ramFileSystems.contains(mount.fsType)) {
+        return RamDisk;
+    }
+    if (networkFileSystems.contains(mount.fsType)) {
+        return NetworkStorage;
+    }
+    if (mount.major == 0) {
+        // Virtual file system without a block device.
+        return UnknownDevice;
+    }
+
+    QString device = QFileInfo(QString("%1/dev/block/%2:%3")
+                               .arg(sysfsRoot).arg(mount.major).arg(mount.minor))
+                     .canonicalFilePath();
+    if (device.isEmpty()) {
+        return UnknownDevice;
+    }
+
+    if (device.contains("/usb")) {
+        return UsbStorage;
+    }
+
+    // Attributes describing the medium belong to the whole disk.
+    if (QFile::exists(device + "/partition")) {
+        device = QFileInfo(device).path();
+    }
+
+    QByteArray mmcType = readSysfsAttribute(device + "/device/type");
+    if (mmcType == "SD") {
+        return RemovableCard;
+    } else if (mmcType == "MMC") {
+        return InternalFlash;
+    }
+
+    if (readSysfsAttribute(device + "/removable") == "1") {
+        return RemovableCard;
+    }
+
+    return InternalFlash;
+}
+
+qint64 CReporterMountTracker::freeSpace(const QString &path)
+{
+    struct statvfs st;
+    if (statvfs(QFile::encodeName(path).constData(), &st) != 0) {
+        return -1;
+    }
+    return qint64(st.f_bavail) * st.f_frsize;
+}
+
+void CReporterMountTracker::refresh()
+{
+    Q_D(CReporterMountTracker);
+
+    // Reading the table to the end re-arms the change notification.
+    d->mountInfo.seek(0);
+    QList<Mount> mounts = parseMountInfo(d->mountInfo.readAll());
+
+    QSet<QString> oldMountPoints;
+    foreach (const Mount &mount, d->mounts) {
+        oldMountPoints << mount.mountPoint;
+    }
+
+    QSet<QString> newMountPoints;
+    for (int i = 0; i < mounts.count(); ++i) {
+        mounts[i].deviceClass = classify(mounts.at(i));
+        newMountPoints << mounts.at(i).mountPoint;
+    }
+
+    d->mounts = mounts;
+
+    foreach (const QString &mountPoint, oldMountPoints - newMountPoints) {
+        qCDebug(cr) << "Unmounted:" << mountPoint;
+        emit mountRemoved(mountPoint);
+    }
+
+    foreach (const QString &mountPoint, newMountPoints - oldMountPoints) {
+        qCDebug(cr) << "Mounted:" << mountPoint;
+        emit mountAdded(mountPoint);
+    }
+}
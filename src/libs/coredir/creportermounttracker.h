@@ -0,0 +1,160 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERMOUNTTRACKER_H
+#define CREPORTERMOUNTTRACKER_H
+
+#include <QList>
+#include <QObject>
+#include <QString>
+
+class CReporterMountTrackerPrivate;
+
+/*!
+ * @class CReporterMountTracker
+ * @brief Keeps track of mounted file systems.
+ *
+ * The mount table is read from /proc/self/mountinfo, which is polled for
+ * changes, so that volumes appearing and disappearing are reported without
+ * a delay.
+ */
+class CReporterMountTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    /*!
+     * @enum DeviceClass
+     * @brief Kind of storage a file system is on.
+     */
+    enum DeviceClass {
+        //! Storage type could not be determined.
+        UnknownDevice = 0,
+        //! Non-removable flash of the device.
+        InternalFlash,
+        //! Removable memory card.
+        RemovableCard,
+        //! Mass storage attached over USB.
+        UsbStorage,
+        //! File system in RAM.
+        RamDisk,
+        //! Network file system.
+        NetworkStorage
+    };
+
+    /*!
+     * @struct Mount
+     * @brief Entry of the mount table.
+     */
+    struct Mount {
+        //! Path the file system is mounted at.
+        QString mountPoint;
+        //! Directory of the file system that is mounted.
+        QString root;
+        //! Mounted device or other source.
+        QString source;
+        //! File system type.
+        QString fsType;
+        //! Device number.
+        quint32 major;
+        quint32 minor;
+        //! @c true if mounted read-only.
+        bool readOnly;
+        //! Storage type.
+        DeviceClass deviceClass;
+    };
+
+    /*!
+     * @brief Class constructor.
+     *
+     * @param mountInfoPath Mount table to watch.
+     * @param parent Owner of this object.
+     */
+    explicit CReporterMountTracker(const QString &mountInfoPath = "/proc/self/mountinfo",
+                                   QObject *parent = 0);
+    ~CReporterMountTracker();
+
+    /*!
+     * @brief Returns currently mounted file systems.
+     */
+    QList<Mount> mounts() const;
+
+    /*!
+     * @brief Returns @c true if a file system is mounted at @a mountPoint.
+     */
+    bool isMountPoint(const QString &mountPoint) const;
+
+    /*!
+     * @brief Finds the file system @a path resides on.
+     *
+     * @param path Absolute path.
+     * @param mount Filled with the mount table entry, if found.
+     * @return @c true if the file system was found.
+     */
+    bool mountForPath(const QString &path, Mount *mount) const;
+
+    /*!
+     * @brief Parses content of a mountinfo file.
+     *
+     * @param data Content of /proc/<pid>/mountinfo.
+     * @return Entries of the table; device class is not determined.
+     */
+    static QList<Mount> parseMountInfo(const QByteArray &data);
+
+    /*!
+     * @brief Determines the kind of storage a file system is on.
+     *
+     * @param mount Mount table entry.
+     * @param sysfsRoot Where sysfs is mounted.
+     */
+    static DeviceClass classify(const Mount &mount, const QString &sysfsRoot = "/sys");
+
+    /*!
+     * @brief Returns bytes available to unprivileged users at @a path.
+     *
+     * @return Free space in bytes, or -1 on error.
+     */
+    static qint64 freeSpace(const QString &path);
+
+Q_SIGNALS:
+    /*!
+     * @brief Emitted when a file system is mounted.
+     */
+    void mountAdded(const QString &mountPoint);
+
+    /*!
+     * @brief Emitted when a file system is unmounted.
+     */
+    void mountRemoved(const QString &mountPoint);
+
+public Q_SLOTS:
+    /*!
+     * @brief Re-reads the mount table and emits signals about the changes.
+     */
+    void refresh();
+
+private:
+    Q_DISABLE_COPY(CReporterMountTracker)
+    Q_DECLARE_PRIVATE(CReporterMountTracker)
+
+    CReporterMountTrackerPrivate *d_ptr;
+};
+
+#endif // CREPORTERMOUNTTRACKER_H
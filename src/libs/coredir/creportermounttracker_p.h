@@ -0,0 +1,47 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERMOUNTTRACKER_P_H
+#define CREPORTERMOUNTTRACKER_P_H
+
+#include <QFile>
+
+#include "creportermounttracker.h"
+
+class QSocketNotifier;
+
+/*!
+ * @class CReporterMountTrackerPrivate
+ * @brief Private CReporterMountTracker class.
+ *
+ * @sa CReporterMountTracker
+ */
+class CReporterMountTrackerPrivate
+{
+public:
+    //! @arg Opened mount table.
+    QFile mountInfo;
+    //! @arg Signals changes in the mount table.
+    QSocketNotifier *notifier;
+    //! @arg Current content of the mount table.
+    QList<CReporterMountTracker::Mount> mounts;
+};
+
+#endif // CREPORTERMOUNTTRACKER_P_H
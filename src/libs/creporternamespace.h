@@ -44,6 +44,10 @@ const QString SystemSettingsLocation = "/usr/share";
 const QString PrivacySettingsFileUser =
     "/.config/crash-reporter-settings/crash-reporter-privacy.conf";
 
+//! Persistent table of handled crashes. First part of the path is composed in code.
+const QString HandledCoresFile =
+    "/.config/crash-reporter-settings/handled-cores.dat";
+
 //! System privacy settings file.
 const QString PrivacySettingsFileSystem =
     "/usr/share/crash-reporter-settings/crash-reporter-privacy.conf";
@@ -54,6 +58,27 @@ const QString PrivacyDisclaimerFile =  "/usr/share/crash-reporter-settings/priva
 //! Default log file.
 const QString DefaultLogFile = "/tmp/crash-reporter.log";
 
+//! Directory with zstd dictionaries for encoding text sections of reports.
+const QString SectionDictionaryLocation = "/usr/share/crash-reporter/dictionaries";
+
+//! Subdirectory of a core directory where broken reports are moved to.
+const QString QuarantineDirName = "quarantine";
+
+//! Subdirectory of a core directory with section indexes of the reports.
+const QString IndexDirName = "index";
+
+//! File in a core directory with the fraction of endurance sessions without
+//! anomalies that the server wants in full.
+const QString EnduranceSamplingRateFile = "endurance-sampling-rate";
+
+//! File in a core directory with ids of the section dictionaries the server
+//! can decode, one per line.
+const QString ServerDictionariesFile = "server-dictionaries";
+
+//! File in a core directory with the endurance snapshot formats the server
+//! can read, one per line.
+const QString EnduranceFormatsFile = "endurance-formats";
+
 #ifndef CREPORTER_UNIT_TEST
 //! Dialog server service name
 const QString DialogServerServiceName = "com.nokia.CrashReporter.DialogServer";
@@ -0,0 +1,407 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creporterenduranceanalyzer.h"
+
+#include <algorithm>
+
+#include <QFile>
+#include <QHash>
+#include <QList>
+
+#include "creporterlzoreader.h"
+#include "creportersnapshotstore.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+const char CReporterEnduranceAnalyzer::SummarySection[] = "endurance-summary";
+
+namespace {
+
+const double DefaultRssThreshold = 1024; // kB per hour
+const double DefaultFdThreshold = 10; // per hour
+const double DefaultThreadThreshold = 2; // per hour
+const int DefaultMinSamples = 4;
+//! Coefficient of determination of a steady growth, one-off jumps fit
+//! the regression line worse.
+const double MinFitQuality = 0.5;
+//! Fastest growing processes listed in the summary besides anomalous ones.
+const int TopProcessCount = 10;
+//! Assumed time between snapshots that don't record uptime.
+const double DefaultSnapshotInterval = 3600; // seconds
+
+enum Metric {
+    Threads,
+    Rss,
+    Fds,
+    MetricCount
+};
+
+/*!
+ * Running sums of a linear regression of a value against time.
+ */
+struct Trend
+{
+    Trend() : n(0), st(0), stt(0), sy(0), syy(0), sty(0), last(0) {}
+
+    void add(double t, double y)
+    {
+        ++n;
+        st += t;
+        stt += t * t;
+        sy += y;
+        syy += y * y;
+        sty += t * y;
+        last = y;
+    }
+
+    //! Growth per hour.
+    double slope() const
+    {
+        double var = n * stt - st * st;
+        return var > 0 ? (n * sty - st * sy) / var * 3600 : 0;
+    }
+
+    //! Coefficient of determination, 0-1.
+    double fit() const
+    {
+        double vart = n * stt - st * st;
+        double vary = n * syy - sy * sy;
+        double cov = n * sty - st * sy;
+        return vart > 0 && vary > 0 ? cov * cov / (vart * vary) : 0;
+    }
+
+    int n;
+    double st, stt, sy, syy, sty;
+    double last;
+};
+
+struct ProcessTrend
+{
+    QByteArray pid;
+    QByteArray name;
+    Trend metrics[MetricCount];
+};
+
+//! Process listed in the summary.
+struct ListedProcess
+{
+    const ProcessTrend *process;
+    bool anomalous;
+};
+
+bool growsFaster(const ListedProcess &a, const ListedProcess &b)
+{
+    if (a.anomalous != b.anomalous) {
+        return a.anomalous;
+    }
+    return a.process->metrics[Rss].slope() > b.process->metrics[Rss].slope();
+}
+
+QByteArray readSnapshotFile(const QString &path)
+{
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly)) {
+        return file.readAll();
+    }
+
+    CReporterLzoReader reader(path + ".lzo");
+    if (reader.open(QIODevice::ReadOnly)) {
+        QByteArray data(reader.readAll());
+        if (!reader.hasError()) {
+            return data;
+        }
+        qCWarning(cr) << "Broken lzop file" << path + ".lzo";
+    }
+
+    return QByteArray();
+}
+
+}
+
+/*!
+ * @class CReporterEnduranceAnalyzerPrivate
+ * @brief Private CReporterEnduranceAnalyzer class.
+ *
+ * @sa CReporterEnduranceAnalyzer
+ */
+class CReporterEnduranceAnalyzerPrivate
+{
+public:
+    CReporterEnduranceAnalyzerPrivate();
+
+    //! @arg Anomaly thresholds per hour, indexed by Metric.
+    double thresholds[MetricCount];
+    //! @arg Snapshots a process has to appear in to be judged.
+    int minSamples;
+    //! @arg Number of snapshots added.
+    int snapshots;
+    //! @arg Time of the first and the last snapshot.
+    double firstTime;
+    double lastTime;
+    //! @arg Trends by pid and name, pids get reused.
+    QHash<QByteArray, ProcessTrend> processes;
+
+    /*!
+     * Checks whether @a process grows faster than the thresholds.
+     */
+    bool isAnomalous(const ProcessTrend &process) const;
+
+    /*!
+     * Starts snapshot taken at @a time.
+     *
+     * @return Time relative to the first snapshot.
+     */
+    double beginSnapshot(double time);
+
+    /*!
+     * Adds line of processes.csv taken at relative time @a t.
+     */
+    void addLine(const QByteArray &line, double t);
+
+    /*!
+     * Adds figures of a process, indexed by Metric, negative if unknown.
+     */
+    void addSample(const QByteArray &pid, const QByteArray &name,
+                   const long values[MetricCount], double t);
+};
+
+CReporterEnduranceAnalyzerPrivate::CReporterEnduranceAnalyzerPrivate()
+    : minSamples(DefaultMinSamples), snapshots(0), firstTime(0), lastTime(0)
+{
+    thresholds[Threads] = DefaultThreadThreshold;
+    thresholds[Rss] = DefaultRssThreshold;
+    thresholds[Fds] = DefaultFdThreshold;
+}
+
+bool CReporterEnduranceAnalyzerPrivate::isAnomalous(const ProcessTrend &process) const
+{
+    for (int i = 0; i < MetricCount; ++i) {
+        const Trend &trend = process.metrics[i];
+        if (trend.n >= minSamples && trend.slope() > thresholds[i] &&
+                trend.fit() >= MinFitQuality) {
+            return true;
+        }
+    }
+    return false;
+}
+
+double CReporterEnduranceAnalyzerPrivate::beginSnapshot(double time)
+{
+    if (snapshots == 0) {
+        firstTime = time;
+    }
+    lastTime = time;
+    ++snapshots;
+
+    // Regression is computed relative to the first snapshot, sums of large
+    // uptimes would lose precision.
+    return time - firstTime;
+}
+
+void CReporterEnduranceAnalyzerPrivate::addLine(const QByteArray &line, double t)
+{
+    // pid,"name",state,threads,vm_size_kb,vm_rss_kb,fds
+    int nameStart = line.indexOf(",\"");
+    int nameEnd = nameStart < 0 ? -1 : line.indexOf("\",", nameStart + 2);
+    if (nameEnd < 0) {
+        return;
+    }
+
+    QList<QByteArray> fields = line.mid(nameEnd + 2).split(',');
+    if (fields.size() < 5) {
+        return;
+    }
+
+    const int columns[MetricCount] = { 1, 3, 4 };
+    long values[MetricCount];
+    for (int i = 0; i < MetricCount; ++i) {
+        bool ok;
+        values[i] = fields.at(columns[i]).trimmed().toLong(&ok);
+        if (!ok) {
+            values[i] = -1;
+        }
+    }
+
+    addSample(line.left(nameStart), line.mid(nameStart + 2, nameEnd - nameStart - 2),
+              values, t);
+}
+
+void CReporterEnduranceAnalyzerPrivate::addSample(const QByteArray &pid,
+                                                  const QByteArray &name,
+                                                  const long values[MetricCount], double t)
+{
+    QByteArray key(pid + ',' + name);
+
+    QHash<QByteArray, ProcessTrend>::iterator process = processes.find(key);
+    if (process == processes.end()) {
+        process = processes.insert(key, ProcessTrend());
+        process->pid = pid;
+        process->name = name;
+    }
+
+    for (int i = 0; i < MetricCount; ++i) {
+        // Descriptors of some processes can't be counted.
+        if (values[i] >= 0) {
+            process->metrics[i].add(t, values[i]);
+        }
+    }
+}
+
+CReporterEnduranceAnalyzer::CReporterEnduranceAnalyzer()
+    : d_ptr(new CReporterEnduranceAnalyzerPrivate)
+{
+}
+
+CReporterEnduranceAnalyzer::~CReporterEnduranceAnalyzer()
+{
+    delete d_ptr;
+}
+
+void CReporterEnduranceAnalyzer::setThresholds(double rssKbPerHour, double fdsPerHour,
+                                               double threadsPerHour)
+{
+    d_ptr->thresholds[Rss] = rssKbPerHour;
+    d_ptr->thresholds[Fds] = fdsPerHour;
+    d_ptr->thresholds[Threads] = threadsPerHour;
+}
+
+void CReporterEnduranceAnalyzer::setMinSamples(int samples)
+{
+    d_ptr->minSamples = qMax(samples, 2);
+}
+
+bool CReporterEnduranceAnalyzer::addSnapshot(const QString &snapshotDir)
+{
+    Q_D(CReporterEnduranceAnalyzer);
+
+    QByteArray processes(readSnapshotFile(snapshotDir + "/processes.csv"));
+    if (processes.isEmpty()) {
+        qCDebug(cr) << "No per-process data in" << snapshotDir;
+        return false;
+    }
+
+    bool ok;
+    double time = readSnapshotFile(snapshotDir + "/uptime").split(' ').first().toDouble(&ok);
+    if (!ok) {
+        time = d->snapshots > 0 ? d->lastTime + DefaultSnapshotInterval : 0;
+    }
+
+    addProcesses(processes, time);
+    return true;
+}
+
+void CReporterEnduranceAnalyzer::addSnapshotStore(const CReporterSnapshotStore &store)
+{
+    Q_D(CReporterEnduranceAnalyzer);
+
+    for (int segment = 0; segment < store.segmentCount(); ++segment) {
+        double t = d->beginSnapshot(store.uptime(segment));
+
+        for (int i = 0; i < store.processCount(segment); ++i) {
+            long values[MetricCount];
+            values[Threads] = store.value(segment, CReporterSnapshotStore::Threads, i);
+            values[Rss] = store.value(segment, CReporterSnapshotStore::VmRssKb, i);
+            values[Fds] = store.value(segment, CReporterSnapshotStore::Fds, i);
+            d->addSample(QByteArray::number(store.value(segment, CReporterSnapshotStore::Pid, i)),
+                         store.name(segment, i), values, t);
+        }
+    }
+}
+
+void CReporterEnduranceAnalyzer::addProcesses(const QByteArray &processes, double time)
+{
+    Q_D(CReporterEnduranceAnalyzer);
+
+    double t = d->beginSnapshot(time);
+
+    int start = processes.indexOf('\n') + 1;
+    while (start > 0 && start < processes.size()) {
+        int end = processes.indexOf('\n', start);
+        if (end < 0) {
+            end = processes.size();
+        }
+        d->addLine(processes.mid(start, end - start), t);
+        start = end + 1;
+    }
+}
+
+int CReporterEnduranceAnalyzer::snapshotCount() const
+{
+    return d_ptr->snapshots;
+}
+
+bool CReporterEnduranceAnalyzer::isAnomalous() const
+{
+    Q_D(const CReporterEnduranceAnalyzer);
+
+    foreach (const ProcessTrend &process, d->processes) {
+        if (d->isAnomalous(process)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QByteArray CReporterEnduranceAnalyzer::summary() const
+{
+    Q_D(const CReporterEnduranceAnalyzer);
+
+    QList<ListedProcess> listed;
+    bool anomalous = false;
+    for (QHash<QByteArray, ProcessTrend>::const_iterator i = d->processes.constBegin();
+         i != d->processes.constEnd(); ++i) {
+        ListedProcess entry = { &i.value(), d->isAnomalous(i.value()) };
+        anomalous |= entry.anomalous;
+        if (entry.anomalous || i->metrics[Rss].slope() > 0) {
+            listed << entry;
+        }
+    }
+    std::sort(listed.begin(), listed.end(), growsFaster);
+
+    QByteArray summary;
+    summary += "snapshots: " + QByteArray::number(d->snapshots) + '\n';
+    summary += "span: " + QByteArray::number(qRound64(d->lastTime - d->firstTime)) + '\n';
+    summary += "processes: " + QByteArray::number(d->processes.size()) + '\n';
+    summary += QByteArray("anomalous: ") + (anomalous ? "yes" : "no") + '\n';
+    summary += "pid,name,samples,anomalous,rss_kb,rss_kb_per_hour,fds,fds_per_hour,"
+               "threads,threads_per_hour\n";
+
+    int others = 0;
+    foreach (const ListedProcess &entry, listed) {
+        if (!entry.anomalous && ++others > TopProcessCount) {
+            break;
+        }
+        const ProcessTrend *process = entry.process;
+        summary += process->pid + ",\"" + process->name + "\"," +
+                   QByteArray::number(process->metrics[Rss].n) + ',' +
+                   (entry.anomalous ? '1' : '0');
+        const Metric metrics[] = { Rss, Fds, Threads };
+        for (int i = 0; i < MetricCount; ++i) {
+            const Trend &trend = process->metrics[metrics[i]];
+            summary += ',' + QByteArray::number(trend.last, 'f', 0) + ',' +
+                       QByteArray::number(trend.slope(), 'f', 1);
+        }
+        summary += '\n';
+    }
+
+    return summary;
+}
@@ -0,0 +1,122 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERENDURANCEANALYZER_H
+#define CREPORTERENDURANCEANALYZER_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "creporterexport.h"
+
+class CReporterEnduranceAnalyzerPrivate;
+class CReporterSnapshotStore;
+
+/*!
+ * @class CReporterEnduranceAnalyzer
+ * @brief Finds leak trends in a session of endurance snapshots.
+ *
+ * Snapshots are fed one at a time. For every process the analyzer keeps
+ * running sums of a linear regression of RSS, open file descriptors and
+ * threads against time, so memory use depends on the number of processes
+ * only. The session is anomalous when a process grows steadily faster
+ * than a threshold in any of them.
+ *
+ * Per-process data come from the snapshot store of endurance-collect-daemon
+ * or from processes.csv in the snapshot directories, snapshots without
+ * either don't contribute.
+ */
+class CREPORTER_EXPORT CReporterEnduranceAnalyzer
+{
+public:
+    //! Name of the rich core section containing summary().
+    static const char SummarySection[];
+
+    CReporterEnduranceAnalyzer();
+    ~CReporterEnduranceAnalyzer();
+
+    /*!
+     * @brief Sets growth rates above which a process is anomalous.
+     *
+     * @param rssKbPerHour RSS growth, 1024 kB per hour by default.
+     * @param fdsPerHour Descriptor growth, 10 per hour by default.
+     * @param threadsPerHour Thread growth, 2 per hour by default.
+     */
+    void setThresholds(double rssKbPerHour, double fdsPerHour, double threadsPerHour);
+
+    /*!
+     * @brief Sets how many snapshots a process has to appear in to be judged.
+     *
+     * Defaults to 4.
+     */
+    void setMinSamples(int samples);
+
+    /*!
+     * @brief Adds snapshot directory.
+     *
+     * Reads processes.csv and uptime of the snapshot, also lzop compressed.
+     *
+     * @return @c false if the snapshot has no per-process data.
+     */
+    bool addSnapshot(const QString &snapshotDir);
+
+    /*!
+     * @brief Adds all snapshots of a snapshot store.
+     *
+     * The columns are read directly, snapshot times are the uptimes stored
+     * with them.
+     */
+    void addSnapshotStore(const CReporterSnapshotStore &store);
+
+    /*!
+     * @brief Adds per-process data of one snapshot.
+     *
+     * @param processes Content of processes.csv.
+     * @param time Time of the snapshot in seconds, e.g. system uptime.
+     */
+    void addProcesses(const QByteArray &processes, double time);
+
+    /*!
+     * @brief Number of snapshots with per-process data added.
+     */
+    int snapshotCount() const;
+
+    /*!
+     * @brief Checks whether some process grew faster than the thresholds.
+     */
+    bool isAnomalous() const;
+
+    /*!
+     * @brief Compact text record of the session.
+     *
+     * Lists the number and time span of the snapshots, the anomalous
+     * processes and the fastest growing ones with their last values and
+     * growth rates per hour.
+     */
+    QByteArray summary() const;
+
+private:
+    Q_DISABLE_COPY(CReporterEnduranceAnalyzer)
+    Q_DECLARE_PRIVATE(CReporterEnduranceAnalyzer)
+
+    CReporterEnduranceAnalyzerPrivate *d_ptr;
+};
+
+#endif // CREPORTERENDURANCEANALYZER_H
@@ -0,0 +1,469 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creporterendurancepacker.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+
+#include "creporterenduranceanalyzer.h"
+#include "creporterlzoreader.h"
+#include "creporterlzowriter.h"
+#include "creportersnapshotdelta.h"
+#include "creportersnapshotstore.h"
+#include "creportertararchive_p.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+const char CReporterEndurancePacker::SnapshotPackSection[] =
+    "endurance-snapshot-pack.tar.xz";
+const char CReporterEndurancePacker::FormatFile[] = "snapshot-format";
+const char CReporterEndurancePacker::FormatSection[] = "endurance-format";
+
+namespace {
+
+//! Size of chunks the snapshot files are read and compressed in.
+const int CHUNK_SIZE = 256 * 1024;
+
+QByteArray sectionHeader(const char *name)
+{
+    return QByteArray("\n[---rich-core: ") + name + "---]\n";
+}
+
+//! Format of the snapshot in @a dir, empty for endurance-snapshot format.
+QByteArray snapshotFormat(const QString &dir)
+{
+    QString path = dir + '/' + CReporterEndurancePacker::FormatFile;
+
+    QFile file(QFile::exists(path + ".lzo") ? path + ".lzo" : path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+
+    if (!CReporterLzoReader::isLzoStream(file.peek(9))) {
+        return file.readAll();
+    }
+
+    CReporterLzoReader reader(&file);
+    if (!reader.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return reader.readAll();
+}
+
+}
+
+/*!
+ * @class CReporterEndurancePackerPrivate
+ * @brief Private CReporterEndurancePacker class.
+ *
+ * @sa CReporterEndurancePacker
+ */
+class CReporterEndurancePackerPrivate
+{
+public:
+    CReporterEndurancePackerPrivate();
+
+    //! @arg Content of the device-uid section.
+    QByteArray deviceUid;
+    //! @arg Content of the boot-time section.
+    QByteArray bootTime;
+    //! @arg Content of the endurance-summary section.
+    QByteArray summary;
+    //! @arg xz compression preset.
+    int preset;
+    //! @arg Snapshot store archived with the snapshots.
+    QString store;
+    //! @arg Whether files are stored as deltas against previous snapshot.
+    bool deltaEncoding;
+    //! @arg Maximum number of compressing threads.
+    int threads;
+    //! @arg Description of the last error.
+    QString error;
+
+    //! @arg Archive being written.
+    CReporterTarWriter *tar;
+    //! @arg Files of the previous snapshot by path in the snapshot, used
+    //! in delta encoding.
+    QHash<QString, QByteArray> previous;
+    //! @arg Files of the snapshot being packed.
+    QHash<QString, QByteArray> current;
+
+    /*!
+     * Writes the report into @a device.
+     */
+    bool writeReport(const QStringList &snapshotDirs, QIODevice *device);
+
+    /*!
+     * Archives directory with all its contents.
+     *
+     * @param path Path to the directory.
+     * @param name Path of the directory in the archive.
+     */
+    bool addDirectory(const QString &path, const QString &name);
+
+    /*!
+     * Archives regular file. Files compressed with lzop are decompressed and
+     * stored without the .lzo suffix.
+     *
+     * @param path Path to the file.
+     * @param name Path of the file in the archive.
+     */
+    bool addFile(const QString &path, const QString &name);
+
+    /*!
+     * Archives file as delta against the same file of the previous snapshot
+     * if that is smaller. The whole file is read into memory.
+     */
+    bool addDeltaFile(QFile *file, bool lzo, const struct stat &st,
+                      const QString &name);
+};
+
+CReporterEndurancePackerPrivate::CReporterEndurancePackerPrivate()
+    : preset(CReporterEndurancePacker::DefaultPreset), deltaEncoding(false), threads(1),
+      tar(0)
+{
+}
+
+bool CReporterEndurancePackerPrivate::writeReport(const QStringList &snapshotDirs,
+                                                  QIODevice *device)
+{
+    CReporterLzoWriter lzo(device);
+    lzo.setCompressionThreads(threads);
+    CReporterTarWriter writer(&lzo);
+    tar = &writer;
+
+    const char *packSection = deltaEncoding ? CReporterSnapshotDelta::DeltaPackSection
+                                            : CReporterEndurancePacker::SnapshotPackSection;
+
+    // Without snapshots, the report carries just the summary.
+    bool packing = !snapshotDirs.isEmpty();
+    QByteArray format = packing ? snapshotFormat(snapshotDirs.first()) : QByteArray();
+
+    bool ok = lzo.open() &&
+              lzo.write(sectionHeader("device-uid") + deviceUid + '\n') &&
+              lzo.write(sectionHeader("boot-time") + bootTime + '\n') &&
+              (format.isEmpty() ||
+               lzo.write(sectionHeader(CReporterEndurancePacker::FormatSection) + format)) &&
+              (summary.isEmpty() ||
+               lzo.write(sectionHeader(CReporterEnduranceAnalyzer::SummarySection) + summary)) &&
+              (!packing || lzo.write(sectionHeader(packSection)));
+    if (!ok) {
+        error = lzo.errorString();
+    }
+
+    if (ok && packing && !writer.open(preset, threads)) {
+        error = writer.errorString();
+        ok = false;
+    }
+
+    foreach (const QString &dir, snapshotDirs) {
+        ok = ok && addDirectory(dir, QFileInfo(dir).fileName());
+        previous.swap(current);
+        current.clear();
+    }
+
+    if (ok && packing && !store.isEmpty()) {
+        ok = addFile(store, CReporterSnapshotStore::FileName);
+    }
+    previous.clear();
+    current.clear();
+
+    if (ok && packing && !writer.close()) {
+        error = writer.errorString();
+        ok = false;
+    }
+
+    if (ok && !lzo.close()) {
+        error = lzo.errorString();
+        ok = false;
+    }
+
+    tar = 0;
+    return ok;
+}
+
+bool CReporterEndurancePackerPrivate::addDirectory(const QString &path,
+                                                   const QString &name)
+{
+    struct stat st;
+    if (stat(QFile::encodeName(path).constData(), &st) < 0 || !S_ISDIR(st.st_mode)) {
+        error = QString("%1 is not a directory").arg(path);
+        return false;
+    }
+
+    if (!tar->addDirectory(name, st.st_mode, st.st_mtime)) {
+        error = tar->errorString();
+        return false;
+    }
+
+    QDir dir(path);
+    foreach (const QFileInfo &entry,
+             dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden |
+                               QDir::System, QDir::Name)) {
+        QString entryName = name + '/' + entry.fileName();
+        bool ok = true;
+
+        if (entry.isSymLink()) {
+            qCDebug(cr) << "Skipping symbolic link" << entry.filePath();
+        } else if (entry.isDir()) {
+            ok = addDirectory(entry.filePath(), entryName);
+        } else if (entry.isFile()) {
+            ok = addFile(entry.filePath(), entryName);
+        }
+
+        if (!ok) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool CReporterEndurancePackerPrivate::addFile(const QString &path,
+                                              const QString &name)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = QString("Unable to open %1: %2").arg(path, file.errorString());
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(file.handle(), &st) < 0) {
+        error = QString("Unable to stat %1: %2").arg(path, strerror(errno));
+        return false;
+    }
+
+    bool lzo = name.endsWith(".lzo") &&
+               CReporterLzoReader::isLzoStream(file.peek(9));
+
+    if (deltaEncoding) {
+        return addDeltaFile(&file, lzo, st, lzo ? name.left(name.size() - 4) : name);
+    }
+
+    qint64 size = lzo ? CReporterLzoReader::uncompressedSize(path) : st.st_size;
+    if (size < 0) {
+        error = QString("Broken lzop file %1").arg(path);
+        return false;
+    }
+
+    if (!tar->beginFile(lzo ? name.left(name.size() - 4) : name, size,
+                        st.st_mode, st.st_mtime)) {
+        error = tar->errorString();
+        return false;
+    }
+
+    qint64 written = 0;
+
+    if (lzo) {
+        CReporterLzoReader reader(&file);
+        if (!reader.open(QIODevice::ReadOnly)) {
+            error = QString("Unable to decompress %1: %2").arg(path, reader.errorString());
+            return false;
+        }
+        QByteArray block;
+        while (!(block = reader.readBlock()).isEmpty()) {
+            written += block.size();
+            if (written > size) {
+                break;
+            }
+            if (!tar->write(block)) {
+                error = tar->errorString();
+                return false;
+            }
+        }
+        if (reader.hasError()) {
+            error = QString("Unable to decompress %1: %2").arg(path, reader.errorString());
+            return false;
+        }
+    } else {
+        QByteArray chunk(CHUNK_SIZE, Qt::Uninitialized);
+        while (written < size) {
+            qint64 length = file.read(chunk.data(), qMin<qint64>(chunk.size(), size - written));
+            if (length <= 0) {
+                break;
+            }
+            written += length;
+            if (!tar->write(chunk.constData(), length)) {
+                error = tar->errorString();
+                return false;
+            }
+        }
+    }
+
+    if (written != size || !tar->endFile()) {
+        // The size is already in the header, the archive can't continue.
+        error = QString("%1 changed while being packed").arg(path);
+        return false;
+    }
+
+    return true;
+}
+
+bool CReporterEndurancePackerPrivate::addDeltaFile(QFile *file, bool lzo,
+                                                   const struct stat &st,
+                                                   const QString &name)
+{
+    QByteArray data;
+
+    if (lzo) {
+        CReporterLzoReader reader(file);
+        if (!reader.open(QIODevice::ReadOnly)) {
+            error = QString("Unable to decompress %1: %2")
+                    .arg(file->fileName(), reader.errorString());
+            return false;
+        }
+        QByteArray block;
+        while (!(block = reader.readBlock()).isEmpty()) {
+            data.append(block);
+        }
+        if (reader.hasError()) {
+            error = QString("Unable to decompress %1: %2")
+                    .arg(file->fileName(), reader.errorString());
+            return false;
+        }
+    } else {
+        data = file->readAll();
+    }
+
+    CReporterTarEntry entry;
+    entry.name = name;
+    entry.type = CReporterTarEntry::File;
+    entry.mode = st.st_mode;
+    entry.mtime = st.st_mtime;
+    entry.data = data;
+
+    // Path in the snapshot, the same in all snapshots.
+    QString path = name.section('/', 1);
+    QHash<QString, QByteArray>::const_iterator base = previous.constFind(path);
+    if (base != previous.constEnd()) {
+        QByteArray delta = CReporterSnapshotDelta::encode(base.value(), data);
+        if (delta.size() < data.size()) {
+            entry.name += CReporterSnapshotDelta::Suffix;
+            entry.data = delta;
+        }
+    }
+
+    current.insert(path, data);
+
+    if (!tar->addEntry(entry)) {
+        error = tar->errorString();
+        return false;
+    }
+    return true;
+}
+
+CReporterEndurancePacker::CReporterEndurancePacker()
+    : d_ptr(new CReporterEndurancePackerPrivate)
+{
+}
+
+CReporterEndurancePacker::~CReporterEndurancePacker()
+{
+    delete d_ptr;
+}
+
+void CReporterEndurancePacker::setDeviceUid(const QByteArray &uid)
+{
+    d_ptr->deviceUid = uid;
+}
+
+void CReporterEndurancePacker::setBootTime(const QByteArray &bootTime)
+{
+    d_ptr->bootTime = bootTime;
+}
+
+void CReporterEndurancePacker::setSummary(const QByteArray &summary)
+{
+    d_ptr->summary = summary;
+}
+
+void CReporterEndurancePacker::setPreset(int preset)
+{
+    d_ptr->preset = qBound(0, preset, 9);
+}
+
+void CReporterEndurancePacker::setCompressionThreads(int threads)
+{
+    d_ptr->threads = qMax(threads, 1);
+}
+
+void CReporterEndurancePacker::setDeltaEncoding(bool enabled)
+{
+    d_ptr->deltaEncoding = enabled;
+}
+
+void CReporterEndurancePacker::setSnapshotStore(const QString &filePath)
+{
+    d_ptr->store = filePath;
+}
+
+bool CReporterEndurancePacker::pack(const QStringList &snapshotDirs,
+                                    const QString &filePath)
+{
+    Q_D(CReporterEndurancePacker);
+
+    d->error.clear();
+
+    QString tempPath(filePath + ".tmp");
+    QFile file(tempPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        d->error = QString("Unable to create %1: %2").arg(tempPath, file.errorString());
+        return false;
+    }
+
+    bool ok = d->writeReport(snapshotDirs, &file);
+
+    if (ok && (!file.flush() || fdatasync(file.handle()) < 0)) {
+        d->error = QString("Unable to write %1: %2").arg(tempPath, strerror(errno));
+        ok = false;
+    }
+    file.close();
+
+    if (ok && ::rename(QFile::encodeName(tempPath).constData(),
+                       QFile::encodeName(filePath).constData()) < 0) {
+        d->error = QString("Unable to rename %1: %2").arg(tempPath, strerror(errno));
+        ok = false;
+    }
+
+    if (!ok) {
+        qCWarning(cr) << "Packing endurance snapshots failed:" << d->error;
+        QFile::remove(tempPath);
+        return false;
+    }
+
+    qCDebug(cr) << "Packed" << snapshotDirs.size() << "endurance snapshots into"
+                << filePath;
+    return true;
+}
+
+QString CReporterEndurancePacker::errorString() const
+{
+    return d_ptr->error;
+}
@@ -0,0 +1,141 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERENDURANCEPACKER_H
+#define CREPORTERENDURANCEPACKER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+#include "creporterexport.h"
+
+class CReporterEndurancePackerPrivate;
+
+/*!
+ * @class CReporterEndurancePacker
+ * @brief Packs endurance snapshots into an endurance report.
+ *
+ * The report is a rich core with device-uid, boot-time, optionally
+ * endurance-format and endurance-summary, and endurance-snapshot-pack.tar.xz
+ * sections. Snapshot directories are archived
+ * with tar and compressed with xz, files the snapshot tool compressed with
+ * lzop are stored decompressed. Everything is done in one pass: snapshot
+ * files are read once, the report is the only file written and memory use
+ * doesn't depend on the size of the snapshots.
+ */
+class CREPORTER_EXPORT CReporterEndurancePacker
+{
+public:
+    //! Name of the section containing the snapshots.
+    static const char SnapshotPackSection[];
+    //! File in the snapshots of endurance-collect-daemon naming their format,
+    //! which differs from the one of endurance-snapshot.
+    static const char FormatFile[];
+    //! Name of the section with the content of FormatFile of the first
+    //! snapshot. Left out for the snapshots of endurance-snapshot.
+    static const char FormatSection[];
+    //! xz preset used by default, same as "xz -0".
+    static const int DefaultPreset = 0;
+
+    CReporterEndurancePacker();
+    ~CReporterEndurancePacker();
+
+    /*!
+     * @brief Sets content of the device-uid section.
+     */
+    void setDeviceUid(const QByteArray &uid);
+
+    /*!
+     * @brief Sets content of the boot-time section.
+     *
+     * @param bootTime Boot time of the session, as in btime of /proc/stat.
+     */
+    void setBootTime(const QByteArray &bootTime);
+
+    /*!
+     * @brief Sets content of the endurance-summary section.
+     *
+     * The section is left out if @a summary is empty, which is the default.
+     *
+     * @sa CReporterEnduranceAnalyzer::summary()
+     */
+    void setSummary(const QByteArray &summary);
+
+    /*!
+     * @brief Sets xz compression preset, 0-9.
+     */
+    void setPreset(int preset);
+
+    /*!
+     * @brief Sets maximum number of threads compressing the report.
+     *
+     * Both the xz compressed pack and the lzop stream around it are
+     * compressed in independent blocks on up to @a threads threads. The
+     * report stays readable by xz and lzop. Defaults to 1.
+     */
+    void setCompressionThreads(int threads);
+
+    /*!
+     * @brief Stores snapshot files as deltas against the previous snapshot.
+     *
+     * The pack is written into CReporterSnapshotDelta::DeltaPackSection
+     * instead of SnapshotPackSection. Files are then read into memory whole.
+     * Disabled by default.
+     *
+     * @sa CReporterSnapshotDelta
+     */
+    void setDeltaEncoding(bool enabled);
+
+    /*!
+     * @brief Sets snapshot store to archive along with the snapshots.
+     *
+     * The store is archived as CReporterSnapshotStore::FileName next to
+     * the snapshot directories. None by default.
+     */
+    void setSnapshotStore(const QString &filePath);
+
+    /*!
+     * @brief Writes endurance report.
+     *
+     * The report is written under a temporary name and renamed when
+     * complete, so a partial report never appears in the core directory.
+     *
+     * @param snapshotDirs Snapshot directories, archived in the given order
+     *        under their own names. If empty, the report has no snapshot
+     *        pack section.
+     * @param filePath Path of the *.rcore.lzo file to create.
+     * @return @c true on success, otherwise see errorString().
+     */
+    bool pack(const QStringList &snapshotDirs, const QString &filePath);
+
+    /*!
+     * @brief Description of the last error.
+     */
+    QString errorString() const;
+
+private:
+    Q_DISABLE_COPY(CReporterEndurancePacker)
+    Q_DECLARE_PRIVATE(CReporterEndurancePacker)
+
+    CReporterEndurancePackerPrivate *d_ptr;
+};
+
+#endif // CREPORTERENDURANCEPACKER_H
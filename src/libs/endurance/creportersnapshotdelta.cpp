@@ -0,0 +1,432 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creportersnapshotdelta.h"
+
+#include <algorithm>
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <QFile>
+#include <QHash>
+#include <QVector>
+
+#include "creporterendurancepacker.h"
+#include "creporterlzowriter.h"
+#include "creporterrichcorereader.h"
+#include "creportersnapshotstore.h"
+#include "creportertararchive_p.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+const char CReporterSnapshotDelta::Suffix[] = ".delta";
+const char CReporterSnapshotDelta::DeltaPackSection[] =
+    "endurance-snapshot-pack.delta.tar.xz";
+
+namespace {
+
+//! First line of every delta.
+const QByteArray DELTA_MAGIC("snapshot-delta 1\n");
+
+const QByteArray SECTION_MARKER("\n[---rich-core: ");
+const QByteArray SECTION_HEADER_END("---]\n");
+
+// Delta operations, each followed by a line count and a newline.
+//! Copy lines from the base.
+const char OP_COPY = '=';
+//! Skip lines of the base.
+const char OP_SKIP = '-';
+//! Insert lines following the operation.
+const char OP_INSERT = '+';
+
+//! Number of later occurrences of a line tried when looking for a match.
+const int MAX_RESYNC_CANDIDATES = 8;
+
+/*!
+ * Line of data, including the terminating newline if it has one.
+ */
+struct Line
+{
+    int start;
+    int length;
+};
+
+QVector<Line> splitLines(const QByteArray &data)
+{
+    QVector<Line> lines;
+    int start = 0;
+    while (start < data.size()) {
+        int end = data.indexOf('\n', start);
+        end = (end < 0) ? data.size() : end + 1;
+        Line line = { start, end - start };
+        lines.append(line);
+        start = end;
+    }
+    return lines;
+}
+
+QByteArray lineData(const QByteArray &data, const Line &line)
+{
+    return QByteArray::fromRawData(data.constData() + line.start, line.length);
+}
+
+bool sameLine(const QByteArray &a, const Line &la, const QByteArray &b, const Line &lb)
+{
+    return la.length == lb.length &&
+           memcmp(a.constData() + la.start, b.constData() + lb.start, la.length) == 0;
+}
+
+void appendOp(QByteArray *delta, char op, int count)
+{
+    delta->append(op);
+    delta->append(QByteArray::number(count));
+    delta->append('\n');
+}
+
+bool writeSectionHeader(CReporterLzoWriter *writer, const QString &name)
+{
+    return writer->write(SECTION_MARKER + name.toUtf8() + SECTION_HEADER_END);
+}
+
+/*!
+ * Adds processes.csv of every snapshot in the store to the archive, as
+ * snapshots without the store had them.
+ */
+bool exportStore(const CReporterTarEntry &storeEntry, CReporterTarWriter *out,
+                 QString *error)
+{
+    CReporterSnapshotStore store;
+    store.setData(storeEntry.data);
+
+    for (int i = 0; i < store.segmentCount(); ++i) {
+        CReporterTarEntry entry;
+        entry.name = QString("%1/processes.csv").arg(store.snapshotNumber(i), 3, 10, QChar('0'));
+        entry.type = CReporterTarEntry::File;
+        entry.mode = storeEntry.mode;
+        entry.mtime = store.time(i);
+        entry.data = store.exportProcesses(i);
+        if (!out->addEntry(entry)) {
+            *error = out->errorString();
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * Restores plain snapshot pack from delta encoded one.
+ */
+bool decodePack(CReporterRichCoreReader *reader, CReporterLzoWriter *writer,
+                QString *error)
+{
+    CReporterTarReader in;
+    CReporterTarWriter out(writer);
+    if (!in.open()) {
+        *error = in.errorString();
+        return false;
+    }
+    if (!out.open(CReporterEndurancePacker::DefaultPreset)) {
+        *error = out.errorString();
+        return false;
+    }
+
+    // Files of the previous and the current snapshot, by path in snapshot.
+    QHash<QString, QByteArray> previous;
+    QHash<QString, QByteArray> current;
+    QString snapshot;
+    QList<CReporterTarEntry> entries;
+
+    QByteArray chunk;
+    while (!(chunk = reader->readSectionChunk()).isEmpty()) {
+        entries.clear();
+        if (!in.feed(chunk.constData(), chunk.size(), &entries)) {
+            *error = in.errorString();
+            return false;
+        }
+
+        foreach (CReporterTarEntry entry, entries) {
+            QString top = entry.name.section('/', 0, 0);
+            QString path = entry.name.section('/', 1);
+            if (top != snapshot) {
+                previous.swap(current);
+                current.clear();
+                snapshot = top;
+            }
+
+            if (entry.type == CReporterTarEntry::File &&
+                    path.endsWith(CReporterSnapshotDelta::Suffix)) {
+                path.chop(qstrlen(CReporterSnapshotDelta::Suffix));
+                QByteArray data;
+                if (!CReporterSnapshotDelta::decode(previous.value(path), entry.data, &data)) {
+                    *error = QString("Broken delta of %1").arg(entry.name);
+                    return false;
+                }
+                entry.name = top + '/' + path;
+                entry.data = data;
+            }
+
+            if (entry.type == CReporterTarEntry::File) {
+                current.insert(path, entry.data);
+            }
+
+            if (!out.addEntry(entry)) {
+                *error = out.errorString();
+                return false;
+            }
+
+            if (entry.type == CReporterTarEntry::File &&
+                    entry.name == CReporterSnapshotStore::FileName &&
+                    !exportStore(entry, &out, error)) {
+                return false;
+            }
+        }
+    }
+
+    if (!in.finish()) {
+        *error = in.errorString();
+        return false;
+    }
+    if (!out.close()) {
+        *error = out.errorString();
+        return false;
+    }
+    return true;
+}
+
+}
+
+QByteArray CReporterSnapshotDelta::encode(const QByteArray &base, const QByteArray &data)
+{
+    QVector<Line> baseLines = splitLines(base);
+    QVector<Line> dataLines = splitLines(data);
+
+    // Where each line occurs in the base, in ascending order.
+    QHash<QByteArray, QVector<int> > positions;
+    positions.reserve(baseLines.size());
+    for (int j = 0; j < baseLines.size(); ++j) {
+        positions[lineData(base, baseLines.at(j))].append(j);
+    }
+
+    QByteArray delta(DELTA_MAGIC);
+    delta.reserve(data.size() / 4);
+
+    int i = 0;
+    int j = 0;
+    int literalStart = 0;
+    int literalCount = 0;
+
+    while (i < dataLines.size()) {
+        if (j < baseLines.size() &&
+                sameLine(data, dataLines.at(i), base, baseLines.at(j))) {
+            if (literalCount > 0) {
+                appendOp(&delta, OP_INSERT, literalCount);
+                delta.append(data.constData() + literalStart,
+                             dataLines.at(i).start - literalStart);
+                literalCount = 0;
+            }
+
+            int run = 0;
+            while (i < dataLines.size() && j < baseLines.size() &&
+                    sameLine(data, dataLines.at(i), base, baseLines.at(j))) {
+                ++i;
+                ++j;
+                ++run;
+            }
+            appendOp(&delta, OP_COPY, run);
+            continue;
+        }
+
+        // Lines were removed or changed, look for this one later in the base.
+        // A match counts only if the next line matches too, so that common
+        // lines don't cause jumps.
+        int resync = -1;
+        QHash<QByteArray, QVector<int> >::const_iterator found =
+            positions.constFind(lineData(data, dataLines.at(i)));
+        if (found != positions.constEnd()) {
+            const QVector<int> &candidates = found.value();
+            QVector<int>::const_iterator p =
+                std::upper_bound(candidates.constBegin(), candidates.constEnd(), j);
+            for (int tries = 0; p != candidates.constEnd() && tries < MAX_RESYNC_CANDIDATES;
+                    ++p, ++tries) {
+                if (i + 1 == dataLines.size() ||
+                        (*p + 1 < baseLines.size() &&
+                         sameLine(data, dataLines.at(i + 1), base, baseLines.at(*p + 1)))) {
+                    resync = *p;
+                    break;
+                }
+            }
+        }
+
+        if (resync >= 0) {
+            if (literalCount > 0) {
+                appendOp(&delta, OP_INSERT, literalCount);
+                delta.append(data.constData() + literalStart,
+                             dataLines.at(i).start - literalStart);
+                literalCount = 0;
+            }
+            appendOp(&delta, OP_SKIP, resync - j);
+            j = resync;
+            continue;
+        }
+
+        if (literalCount == 0) {
+            literalStart = dataLines.at(i).start;
+        }
+        ++literalCount;
+        ++i;
+    }
+
+    if (literalCount > 0) {
+        appendOp(&delta, OP_INSERT, literalCount);
+        delta.append(data.constData() + literalStart, data.size() - literalStart);
+    }
+
+    return delta;
+}
+
+bool CReporterSnapshotDelta::decode(const QByteArray &base, const QByteArray &delta,
+                                    QByteArray *data)
+{
+    if (!delta.startsWith(DELTA_MAGIC)) {
+        return false;
+    }
+
+    QVector<Line> baseLines = splitLines(base);
+    int j = 0;
+    int pos = DELTA_MAGIC.size();
+
+    data->clear();
+
+    while (pos < delta.size()) {
+        char op = delta.at(pos);
+        int eol = delta.indexOf('\n', pos);
+        if (eol < 0) {
+            return false;
+        }
+        bool ok = false;
+        int count = delta.mid(pos + 1, eol - pos - 1).toInt(&ok);
+        if (!ok || count < 0) {
+            return false;
+        }
+        pos = eol + 1;
+
+        switch (op) {
+        case OP_COPY:
+            if (count > baseLines.size() - j) {
+                return false;
+            }
+            if (count > 0) {
+                const Line &last = baseLines.at(j + count - 1);
+                int start = baseLines.at(j).start;
+                data->append(base.constData() + start, last.start + last.length - start);
+            }
+            j += count;
+            break;
+        case OP_SKIP:
+            if (count > baseLines.size() - j) {
+                return false;
+            }
+            j += count;
+            break;
+        case OP_INSERT: {
+            int start = pos;
+            for (int k = 0; k < count; ++k) {
+                if (pos >= delta.size()) {
+                    return false;
+                }
+                int end = delta.indexOf('\n', pos);
+                pos = (end < 0) ? delta.size() : end + 1;
+            }
+            data->append(delta.constData() + start, pos - start);
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool CReporterSnapshotDelta::decodeReport(const QString &sourcePath,
+                                          const QString &targetPath, QString *error)
+{
+    QString message;
+    if (!error) {
+        error = &message;
+    }
+    error->clear();
+
+    CReporterRichCoreReader reader(sourcePath);
+
+    QString tempPath(targetPath + ".tmp");
+    QFile file(tempPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        *error = QString("Unable to create %1: %2").arg(tempPath, file.errorString());
+        return false;
+    }
+
+    CReporterLzoWriter writer(&file);
+    bool ok = writer.open();
+
+    while (ok && reader.nextSection()) {
+        QString name = reader.sectionName();
+
+        if (name == DeltaPackSection) {
+            ok = writeSectionHeader(&writer, CReporterEndurancePacker::SnapshotPackSection) &&
+                 decodePack(&reader, &writer, error);
+            continue;
+        }
+
+        ok = writeSectionHeader(&writer, name);
+        QByteArray chunk;
+        while (ok && !(chunk = reader.readSectionChunk()).isEmpty()) {
+            ok = writer.write(chunk);
+        }
+    }
+
+    if (ok && reader.hasError()) {
+        *error = reader.errorString();
+        ok = false;
+    }
+    if (ok && !writer.close()) {
+        ok = false;
+    }
+    if (!ok && error->isEmpty()) {
+        *error = writer.errorString();
+    }
+
+    file.close();
+
+    if (ok && ::rename(QFile::encodeName(tempPath).constData(),
+                       QFile::encodeName(targetPath).constData()) < 0) {
+        *error = QString("Unable to rename %1: %2").arg(tempPath, strerror(errno));
+        ok = false;
+    }
+
+    if (!ok) {
+        qCWarning(cr) << "Decoding" << sourcePath << "failed:" << *error;
+        QFile::remove(tempPath);
+    }
+    return ok;
+}
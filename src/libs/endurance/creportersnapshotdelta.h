@@ -0,0 +1,88 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERSNAPSHOTDELTA_H
+#define CREPORTERSNAPSHOTDELTA_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "creporterexport.h"
+
+/*!
+ * @class CReporterSnapshotDelta
+ * @brief Line based delta encoding of endurance snapshot files.
+ *
+ * Consecutive endurance snapshots contain the same /proc files with small
+ * changes. A file can be stored as a delta against the same file of the
+ * previous snapshot: runs of lines equal to the previous version are
+ * replaced by their count, only new and changed lines are stored.
+ *
+ * In a delta encoded snapshot pack the first snapshot is stored in full,
+ * files of later snapshots get @c Suffix appended to their name if they are
+ * stored as delta. decodeReport() turns such a report back into one with a
+ * plain snapshot pack.
+ */
+class CREPORTER_EXPORT CReporterSnapshotDelta
+{
+public:
+    //! Suffix of the names of delta encoded files in the snapshot pack.
+    static const char Suffix[];
+    //! Name of the section containing delta encoded snapshot pack.
+    static const char DeltaPackSection[];
+
+    /*!
+     * @brief Encodes @a data as delta against @a base.
+     *
+     * @return Delta, possibly larger than @a data if the two have little in
+     *         common.
+     */
+    static QByteArray encode(const QByteArray &base, const QByteArray &data);
+
+    /*!
+     * @brief Applies delta created by encode().
+     *
+     * @param base Data the delta was created against.
+     * @param delta Encoded delta.
+     * @param data Decoded data are stored here.
+     * @return @c false if @a delta is broken or doesn't fit @a base.
+     */
+    static bool decode(const QByteArray &base, const QByteArray &delta,
+                       QByteArray *data);
+
+    /*!
+     * @brief Rewrites endurance report with plain snapshot pack.
+     *
+     * Other sections are copied unchanged. Reports without a delta encoded
+     * snapshot pack are copied as they are. Snapshot store in the pack is
+     * also exported into processes.csv of each snapshot.
+     *
+     * @param sourcePath Report with delta encoded snapshot pack.
+     * @param targetPath Report to create.
+     * @param error Description of the problem on failure.
+     */
+    static bool decodeReport(const QString &sourcePath, const QString &targetPath,
+                             QString *error = 0);
+
+private:
+    CReporterSnapshotDelta();
+};
+
+#endif // CREPORTERSNAPSHOTDELTA_H
@@ -0,0 +1,280 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creportersnapshotstore.h"
+
+#include <string.h>
+
+#include <QFile>
+#include <QVector>
+#include <QtEndian>
+
+#include "creporterchecksum.h"
+#include "creportersnapshotstore_p.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+const char CReporterSnapshotStore::FileName[] = SNAPSHOT_STORE_FILE_NAME;
+const char CReporterSnapshotStore::ProcessesHeader[] =
+    "pid,name,state,threads,vm_size_kb,vm_rss_kb,fds\n";
+
+namespace {
+
+//! Width in bytes of the numeric columns, indexed by Column.
+const int ColumnWidths[] = { 4, 4, 4, 2, 2 };
+const int ColumnCount = sizeof(ColumnWidths) / sizeof(ColumnWidths[0]);
+
+quint32 readU32(const uchar *p)
+{
+    return qFromLittleEndian<quint32>(p);
+}
+
+qint64 padded(qint64 size)
+{
+    return (size + 3) / 4 * 4;
+}
+
+}
+
+/*!
+ * @class CReporterSnapshotStorePrivate
+ * @brief Private CReporterSnapshotStore class.
+ *
+ * @sa CReporterSnapshotStore
+ */
+class CReporterSnapshotStorePrivate
+{
+public:
+    CReporterSnapshotStorePrivate();
+
+    struct Segment
+    {
+        const uchar *header;
+        int count;
+        const uchar *columns[ColumnCount];
+        const uchar *states;
+        //! @arg Start of each name, they are '\0' terminated.
+        QVector<const char *> names;
+    };
+
+    //! @arg Mapped store file.
+    QFile file;
+    //! @arg Store given with setData().
+    QByteArray buffer;
+    //! @arg Valid segments.
+    QVector<Segment> segments;
+
+    /*!
+     * Finds segments in @a size bytes of @a data.
+     */
+    void index(const uchar *data, qint64 size);
+
+    /*!
+     * Checks segment of @a size bytes and finds its columns.
+     */
+    bool parseSegment(const uchar *data, qint64 size, Segment *segment);
+};
+
+CReporterSnapshotStorePrivate::CReporterSnapshotStorePrivate()
+{
+}
+
+void CReporterSnapshotStorePrivate::index(const uchar *data, qint64 size)
+{
+    segments.clear();
+
+    qint64 pos = 0;
+    while (size - pos >= SNAPSHOT_STORE_HEADER_SIZE + 4) {
+        const uchar *header = data + pos;
+        qint64 segmentSize = readU32(header + SNAPSHOT_STORE_SIZE);
+        if (readU32(header) != SNAPSHOT_STORE_MAGIC ||
+                segmentSize < SNAPSHOT_STORE_HEADER_SIZE + 4 || segmentSize > size - pos) {
+            // Rest of an interrupted append.
+            qCDebug(cr) << "Snapshot store ends at offset" << pos << "of" << size;
+            break;
+        }
+
+        Segment segment;
+        if (parseSegment(header, segmentSize, &segment)) {
+            segments << segment;
+        } else {
+            qCWarning(cr) << "Skipping broken snapshot store segment at offset" << pos;
+        }
+        pos += segmentSize;
+    }
+}
+
+bool CReporterSnapshotStorePrivate::parseSegment(const uchar *data, qint64 size,
+                                                 Segment *segment)
+{
+    quint32 checksum = readU32(data + size - 4);
+    if (CReporterChecksum::adler32(1, reinterpret_cast<const char *>(data), size - 4) !=
+            checksum) {
+        return false;
+    }
+
+    qint64 count = readU32(data + SNAPSHOT_STORE_COUNT);
+    qint64 namesSize = readU32(data + SNAPSHOT_STORE_NAMES_SIZE);
+    if (SNAPSHOT_STORE_HEADER_SIZE + padded(count * SNAPSHOT_STORE_ROW_SIZE) +
+            padded(namesSize) + 4 != size) {
+        return false;
+    }
+
+    segment->header = data;
+    segment->count = count;
+
+    const uchar *column = data + SNAPSHOT_STORE_HEADER_SIZE;
+    for (int i = 0; i < ColumnCount; ++i) {
+        segment->columns[i] = column;
+        column += count * ColumnWidths[i];
+    }
+    segment->states = column;
+
+    const char *names = reinterpret_cast<const char *>(
+        data + SNAPSHOT_STORE_HEADER_SIZE + padded(count * SNAPSHOT_STORE_ROW_SIZE));
+    const char *end = names + namesSize;
+    segment->names.reserve(count);
+    for (const char *name = names; segment->names.size() < count; ++name) {
+        segment->names << name;
+        name = static_cast<const char *>(memchr(name, '\0', end - name));
+        if (!name) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+CReporterSnapshotStore::CReporterSnapshotStore()
+    : d_ptr(new CReporterSnapshotStorePrivate)
+{
+}
+
+CReporterSnapshotStore::~CReporterSnapshotStore()
+{
+    delete d_ptr;
+}
+
+bool CReporterSnapshotStore::open(const QString &filePath)
+{
+    Q_D(CReporterSnapshotStore);
+
+    d->segments.clear();
+    d->buffer.clear();
+    d->file.close();
+
+    d->file.setFileName(filePath);
+    if (!d->file.open(QIODevice::ReadOnly)) {
+        qCWarning(cr) << "Unable to open" << filePath << ":" << d->file.errorString();
+        return false;
+    }
+
+    if (d->file.size() == 0) {
+        return true;
+    }
+
+    const uchar *data = d->file.map(0, d->file.size());
+    if (!data) {
+        // Not mappable, e.g. a pipe.
+        d->buffer = d->file.readAll();
+        d->index(reinterpret_cast<const uchar *>(d->buffer.constData()), d->buffer.size());
+    } else {
+        d->index(data, d->file.size());
+    }
+    return true;
+}
+
+void CReporterSnapshotStore::setData(const QByteArray &data)
+{
+    Q_D(CReporterSnapshotStore);
+
+    d->file.close();
+    d->buffer = data;
+    d->index(reinterpret_cast<const uchar *>(d->buffer.constData()), d->buffer.size());
+}
+
+int CReporterSnapshotStore::segmentCount() const
+{
+    return d_ptr->segments.size();
+}
+
+int CReporterSnapshotStore::snapshotNumber(int segment) const
+{
+    return readU32(d_ptr->segments.at(segment).header + SNAPSHOT_STORE_NUMBER);
+}
+
+quint32 CReporterSnapshotStore::uptime(int segment) const
+{
+    return readU32(d_ptr->segments.at(segment).header + SNAPSHOT_STORE_UPTIME);
+}
+
+quint32 CReporterSnapshotStore::time(int segment) const
+{
+    return readU32(d_ptr->segments.at(segment).header + SNAPSHOT_STORE_TIME);
+}
+
+int CReporterSnapshotStore::processCount(int segment) const
+{
+    return d_ptr->segments.at(segment).count;
+}
+
+qint64 CReporterSnapshotStore::value(int segment, Column column, int process) const
+{
+    const uchar *p = d_ptr->segments.at(segment).columns[column] +
+                     process * ColumnWidths[column];
+
+    if (ColumnWidths[column] == 4) {
+        return readU32(p);
+    }
+
+    quint16 value = qFromLittleEndian<quint16>(p);
+    if (column == Fds && value == SNAPSHOT_STORE_FDS_UNKNOWN) {
+        return -1;
+    }
+    return value;
+}
+
+char CReporterSnapshotStore::state(int segment, int process) const
+{
+    return d_ptr->segments.at(segment).states[process];
+}
+
+QByteArray CReporterSnapshotStore::name(int segment, int process) const
+{
+    return QByteArray(d_ptr->segments.at(segment).names.at(process));
+}
+
+QByteArray CReporterSnapshotStore::exportProcesses(int segment) const
+{
+    int count = processCount(segment);
+
+    QByteArray text(ProcessesHeader);
+    text.reserve(count * 64);
+    for (int i = 0; i < count; ++i) {
+        text += QByteArray::number(value(segment, Pid, i)) + ",\"" + name(segment, i) +
+                "\"," + state(segment, i) + ',' +
+                QByteArray::number(value(segment, Threads, i)) + ',' +
+                QByteArray::number(value(segment, VmSizeKb, i)) + ',' +
+                QByteArray::number(value(segment, VmRssKb, i)) + ',' +
+                QByteArray::number(value(segment, Fds, i)) + '\n';
+    }
+    return text;
+}
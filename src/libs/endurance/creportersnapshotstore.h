@@ -0,0 +1,133 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERSNAPSHOTSTORE_H
+#define CREPORTERSNAPSHOTSTORE_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "creporterexport.h"
+
+class CReporterSnapshotStorePrivate;
+
+/*!
+ * @class CReporterSnapshotStore
+ * @brief Reads the columnar store of per-process endurance figures.
+ *
+ * endurance-collect-daemon appends the processes of every snapshot to the
+ * store as one segment, instead of writing a text file into each snapshot
+ * directory. A segment holds fixed-width columns of pids, RSS, VM size,
+ * threads, open descriptors and states, followed by process names, so a
+ * figure of all processes lies in contiguous memory.
+ *
+ * Store files are mapped rather than read. Segments broken by an
+ * interrupted append are skipped.
+ */
+class CREPORTER_EXPORT CReporterSnapshotStore
+{
+public:
+    //! Name of the store in the endurance directory and the snapshot pack.
+    static const char FileName[];
+    //! First line of exportProcesses().
+    static const char ProcessesHeader[];
+
+    //! Numeric columns of a segment.
+    enum Column {
+        Pid,
+        VmRssKb,
+        VmSizeKb,
+        Threads,
+        Fds
+    };
+
+    CReporterSnapshotStore();
+    ~CReporterSnapshotStore();
+
+    /*!
+     * @brief Opens store file.
+     *
+     * @return @c false if the file can't be read.
+     */
+    bool open(const QString &filePath);
+
+    /*!
+     * @brief Reads store from memory, e.g. from a snapshot pack.
+     */
+    void setData(const QByteArray &data);
+
+    /*!
+     * @brief Number of valid segments.
+     */
+    int segmentCount() const;
+
+    /*!
+     * @brief Number of the snapshot directory the segment belongs to.
+     */
+    int snapshotNumber(int segment) const;
+
+    /*!
+     * @brief System uptime in seconds when the snapshot was taken.
+     */
+    quint32 uptime(int segment) const;
+
+    /*!
+     * @brief Wall-clock time when the snapshot was taken.
+     */
+    quint32 time(int segment) const;
+
+    /*!
+     * @brief Number of processes in the segment.
+     */
+    int processCount(int segment) const;
+
+    /*!
+     * @brief Value of a numeric column.
+     *
+     * @return Value, -1 for descriptors that couldn't be counted.
+     */
+    qint64 value(int segment, Column column, int process) const;
+
+    /*!
+     * @brief State of the process as in /proc/<pid>/status, e.g. 'S'.
+     */
+    char state(int segment, int process) const;
+
+    /*!
+     * @brief Name of the process.
+     */
+    QByteArray name(int segment, int process) const;
+
+    /*!
+     * @brief Exports segment to the processes.csv text format.
+     *
+     * The columns are pid, name in double quotes, state, threads, VM size
+     * and RSS in kB and the number of open descriptors.
+     */
+    QByteArray exportProcesses(int segment) const;
+
+private:
+    Q_DISABLE_COPY(CReporterSnapshotStore)
+    Q_DECLARE_PRIVATE(CReporterSnapshotStore)
+
+    CReporterSnapshotStorePrivate *d_ptr;
+};
+
+#endif // CREPORTERSNAPSHOTSTORE_H
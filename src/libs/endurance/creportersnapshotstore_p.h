@@ -0,0 +1,58 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERSNAPSHOTSTORE_P_H
+#define CREPORTERSNAPSHOTSTORE_P_H
+
+// Layout of the endurance snapshot store, shared by endurance-collect-daemon
+// writing it and CReporterSnapshotStore reading it.
+//
+// The store is a sequence of segments, one per snapshot, each appended
+// whole. All numbers are little endian. A segment consists of:
+//
+//   header    u32 magic, u32 size of the segment, u32 snapshot number,
+//             u32 uptime in seconds, u32 wall-clock time, u32 process
+//             count n, u32 size of the name blob
+//   columns   n values each: u32 pid, u32 vm_rss_kb, u32 vm_size_kb,
+//             u16 threads, u16 fds, u8 state, padded to 4 bytes
+//   names     n names terminated by '\0', padded to 4 bytes
+//   checksum  u32 adler32 of everything above
+
+#define SNAPSHOT_STORE_MAGIC       0x47455345 // "ESEG"
+#define SNAPSHOT_STORE_HEADER_SIZE (7 * 4)
+
+// Offsets of the header fields.
+#define SNAPSHOT_STORE_SIZE        4
+#define SNAPSHOT_STORE_NUMBER      8
+#define SNAPSHOT_STORE_UPTIME      12
+#define SNAPSHOT_STORE_TIME        16
+#define SNAPSHOT_STORE_COUNT       20
+#define SNAPSHOT_STORE_NAMES_SIZE  24
+
+// Bytes of the columns per process.
+#define SNAPSHOT_STORE_ROW_SIZE    (3 * 4 + 2 * 2 + 1)
+
+// Value of the fds column when they couldn't be counted.
+#define SNAPSHOT_STORE_FDS_UNKNOWN 0xffff
+
+// Name of the store in the endurance directory and in the snapshot pack.
+#define SNAPSHOT_STORE_FILE_NAME   "processes.store"
+
+#endif // CREPORTERSNAPSHOTSTORE_P_H
@@ -0,0 +1,432 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creportertararchive_p.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <QFile>
+
+#include "creporterlzowriter.h"
+
+namespace {
+
+//! Size of the xz output buffer.
+const int BUFFER_SIZE = 256 * 1024;
+
+/*!
+ * Writes @a value as zero padded octal number filling @a size bytes of the
+ * field, including the terminating NUL.
+ */
+bool setOctal(char *field, int size, qint64 value)
+{
+    char digits[24];
+    int length = snprintf(digits, sizeof(digits), "%0*llo", size - 1,
+                          static_cast<unsigned long long>(value));
+    if (length != size - 1) {
+        return false;
+    }
+    memcpy(field, digits, size);
+    return true;
+}
+
+qint64 octal(const char *field, int size)
+{
+    bool ok = false;
+    qint64 value = QByteArray(field, qstrnlen(field, size)).trimmed().toLongLong(&ok, 8);
+    return ok ? value : -1;
+}
+
+uint headerChecksum(const char *header)
+{
+    // Computed with the checksum field filled with spaces.
+    uint checksum = 8 * ' ';
+    for (int i = 0; i < CReporterTarWriter::BlockSize; ++i) {
+        if (i < 148 || i >= 156) {
+            checksum += static_cast<uchar>(header[i]);
+        }
+    }
+    return checksum;
+}
+
+/*!
+ * Creates POSIX ustar header. Names longer than 100 bytes are split into
+ * prefix and name at a slash.
+ */
+QByteArray tarHeader(const QString &path, char type, qint64 size, uint mode,
+                     qint64 mtime)
+{
+    QByteArray name = QFile::encodeName(path);
+    QByteArray prefix;
+
+    if (name.size() > 100) {
+        // Trailing slash of a directory stays in the name.
+        int slash = name.lastIndexOf('/', qMin(155, name.size() - 2));
+        if (slash <= 0 || name.size() - slash - 1 > 100) {
+            return QByteArray();
+        }
+        prefix = name.left(slash);
+        name = name.mid(slash + 1);
+    }
+
+    QByteArray header(CReporterTarWriter::BlockSize, '\0');
+    char *h = header.data();
+
+    memcpy(h, name.constData(), name.size());
+    bool ok = setOctal(h + 100, 8, mode & 07777) &&
+              setOctal(h + 108, 8, 0) &&
+              setOctal(h + 116, 8, 0) &&
+              setOctal(h + 124, 12, size) &&
+              setOctal(h + 136, 12, qMax<qint64>(0, mtime));
+    if (!ok) {
+        return QByteArray();
+    }
+    h[156] = type;
+    memcpy(h + 257, "ustar", 6);
+    memcpy(h + 263, "00", 2);
+    memcpy(h + 265, "root", 4);
+    memcpy(h + 297, "root", 4);
+    memcpy(h + 345, prefix.constData(), prefix.size());
+
+    setOctal(h + 148, 7, headerChecksum(h));
+    h[155] = ' ';
+
+    return header;
+}
+
+}
+
+CReporterTarEntry::CReporterTarEntry()
+    : type(File), mode(0644), mtime(0)
+{
+}
+
+CReporterTarWriter::CReporterTarWriter(CReporterLzoWriter *output)
+    : output(output), fileSize(0), fileWritten(0), archiveSize(0)
+{
+    lzma_stream init = LZMA_STREAM_INIT;
+    xz = init;
+}
+
+CReporterTarWriter::~CReporterTarWriter()
+{
+    lzma_end(&xz);
+}
+
+bool CReporterTarWriter::open(int preset, int threads)
+{
+    lzma_ret ret;
+    if (threads > 1) {
+        lzma_mt options;
+        memset(&options, 0, sizeof(options));
+        options.threads = threads;
+        options.preset = preset;
+        options.check = LZMA_CHECK_CRC64;
+        // Block size is derived from the preset, three times the dictionary.
+        options.block_size = 0;
+        ret = lzma_stream_encoder_mt(&xz, &options);
+    } else {
+        ret = lzma_easy_encoder(&xz, preset, LZMA_CHECK_CRC64);
+    }
+    if (ret != LZMA_OK) {
+        error = QString("Failed to initialize xz encoder (%1)").arg(ret);
+        return false;
+    }
+
+    buffer.resize(BUFFER_SIZE);
+    fileSize = fileWritten = archiveSize = 0;
+    return true;
+}
+
+bool CReporterTarWriter::addDirectory(const QString &name, uint mode, qint64 mtime)
+{
+    return writeHeader(name + '/', CReporterTarEntry::Directory, 0, mode, mtime);
+}
+
+bool CReporterTarWriter::beginFile(const QString &name, qint64 size, uint mode,
+                                   qint64 mtime)
+{
+    fileSize = size;
+    fileWritten = 0;
+    return writeHeader(name, CReporterTarEntry::File, size, mode, mtime);
+}
+
+bool CReporterTarWriter::write(const char *data, qint64 size)
+{
+    if (fileWritten + size > fileSize) {
+        error = "More data than the size of the file";
+        return false;
+    }
+    fileWritten += size;
+    return writeRaw(data, size);
+}
+
+bool CReporterTarWriter::write(const QByteArray &data)
+{
+    return write(data.constData(), data.size());
+}
+
+bool CReporterTarWriter::endFile()
+{
+    if (fileWritten != fileSize) {
+        error = "Less data than the size of the file";
+        return false;
+    }
+
+    int remainder = archiveSize % BlockSize;
+    return remainder == 0 || writeRaw(QByteArray(BlockSize - remainder, '\0').constData(),
+                                      BlockSize - remainder);
+}
+
+bool CReporterTarWriter::addEntry(const CReporterTarEntry &entry)
+{
+    if (entry.type == CReporterTarEntry::Directory) {
+        return addDirectory(entry.name, entry.mode, entry.mtime);
+    }
+
+    return beginFile(entry.name, entry.data.size(), entry.mode, entry.mtime) &&
+           write(entry.data) && endFile();
+}
+
+bool CReporterTarWriter::close()
+{
+    // Archive ends with two empty blocks.
+    QByteArray end(2 * BlockSize, '\0');
+    bool ok = writeRaw(end.constData(), end.size()) && compress(0, 0, LZMA_FINISH);
+
+    lzma_end(&xz);
+    buffer.clear();
+    return ok;
+}
+
+QString CReporterTarWriter::errorString() const
+{
+    return error;
+}
+
+bool CReporterTarWriter::writeHeader(const QString &name, char type, qint64 size,
+                                     uint mode, qint64 mtime)
+{
+    QByteArray header = tarHeader(name, type, size, mode, mtime);
+    if (header.isEmpty()) {
+        error = QString("Name too long for tar: %1").arg(name);
+        return false;
+    }
+    return writeRaw(header.constData(), header.size());
+}
+
+bool CReporterTarWriter::writeRaw(const char *data, qint64 size)
+{
+    archiveSize += size;
+    return compress(data, size, LZMA_RUN);
+}
+
+bool CReporterTarWriter::compress(const char *data, size_t size, lzma_action action)
+{
+    xz.next_in = reinterpret_cast<const uint8_t *>(data);
+    xz.avail_in = size;
+
+    forever {
+        xz.next_out = reinterpret_cast<uint8_t *>(buffer.data());
+        xz.avail_out = buffer.size();
+
+        lzma_ret ret = lzma_code(&xz, action);
+        if (ret != LZMA_OK && ret != LZMA_STREAM_END) {
+            error = QString("xz compression failed (%1)").arg(ret);
+            return false;
+        }
+
+        size_t produced = buffer.size() - xz.avail_out;
+        if (produced > 0 && !output->write(buffer.constData(), produced)) {
+            error = output->errorString();
+            return false;
+        }
+
+        if (ret == LZMA_STREAM_END ||
+                (action == LZMA_RUN && xz.avail_in == 0 && xz.avail_out > 0)) {
+            return true;
+        }
+    }
+}
+
+CReporterTarReader::CReporterTarReader()
+    : entrySize(0), entryRemaining(0), inEntry(false), archiveEnded(false),
+      streamEnded(false)
+{
+    lzma_stream init = LZMA_STREAM_INIT;
+    xz = init;
+}
+
+CReporterTarReader::~CReporterTarReader()
+{
+    lzma_end(&xz);
+}
+
+bool CReporterTarReader::open()
+{
+    lzma_ret ret = lzma_stream_decoder(&xz, UINT64_MAX, 0);
+    if (ret != LZMA_OK) {
+        error = QString("Failed to initialize xz decoder (%1)").arg(ret);
+        return false;
+    }
+
+    output.resize(BUFFER_SIZE);
+    pending.clear();
+    inEntry = archiveEnded = streamEnded = false;
+    return true;
+}
+
+bool CReporterTarReader::feed(const char *data, qint64 size,
+                              QList<CReporterTarEntry> *entries)
+{
+    if (streamEnded) {
+        if (size > 0) {
+            error = "Garbage after the end of xz stream";
+            return false;
+        }
+        return true;
+    }
+
+    xz.next_in = reinterpret_cast<const uint8_t *>(data);
+    xz.avail_in = size;
+
+    do {
+        xz.next_out = reinterpret_cast<uint8_t *>(output.data());
+        xz.avail_out = output.size();
+
+        lzma_ret ret = lzma_code(&xz, LZMA_RUN);
+        if (ret != LZMA_OK && ret != LZMA_STREAM_END) {
+            error = QString("xz decompression failed (%1)").arg(ret);
+            return false;
+        }
+
+        pending.append(output.constData(), output.size() - xz.avail_out);
+        if (!parse(entries)) {
+            return false;
+        }
+
+        if (ret == LZMA_STREAM_END) {
+            streamEnded = true;
+            if (xz.avail_in > 0) {
+                error = "Garbage after the end of xz stream";
+                return false;
+            }
+            break;
+        }
+    } while (xz.avail_in > 0 || xz.avail_out == 0);
+
+    return true;
+}
+
+bool CReporterTarReader::finish()
+{
+    if (!streamEnded) {
+        error = "Truncated xz stream";
+        return false;
+    }
+    if (!archiveEnded || inEntry) {
+        error = "Truncated tar archive";
+        return false;
+    }
+    return true;
+}
+
+QString CReporterTarReader::errorString() const
+{
+    return error;
+}
+
+bool CReporterTarReader::parse(QList<CReporterTarEntry> *entries)
+{
+    const int blockSize = CReporterTarWriter::BlockSize;
+    int pos = 0;
+
+    while (!archiveEnded) {
+        if (!inEntry) {
+            if (pending.size() - pos < blockSize) {
+                break;
+            }
+
+            const char *h = pending.constData() + pos;
+            pos += blockSize;
+
+            if (h[0] == '\0') {
+                archiveEnded = true;
+                break;
+            }
+
+            if (octal(h + 148, 8) != headerChecksum(h) ||
+                    memcmp(h + 257, "ustar", 5) != 0) {
+                error = "Invalid tar header";
+                return false;
+            }
+
+            QByteArray name(h, qstrnlen(h, 100));
+            QByteArray prefix(h + 345, qstrnlen(h + 345, 155));
+            if (!prefix.isEmpty()) {
+                name = prefix + '/' + name;
+            }
+            if (name.endsWith('/')) {
+                name.chop(1);
+            }
+
+            current = CReporterTarEntry();
+            current.name = QFile::decodeName(name);
+            current.type = h[156] ? h[156] : char(CReporterTarEntry::File);
+            current.mode = octal(h + 100, 8);
+            current.mtime = octal(h + 136, 12);
+            entrySize = octal(h + 124, 12);
+            if (entrySize < 0 || entrySize > INT_MAX - blockSize) {
+                error = "Invalid size in tar header";
+                return false;
+            }
+
+            entryRemaining = (entrySize + blockSize - 1) / blockSize * blockSize;
+            current.data.reserve(entrySize);
+            inEntry = true;
+        }
+
+        int available = qMin<qint64>(entryRemaining, pending.size() - pos);
+        if (entryRemaining > 0 && available == 0) {
+            break;
+        }
+
+        int dataLength = qMin<qint64>(available, entrySize - current.data.size());
+        current.data.append(pending.constData() + pos, dataLength);
+        pos += available;
+        entryRemaining -= available;
+
+        if (entryRemaining == 0) {
+            entries->append(current);
+            current = CReporterTarEntry();
+            inEntry = false;
+        }
+    }
+
+    if (archiveEnded) {
+        // Whatever follows the end of the archive is padding.
+        pending.clear();
+    } else {
+        pending.remove(0, pos);
+    }
+    return true;
+}
@@ -0,0 +1,183 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERTARARCHIVE_P_H
+#define CREPORTERTARARCHIVE_P_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+#include <lzma.h>
+
+class CReporterLzoWriter;
+
+// Streaming access to the xz compressed tar archives of endurance reports.
+
+/*!
+ * @brief Member of a tar archive.
+ */
+struct CReporterTarEntry
+{
+    CReporterTarEntry();
+
+    //! @arg Path in the archive, directories without the trailing slash.
+    QString name;
+    //! @arg Type flag, e.g. CReporterTarEntry::File.
+    char type;
+    //! @arg Permission bits.
+    uint mode;
+    //! @arg Modification time in seconds since the epoch.
+    qint64 mtime;
+    //! @arg Contents of a file.
+    QByteArray data;
+
+    //! Type flags of the entries written.
+    enum Type {
+        File = '0',
+        Directory = '5'
+    };
+};
+
+/*!
+ * @class CReporterTarWriter
+ * @brief Writes xz compressed POSIX tar archive.
+ *
+ * The compressed stream goes to an lzop writer, i.e. into a section of a
+ * rich core. Files can be written in chunks, only their size has to be
+ * known in advance.
+ */
+class CReporterTarWriter
+{
+public:
+    //! Size of tar header and data blocks.
+    static const int BlockSize = 512;
+
+    explicit CReporterTarWriter(CReporterLzoWriter *output);
+    ~CReporterTarWriter();
+
+    /*!
+     * @brief Starts the xz stream.
+     *
+     * With more than one thread the archive is split into xz blocks that
+     * are compressed in parallel. The result is a standard multi-block xz
+     * stream, decompressed like any other.
+     *
+     * @param preset xz compression preset, 0-9.
+     * @param threads Maximum number of compressing threads.
+     */
+    bool open(int preset, int threads = 1);
+
+    bool addDirectory(const QString &name, uint mode, qint64 mtime);
+
+    /*!
+     * @brief Starts a file of @a size bytes, its data follow with write().
+     */
+    bool beginFile(const QString &name, qint64 size, uint mode, qint64 mtime);
+    bool write(const char *data, qint64 size);
+    bool write(const QByteArray &data);
+
+    /*!
+     * @brief Completes the file, fails unless all its data were written.
+     */
+    bool endFile();
+
+    /*!
+     * @brief Adds a directory or a file with all its data.
+     */
+    bool addEntry(const CReporterTarEntry &entry);
+
+    /*!
+     * @brief Terminates the archive and the xz stream.
+     */
+    bool close();
+
+    QString errorString() const;
+
+private:
+    Q_DISABLE_COPY(CReporterTarWriter)
+
+    bool writeHeader(const QString &name, char type, qint64 size, uint mode,
+                     qint64 mtime);
+    bool writeRaw(const char *data, qint64 size);
+    bool compress(const char *data, size_t size, lzma_action action);
+
+    CReporterLzoWriter *output;
+    lzma_stream xz;
+    QByteArray buffer;
+    qint64 fileSize;
+    qint64 fileWritten;
+    qint64 archiveSize;
+    QString error;
+};
+
+/*!
+ * @class CReporterTarReader
+ * @brief Parses xz compressed tar archive fed in chunks.
+ *
+ * Entries are returned once complete, so memory use is bounded by the
+ * largest file in the archive.
+ */
+class CReporterTarReader
+{
+public:
+    CReporterTarReader();
+    ~CReporterTarReader();
+
+    bool open();
+
+    /*!
+     * @brief Decompresses and parses next part of the archive.
+     *
+     * @param data Part of the xz stream.
+     * @param size Size of @a data.
+     * @param entries Completed entries are appended here.
+     */
+    bool feed(const char *data, qint64 size, QList<CReporterTarEntry> *entries);
+
+    /*!
+     * @brief Checks that the whole archive was read.
+     */
+    bool finish();
+
+    QString errorString() const;
+
+private:
+    Q_DISABLE_COPY(CReporterTarReader)
+
+    bool parse(QList<CReporterTarEntry> *entries);
+
+    lzma_stream xz;
+    QByteArray output;
+    //! @arg Decompressed data not parsed yet.
+    QByteArray pending;
+    //! @arg Entry whose data are being read.
+    CReporterTarEntry current;
+    //! @arg Size of the current entry.
+    qint64 entrySize;
+    //! @arg Bytes of the current entry including padding still to read.
+    qint64 entryRemaining;
+    bool inEntry;
+    bool archiveEnded;
+    bool streamEnded;
+    QString error;
+};
+
+#endif // CREPORTERTARARCHIVE_P_H
@@ -26,6 +26,7 @@
  */
 
 #include <QAuthenticator>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QNetworkReply>
@@ -36,11 +37,15 @@
 #include <QSslConfiguration>
 #include <QNetworkProxy>
 #include <QTime>
+#include <QUrlQuery>
 
 #include "creportercoreregistry.h"
 #include "creporterhttpclient.h"
 #include "creporterhttpclient_p.h"
 #include "creporterapplicationsettings.h"
+#include "creporternamespace.h"
+#include "creportersectionencoder.h"
+#include "creportertriagerecord.h"
 #include "creporterutils.h"
 
 using CReporter::LoggingCategory::cr;
@@ -48,10 +53,43 @@ using CReporter::LoggingCategory::cr;
 const char *clientstate_string[] = {"None", "Init", "Connecting", "Sending", "Aborting"};
 const int CONNECTION_TIMEOUT_MS = 2 * 60 * 1000;
 
+namespace {
+
+QString serverDictionariesFile()
+{
+    return CReporterCoreRegistry::instance()->getCoreLocationPaths().first() +
+           '/' + CReporter::ServerDictionariesFile;
+}
+
+/*!
+ * Ids of the section dictionaries the server told it can decode in the
+ * reply to the last upload.
+ */
+QList<quint32> serverDictionaries()
+{
+    QList<quint32> ids;
+
+    QFile file(serverDictionariesFile());
+    if (file.open(QIODevice::ReadOnly)) {
+        foreach (const QByteArray &line, file.readAll().split('\n')) {
+            quint32 id = line.trimmed().toUInt();
+            if (id != 0) {
+                ids << id;
+            }
+        }
+    }
+
+    return ids;
+}
+
+}
+
 CReporterHttpClientPrivate::CReporterHttpClientPrivate(CReporterHttpClient *parent)
     : QObject(parent),
       m_manager(0),
       m_reply(0),
+      m_triageRecord(false),
+      m_coreRequested(false),
       m_connectionTimeout(this),
       q_ptr(parent)
 {
@@ -99,7 +137,7 @@ void CReporterHttpClientPrivate::init(bool deleteAfterSending)
     stateChange(CReporterHttpClient::Init);
 }
 
-bool CReporterHttpClientPrivate::createRequest(const QString &file)
+bool CReporterHttpClientPrivate::createRequest(const QString &file, bool triageRecord)
 {
     Q_ASSERT(m_manager != NULL);
     qCDebug(cr) << "Create new request.";
@@ -125,6 +163,8 @@ bool CReporterHttpClientPrivate::createRequest(const QString &file)
 
     // Set file to be the current.
     m_currentFile.setFile(file);
+    m_triageRecord = triageRecord;
+    m_coreRequested = false;
     qCDebug(cr) << "File to upload:" << m_currentFile.absoluteFilePath();
     qCDebug(cr) << "File size:" << m_currentFile.size() / 1024 << "kB's";
 
@@ -134,8 +174,13 @@ bool CReporterHttpClientPrivate::createRequest(const QString &file)
 
     url.setPath(serverPath);
 
-    url.setQuery("uuid=" + CReporterUtils::deviceUid() +
-                 "&model=" + CReporterUtils::deviceModel());
+    QString query("uuid=" + CReporterUtils::deviceUid() +
+                  "&model=" + CReporterUtils::deviceModel());
+    if (m_triageRecord) {
+        // The record is sent under the name of the report it summarizes.
+        query += "&triage=1";
+    }
+    url.setQuery(query);
 
     request.setUrl(url);
     qCDebug(cr) << "Upload URL:" << url.toString();
@@ -238,6 +283,58 @@ void CReporterHttpClientPrivate::parseReply()
     }
 
     QJsonObject json = reply.object();
+    if (m_triageRecord) {
+        m_coreRequested = json.value("core_requested").toBool(false);
+        qCDebug(cr) << "Server requested full report:" << m_coreRequested;
+    }
+
+    QString corePath(CReporterCoreRegistry::instance()->getCoreLocationPaths().first());
+
+    /* Text sections of reports are encoded for upload only with
+     * dictionaries the server has announced. Servers that don't know about
+     * section encoding don't send the list. */
+    QJsonValue dictionaries = json.value("section_dictionaries");
+    QFile dictionariesFile(serverDictionariesFile());
+    if (dictionaries.isArray()) {
+        if (dictionariesFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            foreach (const QJsonValue &id, dictionaries.toArray()) {
+                dictionariesFile.write(QByteArray::number(qint64(id.toDouble())) + '\n');
+            }
+        } else {
+            qCWarning(cr) << "Couldn't save section dictionaries of the server.";
+        }
+    } else if (dictionariesFile.exists()) {
+        dictionariesFile.remove();
+    }
+
+    // Endurance packing runs as a separate process, it reads the rate the
+    // server asks for from the core directory.
+    QJsonValue samplingRate = json.value("endurance_sampling_rate");
+    if (samplingRate.isDouble()) {
+        QFile rateFile(corePath + '/' + CReporter::EnduranceSamplingRateFile);
+        if (rateFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            rateFile.write(QByteArray::number(qBound(0.0, samplingRate.toDouble(), 1.0)));
+        } else {
+            qCWarning(cr) << "Couldn't save endurance sampling rate.";
+        }
+    }
+
+    /* endurance-collect-daemon switches to the native snapshot format only
+     * after the server has listed it here. */
+    QJsonValue formats = json.value("endurance_formats");
+    QFile formatsFile(corePath + '/' + CReporter::EnduranceFormatsFile);
+    if (formats.isArray()) {
+        if (formatsFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            foreach (const QJsonValue &format, formats.toArray()) {
+                formatsFile.write(format.toString().toUtf8() + '\n');
+            }
+        } else {
+            qCWarning(cr) << "Couldn't save endurance formats of the server.";
+        }
+    } else if (formatsFile.exists()) {
+        formatsFile.remove();
+    }
+
     int submissionId = static_cast<int>(json.value("submission_id").toDouble(0));
     if (submissionId == 0) {
         qCWarning(cr) << "Failed to parse submission id from JSON.";
@@ -249,7 +346,6 @@ void CReporterHttpClientPrivate::parseReply()
     submissionUrl.setPath("/");
     submissionUrl.setFragment(QString("submissions/%1").arg(submissionId));
 
-    QString corePath(CReporterCoreRegistry::instance()->getCoreLocationPaths().first());
     QFile uploadlog(corePath + "/uploadlog");
     if (!uploadlog.open(QIODevice::WriteOnly | QIODevice::Append)) {
         qCWarning(cr) << "Couldn't open uploadlog for writing.";
@@ -272,7 +368,7 @@ void CReporterHttpClientPrivate::handleFinished()
         // Upload was successful.
         parseReply();
 
-        if (m_deleteFileFlag) {
+        if (m_deleteFileFlag && !m_triageRecord) {
             // Remove file if delete was requested.
             CReporterUtils::removeFile(m_currentFile.absoluteFilePath());
         }
@@ -318,15 +414,44 @@ void CReporterHttpClientPrivate::stateChange(CReporterHttpClient::State nextStat
 
 bool CReporterHttpClientPrivate::createPutRequest(QNetworkRequest &request, QByteArray &dataToSend)
 {
-    QFile file(m_currentFile.absoluteFilePath());
-    // Abort, if file doesn't exist or IO error.
-    if (!file.exists() || !file.open(QIODevice::ReadOnly)) {
-        return false;
-    }
+    if (m_triageRecord) {
+        QByteArray record(CReporterTriageRecord::create(m_currentFile.absoluteFilePath()));
+        if (record.isEmpty()) {
+            return false;
+        }
+        dataToSend += record;
+    } else {
+        // Dictionaries are loaded once, encoding is safe from multiple threads.
+        static const CReporterSectionEncoder encoder;
+
+        QByteArray encoded;
+        if (encoder.dictionaryId() != 0 &&
+                serverDictionaries().contains(encoder.dictionaryId())) {
+            encoded = encoder.encodeReport(m_currentFile.absoluteFilePath());
+        }
 
-    // Append file.
-    dataToSend += file.readAll();
-    file.close();
+        if (!encoded.isEmpty()) {
+            // Tell the server which dictionary to decode the sections with.
+            QUrl url(request.url());
+            QUrlQuery query(url);
+            query.addQueryItem("section_dictionary",
+                               QString::number(encoder.dictionaryId()));
+            url.setQuery(query);
+            request.setUrl(url);
+
+            dataToSend += encoded;
+        } else {
+            QFile file(m_currentFile.absoluteFilePath());
+            // Abort, if file doesn't exist or IO error.
+            if (!file.exists() || !file.open(QIODevice::ReadOnly)) {
+                return false;
+            }
+
+            // Append file.
+            dataToSend += file.readAll();
+            file.close();
+        }
+    }
 
     // Construct HTTP Headers.
     request.setRawHeader("User-Agent", "crash-reporter");
@@ -374,7 +499,20 @@ bool CReporterHttpClient::upload(const QString &file)
     Q_D(CReporterHttpClient);
     qCDebug(cr) << "Upload requested.";
 
-    return d->createRequest(file);
+    return d->createRequest(file, false);
+}
+
+bool CReporterHttpClient::uploadTriageRecord(const QString &file)
+{
+    Q_D(CReporterHttpClient);
+    qCDebug(cr) << "Triage record upload requested.";
+
+    return d->createRequest(file, true);
+}
+
+bool CReporterHttpClient::coreRequested() const
+{
+    return d_ptr->m_coreRequested;
 }
 
 void CReporterHttpClient::cancel()
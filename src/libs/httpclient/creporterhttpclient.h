@@ -92,6 +92,16 @@ public:
      */
     QString stateToString(CReporterHttpClient::State state) const;
 
+    /*!
+     * @brief Whether the server asked for the full report after the last
+     * triage record upload.
+     *
+     * @return True, if the full report should be uploaded regardless of
+     *  the network restrictions.
+     * @sa uploadTriageRecord()
+     */
+    bool coreRequested() const;
+
 Q_SIGNALS:
     /*!
      * @brief Sent, when all pending network replies have finished.
@@ -134,6 +144,16 @@ public Q_SLOTS:
      */
     bool upload(const QString &file);
 
+    /*!
+     * @brief Uploads triage record of a crash report to the remote server.
+     *
+     * The record is extracted from @a file and sent under its name. The
+     * report itself is never deleted after a triage record upload.
+     *
+     * @sa CReporterTriageRecord, coreRequested()
+     */
+    bool uploadTriageRecord(const QString &file);
+
     /*!
      * @brief Cancels ongoing request.
      *
@@ -63,9 +63,11 @@ public:
      * @brief Creates a new request sent over the network.
      *
      * @param file File to send.
+     * @param triageRecord If true, triage record of @a file is sent instead
+     *  of the file itself.
      * @sa <a href="http://doc.trolltech.com/4.6/qnetworkrequest.html">QNetworkRequest</a>
      */
-    bool createRequest(const QString &file);
+    bool createRequest(const QString &file, bool triageRecord);
 
     /*!
      * @brief Cancels ongoing request.
@@ -169,6 +171,10 @@ public:
     bool m_deleteFileFlag;
     //! @arg Current file to process.
     QFileInfo m_currentFile;
+    //! @arg True, if triage record of the current file is sent.
+    bool m_triageRecord;
+    //! @arg True, if server replied it wants the full report.
+    bool m_coreRequested;
     //! @arg Client state.
     CReporterHttpClient::State m_clientState;
     /*!
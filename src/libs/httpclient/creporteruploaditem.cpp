@@ -40,16 +40,18 @@ public:
     QString filename;
     QString errorString;
     qint64 filesize;
+    CReporterUploadItem::ItemContent content;
     CReporterHttpClient *http;
     CReporterUploadItem::ItemStatus status;
 };
 
-CReporterUploadItem::CReporterUploadItem(const QString &file)
+CReporterUploadItem::CReporterUploadItem(const QString &file, ItemContent content)
     : d_ptr(new CReporterUploadItemPrivate())
 {
     Q_D(CReporterUploadItem);
 
     d->filepath = file;
+    d->content = content;
     d->http = 0;
 
     QFileInfo fi(d->filepath);
@@ -76,6 +78,16 @@ QString CReporterUploadItem::filename() const
     return d_ptr->filename;
 }
 
+QString CReporterUploadItem::filepath() const
+{
+    return d_ptr->filepath;
+}
+
+CReporterUploadItem::ItemContent CReporterUploadItem::content() const
+{
+    return d_ptr->content;
+}
+
 void CReporterUploadItem::markDone()
 {
     qCDebug(cr) << "Item done.";
@@ -109,7 +121,11 @@ bool CReporterUploadItem::startUpload()
     connect(d->http, SIGNAL(updateProgress(int)), this, SIGNAL(updateProgress(int)));
 
     d->http->initSession();
-    if (d->http->upload(d->filepath)) {
+
+    bool started = (d->content == TriageRecord)
+                   ? d->http->uploadTriageRecord(d->filepath)
+                   : d->http->upload(d->filepath);
+    if (started) {
         setStatus(Sending);
         return true;
     }
@@ -167,6 +183,12 @@ void CReporterUploadItem::uploadError(const QString &file, const QString &errorS
 
 void CReporterUploadItem::emitUploadFinished()
 {
+    Q_D(CReporterUploadItem);
+
+    if (d->content == TriageRecord && d->status == Sending) {
+        emit triageRecordUploaded(d->filepath, d->http->coreRequested());
+    }
+
     setStatus(Finished);
     emit uploadFinished();
 }
@@ -58,12 +58,24 @@ public:
         Cancelled,
     } ItemStatus;
 
+    /*!
+     * @enum ItemContent
+     * @brief What is uploaded for the file.
+     */
+    typedef enum ItemContent {
+        //! The whole file.
+        FullReport = 0,
+        //! Small triage record extracted from the file.
+        TriageRecord,
+    } ItemContent;
+
     /*!
      * @brief Class constructor.
      *
      * @param file Path to file.
+     * @param content What to upload.
      */
-    CReporterUploadItem(const QString &file);
+    CReporterUploadItem(const QString &file, ItemContent content = FullReport);
 
     virtual ~CReporterUploadItem();
 
@@ -81,6 +93,20 @@ public:
      */
     QString filename() const;
 
+    /*!
+     * @brief Returns path to file.
+     *
+     * @return Absolute or relative path as given to the constructor.
+     */
+    QString filepath() const;
+
+    /*!
+     * @brief Returns what is uploaded for the file.
+     *
+     * @return Item content.
+     */
+    CReporterUploadItem::ItemContent content() const;
+
     /*!
      * @brief Marks item as done. Causes to emit done().
      *
@@ -143,6 +169,15 @@ Q_SIGNALS:
      */
     void uploadFinished();
 
+    /*!
+     * @brief Sent before uploadFinished(), when triage record was uploaded
+     * successfully.
+     *
+     * @param file Path to the file the record was extracted from.
+     * @param coreRequested True, if the server asked for the full report.
+     */
+    void triageRecordUploaded(const QString &file, bool coreRequested);
+
 private Q_SLOTS:
     /*!
      * @brief Emits uploadFinished().
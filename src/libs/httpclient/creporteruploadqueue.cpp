@@ -39,6 +39,8 @@ public:
     QQueue<CReporterUploadItem *> uploadQueue;
     bool notified;
     int nbrOfItems;
+    //! Number of prioritized items at the head of uploadQueue.
+    int nbrOfPrioritized;
 };
 
 CReporterUploadQueue::CReporterUploadQueue(QObject *parent)
@@ -49,6 +51,7 @@ CReporterUploadQueue::CReporterUploadQueue(QObject *parent)
     d_ptr->uploadQueue.clear();
     d_ptr->notified = false;
     d_ptr->nbrOfItems = 0;
+    d_ptr->nbrOfPrioritized = 0;
 }
 
 CReporterUploadQueue::~CReporterUploadQueue()
@@ -61,13 +64,18 @@ CReporterUploadQueue::~CReporterUploadQueue()
     d_ptr = 0;
 }
 
-void CReporterUploadQueue::enqueue(CReporterUploadItem *item)
+void CReporterUploadQueue::enqueue(CReporterUploadItem *item, bool prioritized)
 {
     Q_ASSERT(item != 0);
     qCDebug(cr) << "Append new item to queue...";
 
     item->setParent(this);
-    d_ptr->uploadQueue.append(item);
+    if (prioritized) {
+        // Behind the other prioritized items, ahead of the rest.
+        d_ptr->uploadQueue.insert(d_ptr->nbrOfPrioritized++, item);
+    } else {
+        d_ptr->uploadQueue.append(item);
+    }
 
     emit itemAdded(item);
 
@@ -112,6 +120,7 @@ void CReporterUploadQueue::clear()
         QQueue<CReporterUploadItem *> items = d_ptr->uploadQueue;
         // Clear list.
         d_ptr->uploadQueue.clear();
+        d_ptr->nbrOfPrioritized = 0;
         // Delete entries.
         qDeleteAll(items);
     }
@@ -121,6 +130,9 @@ void CReporterUploadQueue::emitNextItem()
 {
     qCDebug(cr) << "Emit nextItem().";
     CReporterUploadItem *item = d_ptr->uploadQueue.dequeue();
+    if (d_ptr->nbrOfPrioritized > 0) {
+        d_ptr->nbrOfPrioritized--;
+    }
 
     emit nextItem(item);
 }
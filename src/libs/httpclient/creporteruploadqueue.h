@@ -52,7 +52,14 @@ public:
 
     ~CReporterUploadQueue();
 
-    void enqueue(CReporterUploadItem *item);
+    /*!
+     * @brief Adds item to the queue.
+     *
+     * @param item Item to upload, queue takes its ownership.
+     * @param prioritized If true, the item is uploaded before all items that
+     *  were enqueued without priority.
+     */
+    void enqueue(CReporterUploadItem *item, bool prioritized = false);
     CReporterUploadItem *dequeue() const;
 
     /*!
@@ -28,7 +28,7 @@ include(../../crash-reporter-conf.pri)
 
 TEMPLATE = lib
 CONFIG += dll
-QT += network dbus
+QT += network dbus concurrent
 
 DEFINES += CREPORTER_EXPORTS
 
@@ -48,9 +48,11 @@ DESTDIR = ../../lib
 
 INCLUDEPATH += . \
                coredir \
+               endurance \
                serviceif \
                utils \
                settings \
+               richcore \
 
 DEPENDPATH = $$INCLUDEPATH
 
@@ -60,7 +62,14 @@ DBUS_INTERFACES = \
 	../autouploader/com.nokia.CrashReporter.AutoUploader.xml \
 
 SOURCES += coredir/creportercoredir.cpp \
+           coredir/creportercorescanner.cpp \
            coredir/creportercoreregistry.cpp \
+           coredir/creportermounttracker.cpp \
+           endurance/creporterenduranceanalyzer.cpp \
+           endurance/creporterendurancepacker.cpp \
+           endurance/creportersnapshotdelta.cpp \
+           endurance/creportersnapshotstore.cpp \
+           endurance/creportertararchive.cpp \
            httpclient/creporterhttpclient.cpp \
            httpclient/creporteruploaditem.cpp \
            httpclient/creporteruploadqueue.cpp \
@@ -74,11 +83,28 @@ SOURCES += coredir/creportercoredir.cpp \
            settings/creporterapplicationsettings.cpp \
            settings/creportersettingsinit.cpp \
            notification/creporternotification.cpp \
+           richcore/creporterchecksum.cpp \
+           richcore/creportercorereducer.cpp \
+           richcore/creporterintegritychecker.cpp \
+           richcore/creporterlzoreader.cpp \
+           richcore/creporterlzowriter.cpp \
+           richcore/creporterrichcoreindex.cpp \
+           richcore/creporterrichcorereader.cpp \
+           richcore/creportersectionencoder.cpp \
+           richcore/creportersectionscanner.cpp \
+           richcore/creporterstacksignature.cpp \
+           richcore/creportertriagerecord.cpp \
 
 # Public headers
 PUBLIC_HEADERS += creporternamespace.h \
                   coredir/creportercoredir.h \
+                  coredir/creportercorescanner.h \
                   coredir/creportercoreregistry.h \
+                  coredir/creportermounttracker.h \
+                  endurance/creporterenduranceanalyzer.h \
+                  endurance/creporterendurancepacker.h \
+                  endurance/creportersnapshotdelta.h \
+                  endurance/creportersnapshotstore.h \
                   httpclient/creporterhttpclient.h \
                   httpclient/creporteruploaditem.h \
                   httpclient/creporteruploadqueue.h \
@@ -94,12 +120,29 @@ PUBLIC_HEADERS += creporternamespace.h \
                   settings/creportersettingsbase.h \
                   settings/creporterapplicationsettings.h \
                   notification/creporternotification.h \
+                  richcore/creporterchecksum.h \
+                  richcore/creportercorereducer.h \
+                  richcore/creporterintegritychecker.h \
+                  richcore/creporterlzoreader.h \
+                  richcore/creporterlzowriter.h \
+                  richcore/creporterrichcoreindex.h \
+                  richcore/creporterrichcorereader.h \
+                  richcore/creportersectionencoder.h \
+                  richcore/creportersectionscanner.h \
+                  richcore/creporterstacksignature.h \
+                  richcore/creportertriagerecord.h \
                   creporterexport.h \
 
 # Local headers
 HEADERS += $$PUBLIC_HEADERS \
            coredir/creportercoredir_p.h \
            coredir/creportercoreregistry_p.h \
+           coredir/creportermounttracker_p.h \
+           endurance/creportersnapshotstore_p.h \
+           endurance/creportertararchive_p.h \
+           richcore/creporterlzop_p.h \
+           richcore/creporterlzoreader_p.h \
+           richcore/creporterrichcorereader_p.h \
             httpclient/creporterhttpclient_p.h \
             httpclient/creporteruploadengine_p.h \
             settings/creportersettingsbase_p.h \
@@ -108,6 +151,9 @@ HEADERS += $$PUBLIC_HEADERS \
 
 LIBS += -lssu
 
+CONFIG += link_pkgconfig
+PKGCONFIG += liblzma lzo2 libzstd
+
 TARGET = $$qtLibraryTarget(crashreporter)
 
 target.path += $$[QT_INSTALL_LIBS]
@@ -0,0 +1,318 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creporterchecksum.h"
+
+#include <QtEndian>
+
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <tmmintrin.h>
+#define CREPORTER_CHECKSUM_SSSE3
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CREPORTER_CHECKSUM_NEON
+#endif
+#if defined(__GNUC__) && defined(__aarch64__)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#define CREPORTER_CHECKSUM_ARMV8_CRC32
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1 << 7)
+#endif
+#endif
+
+namespace {
+
+typedef quint32 (*ChecksumFunction)(quint32 checksum, const uchar *data,
+                                    size_t size);
+
+//! Reversed CRC-32 polynomial.
+const quint32 CRC32_POLYNOMIAL = 0xedb88320;
+
+//! Largest prime smaller than 65536.
+const quint32 ADLER_BASE = 65521;
+//! Most bytes that can be summed before the Adler-32 sums overflow 32 bits.
+const size_t ADLER_NMAX = 5552;
+//! Bytes summed in one step by the vectorized Adler-32 variants.
+const size_t ADLER_BLOCK = 32;
+
+struct Crc32Tables {
+    Crc32Tables()
+    {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? (crc >> 1) ^ CRC32_POLYNOMIAL : crc >> 1;
+            }
+            table[0][i] = crc;
+        }
+        for (int k = 1; k < 8; ++k) {
+            for (int i = 0; i < 256; ++i) {
+                quint32 crc = table[k - 1][i];
+                table[k][i] = (crc >> 8) ^ table[0][crc & 0xff];
+            }
+        }
+    }
+
+    quint32 table[8][256];
+};
+
+quint32 crc32Slicing8(quint32 crc, const uchar *data, size_t size)
+{
+    static const Crc32Tables tables;
+    const quint32 (*t)[256] = tables.table;
+
+    crc = ~crc;
+    for (; size > 0 && (quintptr(data) & 7); --size) {
+        crc = t[0][(crc ^ *data++) & 0xff] ^ (crc >> 8);
+    }
+    for (; size >= 8; size -= 8, data += 8) {
+        quint32 one = qFromLittleEndian<quint32>(data) ^ crc;
+        quint32 two = qFromLittleEndian<quint32>(data + 4);
+        crc = t[7][one & 0xff] ^ t[6][(one >> 8) & 0xff] ^
+              t[5][(one >> 16) & 0xff] ^ t[4][one >> 24] ^
+              t[3][two & 0xff] ^ t[2][(two >> 8) & 0xff] ^
+              t[1][(two >> 16) & 0xff] ^ t[0][two >> 24];
+    }
+    for (; size > 0; --size) {
+        crc = t[0][(crc ^ *data++) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+#if defined(CREPORTER_CHECKSUM_ARMV8_CRC32)
+__attribute__((target("+crc")))
+quint32 crc32Armv8(quint32 crc, const uchar *data, size_t size)
+{
+    crc = ~crc;
+    for (; size > 0 && (quintptr(data) & 7); --size) {
+        crc = __crc32b(crc, *data++);
+    }
+    for (; size >= 8; size -= 8, data += 8) {
+        crc = __crc32d(crc, *reinterpret_cast<const quint64 *>(data));
+    }
+    for (; size > 0; --size) {
+        crc = __crc32b(crc, *data++);
+    }
+    return ~crc;
+}
+#endif
+
+quint32 adler32Scalar(quint32 adler, const uchar *data, size_t size)
+{
+    quint32 s1 = adler & 0xffff;
+    quint32 s2 = adler >> 16;
+
+    while (size > 0) {
+        size_t n = qMin(size, ADLER_NMAX);
+        size -= n;
+        for (; n > 0; --n) {
+            s1 += *data++;
+            s2 += s1;
+        }
+        s1 %= ADLER_BASE;
+        s2 %= ADLER_BASE;
+    }
+
+    return (s2 << 16) | s1;
+}
+
+/*
+ * Vectorized variants process the data in blocks of 32 bytes. For a block
+ * b[0..31] entered with sum s1, Adler-32 adds sum(b) to s1 and
+ * 32 * s1 + sum((32 - i) * b[i]) to s2. Byte sums, their prefix sums over the
+ * blocks and the weighted sums are accumulated in vector lanes and reduced
+ * before the lanes could overflow.
+ */
+
+#if defined(CREPORTER_CHECKSUM_SSSE3)
+__attribute__((target("ssse3")))
+quint64 sumLanes(__m128i lanes)
+{
+    quint32 values[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(values), lanes);
+    return quint64(values[0]) + values[1] + values[2] + values[3];
+}
+
+__attribute__((target("ssse3")))
+quint32 adler32Ssse3(quint32 adler, const uchar *data, size_t size)
+{
+    quint32 s1 = adler & 0xffff;
+    quint32 s2 = adler >> 16;
+
+    const __m128i weightsHigh = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25,
+                                              24, 23, 22, 21, 20, 19, 18, 17);
+    const __m128i weightsLow = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9,
+                                             8, 7, 6, 5, 4, 3, 2, 1);
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i zero = _mm_setzero_si128();
+
+    while (size >= ADLER_BLOCK) {
+        size_t blocks = qMin(size, ADLER_NMAX) / ADLER_BLOCK;
+        size -= blocks * ADLER_BLOCK;
+
+        __m128i sums = zero;
+        __m128i prefixSums = zero;
+        __m128i weightedSums = zero;
+        for (size_t i = 0; i < blocks; ++i, data += ADLER_BLOCK) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16));
+
+            prefixSums = _mm_add_epi32(prefixSums, sums);
+            sums = _mm_add_epi32(sums, _mm_sad_epu8(a, zero));
+            sums = _mm_add_epi32(sums, _mm_sad_epu8(b, zero));
+            weightedSums = _mm_add_epi32(weightedSums, _mm_madd_epi16(
+                    _mm_maddubs_epi16(a, weightsHigh), ones));
+            weightedSums = _mm_add_epi32(weightedSums, _mm_madd_epi16(
+                    _mm_maddubs_epi16(b, weightsLow), ones));
+        }
+
+        s2 = (s2 + quint64(s1) * blocks * ADLER_BLOCK +
+              sumLanes(prefixSums) * ADLER_BLOCK + sumLanes(weightedSums))
+             % ADLER_BASE;
+        s1 = (s1 + sumLanes(sums)) % ADLER_BASE;
+    }
+
+    return adler32Scalar((s2 << 16) | s1, data, size);
+}
+#endif
+
+#if defined(CREPORTER_CHECKSUM_NEON)
+quint64 sumLanes(uint32x4_t lanes)
+{
+    quint32 values[4];
+    vst1q_u32(values, lanes);
+    return quint64(values[0]) + values[1] + values[2] + values[3];
+}
+
+quint32 adler32Neon(quint32 adler, const uchar *data, size_t size)
+{
+    static const uint8_t WEIGHTS[ADLER_BLOCK] = {
+        32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+        16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1
+    };
+
+    quint32 s1 = adler & 0xffff;
+    quint32 s2 = adler >> 16;
+
+    const uint8x8_t weights0 = vld1_u8(WEIGHTS);
+    const uint8x8_t weights1 = vld1_u8(WEIGHTS + 8);
+    const uint8x8_t weights2 = vld1_u8(WEIGHTS + 16);
+    const uint8x8_t weights3 = vld1_u8(WEIGHTS + 24);
+
+    while (size >= ADLER_BLOCK) {
+        size_t blocks = qMin(size, ADLER_NMAX) / ADLER_BLOCK;
+        size -= blocks * ADLER_BLOCK;
+
+        uint32x4_t sums = vdupq_n_u32(0);
+        uint32x4_t prefixSums = vdupq_n_u32(0);
+        uint32x4_t weightedSums = vdupq_n_u32(0);
+        for (size_t i = 0; i < blocks; ++i, data += ADLER_BLOCK) {
+            uint8x16_t a = vld1q_u8(data);
+            uint8x16_t b = vld1q_u8(data + 16);
+
+            prefixSums = vaddq_u32(prefixSums, sums);
+            sums = vpadalq_u16(sums, vpadalq_u8(vpaddlq_u8(a), b));
+
+            // Each 16-bit lane adds up four products, at most 255 * 80.
+            uint16x8_t products = vmull_u8(vget_low_u8(a), weights0);
+            products = vmlal_u8(products, vget_high_u8(a), weights1);
+            products = vmlal_u8(products, vget_low_u8(b), weights2);
+            products = vmlal_u8(products, vget_high_u8(b), weights3);
+            weightedSums = vpadalq_u16(weightedSums, products);
+        }
+
+        s2 = (s2 + quint64(s1) * blocks * ADLER_BLOCK +
+              sumLanes(prefixSums) * ADLER_BLOCK + sumLanes(weightedSums))
+             % ADLER_BASE;
+        s1 = (s1 + sumLanes(sums)) % ADLER_BASE;
+    }
+
+    return adler32Scalar((s2 << 16) | s1, data, size);
+}
+#endif
+
+struct Implementation {
+    ChecksumFunction crc32;
+    ChecksumFunction adler32;
+    const char *name;
+};
+
+Implementation selectImplementation()
+{
+#if defined(CREPORTER_CHECKSUM_SSSE3)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("ssse3")) {
+        Implementation ssse3 = { crc32Slicing8, adler32Ssse3,
+                                 "crc32:slicing8 adler32:ssse3" };
+        return ssse3;
+    }
+#endif
+#if defined(CREPORTER_CHECKSUM_ARMV8_CRC32)
+    if (getauxval(AT_HWCAP) & HWCAP_CRC32) {
+        Implementation armv8 = { crc32Armv8, adler32Neon,
+                                 "crc32:armv8 adler32:neon" };
+        return armv8;
+    }
+#endif
+#if defined(CREPORTER_CHECKSUM_NEON)
+    Implementation neon = { crc32Slicing8, adler32Neon,
+                            "crc32:slicing8 adler32:neon" };
+    return neon;
+#else
+    Implementation scalar = { crc32Slicing8, adler32Scalar,
+                              "crc32:slicing8 adler32:scalar" };
+    return scalar;
+#endif
+}
+
+const Implementation &implementation()
+{
+    static const Implementation selected = selectImplementation();
+    return selected;
+}
+
+}
+
+quint32 CReporterChecksum::crc32(quint32 crc, const char *data, qint64 size)
+{
+    if (size <= 0) {
+        return crc;
+    }
+    return ::implementation().crc32(crc, reinterpret_cast<const uchar *>(data),
+                                     size);
+}
+
+quint32 CReporterChecksum::adler32(quint32 adler, const char *data, qint64 size)
+{
+    if (size <= 0) {
+        return adler;
+    }
+    return ::implementation().adler32(adler, reinterpret_cast<const uchar *>(data),
+                                      size);
+}
+
+const char *CReporterChecksum::implementation()
+{
+    return ::implementation().name;
+}
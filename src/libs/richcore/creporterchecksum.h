@@ -0,0 +1,70 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERCHECKSUM_H
+#define CREPORTERCHECKSUM_H
+
+#include <QtGlobal>
+
+#include "creporterexport.h"
+
+/*!
+ * @class CReporterChecksum
+ * @brief Checksums used by the lzop format.
+ *
+ * Both are compatible with zlib and liblzo. CRC-32 uses the CRC instructions
+ * of ARMv8 CPUs that have them and slicing-by-8 tables elsewhere; x86 has
+ * hardware support only for the Castagnoli polynomial, which lzop doesn't
+ * use. Adler-32 sums 32 bytes at a time with NEON, or with SSSE3 when the
+ * CPU supports it.
+ */
+class CREPORTER_EXPORT CReporterChecksum
+{
+public:
+    /*!
+     * @brief Updates CRC-32 (IEEE 802.3) with @a data.
+     *
+     * @param crc Checksum of the preceding data, 0 at the start.
+     * @param data Data to add.
+     * @param size Size of @a data.
+     */
+    static quint32 crc32(quint32 crc, const char *data, qint64 size);
+
+    /*!
+     * @brief Updates Adler-32 with @a data.
+     *
+     * @param adler Checksum of the preceding data, 1 at the start.
+     * @param data Data to add.
+     * @param size Size of @a data.
+     */
+    static quint32 adler32(quint32 adler, const char *data, qint64 size);
+
+    /*!
+     * @brief Names of the implementations used on this CPU.
+     *
+     * @return E.g. "crc32:armv8 adler32:neon".
+     */
+    static const char *implementation();
+
+private:
+    CReporterChecksum();
+};
+
+#endif // CREPORTERCHECKSUM_H
@@ -0,0 +1,932 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creportercorereducer.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QPair>
+#include <QSet>
+#include <QThread>
+#include <QVector>
+
+#include <algorithm>
+#include <elf.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "creporterlzowriter.h"
+#include "creporterrichcorereader.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+#ifndef NT_FILE
+#define NT_FILE 0x46494c45
+#endif
+
+namespace {
+
+const QString COREDUMP_SECTION("coredump");
+const QString REDUCTION_SECTION("core-reduction");
+const QByteArray SECTION_MARKER("\n[---rich-core: ");
+const QByteArray SECTION_HEADER_END("---]\n");
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+const unsigned char HOST_ELF_DATA = ELFDATA2LSB;
+#else
+const unsigned char HOST_ELF_DATA = ELFDATA2MSB;
+#endif
+
+//! Granularity in which segments are sparsified.
+const quint64 CORE_PAGE_SIZE = 4096;
+//! Area below the stack pointer leaf functions may use.
+const quint64 STACK_RED_ZONE = 128;
+//! Upper limit of program header table and notes size.
+const quint64 MAX_METADATA_SIZE = 16 * 1024 * 1024;
+//! More program headers would need extended numbering.
+const int MAX_PROGRAM_HEADERS = PN_XNUM - 1;
+//! Amount of core data handled at once.
+const qint64 COPY_CHUNK_SIZE = 256 * 1024;
+
+//! Offsets of pr_reg in struct elf_prstatus.
+const int PRSTATUS_REG_OFFSET_32 = 72;
+const int PRSTATUS_REG_OFFSET_64 = 112;
+
+quint64 pageFloor(quint64 address)
+{
+    return address & ~(CORE_PAGE_SIZE - 1);
+}
+
+quint64 alignUp(quint64 value, quint64 alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+//! Index of the stack pointer in pr_reg, -1 for unsupported machines.
+int stackPointerIndex(int machine)
+{
+    switch (machine) {
+    case EM_ARM:
+        return 13;
+    case EM_AARCH64:
+        return 31;
+    case EM_386:
+        return 15;
+    case EM_X86_64:
+        return 19;
+    default:
+        return -1;
+    }
+}
+
+struct Segment {
+    enum Role {
+        //! Copied as it is.
+        Keep,
+        //! Thread stack, only the part in use is kept.
+        Stack,
+        //! Anonymous writable memory, only the referenced pages are kept.
+        Reducible,
+    };
+
+    quint32 type;
+    quint32 flags;
+    quint64 offset;
+    quint64 vaddr;
+    quint64 paddr;
+    quint64 filesz;
+    quint64 memsz;
+    quint64 align;
+    Role role;
+    //! Lowest address of the stack in use.
+    quint64 liveStart;
+};
+
+//! Program header of the reduced core and where its data come from.
+struct Piece {
+    quint32 type;
+    quint32 flags;
+    quint64 vaddr;
+    quint64 paddr;
+    quint64 filesz;
+    quint64 memsz;
+    quint64 align;
+    quint64 inOffset;
+    quint64 outOffset;
+};
+
+bool pieceBefore(const Piece *a, const Piece *b)
+{
+    return a->inOffset < b->inOffset;
+}
+
+bool startsBefore(quint64 address, const Segment *segment)
+{
+    return address < segment->vaddr;
+}
+
+bool vaddrLessThan(const Segment *a, const Segment *b)
+{
+    return a->vaddr < b->vaddr;
+}
+
+bool offsetLessThan(const Segment *a, const Segment *b)
+{
+    return a->offset < b->offset;
+}
+
+template <typename Phdr>
+Segment toSegment(const char *data)
+{
+    Phdr phdr;
+    memcpy(&phdr, data, sizeof(phdr));
+
+    Segment segment;
+    segment.type = phdr.p_type;
+    segment.flags = phdr.p_flags;
+    segment.offset = phdr.p_offset;
+    segment.vaddr = phdr.p_vaddr;
+    segment.paddr = phdr.p_paddr;
+    segment.filesz = phdr.p_filesz;
+    segment.memsz = phdr.p_memsz;
+    segment.align = phdr.p_align;
+    segment.role = Segment::Keep;
+    segment.liveStart = phdr.p_vaddr;
+    return segment;
+}
+
+template <typename Phdr>
+QByteArray fromPiece(const Piece &piece)
+{
+    Phdr phdr;
+    memset(&phdr, 0, sizeof(phdr));
+    phdr.p_type = piece.type;
+    phdr.p_flags = piece.flags;
+    phdr.p_offset = piece.outOffset;
+    phdr.p_vaddr = piece.vaddr;
+    phdr.p_paddr = piece.paddr;
+    phdr.p_filesz = piece.filesz;
+    phdr.p_memsz = piece.memsz;
+    phdr.p_align = piece.align;
+    return QByteArray(reinterpret_cast<const char *>(&phdr), sizeof(phdr));
+}
+
+struct ElfHeader {
+    quint16 type;
+    quint16 machine;
+    quint64 phoff;
+    quint16 phentsize;
+    quint16 phnum;
+};
+
+template <typename Ehdr>
+ElfHeader parseElfHeader(const QByteArray &data)
+{
+    Ehdr ehdr;
+    memcpy(&ehdr, data.constData(), sizeof(ehdr));
+
+    ElfHeader header;
+    header.type = ehdr.e_type;
+    header.machine = ehdr.e_machine;
+    header.phoff = ehdr.e_phoff;
+    header.phentsize = ehdr.e_phentsize;
+    header.phnum = ehdr.e_phnum;
+    return header;
+}
+
+template <typename Ehdr>
+QByteArray reducedElfHeader(const QByteArray &data, int phnum)
+{
+    Ehdr ehdr;
+    memcpy(&ehdr, data.constData(), sizeof(ehdr));
+
+    // Program headers follow right after, there are no sections.
+    ehdr.e_phoff = sizeof(ehdr);
+    ehdr.e_phnum = phnum;
+    ehdr.e_shoff = 0;
+    ehdr.e_shnum = 0;
+    ehdr.e_shstrndx = SHN_UNDEF;
+    return QByteArray(reinterpret_cast<const char *>(&ehdr), sizeof(ehdr));
+}
+
+/*!
+ * Sequential access to the data of the current rich core section.
+ */
+class SectionStream
+{
+public:
+    explicit SectionStream(CReporterRichCoreReader *reader)
+        : reader(reader), pos(0) {}
+
+    //! Returns at most @a maxSize next bytes, valid until the next call.
+    QByteArray next(quint64 maxSize)
+    {
+        QByteArray chunk =
+            reader->readSectionChunk(qMin<quint64>(maxSize, COPY_CHUNK_SIZE));
+        pos += chunk.size();
+        return chunk;
+    }
+
+    //! Skips to @a offset, which mustn't be behind the current position.
+    bool skipTo(quint64 offset)
+    {
+        while (pos < offset) {
+            if (next(offset - pos).isEmpty()) {
+                return false;
+            }
+        }
+        return pos == offset;
+    }
+
+    //! Appends next bytes to @a data until it has @a size bytes.
+    bool read(QByteArray *data, quint64 size)
+    {
+        while (quint64(data->size()) < size) {
+            QByteArray chunk = next(size - data->size());
+            if (chunk.isEmpty()) {
+                return false;
+            }
+            data->append(chunk);
+        }
+        return true;
+    }
+
+    quint64 position() const
+    {
+        return pos;
+    }
+
+private:
+    CReporterRichCoreReader *reader;
+    quint64 pos;
+};
+
+/*!
+ * Structure of the ELF core and the plan what to keep of it.
+ */
+class CoreLayout
+{
+public:
+    CoreLayout();
+
+    /*!
+     * Reads the core from the start of the coredump section and decides
+     * what to keep.
+     */
+    bool analyze(SectionStream *in);
+
+    //! Whether the reduced core differs from the original.
+    bool changed() const;
+
+    //! Writes the reduced core read again from the start of the section.
+    bool write(SectionStream *in, CReporterLzoWriter *out) const;
+
+    //! Text of the core-reduction section.
+    QByteArray statistics() const;
+
+private:
+    bool readHeaders(SectionStream *in);
+    bool readNotes(SectionStream *in);
+    void parseNote(quint32 type, const char *desc, quint64 size);
+    bool classify();
+    bool isFileBacked(const Segment &segment) const;
+    bool scan(SectionStream *in);
+    int scanWords(const char *data, int size);
+    void markAddress(quint64 address);
+    void plan(bool sparse);
+    quint64 word(const char *data) const;
+
+    bool is64;
+    int machine;
+    QByteArray elfHeader;
+    quint64 originalSize;
+    QList<Segment> segments;
+
+    QVector<quint64> registers;
+    QVector<quint64> stackPointers;
+    QList<QPair<quint64, quint64> > fileMappings;
+
+    //! Reducible segments sorted by address.
+    QVector<const Segment *> reducible;
+    QSet<quint64> referencedPages;
+
+    QList<Piece> pieces;
+    quint64 reducedSize;
+    int droppedSegments;
+    int sparseSegments;
+    int trimmedStacks;
+};
+
+CoreLayout::CoreLayout()
+    : is64(false), machine(EM_NONE), originalSize(0),
+      reducedSize(0), droppedSegments(0), sparseSegments(0), trimmedStacks(0)
+{
+}
+
+bool CoreLayout::analyze(SectionStream *in)
+{
+    if (!readHeaders(in) || !readNotes(in) || !classify() || !scan(in)) {
+        return false;
+    }
+
+    plan(true);
+    if (pieces.size() > MAX_PROGRAM_HEADERS) {
+        // Keep referenced segments whole rather than split them.
+        plan(false);
+    }
+    if (pieces.size() > MAX_PROGRAM_HEADERS) {
+        qCDebug(cr) << "Too many program headers in reduced core.";
+        return false;
+    }
+
+    return true;
+}
+
+bool CoreLayout::changed() const
+{
+    return droppedSegments > 0 || sparseSegments > 0 || trimmedStacks > 0;
+}
+
+quint64 CoreLayout::word(const char *data) const
+{
+    if (is64) {
+        quint64 value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    quint32 value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+bool CoreLayout::readHeaders(SectionStream *in)
+{
+    if (!in->read(&elfHeader, EI_NIDENT) ||
+            memcmp(elfHeader.constData(), ELFMAG, SELFMAG) != 0) {
+        qCDebug(cr) << "Core dump is not an ELF file.";
+        return false;
+    }
+
+    unsigned char elfClass = elfHeader.at(EI_CLASS);
+    if ((elfClass != ELFCLASS32 && elfClass != ELFCLASS64) ||
+            static_cast<unsigned char>(elfHeader.at(EI_DATA)) != HOST_ELF_DATA) {
+        qCDebug(cr) << "Unsupported ELF class or byte order.";
+        return false;
+    }
+    is64 = (elfClass == ELFCLASS64);
+
+    quint64 ehdrSize = is64 ? sizeof(Elf64_Ehdr) : sizeof(Elf32_Ehdr);
+    quint64 phdrSize = is64 ? sizeof(Elf64_Phdr) : sizeof(Elf32_Phdr);
+    if (!in->read(&elfHeader, ehdrSize)) {
+        return false;
+    }
+
+    ElfHeader header = is64 ? parseElfHeader<Elf64_Ehdr>(elfHeader)
+                            : parseElfHeader<Elf32_Ehdr>(elfHeader);
+    machine = header.machine;
+
+    if (header.type != ET_CORE || header.phentsize != phdrSize ||
+            header.phnum == PN_XNUM || header.phoff < ehdrSize ||
+            header.phoff + header.phnum * phdrSize > MAX_METADATA_SIZE) {
+        qCDebug(cr) << "Unsupported ELF core header.";
+        return false;
+    }
+
+    QByteArray table;
+    if (!in->skipTo(header.phoff) || !in->read(&table, header.phnum * phdrSize)) {
+        return false;
+    }
+
+    originalSize = in->position();
+    for (int i = 0; i < header.phnum; ++i) {
+        const char *data = table.constData() + i * phdrSize;
+        segments << (is64 ? toSegment<Elf64_Phdr>(data)
+                          : toSegment<Elf32_Phdr>(data));
+        originalSize = qMax(originalSize,
+                            segments.last().offset + segments.last().filesz);
+    }
+
+    return true;
+}
+
+bool CoreLayout::readNotes(SectionStream *in)
+{
+    QList<const Segment *> notes;
+    foreach (const Segment &segment, segments) {
+        if (segment.type == PT_NOTE) {
+            notes << &segment;
+        }
+    }
+    std::sort(notes.begin(), notes.end(), offsetLessThan);
+
+    foreach (const Segment *segment, notes) {
+        QByteArray data;
+        // Notes are expected before the memory contents.
+        if (segment->filesz > MAX_METADATA_SIZE || !in->skipTo(segment->offset) ||
+                !in->read(&data, segment->filesz)) {
+            qCDebug(cr) << "Couldn't read core notes.";
+            return false;
+        }
+
+        quint64 pos = 0;
+        quint64 size = data.size();
+        while (pos + sizeof(Elf32_Nhdr) <= size) {
+            // Same layout in 64-bit cores.
+            Elf32_Nhdr nhdr;
+            memcpy(&nhdr, data.constData() + pos, sizeof(nhdr));
+            pos += sizeof(nhdr) + alignUp(nhdr.n_namesz, 4);
+            if (pos + nhdr.n_descsz > size) {
+                break;
+            }
+
+            parseNote(nhdr.n_type, data.constData() + pos, nhdr.n_descsz);
+            pos += alignUp(nhdr.n_descsz, 4);
+        }
+    }
+
+    return true;
+}
+
+void CoreLayout::parseNote(quint32 type, const char *desc, quint64 size)
+{
+    quint64 wordSize = is64 ? 8 : 4;
+
+    if (type == NT_PRSTATUS) {
+        // pr_reg is followed by int pr_fpvalid, padded to the word size.
+        quint64 first = is64 ? PRSTATUS_REG_OFFSET_64 : PRSTATUS_REG_OFFSET_32;
+        if (size < first + wordSize) {
+            return;
+        }
+
+        int index = 0;
+        int spIndex = stackPointerIndex(machine);
+        for (quint64 pos = first; pos + 2 * wordSize <= size; pos += wordSize, ++index) {
+            quint64 value = word(desc + pos);
+            registers << value;
+            if (index == spIndex) {
+                stackPointers << value;
+            }
+        }
+    } else if (type == NT_FILE) {
+        // count, page size, count * (start, end, file offset), file names.
+        if (size < 2 * wordSize) {
+            return;
+        }
+
+        quint64 count = word(desc);
+        quint64 pos = 2 * wordSize;
+        for (quint64 i = 0; i < count && pos + 3 * wordSize <= size; ++i) {
+            fileMappings << qMakePair(word(desc + pos), word(desc + pos + wordSize));
+            pos += 3 * wordSize;
+        }
+    }
+}
+
+bool CoreLayout::isFileBacked(const Segment &segment) const
+{
+    quint64 end = segment.vaddr + segment.memsz;
+
+    typedef QPair<quint64, quint64> Range;
+    foreach (const Range &mapping, fileMappings) {
+        if (mapping.first < end && segment.vaddr < mapping.second) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool CoreLayout::classify()
+{
+    if (stackPointers.isEmpty()) {
+        // Without the stacks nothing is known to be unreferenced.
+        qCDebug(cr) << "No thread stacks found in core of machine" << machine;
+        return false;
+    }
+
+    for (int i = 0; i < segments.size(); ++i) {
+        Segment &segment = segments[i];
+        if (segment.type != PT_LOAD || segment.filesz == 0) {
+            continue;
+        }
+
+        quint64 end = segment.vaddr + segment.memsz;
+        bool isStack = false;
+        quint64 lowestSp = end;
+        foreach (quint64 sp, stackPointers) {
+            if (sp >= segment.vaddr && sp < end) {
+                isStack = true;
+                lowestSp = qMin(lowestSp, sp);
+            }
+        }
+
+        if (isStack) {
+            segment.role = Segment::Stack;
+            quint64 live = pageFloor(lowestSp - qMin(lowestSp, STACK_RED_ZONE));
+            if (live > segment.vaddr && live < segment.vaddr + segment.filesz) {
+                segment.liveStart = live;
+            }
+        } else if ((segment.flags & PF_W) && segment.filesz >= quint64(CReporterCoreReducer::MinReducibleSize) &&
+                   !isFileBacked(segment)) {
+            segment.role = Segment::Reducible;
+            reducible << &segment;
+        }
+    }
+
+    std::sort(reducible.begin(), reducible.end(), vaddrLessThan);
+    return true;
+}
+
+void CoreLayout::markAddress(quint64 address)
+{
+    QVector<const Segment *>::const_iterator it =
+        std::upper_bound(reducible.constBegin(), reducible.constEnd(),
+                         address, startsBefore);
+    if (it == reducible.constBegin()) {
+        return;
+    }
+
+    const Segment *segment = *(it - 1);
+    if (address < segment->vaddr + segment->filesz) {
+        referencedPages.insert(pageFloor(address));
+    }
+}
+
+int CoreLayout::scanWords(const char *data, int size)
+{
+    int wordSize = is64 ? 8 : 4;
+    int pos = 0;
+    for (; pos + wordSize <= size; pos += wordSize) {
+        markAddress(word(data + pos));
+    }
+    return pos;
+}
+
+bool CoreLayout::scan(SectionStream *in)
+{
+    if (reducible.isEmpty()) {
+        // Only stacks get trimmed, no need to look for references.
+        return true;
+    }
+
+    foreach (quint64 value, registers) {
+        markAddress(value);
+    }
+
+    // Stacks and the other writable data that is kept refer to the heap.
+    QList<const Segment *> roots;
+    foreach (const Segment &segment, segments) {
+        if (segment.type == PT_LOAD && segment.filesz > 0 &&
+                (segment.flags & PF_W) && segment.role != Segment::Reducible) {
+            roots << &segment;
+        }
+    }
+    std::sort(roots.begin(), roots.end(), offsetLessThan);
+
+    foreach (const Segment *segment, roots) {
+        quint64 start = segment->offset + (segment->liveStart - segment->vaddr);
+        quint64 remaining = segment->filesz - (segment->liveStart - segment->vaddr);
+        if (!in->skipTo(start)) {
+            qCDebug(cr) << "Unexpected order of core segments.";
+            return false;
+        }
+
+        QByteArray carry;
+        while (remaining > 0) {
+            QByteArray chunk = in->next(remaining);
+            if (chunk.isEmpty()) {
+                qCDebug(cr) << "Core dump is truncated.";
+                return false;
+            }
+            remaining -= chunk.size();
+
+            int done = 0;
+            if (!carry.isEmpty()) {
+                // Word split between chunks.
+                int missing = qMin((is64 ? 8 : 4) - carry.size(), chunk.size());
+                carry.append(chunk.constData(), missing);
+                done = missing;
+                if (scanWords(carry.constData(), carry.size()) > 0) {
+                    carry.clear();
+                }
+            }
+            done += scanWords(chunk.constData() + done, chunk.size() - done);
+            carry.append(chunk.constData() + done, chunk.size() - done);
+        }
+    }
+
+    return true;
+}
+
+void CoreLayout::plan(bool sparse)
+{
+    pieces.clear();
+    droppedSegments = 0;
+    sparseSegments = 0;
+    trimmedStacks = 0;
+
+    foreach (const Segment &segment, segments) {
+        Piece piece;
+        piece.type = segment.type;
+        piece.flags = segment.flags;
+        piece.vaddr = segment.vaddr;
+        piece.paddr = segment.paddr;
+        piece.filesz = segment.filesz;
+        piece.memsz = segment.memsz;
+        piece.align = segment.align;
+        piece.inOffset = segment.offset;
+        piece.outOffset = 0;
+
+        if (segment.role == Segment::Keep) {
+            pieces << piece;
+            continue;
+        }
+
+        if (segment.role == Segment::Stack) {
+            quint64 unused = segment.liveStart - segment.vaddr;
+            if (unused > 0) {
+                Piece gap(piece);
+                gap.filesz = 0;
+                gap.memsz = unused;
+                pieces << gap;
+                ++trimmedStacks;
+            }
+            piece.vaddr += unused;
+            piece.paddr += segment.paddr ? unused : 0;
+            piece.filesz -= unused;
+            piece.memsz -= unused;
+            piece.inOffset += unused;
+            pieces << piece;
+            continue;
+        }
+
+        // Runs of referenced and unreferenced pages.
+        QList<Piece> runs;
+        quint64 end = segment.vaddr + segment.filesz;
+        int keptRuns = 0;
+        for (quint64 pos = segment.vaddr; pos < end;) {
+            quint64 next = qMin(pageFloor(pos) + CORE_PAGE_SIZE, end);
+            bool keep = referencedPages.contains(pageFloor(pos));
+
+            if (!runs.isEmpty() && (runs.last().filesz > 0) == keep) {
+                runs.last().memsz += next - pos;
+                runs.last().filesz += keep ? next - pos : 0;
+            } else {
+                Piece run(piece);
+                run.vaddr = pos;
+                run.paddr = segment.paddr ? segment.paddr + (pos - segment.vaddr) : 0;
+                run.filesz = keep ? next - pos : 0;
+                run.memsz = next - pos;
+                run.inOffset = segment.offset + (pos - segment.vaddr);
+                runs << run;
+                keptRuns += keep ? 1 : 0;
+            }
+            pos = next;
+        }
+
+        if (keptRuns == 0) {
+            piece.filesz = 0;
+            pieces << piece;
+            ++droppedSegments;
+        } else if (!sparse || runs.size() == 1) {
+            pieces << piece;
+        } else {
+            if (segment.memsz > segment.filesz) {
+                Piece tail(piece);
+                tail.vaddr = end;
+                tail.paddr = segment.paddr ? segment.paddr + segment.filesz : 0;
+                tail.filesz = 0;
+                tail.memsz = segment.memsz - segment.filesz;
+                tail.inOffset = segment.offset + segment.filesz;
+                runs << tail;
+            }
+            pieces << runs;
+            ++sparseSegments;
+        }
+    }
+
+    // Data go in the original order, aligned as in the original.
+    QList<Piece *> order;
+    for (int i = 0; i < pieces.size(); ++i) {
+        order << &pieces[i];
+    }
+    std::stable_sort(order.begin(), order.end(), pieceBefore);
+
+    quint64 phdrSize = is64 ? sizeof(Elf64_Phdr) : sizeof(Elf32_Phdr);
+    quint64 cursor = elfHeader.size() + pieces.size() * phdrSize;
+    foreach (Piece *piece, order) {
+        if (piece->filesz > 0) {
+            cursor = alignUp(cursor, qBound<quint64>(1, piece->align, CORE_PAGE_SIZE));
+        }
+        piece->outOffset = cursor;
+        cursor += piece->filesz;
+    }
+    reducedSize = cursor;
+}
+
+bool CoreLayout::write(SectionStream *in, CReporterLzoWriter *out) const
+{
+    QByteArray headers = is64
+        ? reducedElfHeader<Elf64_Ehdr>(elfHeader, pieces.size())
+        : reducedElfHeader<Elf32_Ehdr>(elfHeader, pieces.size());
+    foreach (const Piece &piece, pieces) {
+        headers += is64 ? fromPiece<Elf64_Phdr>(piece)
+                        : fromPiece<Elf32_Phdr>(piece);
+    }
+    if (!out->write(headers)) {
+        return false;
+    }
+
+    QList<const Piece *> order;
+    foreach (const Piece &piece, pieces) {
+        if (piece.filesz > 0) {
+            order << &piece;
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), pieceBefore);
+
+    quint64 written = headers.size();
+    foreach (const Piece *piece, order) {
+        // Overlapping data can't be streamed.
+        if (!in->skipTo(piece->inOffset)) {
+            qCWarning(cr) << "Couldn't read core data at offset" << piece->inOffset;
+            return false;
+        }
+
+        if (piece->outOffset > written &&
+                !out->write(QByteArray(int(piece->outOffset - written), '\0'))) {
+            return false;
+        }
+
+        quint64 remaining = piece->filesz;
+        while (remaining > 0) {
+            QByteArray chunk = in->next(remaining);
+            if (chunk.isEmpty() || !out->write(chunk)) {
+                return false;
+            }
+            remaining -= chunk.size();
+        }
+        written = piece->outOffset + piece->filesz;
+    }
+
+    return true;
+}
+
+QByteArray CoreLayout::statistics() const
+{
+    QByteArray text;
+    text += "original-size: " + QByteArray::number(originalSize) + '\n';
+    text += "reduced-size: " + QByteArray::number(reducedSize) + '\n';
+    text += "dropped-segments: " + QByteArray::number(droppedSegments) + '\n';
+    text += "sparse-segments: " + QByteArray::number(sparseSegments) + '\n';
+    text += "trimmed-stacks: " + QByteArray::number(trimmedStacks) + '\n';
+    return text;
+}
+
+bool writeSectionHeader(CReporterLzoWriter *writer, const QString &name)
+{
+    return writer->write(SECTION_MARKER + name.toUtf8() + SECTION_HEADER_END);
+}
+
+bool writeReduced(const QString &filePath, const CoreLayout &layout,
+                  QIODevice *device)
+{
+    QFileInfo fi(filePath);
+    CReporterRichCoreReader reader(filePath);
+    CReporterLzoWriter writer(device);
+
+    reader.setDecodingThreads(QThread::idealThreadCount());
+    if (!writer.open(fi.completeBaseName(), fi.lastModified().toUTC())) {
+        return false;
+    }
+
+    while (reader.nextSection()) {
+        QString name = reader.sectionName();
+
+        if (name == COREDUMP_SECTION) {
+            SectionStream in(&reader);
+            if (!writeSectionHeader(&writer, REDUCTION_SECTION) ||
+                    !writer.write(layout.statistics()) ||
+                    !writeSectionHeader(&writer, name) ||
+                    !layout.write(&in, &writer)) {
+                qCWarning(cr) << "Writing of reduced core failed:" << writer.errorString();
+                return false;
+            }
+            continue;
+        }
+
+        if (!writeSectionHeader(&writer, name)) {
+            return false;
+        }
+        QByteArray chunk;
+        while (!(chunk = reader.readSectionChunk(COPY_CHUNK_SIZE)).isEmpty()) {
+            if (!writer.write(chunk)) {
+                return false;
+            }
+        }
+    }
+
+    if (reader.hasError()) {
+        qCWarning(cr) << "Failed to read" << filePath << ":" << reader.errorString();
+        return false;
+    }
+
+    return writer.close();
+}
+
+}
+
+bool CReporterCoreReducer::reduce(const QString &filePath)
+{
+    if (!filePath.endsWith(".lzo")) {
+        qCDebug(cr) << "Only compressed rich cores are reduced:" << filePath;
+        return false;
+    }
+
+    qint64 originalFileSize = QFileInfo(filePath).size();
+
+    CoreLayout layout;
+    {
+        CReporterRichCoreReader reader(filePath);
+        reader.setDecodingThreads(QThread::idealThreadCount());
+        bool found = false;
+
+        while (!found && reader.nextSection()) {
+            if (reader.sectionName() == REDUCTION_SECTION) {
+                qCDebug(cr) << "Core in" << filePath << "is already reduced.";
+                return false;
+            }
+            found = (reader.sectionName() == COREDUMP_SECTION);
+        }
+
+        if (!found) {
+            qCDebug(cr) << "No core dump in" << filePath;
+            return false;
+        }
+
+        SectionStream in(&reader);
+        if (!layout.analyze(&in)) {
+            return false;
+        }
+    }
+
+    if (!layout.changed()) {
+        qCDebug(cr) << "Nothing to reduce in" << filePath;
+        return false;
+    }
+
+    QString tempPath(filePath + ".reduce");
+    QFile temp(tempPath);
+    if (!temp.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(cr) << "Couldn't create" << tempPath << ":" << temp.errorString();
+        return false;
+    }
+
+    bool ok = writeReduced(filePath, layout, &temp);
+    temp.close();
+
+    if (ok && QFileInfo(filePath).size() != originalFileSize) {
+        // Something was appended meanwhile, don't lose it.
+        qCDebug(cr) << filePath << "changed during reduction.";
+        ok = false;
+    }
+
+    if (ok) {
+        temp.setPermissions(QFile::permissions(filePath));
+        if (::rename(QFile::encodeName(tempPath).constData(),
+                     QFile::encodeName(filePath).constData()) < 0) {
+            qCWarning(cr) << "Couldn't replace" << filePath << ":" << strerror(errno);
+            ok = false;
+        }
+    }
+
+    if (!ok) {
+        QFile::remove(tempPath);
+        return false;
+    }
+
+    qCDebug(cr) << "Reduced core in" << filePath << "from" << originalFileSize
+                << "to" << QFileInfo(filePath).size() << "bytes.";
+    return true;
+}
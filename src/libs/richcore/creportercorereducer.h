@@ -0,0 +1,71 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERCOREREDUCER_H
+#define CREPORTERCOREREDUCER_H
+
+#include <QString>
+
+#include "creporterexport.h"
+
+/*!
+ * @class CReporterCoreReducer
+ * @brief Shrinks the ELF core dump inside a rich core.
+ *
+ * Most of a core dump of a large application is anonymous heap that the
+ * stack trace never touches. The reducer keeps the notes, the in-use part
+ * of the thread stacks and all mappings it can't prove unneeded. Pages of
+ * large anonymous writable segments are kept only if the registers, the
+ * stacks or the other kept writable data point into them. The rest is
+ * replaced by program headers without file data, so the debugger still
+ * knows the address space layout.
+ *
+ * References are followed only one level deep: a heap page is kept if a
+ * register, a stack or other kept writable data points into it, but
+ * pointers stored in the kept heap pages aren't followed further. Data
+ * reachable only through such pointer chains, e.g. the nodes of a linked
+ * list, are lost, so a debugger may not be able to inspect them.
+ *
+ * The rich core is read twice as a stream, never as a whole, and written
+ * out compressed again.
+ */
+class CREPORTER_EXPORT CReporterCoreReducer
+{
+public:
+    //! Anonymous writable segments smaller than this are always kept.
+    static const int MinReducibleSize = 64 * 1024;
+
+    /*!
+     * @brief Reduces the core dump of a rich core in place.
+     *
+     * The reduced report replaces the original atomically and carries a
+     * core-reduction section with the sizes, so it isn't reduced again.
+     * Section index of the original becomes stale.
+     *
+     * @param filePath Path to *.rcore.lzo file.
+     * @return True if the file was replaced by a reduced one.
+     */
+    static bool reduce(const QString &filePath);
+
+private:
+    CReporterCoreReducer();
+};
+
+#endif // CREPORTERCOREREDUCER_H
@@ -0,0 +1,171 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creporterintegritychecker.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+
+#include "creporterlzoreader.h"
+#include "creporternamespace.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+
+//! Header of the first section, the very first marker has no newline.
+const QByteArray FIRST_SECTION_MARKER("[---rich-core: ");
+//! Suffix of the files with reasons of quarantine.
+const QString REASON_SUFFIX(".reason");
+
+bool startsWithSection(const QByteArray &data)
+{
+    int start = data.startsWith('\n') ? 1 : 0;
+    return data.mid(start, FIRST_SECTION_MARKER.size()) == FIRST_SECTION_MARKER;
+}
+
+bool checkCompressed(const QString &filePath, QString *reason,
+                     CReporterRichCoreIndex::Entries *index)
+{
+    CReporterLzoReader lzo(filePath);
+    lzo.setVerifyChecksums(true);
+    lzo.setDecodingThreads(QThread::idealThreadCount());
+
+    if (!lzo.open(QIODevice::ReadOnly)) {
+        *reason = lzo.errorString();
+        return false;
+    }
+
+    QByteArray block = lzo.readBlock();
+    if (block.isEmpty() && !lzo.hasError()) {
+        *reason = "Report is empty";
+        return false;
+    }
+    if (!block.isEmpty() && !startsWithSection(block)) {
+        *reason = "Not a rich core";
+        return false;
+    }
+
+    CReporterRichCoreIndex::Builder builder;
+    while (!block.isEmpty()) {
+        if (index) {
+            builder.addBlock(block, lzo.streamOffset(), lzo.blockOffset());
+        }
+        block = lzo.readBlock();
+    }
+
+    if (lzo.hasError()) {
+        *reason = QString("%1 at offset %2").arg(lzo.errorString())
+                  .arg(lzo.compressedPos());
+        return false;
+    }
+
+    if (index) {
+        *index = builder.entries();
+    }
+    return true;
+}
+
+bool checkPlain(const QString &filePath, QString *reason)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *reason = file.errorString();
+        return false;
+    }
+
+    if (!startsWithSection(file.read(FIRST_SECTION_MARKER.size() + 1))) {
+        *reason = file.size() == 0 ? "Report is empty" : "Not a rich core";
+        return false;
+    }
+
+    return true;
+}
+
+void removeOldest(const QDir &quarantine)
+{
+    QFileInfoList reports = quarantine.entryInfoList(
+            QStringList() << "*.rcore" << "*.rcore.lzo", QDir::Files,
+            QDir::Time);
+
+    for (int i = CReporterIntegrityChecker::MaxQuarantinedReports;
+            i < reports.count(); ++i) {
+        QString filePath = reports.at(i).absoluteFilePath();
+        qCDebug(cr) << "Removing old quarantined report" << filePath;
+        QFile::remove(filePath);
+        QFile::remove(filePath + REASON_SUFFIX);
+    }
+}
+
+}
+
+bool CReporterIntegrityChecker::check(const QString &filePath, QString *reason,
+                                      CReporterRichCoreIndex::Entries *index)
+{
+    if (index) {
+        index->clear();
+    }
+
+    bool ok = filePath.endsWith(".lzo") ? checkCompressed(filePath, reason, index)
+                                        : checkPlain(filePath, reason);
+    if (!ok) {
+        qCWarning(cr) << "Report" << filePath << "is broken:" << *reason;
+    }
+    return ok;
+}
+
+QString CReporterIntegrityChecker::quarantine(const QString &filePath,
+                                              const QString &reason)
+{
+    QFileInfo fi(filePath);
+    QDir dir(fi.absolutePath());
+
+    if (!dir.exists(CReporter::QuarantineDirName) &&
+            !dir.mkdir(CReporter::QuarantineDirName)) {
+        qCWarning(cr) << "Cannot create quarantine directory in" << dir.path();
+        return QString();
+    }
+
+    QDir quarantine(dir.filePath(CReporter::QuarantineDirName));
+    QString target = quarantine.filePath(fi.fileName());
+
+    QFile::remove(target);
+    if (!QFile::rename(filePath, target)) {
+        qCWarning(cr) << "Cannot move" << filePath << "to quarantine.";
+        return QString();
+    }
+
+    QFile reasonFile(target + REASON_SUFFIX);
+    if (reasonFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        reasonFile.write(QString("%1\n%2\n")
+                         .arg(QDateTime::currentDateTimeUtc().toString(Qt::ISODate))
+                         .arg(reason).toUtf8());
+    }
+
+    qCDebug(cr) << "Quarantined" << filePath << ":" << reason;
+
+    removeOldest(quarantine);
+
+    return target;
+}
@@ -0,0 +1,77 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERINTEGRITYCHECKER_H
+#define CREPORTERINTEGRITYCHECKER_H
+
+#include <QString>
+
+#include "creporterexport.h"
+#include "creporterrichcoreindex.h"
+
+/*!
+ * @class CReporterIntegrityChecker
+ * @brief Finds and sets aside reports that are truncated or corrupted.
+ *
+ * Reports cut short by an interrupted dump or a full disk would be rejected
+ * by the server only after being uploaded in full, again on every retry.
+ */
+class CREPORTER_EXPORT CReporterIntegrityChecker
+{
+public:
+    //! Most quarantined reports kept in one core directory.
+    static const int MaxQuarantinedReports = 10;
+
+    /*!
+     * @brief Checks that a report is complete and undamaged.
+     *
+     * lzop compressed reports are decoded to the end with checksums of all
+     * blocks verified. Plain reports are only checked to start with a rich
+     * core section.
+     *
+     * @param filePath Path to *.rcore.lzo or *.rcore file.
+     * @param reason Set to description of the problem if the report is
+     *               broken.
+     * @param index If not null, receives section index of a compressed
+     *              report, built while it's decoded for the check.
+     * @return True if the report can be uploaded.
+     */
+    static bool check(const QString &filePath, QString *reason,
+                      CReporterRichCoreIndex::Entries *index = 0);
+
+    /*!
+     * @brief Moves a broken report where it won't be uploaded.
+     *
+     * The report is moved to the CReporter::QuarantineDirName subdirectory
+     * of its directory and @a reason is written next to it, into a file
+     * with ".reason" suffix. The oldest quarantined reports are removed
+     * beyond MaxQuarantinedReports.
+     *
+     * @param filePath Path to the report.
+     * @param reason Why the report was quarantined.
+     * @return New path of the report, or empty string on failure.
+     */
+    static QString quarantine(const QString &filePath, const QString &reason);
+
+private:
+    CReporterIntegrityChecker();
+};
+
+#endif // CREPORTERINTEGRITYCHECKER_H
@@ -0,0 +1,50 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERLZOP_P_H
+#define CREPORTERLZOP_P_H
+
+// Definitions of the lzop file format shared by the reader and the writer.
+
+//! lzop file magic.
+extern const char LZOP_MAGIC[9];
+
+// lzop header flags.
+#define LZOP_F_ADLER32_D     0x00000001
+#define LZOP_F_ADLER32_C     0x00000002
+#define LZOP_F_H_EXTRA_FIELD 0x00000040
+#define LZOP_F_CRC32_D       0x00000100
+#define LZOP_F_CRC32_C       0x00000200
+#define LZOP_F_H_FILTER      0x00000800
+#define LZOP_F_H_CRC32       0x00001000
+#define LZOP_F_OS_UNIX       0x03000000
+
+// lzop compression methods decodable by lzo1x_decompress_safe().
+#define LZOP_M_LZO1X_1       1
+#define LZOP_M_LZO1X_1_15    2
+#define LZOP_M_LZO1X_999     3
+
+//! Format version that added version_needed, level and mtime_high fields.
+#define LZOP_VERSION_0940    0x0940
+
+//! Largest block lzop can create.
+#define LZOP_MAX_BLOCK_SIZE (64 * 1024 * 1024)
+
+#endif // CREPORTERLZOP_P_H
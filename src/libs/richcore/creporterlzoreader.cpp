@@ -0,0 +1,680 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creporterlzoreader.h"
+#include "creporterlzoreader_p.h"
+
+#include <QFile>
+#include <QtConcurrentRun>
+
+#include <lzo/lzo1x.h>
+
+#include "creporterchecksum.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+const char LZOP_MAGIC[9] = {
+    '\x89', 'L', 'Z', 'O', '\x00', '\r', '\n', '\x1a', '\n'
+};
+
+namespace {
+
+//! Oldest lzop format version that is understood.
+const quint16 LZOP_MIN_VERSION = 0x0900;
+
+/*!
+ * Checks @a data against the checksums present according to @a flags.
+ */
+bool checksumsMatch(const QByteArray &data, quint32 flags,
+                    quint32 adler32Flag, quint32 adler32,
+                    quint32 crc32Flag, quint32 crc32)
+{
+    if ((flags & adler32Flag) &&
+            CReporterChecksum::adler32(1, data.constData(), data.size()) != adler32) {
+        return false;
+    }
+    if ((flags & crc32Flag) &&
+            CReporterChecksum::crc32(0, data.constData(), data.size()) != crc32) {
+        return false;
+    }
+    return true;
+}
+
+}
+
+// ******** Class CReporterLzoBlock ********
+
+CReporterLzoBlock::CReporterLzoBlock()
+    : dstLength(0), flags(0), verify(false), adler32(0), crc32(0),
+      compressedAdler32(0), compressedCrc32(0), offset(0), streamOffset(0),
+      end(0)
+{
+}
+
+// ******** Class CReporterLzoReaderPrivate ********
+
+CReporterLzoReaderPrivate::CReporterLzoReaderPrivate()
+    : source(0), ownsSource(false), flags(0), blockPos(0), finished(false),
+      failed(false), sourcePos(0), blockOffset(0), blockStreamOffset(0),
+      blockEnd(0), streamOffset(0), adler32(0), crc32(0),
+      verifyChecksums(false), threads(1), readAhead(BlockRead), header(0)
+{
+}
+
+qint64 CReporterLzoReaderPrivate::readSome(char *data, qint64 size)
+{
+    qint64 total = 0;
+    while (total < size) {
+        qint64 n = source->read(data + total, size - total);
+        if (n < 0) {
+            break;
+        }
+        if (n == 0) {
+            // Sequential sources like pipes may just not have the data yet.
+            if (!source->isSequential() || !source->waitForReadyRead(-1)) {
+                break;
+            }
+            continue;
+        }
+        total += n;
+    }
+
+    if (header) {
+        header->append(data, total);
+    }
+    sourcePos += total;
+
+    return total;
+}
+
+bool CReporterLzoReaderPrivate::readFully(char *data, qint64 size)
+{
+    return readSome(data, size) == size;
+}
+
+bool CReporterLzoReaderPrivate::readUInt8(quint8 *value)
+{
+    return readFully(reinterpret_cast<char *>(value), 1);
+}
+
+bool CReporterLzoReaderPrivate::readUInt16(quint16 *value)
+{
+    uchar buf[2];
+    if (!readFully(reinterpret_cast<char *>(buf), sizeof(buf))) {
+        return false;
+    }
+    *value = (quint16(buf[0]) << 8) | buf[1];
+    return true;
+}
+
+bool CReporterLzoReaderPrivate::readUInt32(quint32 *value)
+{
+    uchar buf[4];
+    if (!readFully(reinterpret_cast<char *>(buf), sizeof(buf))) {
+        return false;
+    }
+    *value = (quint32(buf[0]) << 24) | (quint32(buf[1]) << 16) |
+             (quint32(buf[2]) << 8) | buf[3];
+    return true;
+}
+
+bool CReporterLzoReaderPrivate::readStreamStart(QString *error)
+{
+    qint64 start = sourcePos;
+
+    char magic[sizeof(LZOP_MAGIC)];
+    if (!readFully(magic, sizeof(magic)) ||
+            memcmp(magic, LZOP_MAGIC, sizeof(magic)) != 0) {
+        *error = "Not an lzop stream";
+        return false;
+    }
+
+    if (!readHeader(error)) {
+        return false;
+    }
+
+    streamOffset = start;
+    return true;
+}
+
+bool CReporterLzoReaderPrivate::readHeader(QString *error)
+{
+    QByteArray headerBytes;
+    header = &headerBytes;
+
+    quint16 version = 0;
+    quint16 libVersion = 0;
+    quint16 versionNeeded = 0;
+    quint8 method = 0;
+    quint8 level = 0;
+    quint32 value = 0;
+    quint8 nameLength = 0;
+    char name[256];
+
+    bool ok = readUInt16(&version) && readUInt16(&libVersion);
+    if (ok && version >= LZOP_VERSION_0940) {
+        ok = readUInt16(&versionNeeded);
+    }
+    ok = ok && readUInt8(&method);
+    if (ok && version >= LZOP_VERSION_0940) {
+        ok = readUInt8(&level);
+    }
+    ok = ok && readUInt32(&flags);
+    if (ok && (flags & LZOP_F_H_FILTER)) {
+        ok = readUInt32(&value);
+    }
+    // Mode and mtime.
+    ok = ok && readUInt32(&value) && readUInt32(&value);
+    if (ok && version >= LZOP_VERSION_0940) {
+        ok = readUInt32(&value);
+    }
+    ok = ok && readUInt8(&nameLength) && readFully(name, nameLength);
+
+    header = 0;
+
+    quint32 checksum = 0;
+    if (!ok || !readUInt32(&checksum)) {
+        *error = "Truncated lzop header";
+        return false;
+    }
+
+    if (version < LZOP_MIN_VERSION) {
+        *error = QString("Unsupported lzop version 0x%1").arg(version, 0, 16);
+        return false;
+    }
+    if (method != LZOP_M_LZO1X_1 && method != LZOP_M_LZO1X_1_15 &&
+            method != LZOP_M_LZO1X_999) {
+        *error = QString("Unsupported lzop method %1").arg(method);
+        return false;
+    }
+
+    quint32 expected = (flags & LZOP_F_H_CRC32) ?
+        CReporterChecksum::crc32(0, headerBytes.constData(), headerBytes.size()) :
+        CReporterChecksum::adler32(1, headerBytes.constData(), headerBytes.size());
+    if (checksum != expected) {
+        *error = "lzop header checksum mismatch";
+        return false;
+    }
+
+    if (flags & LZOP_F_H_EXTRA_FIELD) {
+        quint32 extraLength = 0;
+        ok = readUInt32(&extraLength) &&
+             extraLength <= quint32(LZOP_MAX_BLOCK_SIZE);
+        if (ok) {
+            QByteArray extra(extraLength, Qt::Uninitialized);
+            ok = readFully(extra.data(), extraLength) && readUInt32(&value);
+        }
+        if (!ok) {
+            *error = "Truncated lzop extra field";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+CReporterLzoReaderPrivate::Result CReporterLzoReaderPrivate::readRawBlock(
+        CReporterLzoBlock *raw, QString *error)
+{
+    forever {
+        qint64 start = sourcePos;
+        quint32 dstLength = 0;
+        if (!readUInt32(&dstLength)) {
+            *error = "Truncated lzop stream";
+            return StreamError;
+        }
+
+        if (dstLength == 0) {
+            // End of one lzop stream, another one may follow it.
+            qint64 nextStream = sourcePos;
+            char magic[sizeof(LZOP_MAGIC)];
+            qint64 n = readSome(magic, sizeof(magic));
+            if (n == 0) {
+                return EndOfStream;
+            }
+            if (n != sizeof(magic) || memcmp(magic, LZOP_MAGIC, n) != 0) {
+                *error = "Garbage after the end of lzop stream";
+                return StreamError;
+            }
+            if (!readHeader(error)) {
+                return StreamError;
+            }
+            streamOffset = nextStream;
+            continue;
+        }
+
+        quint32 srcLength = 0;
+        if (!readUInt32(&srcLength)) {
+            *error = "Truncated lzop block header";
+            return StreamError;
+        }
+        if (dstLength > quint32(LZOP_MAX_BLOCK_SIZE) || srcLength == 0 ||
+                srcLength > dstLength) {
+            *error = QString("Invalid lzop block size %1/%2")
+                     .arg(srcLength).arg(dstLength);
+            return StreamError;
+        }
+
+        bool ok = true;
+        if (flags & LZOP_F_ADLER32_D) {
+            ok = ok && readUInt32(&raw->adler32);
+        }
+        if (flags & LZOP_F_CRC32_D) {
+            ok = ok && readUInt32(&raw->crc32);
+        }
+        // Checksums of compressed data are present only for compressed blocks.
+        if (srcLength < dstLength) {
+            if (flags & LZOP_F_ADLER32_C) {
+                ok = ok && readUInt32(&raw->compressedAdler32);
+            }
+            if (flags & LZOP_F_CRC32_C) {
+                ok = ok && readUInt32(&raw->compressedCrc32);
+            }
+        }
+
+        if (srcLength < dstLength && threads <= 1) {
+            // Serially decoded blocks share one buffer for compressed data.
+            compressed.resize(srcLength);
+            ok = ok && readFully(compressed.data(), srcLength);
+            raw->payload = compressed;
+        } else {
+            raw->payload = QByteArray(srcLength, Qt::Uninitialized);
+            ok = ok && readFully(raw->payload.data(), srcLength);
+        }
+        if (!ok) {
+            *error = "Truncated lzop block";
+            return StreamError;
+        }
+
+        raw->dstLength = dstLength;
+        raw->flags = flags;
+        raw->verify = verifyChecksums;
+        raw->offset = start;
+        raw->streamOffset = streamOffset;
+        raw->end = sourcePos;
+        return BlockRead;
+    }
+}
+
+bool CReporterLzoReaderPrivate::decompress(const CReporterLzoBlock &raw,
+                                           QByteArray *data, QString *error)
+{
+    if (quint32(raw.payload.size()) == raw.dstLength) {
+        // Block was stored uncompressed.
+        *data = raw.payload;
+    } else {
+        // Broken compressed data are cheaper to detect before decompression.
+        if (raw.verify && !checksumsMatch(raw.payload, raw.flags,
+                                          LZOP_F_ADLER32_C, raw.compressedAdler32,
+                                          LZOP_F_CRC32_C, raw.compressedCrc32)) {
+            *error = "lzop block checksum mismatch";
+            return false;
+        }
+
+        // Detaches if the previous block is still referenced by the user.
+        data->resize(raw.dstLength);
+
+        lzo_uint length = raw.dstLength;
+        int result = lzo1x_decompress_safe(
+                reinterpret_cast<const lzo_bytep>(raw.payload.constData()),
+                raw.payload.size(), reinterpret_cast<lzo_bytep>(data->data()),
+                &length, 0);
+        if (result != LZO_E_OK || length != raw.dstLength) {
+            *error = QString("Corrupted lzop block (error %1)").arg(result);
+            return false;
+        }
+    }
+
+    if (raw.verify && !checksumsMatch(*data, raw.flags,
+                                      LZOP_F_ADLER32_D, raw.adler32,
+                                      LZOP_F_CRC32_D, raw.crc32)) {
+        *error = "lzop block checksum mismatch";
+        return false;
+    }
+
+    return true;
+}
+
+CReporterLzoBlock CReporterLzoReaderPrivate::decompressed(CReporterLzoBlock raw)
+{
+    decompress(raw, &raw.data, &raw.error);
+    raw.payload.clear();
+    return raw;
+}
+
+CReporterLzoReaderPrivate::Result CReporterLzoReaderPrivate::decodeBlock(
+        QString *error)
+{
+    CReporterLzoBlock current;
+
+    if (threads <= 1 && pending.isEmpty() && readAhead == BlockRead) {
+        Result result = readRawBlock(&current, error);
+        if (result != BlockRead) {
+            return result;
+        }
+        if (!decompress(current, &block, error)) {
+            return StreamError;
+        }
+    } else {
+        // Keep the thread pool busy with the blocks that follow.
+        while (readAhead == BlockRead && pending.size() < 2 * qMax(threads, 1)) {
+            CReporterLzoBlock raw;
+            readAhead = readRawBlock(&raw, &readAheadError);
+            if (readAhead == BlockRead) {
+                pending.enqueue(QtConcurrent::run(
+                        &CReporterLzoReaderPrivate::decompressed, raw));
+            }
+        }
+
+        if (pending.isEmpty()) {
+            *error = readAheadError;
+            return readAhead;
+        }
+
+        current = pending.dequeue().result();
+        if (!current.error.isEmpty()) {
+            *error = current.error;
+            dropPending();
+            return StreamError;
+        }
+        block = current.data;
+    }
+
+    blockOffset = current.offset;
+    blockStreamOffset = current.streamOffset;
+    blockEnd = current.end;
+    adler32 = current.adler32;
+    crc32 = current.crc32;
+    blockPos = 0;
+    return BlockRead;
+}
+
+void CReporterLzoReaderPrivate::dropPending()
+{
+    while (!pending.isEmpty()) {
+        pending.dequeue().waitForFinished();
+    }
+    readAhead = BlockRead;
+    readAheadError.clear();
+}
+
+// ******** Class CReporterLzoReader ********
+
+CReporterLzoReader::CReporterLzoReader(QIODevice *source, QObject *parent)
+    : QIODevice(parent), d_ptr(new CReporterLzoReaderPrivate)
+{
+    d_ptr->source = source;
+}
+
+CReporterLzoReader::CReporterLzoReader(const QString &fileName, QObject *parent)
+    : QIODevice(parent), d_ptr(new CReporterLzoReaderPrivate)
+{
+    d_ptr->source = new QFile(fileName, this);
+    d_ptr->ownsSource = true;
+}
+
+CReporterLzoReader::~CReporterLzoReader()
+{
+    delete d_ptr;
+    d_ptr = 0;
+}
+
+bool CReporterLzoReader::isLzoStream(const QByteArray &header)
+{
+    return header.startsWith(QByteArray::fromRawData(LZOP_MAGIC,
+                                                     sizeof(LZOP_MAGIC)));
+}
+
+qint64 CReporterLzoReader::uncompressedSize(const QString &fileName)
+{
+    CReporterLzoReader reader(fileName);
+    if (!reader.open(QIODevice::ReadOnly)) {
+        qCWarning(cr) << "Unable to open" << fileName << ":" << reader.errorString();
+        return -1;
+    }
+
+    CReporterLzoReaderPrivate *d = reader.d_func();
+    CReporterLzoBlock raw;
+    QString error;
+    qint64 size = 0;
+
+    forever {
+        switch (d->readRawBlock(&raw, &error)) {
+        case CReporterLzoReaderPrivate::BlockRead:
+            size += raw.dstLength;
+            break;
+        case CReporterLzoReaderPrivate::EndOfStream:
+            return size;
+        case CReporterLzoReaderPrivate::StreamError:
+            qCWarning(cr) << "Error reading" << fileName << ":" << error;
+            return -1;
+        }
+    }
+}
+
+QByteArray CReporterLzoReader::readBlock()
+{
+    Q_D(CReporterLzoReader);
+
+    if (!isOpen()) {
+        return QByteArray();
+    }
+
+    if (d->blockPos >= d->block.size()) {
+        if (d->finished) {
+            return QByteArray();
+        }
+
+        QString error;
+        CReporterLzoReaderPrivate::Result result = d->decodeBlock(&error);
+        if (result != CReporterLzoReaderPrivate::BlockRead) {
+            d->finished = true;
+            d->block.clear();
+            d->blockPos = 0;
+            if (result == CReporterLzoReaderPrivate::StreamError) {
+                d->failed = true;
+                setErrorString(error);
+                qCWarning(cr) << "Error decoding lzop stream:" << error;
+            }
+            return QByteArray();
+        }
+    }
+
+    QByteArray data = (d->blockPos == 0) ? d->block : d->block.mid(d->blockPos);
+    d->blockPos = d->block.size();
+    return data;
+}
+
+void CReporterLzoReader::setDecodingThreads(int threads)
+{
+    d_ptr->threads = qMax(threads, 1);
+}
+
+int CReporterLzoReader::decodingThreads() const
+{
+    return d_ptr->threads;
+}
+
+void CReporterLzoReader::setVerifyChecksums(bool verify)
+{
+    d_ptr->verifyChecksums = verify;
+}
+
+qint64 CReporterLzoReader::compressedPos() const
+{
+    // The source is read ahead of the current block when decoding in parallel.
+    return d_ptr->pending.isEmpty() ? d_ptr->sourcePos : d_ptr->blockEnd;
+}
+
+qint64 CReporterLzoReader::blockOffset() const
+{
+    return d_ptr->blockOffset;
+}
+
+qint64 CReporterLzoReader::streamOffset() const
+{
+    return d_ptr->blockStreamOffset;
+}
+
+bool CReporterLzoReader::seekBlock(qint64 streamOffset, qint64 blockOffset)
+{
+    Q_D(CReporterLzoReader);
+
+    if (!isOpen() || d->source->isSequential()) {
+        return false;
+    }
+
+    d->dropPending();
+    d->block.clear();
+    d->blockPos = 0;
+    d->finished = false;
+    d->failed = false;
+
+    QString error;
+    if (!d->source->seek(streamOffset)) {
+        error = "Cannot seek in the source";
+    } else {
+        d->sourcePos = streamOffset;
+        if (d->readStreamStart(&error) && blockOffset >= d->sourcePos) {
+            if (d->source->seek(blockOffset)) {
+                d->sourcePos = blockOffset;
+                d->blockStreamOffset = streamOffset;
+                return true;
+            }
+            error = "Cannot seek in the source";
+        } else if (error.isEmpty()) {
+            error = "Block is outside of the lzop stream";
+        }
+    }
+
+    d->finished = true;
+    d->failed = true;
+    setErrorString(error);
+    qCWarning(cr) << "Error seeking lzop stream:" << error;
+    return false;
+}
+
+bool CReporterLzoReader::hasError() const
+{
+    return d_ptr->failed;
+}
+
+bool CReporterLzoReader::open(OpenMode mode)
+{
+    Q_D(CReporterLzoReader);
+
+    if (mode & WriteOnly) {
+        setErrorString("Writing lzop streams is not supported");
+        return false;
+    }
+
+    if (!d->source->isOpen() && !d->source->open(ReadOnly)) {
+        setErrorString(d->source->errorString());
+        return false;
+    }
+
+    if (lzo_init() != LZO_E_OK) {
+        setErrorString("Failed to initialize LZO library");
+        return false;
+    }
+
+    d->dropPending();
+    d->finished = false;
+    d->failed = false;
+    d->block.clear();
+    d->blockPos = 0;
+
+    QString error;
+    if (!d->readStreamStart(&error)) {
+        setErrorString(error);
+        return false;
+    }
+    d->blockStreamOffset = d->streamOffset;
+
+    // Decoded blocks already are the buffer, don't copy them once more.
+    return QIODevice::open(mode | Unbuffered);
+}
+
+void CReporterLzoReader::close()
+{
+    Q_D(CReporterLzoReader);
+
+    QIODevice::close();
+
+    d->dropPending();
+    if (d->ownsSource) {
+        d->source->close();
+    }
+    d->block.clear();
+    d->compressed.clear();
+    d->blockPos = 0;
+}
+
+bool CReporterLzoReader::isSequential() const
+{
+    return true;
+}
+
+bool CReporterLzoReader::atEnd() const
+{
+    return d_ptr->finished && d_ptr->blockPos >= d_ptr->block.size() &&
+           QIODevice::bytesAvailable() == 0;
+}
+
+qint64 CReporterLzoReader::bytesAvailable() const
+{
+    return d_ptr->block.size() - d_ptr->blockPos + QIODevice::bytesAvailable();
+}
+
+qint64 CReporterLzoReader::readData(char *data, qint64 maxSize)
+{
+    Q_D(CReporterLzoReader);
+
+    qint64 total = 0;
+    while (total < maxSize) {
+        if (d->blockPos >= d->block.size()) {
+            // Decode the next block, but keep it for subsequent reads.
+            QByteArray block = readBlock();
+            if (block.isEmpty()) {
+                if (d->failed && total == 0) {
+                    return -1;
+                }
+                break;
+            }
+            d->blockPos = 0;
+        }
+
+        qint64 n = qMin<qint64>(maxSize - total, d->block.size() - d->blockPos);
+        memcpy(data + total, d->block.constData() + d->blockPos, n);
+        d->blockPos += n;
+        total += n;
+    }
+
+    return total;
+}
+
+qint64 CReporterLzoReader::writeData(const char *data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+
+    return -1;
+}
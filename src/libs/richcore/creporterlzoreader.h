@@ -0,0 +1,171 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERLZOREADER_H
+#define CREPORTERLZOREADER_H
+
+#include <QIODevice>
+
+#include "creporterexport.h"
+
+class CReporterLzoReaderPrivate;
+
+/*!
+ * @class CReporterLzoReader
+ * @brief Sequential device decompressing an lzop stream.
+ *
+ * The stream is decoded one block at a time, so memory use is bounded by
+ * the lzop block size regardless of the size of the stream. Concatenated
+ * lzop streams, as created by appending to a rich core, are read as one.
+ */
+class CREPORTER_EXPORT CReporterLzoReader : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    /*!
+     * @brief Creates reader of compressed data from another device.
+     *
+     * @param source Device with lzop stream. Must stay valid during the
+     *               lifetime of the reader; it is opened if it isn't open yet.
+     * @param parent Owner of this object.
+     */
+    explicit CReporterLzoReader(QIODevice *source, QObject *parent = 0);
+
+    /*!
+     * @brief Creates reader of an lzop compressed file.
+     *
+     * @param fileName Path to the file.
+     * @param parent Owner of this object.
+     */
+    explicit CReporterLzoReader(const QString &fileName, QObject *parent = 0);
+
+    ~CReporterLzoReader();
+
+    /*!
+     * @brief Checks whether data start with lzop file magic.
+     *
+     * @param header At least the first 9 bytes of the data.
+     */
+    static bool isLzoStream(const QByteArray &header);
+
+    /*!
+     * @brief Computes size of the data in an lzop file without decoding it.
+     *
+     * Only the block headers are parsed, blocks are not decompressed.
+     *
+     * @param fileName Path to the file.
+     * @return Total uncompressed size, or -1 if the file isn't a valid lzop
+     *         stream.
+     */
+    static qint64 uncompressedSize(const QString &fileName);
+
+    /*!
+     * @brief Decodes and returns the next block of uncompressed data.
+     *
+     * If part of the current block was already read with read(), the rest
+     * of it is returned. The data are not copied.
+     *
+     * @return Uncompressed data, or empty array at the end of the stream or
+     *         on error.
+     */
+    QByteArray readBlock();
+
+    /*!
+     * @brief Sets number of blocks decoded at the same time.
+     *
+     * With more than one thread, the reader reads the block headers ahead
+     * and decompresses up to twice @a threads blocks in the global thread
+     * pool, while blocks are still returned in stream order. Worth it only
+     * for streams of many blocks, like rich cores with a core dump.
+     *
+     * @param threads Number of threads, e.g. QThread::idealThreadCount().
+     *                1 decodes serially in the calling thread, the default.
+     */
+    void setDecodingThreads(int threads);
+
+    /*!
+     * @brief Number of blocks decoded at the same time.
+     */
+    int decodingThreads() const;
+
+    /*!
+     * @brief Sets whether checksums of the blocks are verified.
+     *
+     * Blocks are checked against those of the Adler-32 and CRC-32 checksums
+     * of their compressed and uncompressed data the stream has. A mismatch
+     * stops decoding with an error. The header checksums are always checked.
+     *
+     * @sa CReporterChecksum
+     */
+    void setVerifyChecksums(bool verify);
+
+    /*!
+     * @brief Position in the compressed source where the next block starts.
+     */
+    qint64 compressedPos() const;
+
+    /*!
+     * @brief Position in the source of the block last returned by readBlock().
+     */
+    qint64 blockOffset() const;
+
+    /*!
+     * @brief Position in the source of the lzop header of the stream the
+     *        block last returned by readBlock() belongs to.
+     */
+    qint64 streamOffset() const;
+
+    /*!
+     * @brief Continues decoding from given block.
+     *
+     * Requires a source that supports seeking.
+     *
+     * @param streamOffset Position of the header of the lzop stream with the
+     *                     block, as returned by streamOffset().
+     * @param blockOffset Position of the block, as returned by blockOffset().
+     */
+    bool seekBlock(qint64 streamOffset, qint64 blockOffset);
+
+    /*!
+     * @brief Whether decoding stopped because the stream is broken.
+     *
+     * @sa errorString()
+     */
+    bool hasError() const;
+
+    virtual bool open(OpenMode mode);
+    virtual void close();
+    virtual bool isSequential() const;
+    virtual bool atEnd() const;
+    virtual qint64 bytesAvailable() const;
+
+protected:
+    virtual qint64 readData(char *data, qint64 maxSize);
+    virtual qint64 writeData(const char *data, qint64 maxSize);
+
+private:
+    Q_DISABLE_COPY(CReporterLzoReader)
+    Q_DECLARE_PRIVATE(CReporterLzoReader)
+
+    CReporterLzoReaderPrivate *d_ptr;
+};
+
+#endif // CREPORTERLZOREADER_H
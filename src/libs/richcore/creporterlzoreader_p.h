@@ -0,0 +1,195 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERLZOREADER_P_H
+#define CREPORTERLZOREADER_P_H
+
+#include <QByteArray>
+#include <QFuture>
+#include <QQueue>
+#include <QString>
+
+#include "creporterlzop_p.h"
+
+class QIODevice;
+
+/*!
+ * @brief lzop block read from the stream.
+ *
+ * Holds everything needed to decompress the block independently of the
+ * reader, possibly in another thread.
+ */
+struct CReporterLzoBlock
+{
+    CReporterLzoBlock();
+
+    //! @arg Data as stored in the stream, compressed if shorter than
+    //!      @a dstLength.
+    QByteArray payload;
+    //! @arg Size of the uncompressed data.
+    quint32 dstLength;
+    //! @arg Flags of the lzop stream of the block.
+    quint32 flags;
+    //! @arg Whether the checksums are to be verified.
+    bool verify;
+    //! @arg Checksums of the uncompressed data, as stored in the stream.
+    quint32 adler32;
+    quint32 crc32;
+    //! @arg Checksums of the compressed data, as stored in the stream.
+    quint32 compressedAdler32;
+    quint32 compressedCrc32;
+    //! @arg Source position of the block.
+    qint64 offset;
+    //! @arg Source position of the header of the lzop stream of the block.
+    qint64 streamOffset;
+    //! @arg Source position following the block.
+    qint64 end;
+    //! @arg Uncompressed data.
+    QByteArray data;
+    //! @arg Description of the problem if decompression failed.
+    QString error;
+};
+
+/*!
+ * @class CReporterLzoReaderPrivate
+ * @brief Private CReporterLzoReader class.
+ *
+ * @sa CReporterLzoReader
+ */
+class CReporterLzoReaderPrivate
+{
+public:
+    CReporterLzoReaderPrivate();
+
+    enum Result {
+        //! Block was decoded.
+        BlockRead,
+        //! End of the stream was reached.
+        EndOfStream,
+        //! Stream is broken.
+        StreamError
+    };
+
+    //! @arg Device the compressed data are read from.
+    QIODevice *source;
+    //! @arg Whether the source is owned by the reader.
+    bool ownsSource;
+    //! @arg Flags of the lzop stream being read.
+    quint32 flags;
+    //! @arg Compressed data of the current block.
+    QByteArray compressed;
+    //! @arg Uncompressed data of the current block.
+    QByteArray block;
+    //! @arg Read position in the current block.
+    int blockPos;
+    //! @arg Whether the end of the stream or an error was reached.
+    bool finished;
+    //! @arg Whether the stream is broken.
+    bool failed;
+    //! @arg Number of bytes read from the source.
+    qint64 sourcePos;
+    //! @arg Source position of the current block.
+    qint64 blockOffset;
+    //! @arg Source position of the header of the lzop stream of the current
+    //!      block.
+    qint64 blockStreamOffset;
+    //! @arg Source position following the current block.
+    qint64 blockEnd;
+    //! @arg Source position of the header of the lzop stream being parsed.
+    qint64 streamOffset;
+    //! @arg Checksums of the current block, as stored in the stream.
+    quint32 adler32;
+    quint32 crc32;
+    //! @arg Whether checksums of the blocks are verified.
+    bool verifyChecksums;
+    //! @arg Number of blocks to decode concurrently, 1 to decode serially.
+    int threads;
+    //! @arg Blocks being decoded ahead of the current one, in stream order.
+    QQueue<QFuture<CReporterLzoBlock> > pending;
+    //! @arg Result of the last attempt to read a block ahead.
+    Result readAhead;
+    //! @arg Description of the problem that stopped reading ahead.
+    QString readAheadError;
+    //! @arg If set, bytes read from the source are collected here.
+    QByteArray *header;
+
+    /*!
+     * Reads from the source until @a size bytes are read or the source has
+     * no more data.
+     *
+     * @return Number of bytes read.
+     */
+    qint64 readSome(char *data, qint64 size);
+    bool readFully(char *data, qint64 size);
+    bool readUInt8(quint8 *value);
+    bool readUInt16(quint16 *value);
+    bool readUInt32(quint32 *value);
+
+    /*!
+     * Reads lzop magic and header.
+     *
+     * @param error Set to description of the problem on failure.
+     */
+    bool readStreamStart(QString *error);
+
+    /*!
+     * Parses lzop header following the magic.
+     *
+     * @param error Set to description of the problem on failure.
+     */
+    bool readHeader(QString *error);
+
+    /*!
+     * Reads next block from the source without decompressing it.
+     *
+     * @param error Set to description of the problem on failure.
+     */
+    Result readRawBlock(CReporterLzoBlock *raw, QString *error);
+
+    /*!
+     * Decompresses @a raw into @a data, verifying its checksums if
+     * requested.
+     *
+     * @param error Set to description of the problem on failure.
+     */
+    static bool decompress(const CReporterLzoBlock &raw, QByteArray *data,
+                           QString *error);
+
+    /*!
+     * Returns @a raw with uncompressed data or error set. Runs in the
+     * thread pool.
+     */
+    static CReporterLzoBlock decompressed(CReporterLzoBlock raw);
+
+    /*!
+     * Decodes next block into @a block, either directly or by taking the
+     * oldest of the blocks decoded ahead.
+     *
+     * @param error Set to description of the problem on failure.
+     */
+    Result decodeBlock(QString *error);
+
+    /*!
+     * Waits for the blocks being decoded ahead and drops them.
+     */
+    void dropPending();
+};
+
+#endif // CREPORTERLZOREADER_P_H
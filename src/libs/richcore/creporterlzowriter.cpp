@@ -0,0 +1,528 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creporterlzowriter.h"
+
+#include <QBuffer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFuture>
+#include <QQueue>
+#include <QThreadPool>
+#include <QtConcurrentRun>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <lzo/lzo1x.h>
+
+#include "creporterchecksum.h"
+#include "creporterlzop_p.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+
+//! Format version written to the header, same as lzop 1.03.
+const quint16 LZOP_VERSION = 0x1030;
+//! Compression level recorded for LZO1X-1.
+const quint8 LZOP_LEVEL = 3;
+//! Mode of the original file recorded in the header.
+const quint32 LZOP_FILE_MODE = 0100644;
+
+const quint32 WRITER_FLAGS = LZOP_F_ADLER32_D | LZOP_F_ADLER32_C |
+                             LZOP_F_OS_UNIX;
+
+void appendUInt8(QByteArray *data, quint8 value)
+{
+    data->append(char(value));
+}
+
+void appendUInt16(QByteArray *data, quint16 value)
+{
+    data->append(char(value >> 8));
+    data->append(char(value));
+}
+
+void appendUInt32(QByteArray *data, quint32 value)
+{
+    data->append(char(value >> 24));
+    data->append(char(value >> 16));
+    data->append(char(value >> 8));
+    data->append(char(value));
+}
+
+quint32 adler32(const char *data, int size)
+{
+    return CReporterChecksum::adler32(1, data, size);
+}
+
+//! Size of block header with checksum of compressed data.
+const int BLOCK_HEADER_SIZE = 16;
+
+/*!
+ * Encodes block of at most LZOP_MAX_BLOCK_SIZE bytes, including its header,
+ * into @a block.
+ *
+ * @param workMemory LZO1X_1_MEM_COMPRESS bytes for the compressor.
+ */
+bool encodeBlock(const char *data, int size, bool compress, char *workMemory,
+                 QByteArray *block, QString *error)
+{
+    // Worst case expansion of LZO1X.
+    block->resize(BLOCK_HEADER_SIZE + size + size / 16 + 64 + 3);
+    char *payload = block->data() + BLOCK_HEADER_SIZE;
+    lzo_uint compressedSize = size;
+
+    if (compress) {
+        compressedSize = block->size() - BLOCK_HEADER_SIZE;
+        int result = lzo1x_1_compress(
+                reinterpret_cast<const lzo_bytep>(data), size,
+                reinterpret_cast<lzo_bytep>(payload), &compressedSize,
+                workMemory);
+        if (result != LZO_E_OK) {
+            *error = QString("LZO compression failed (error %1)").arg(result);
+            return false;
+        }
+    }
+
+    QByteArray header;
+    appendUInt32(&header, size);
+    if (compressedSize < lzo_uint(size)) {
+        appendUInt32(&header, compressedSize);
+        appendUInt32(&header, adler32(data, size));
+        appendUInt32(&header, adler32(payload, compressedSize));
+        memcpy(block->data(), header.constData(), header.size());
+        block->resize(BLOCK_HEADER_SIZE + compressedSize);
+        return true;
+    }
+
+    // Incompressible data are stored as they are, without the checksum of
+    // compressed data.
+    appendUInt32(&header, size);
+    appendUInt32(&header, adler32(data, size));
+    memcpy(block->data(), header.constData(), header.size());
+    memcpy(block->data() + header.size(), data, size);
+    block->resize(header.size() + size);
+    return true;
+}
+
+/*!
+ * Block encoded in the thread pool.
+ */
+struct EncodedBlock
+{
+    //! Header and data of the block as written to the stream.
+    QByteArray data;
+    //! Description of the problem if encoding failed.
+    QString error;
+};
+
+EncodedBlock encodedBlock(QByteArray data, bool compress)
+{
+    EncodedBlock block;
+    QByteArray workMemory(LZO1X_1_MEM_COMPRESS, Qt::Uninitialized);
+    if (!encodeBlock(data.constData(), data.size(), compress, workMemory.data(),
+                     &block.data, &block.error)) {
+        block.data.clear();
+    }
+    return block;
+}
+
+}
+
+/*!
+ * @class CReporterLzoWriterPrivate
+ * @brief Private CReporterLzoWriter class.
+ *
+ * @sa CReporterLzoWriter
+ */
+class CReporterLzoWriterPrivate
+{
+public:
+    CReporterLzoWriterPrivate(QIODevice *device, int blockSize);
+
+    //! @arg Device the stream is written to.
+    QIODevice *device;
+    //! @arg Uncompressed size of one block.
+    int blockSize;
+    //! @arg Uncompressed data not forming a full block yet.
+    QByteArray pending;
+    //! @arg Encoded block, reused between blocks.
+    QByteArray compressed;
+    //! @arg Work memory of the compressor.
+    QByteArray workMemory;
+    //! @arg Whether blocks are compressed.
+    bool compressionEnabled;
+    //! @arg Whether the header was written and the stream is not closed.
+    bool opened;
+    //! @arg Number of blocks compressed at the same time.
+    int threads;
+    //! @arg Threads compressing the blocks, created on demand.
+    QThreadPool *pool;
+    //! @arg Blocks being compressed, in stream order.
+    QQueue<QFuture<EncodedBlock> > encoding;
+    //! @arg Description of the last error.
+    QString error;
+
+    bool writeBlock(const char *data, int size);
+    bool writeData(const char *data, qint64 size);
+
+    /*!
+     * Writes compressed blocks until at most @a maxEncoding remain in the
+     * thread pool.
+     */
+    bool flushEncoded(int maxEncoding);
+};
+
+CReporterLzoWriterPrivate::CReporterLzoWriterPrivate(QIODevice *device,
+        int blockSize)
+    : device(device), blockSize(qBound(1, blockSize, LZOP_MAX_BLOCK_SIZE)),
+      compressionEnabled(true), opened(false), threads(1), pool(0)
+{
+}
+
+bool CReporterLzoWriterPrivate::writeBlock(const char *data, int size)
+{
+    if (threads > 1) {
+        if (!pool) {
+            pool = new QThreadPool;
+            pool->setMaxThreadCount(threads);
+        }
+        // Blocks are independent, only their order in the stream matters.
+        encoding.enqueue(QtConcurrent::run(pool, encodedBlock,
+                                           QByteArray(data, size),
+                                           compressionEnabled));
+        return flushEncoded(2 * threads);
+    }
+
+    return encodeBlock(data, size, compressionEnabled, workMemory.data(),
+                       &compressed, &error) &&
+           writeData(compressed.constData(), compressed.size());
+}
+
+bool CReporterLzoWriterPrivate::writeData(const char *data, qint64 size)
+{
+    if (device->write(data, size) != size) {
+        error = device->errorString();
+        return false;
+    }
+    return true;
+}
+
+bool CReporterLzoWriterPrivate::flushEncoded(int maxEncoding)
+{
+    while (encoding.size() > maxEncoding) {
+        EncodedBlock block = encoding.dequeue().result();
+        if (!block.error.isEmpty()) {
+            error = block.error;
+            return false;
+        }
+        if (!writeData(block.data.constData(), block.data.size())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+CReporterLzoWriter::CReporterLzoWriter(QIODevice *device, int blockSize)
+    : d_ptr(new CReporterLzoWriterPrivate(device, blockSize))
+{
+}
+
+CReporterLzoWriter::~CReporterLzoWriter()
+{
+    // Waits for the blocks still being compressed.
+    delete d_ptr->pool;
+    delete d_ptr;
+    d_ptr = 0;
+}
+
+void CReporterLzoWriter::setCompressionEnabled(bool enabled)
+{
+    d_ptr->compressionEnabled = enabled;
+}
+
+void CReporterLzoWriter::setCompressionThreads(int threads)
+{
+    d_ptr->threads = qMax(threads, 1);
+    if (d_ptr->pool) {
+        d_ptr->pool->setMaxThreadCount(d_ptr->threads);
+    }
+}
+
+int CReporterLzoWriter::compressionThreads() const
+{
+    return d_ptr->threads;
+}
+
+bool CReporterLzoWriter::open(const QString &name, const QDateTime &mtime)
+{
+    Q_D(CReporterLzoWriter);
+
+    if (lzo_init() != LZO_E_OK) {
+        d->error = "Failed to initialize LZO library";
+        return false;
+    }
+    d->workMemory.resize(LZO1X_1_MEM_COMPRESS);
+
+    QByteArray fileName = name.toUtf8().left(255);
+    quint64 time = mtime.isValid() ?
+                   qMax<qint64>(0, mtime.toMSecsSinceEpoch() / 1000) : 0;
+
+    QByteArray header;
+    appendUInt16(&header, LZOP_VERSION);
+    appendUInt16(&header, lzo_version() & 0xffff);
+    appendUInt16(&header, LZOP_VERSION_0940);
+    appendUInt8(&header, LZOP_M_LZO1X_1);
+    appendUInt8(&header, LZOP_LEVEL);
+    appendUInt32(&header, WRITER_FLAGS);
+    appendUInt32(&header, LZOP_FILE_MODE);
+    appendUInt32(&header, time & 0xffffffff);
+    appendUInt32(&header, time >> 32);
+    appendUInt8(&header, fileName.size());
+    header.append(fileName);
+    quint32 checksum = adler32(header.constData(), header.size());
+
+    appendUInt32(&header, checksum);
+
+    d->pending.clear();
+    d->opened = d->writeData(LZOP_MAGIC, sizeof(LZOP_MAGIC)) &&
+                d->writeData(header.constData(), header.size());
+    return d->opened;
+}
+
+bool CReporterLzoWriter::write(const char *data, qint64 size)
+{
+    Q_D(CReporterLzoWriter);
+
+    if (!d->opened) {
+        if (d->error.isEmpty()) {
+            d->error = "Stream is not open";
+        }
+        return false;
+    }
+
+    if (!d->pending.isEmpty()) {
+        int n = qMin<qint64>(size, d->blockSize - d->pending.size());
+        d->pending.append(data, n);
+        data += n;
+        size -= n;
+
+        if (d->pending.size() < d->blockSize) {
+            return true;
+        }
+        if (!d->writeBlock(d->pending.constData(), d->pending.size())) {
+            return false;
+        }
+        d->pending.clear();
+    }
+
+    // Compress full blocks directly from the caller's buffer.
+    while (size >= d->blockSize) {
+        if (!d->writeBlock(data, d->blockSize)) {
+            return false;
+        }
+        data += d->blockSize;
+        size -= d->blockSize;
+    }
+
+    d->pending.append(data, size);
+    return true;
+}
+
+bool CReporterLzoWriter::write(const QByteArray &data)
+{
+    return write(data.constData(), data.size());
+}
+
+bool CReporterLzoWriter::close()
+{
+    Q_D(CReporterLzoWriter);
+
+    if (!d->opened) {
+        return false;
+    }
+    d->opened = false;
+
+    if (!d->pending.isEmpty() &&
+            !d->writeBlock(d->pending.constData(), d->pending.size())) {
+        return false;
+    }
+    d->pending.clear();
+
+    if (!d->flushEncoded(0)) {
+        return false;
+    }
+
+    // Block with zero length terminates the stream.
+    QByteArray end;
+    appendUInt32(&end, 0);
+    bool ok = d->writeData(end.constData(), end.size());
+
+    d->compressed.clear();
+    d->workMemory.clear();
+    return ok;
+}
+
+QString CReporterLzoWriter::errorString() const
+{
+    return d_ptr->error;
+}
+
+QByteArray CReporterLzoWriter::compress(const QByteArray &data,
+                                        const QString &name)
+{
+    QByteArray stream;
+    QBuffer buffer(&stream);
+    buffer.open(QIODevice::WriteOnly);
+
+    CReporterLzoWriter writer(&buffer);
+    if (!writer.open(name) || !writer.write(data) || !writer.close()) {
+        qCWarning(cr) << "Compression failed:" << writer.errorString();
+        return QByteArray();
+    }
+
+    return stream;
+}
+
+bool CReporterLzoWriter::appendToFile(const QString &filePath,
+                                      const QByteArray &data,
+                                      const QString &name)
+{
+    QByteArray stream = compress(data, name);
+    if (stream.isEmpty()) {
+        return false;
+    }
+
+    return appendStream(filePath, stream);
+}
+
+bool CReporterLzoWriter::appendStream(const QString &filePath,
+                                      const QByteArray &stream)
+{
+    int fd = ::open(QFile::encodeName(filePath).constData(),
+                    O_WRONLY | O_APPEND | O_CLOEXEC);
+    if (fd < 0) {
+        qCWarning(cr) << "Unable to open file:" << filePath << strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        qCWarning(cr) << "Unable to stat file:" << filePath << strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    // One write keeps the stream in one piece when there are more writers.
+    ssize_t written;
+    do {
+        written = ::write(fd, stream.constData(), stream.size());
+    } while (written < 0 && errno == EINTR);
+
+    bool ok = (written == stream.size());
+    if (!ok) {
+        qCWarning(cr) << "Unable to append to file:" << filePath
+                      << (written < 0 ? strerror(errno) : "short write");
+        // Don't leave a truncated stream behind.
+        if (written > 0 && ftruncate(fd, st.st_size) < 0) {
+            qCWarning(cr) << "Unable to restore file:" << filePath;
+        }
+    }
+
+    ::close(fd);
+    return ok;
+}
+
+bool CReporterLzoWriter::compressFile(const QString &sourcePath,
+                                      const QString &targetPath)
+{
+    QFile source(sourcePath);
+    if (!source.open(QIODevice::ReadOnly)) {
+        qCWarning(cr) << "Unable to open file:" << sourcePath << source.errorString();
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(source.handle(), &st) < 0) {
+        qCWarning(cr) << "Unable to stat file:" << sourcePath << strerror(errno);
+        return false;
+    }
+
+    QFile target(targetPath);
+    if (!target.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(cr) << "Unable to create file:" << targetPath << target.errorString();
+        return false;
+    }
+
+    // The source is read once, don't push more useful data out of the cache.
+    posix_fadvise(source.handle(), 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    CReporterLzoWriter writer(&target);
+    bool ok = writer.open(QFileInfo(sourcePath).fileName(),
+                          QDateTime::fromTime_t(st.st_mtime));
+
+    QByteArray buffer(DefaultBlockSize, Qt::Uninitialized);
+    while (ok) {
+        qint64 length = source.read(buffer.data(), buffer.size());
+        if (length <= 0) {
+            if (length < 0) {
+                qCWarning(cr) << "Unable to read file:" << sourcePath
+                              << source.errorString();
+                ok = false;
+            }
+            break;
+        }
+        ok = writer.write(buffer.constData(), length);
+    }
+
+    if (ok && !writer.close()) {
+        ok = false;
+    }
+    if (!ok && !writer.errorString().isEmpty()) {
+        qCWarning(cr) << "Compression of" << sourcePath << "failed:"
+                      << writer.errorString();
+    }
+
+    posix_fadvise(source.handle(), 0, 0, POSIX_FADV_DONTNEED);
+
+    if (ok) {
+        struct timespec times[2] = { st.st_atim, st.st_mtim };
+        ok = target.flush() &&
+             fchmod(target.handle(), st.st_mode & 07777) == 0 &&
+             futimens(target.handle(), times) == 0 &&
+             fdatasync(target.handle()) == 0;
+        if (!ok) {
+            qCWarning(cr) << "Unable to write file:" << targetPath << strerror(errno);
+        }
+    }
+
+    target.close();
+
+    if (!ok) {
+        QFile::remove(targetPath);
+    }
+    return ok;
+}
@@ -0,0 +1,165 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERLZOWRITER_H
+#define CREPORTERLZOWRITER_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+
+#include "creporterexport.h"
+
+class QIODevice;
+class CReporterLzoWriterPrivate;
+
+/*!
+ * @class CReporterLzoWriter
+ * @brief Writes lzop compatible compressed streams.
+ *
+ * Data are compressed in blocks with LZO1X-1, the method lzop uses by
+ * default, so the output can be decompressed with lzop or
+ * CReporterLzoReader. Blocks are independent of each other and can be
+ * compressed on several threads, see setCompressionThreads().
+ */
+class CREPORTER_EXPORT CReporterLzoWriter
+{
+public:
+    //! Uncompressed size of one block, same as lzop uses.
+    static const int DefaultBlockSize = 256 * 1024;
+
+    /*!
+     * @brief Creates writer of compressed data to a device.
+     *
+     * @param device Open device to write to. Must stay valid until close().
+     * @param blockSize Uncompressed size of one block.
+     */
+    explicit CReporterLzoWriter(QIODevice *device,
+                                int blockSize = DefaultBlockSize);
+
+    ~CReporterLzoWriter();
+
+    /*!
+     * @brief Sets whether blocks are compressed.
+     *
+     * Blocks that are not compressed are stored as they are, so they can be
+     * located and read directly in the file. Enabled by default.
+     */
+    void setCompressionEnabled(bool enabled);
+
+    /*!
+     * @brief Sets number of blocks compressed at the same time.
+     *
+     * With more than one thread, full blocks are copied and compressed in a
+     * thread pool of the writer limited to @a threads threads, while they
+     * are still written in order. The stream is identical to the one
+     * written by a single thread. Keeping @a threads below the number of
+     * CPUs leaves the rest of the system responsive.
+     *
+     * @param threads Number of threads, e.g. QThread::idealThreadCount().
+     *                1 compresses serially in the calling thread, the
+     *                default.
+     */
+    void setCompressionThreads(int threads);
+
+    /*!
+     * @brief Number of blocks compressed at the same time.
+     */
+    int compressionThreads() const;
+
+    /*!
+     * @brief Starts the stream by writing lzop header.
+     *
+     * @param name Original file name stored in the header.
+     * @param mtime Modification time stored in the header.
+     */
+    bool open(const QString &name = QString(),
+              const QDateTime &mtime = QDateTime::currentDateTimeUtc());
+
+    /*!
+     * @brief Compresses data to the stream.
+     *
+     * Full blocks are written to the device immediately, the rest is kept
+     * until more data arrive or the stream is closed.
+     */
+    bool write(const char *data, qint64 size);
+    bool write(const QByteArray &data);
+
+    /*!
+     * @brief Writes remaining data and terminates the stream.
+     */
+    bool close();
+
+    /*!
+     * @brief Description of the last error.
+     */
+    QString errorString() const;
+
+    /*!
+     * @brief Compresses data into a complete lzop stream in memory.
+     *
+     * @param data Uncompressed data.
+     * @param name Original file name stored in the header.
+     */
+    static QByteArray compress(const QByteArray &data,
+                               const QString &name = QString());
+
+    /*!
+     * @brief Appends data as a new lzop stream at the end of a file.
+     *
+     * The stream is compressed in memory and appended with a single write,
+     * so concurrent appends to the same file don't interleave. If the write
+     * fails, the file is truncated back to its original size.
+     *
+     * @param filePath Path to *.lzo file.
+     * @param data Uncompressed data.
+     * @param name Original file name stored in the header.
+     */
+    static bool appendToFile(const QString &filePath, const QByteArray &data,
+                             const QString &name = QString());
+
+    /*!
+     * @brief Appends already compressed lzop stream at the end of a file.
+     *
+     * @sa appendToFile()
+     */
+    static bool appendStream(const QString &filePath, const QByteArray &stream);
+
+    /*!
+     * @brief Compresses a file into a new lzop file.
+     *
+     * The source is streamed one block at a time. Permissions and times of
+     * the source are copied to the target, which is synced to disk before
+     * returning, so it can safely replace the source. On failure the target
+     * is removed.
+     *
+     * @param sourcePath Path to the file to compress.
+     * @param targetPath Path to the compressed file to create.
+     */
+    static bool compressFile(const QString &sourcePath, const QString &targetPath);
+
+private:
+    Q_DISABLE_COPY(CReporterLzoWriter)
+    Q_DECLARE_PRIVATE(CReporterLzoWriter)
+
+    CReporterLzoWriterPrivate *d_ptr;
+};
+
+#endif // CREPORTERLZOWRITER_H
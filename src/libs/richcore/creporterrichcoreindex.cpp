@@ -0,0 +1,289 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creporterrichcoreindex.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QThread>
+
+#include "creporterlzoreader.h"
+#include "creporternamespace.h"
+#include "creportersectionscanner.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+
+const QByteArray SECTION_MARKER("\n[---rich-core: ");
+const QByteArray SECTION_HEADER_END("---]\n");
+
+//! First line of the index, followed by the size of the rich core.
+const QByteArray INDEX_HEADER_PREFIX("rich-core-index-size: ");
+
+//! Suffix of the index files.
+const QString INDEX_SUFFIX(".index");
+
+//! Indexes larger than this are considered broken.
+const qint64 MAX_INDEX_SIZE = 4 * 1024 * 1024;
+
+//! Longest accepted section header line.
+const int MAX_HEADER_SIZE = 1024;
+
+void removeOrphans(const QDir &indexDir)
+{
+    QDir reportDir(indexDir.filePath(".."));
+    foreach (const QString &name,
+             indexDir.entryList(QStringList() << '*' + INDEX_SUFFIX, QDir::Files)) {
+        QString report = name.left(name.size() - INDEX_SUFFIX.size());
+        if (!reportDir.exists(report)) {
+            qCDebug(cr) << "Removing index of removed report" << report;
+            indexDir.remove(name);
+        }
+    }
+}
+
+}
+
+CReporterRichCoreIndex::Builder::Builder()
+    : windowOffset(0), decodedSize(0)
+{
+}
+
+void CReporterRichCoreIndex::Builder::addBlock(const QByteArray &data,
+                                               qint64 streamOffset,
+                                               qint64 blockOffset)
+{
+    if (data.isEmpty()) {
+        return;
+    }
+
+    Block block = { decodedSize, streamOffset, blockOffset };
+    blocks << block;
+
+    if (decodedSize == 0 && !data.startsWith('\n')) {
+        // The very first marker isn't preceded by a newline.
+        window = "\n";
+        windowOffset = -1;
+    }
+    decodedSize += data.size();
+    window.append(data);
+
+    int from = 0;
+    int keepFrom = -1;
+    forever {
+        int marker = CReporterSectionScanner::indexOf(window, SECTION_MARKER, from);
+        if (marker < 0) {
+            break;
+        }
+
+        int nameStart = marker + SECTION_MARKER.size();
+        int nameEnd = CReporterSectionScanner::indexOf(window, SECTION_HEADER_END,
+                                                      nameStart);
+        if (nameEnd < 0 && window.size() - marker < MAX_HEADER_SIZE) {
+            // Header continues in the next block.
+            keepFrom = marker;
+            break;
+        }
+        if (nameEnd < 0 || nameEnd - marker > MAX_HEADER_SIZE) {
+            from = marker + 1;
+            continue;
+        }
+
+        if (!sections.isEmpty()) {
+            sections.last().size = windowOffset + marker - sections.last().offset;
+        }
+
+        Entry entry;
+        entry.name = QString::fromUtf8(window.constData() + nameStart,
+                                       nameEnd - nameStart);
+        entry.offset = windowOffset + nameEnd + SECTION_HEADER_END.size();
+        entry.size = 0;
+        sections << entry;
+
+        from = nameEnd + SECTION_HEADER_END.size();
+    }
+
+    if (keepFrom < 0) {
+        // Keep what might be the beginning of a marker.
+        keepFrom = qMax(from, window.size() - (SECTION_MARKER.size() - 1));
+    }
+    window.remove(0, keepFrom);
+    windowOffset += keepFrom;
+}
+
+CReporterRichCoreIndex::Entries CReporterRichCoreIndex::Builder::entries() const
+{
+    Entries result(sections);
+    if (!result.isEmpty()) {
+        result.last().size = decodedSize - result.last().offset;
+    }
+
+    // Find the block where each section's data start.
+    int block = 0;
+    for (int i = 0; i < result.size(); ++i) {
+        Entry &entry = result[i];
+        while (block + 1 < blocks.size() &&
+                blocks.at(block + 1).decodedOffset <= entry.offset) {
+            ++block;
+        }
+        entry.streamOffset = blocks.at(block).streamOffset;
+        entry.blockOffset = blocks.at(block).blockOffset;
+        entry.blockSkip = entry.offset - blocks.at(block).decodedOffset;
+    }
+
+    return result;
+}
+
+QString CReporterRichCoreIndex::indexPath(const QString &filePath)
+{
+    QFileInfo fi(filePath);
+    return fi.absolutePath() + '/' + CReporter::IndexDirName + '/' +
+           fi.fileName() + INDEX_SUFFIX;
+}
+
+bool CReporterRichCoreIndex::load(const QString &filePath, Entries *entries)
+{
+    QFile file(indexPath(filePath));
+    if (!file.open(QIODevice::ReadOnly) || file.size() > MAX_INDEX_SIZE) {
+        return false;
+    }
+
+    QByteArray text = file.readAll();
+    int headerEnd = text.indexOf('\n');
+    if (!text.startsWith(INDEX_HEADER_PREFIX) || headerEnd < 0) {
+        qCDebug(cr) << "Ignoring broken section index of" << filePath;
+        return false;
+    }
+
+    bool ok = false;
+    qint64 reportSize = text.mid(INDEX_HEADER_PREFIX.size(),
+                                 headerEnd - INDEX_HEADER_PREFIX.size())
+                        .toLongLong(&ok);
+    if (!ok || reportSize != QFileInfo(filePath).size()) {
+        // Report was changed or replaced after the index was built.
+        return false;
+    }
+
+    Entries result;
+    foreach (const QByteArray &line, text.mid(headerEnd + 1).split('\n')) {
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        QList<QByteArray> fields = line.split('\t');
+        if (fields.size() != 6) {
+            return false;
+        }
+
+        Entry entry;
+        entry.name = QString::fromUtf8(fields.at(0));
+        entry.offset = fields.at(1).toLongLong(&ok);
+        entry.size = ok ? fields.at(2).toLongLong(&ok) : 0;
+        entry.streamOffset = ok ? fields.at(3).toLongLong(&ok) : 0;
+        entry.blockOffset = ok ? fields.at(4).toLongLong(&ok) : 0;
+        entry.blockSkip = ok ? fields.at(5).toLongLong(&ok) : 0;
+        if (!ok) {
+            return false;
+        }
+        result << entry;
+    }
+
+    *entries = result;
+    return true;
+}
+
+bool CReporterRichCoreIndex::build(const QString &filePath, Entries *entries)
+{
+    CReporterLzoReader lzo(filePath);
+    lzo.setDecodingThreads(QThread::idealThreadCount());
+    if (!lzo.open(QIODevice::ReadOnly)) {
+        qCWarning(cr) << "Cannot index" << filePath << ":" << lzo.errorString();
+        return false;
+    }
+
+    Builder builder;
+    QByteArray data;
+    while (!(data = lzo.readBlock()).isEmpty()) {
+        builder.addBlock(data, lzo.streamOffset(), lzo.blockOffset());
+    }
+
+    if (lzo.hasError()) {
+        qCWarning(cr) << "Cannot index" << filePath << ":" << lzo.errorString();
+        return false;
+    }
+
+    *entries = builder.entries();
+    return true;
+}
+
+bool CReporterRichCoreIndex::save(const QString &filePath,
+                                  const Entries &entries)
+{
+    QFileInfo fi(filePath);
+    QDir dir(fi.absolutePath());
+    if (!dir.exists(CReporter::IndexDirName) &&
+            !dir.mkdir(CReporter::IndexDirName)) {
+        qCWarning(cr) << "Cannot create index directory in" << dir.path();
+        return false;
+    }
+
+    QByteArray text = INDEX_HEADER_PREFIX + QByteArray::number(fi.size()) + '\n';
+    foreach (const Entry &entry, entries) {
+        text += entry.name.toUtf8() + '\t' +
+                QByteArray::number(entry.offset) + '\t' +
+                QByteArray::number(entry.size) + '\t' +
+                QByteArray::number(entry.streamOffset) + '\t' +
+                QByteArray::number(entry.blockOffset) + '\t' +
+                QByteArray::number(entry.blockSkip) + '\n';
+    }
+
+    QSaveFile file(indexPath(filePath));
+    if (!file.open(QIODevice::WriteOnly) || file.write(text) != text.size() ||
+            !file.commit()) {
+        qCWarning(cr) << "Cannot write index of" << filePath << ":"
+                      << file.errorString();
+        return false;
+    }
+
+    removeOrphans(QDir(dir.filePath(CReporter::IndexDirName)));
+
+    return true;
+}
+
+bool CReporterRichCoreIndex::ensure(const QString &filePath)
+{
+    Entries entries;
+    if (load(filePath, &entries)) {
+        return true;
+    }
+
+    if (!filePath.endsWith(".lzo") || !build(filePath, &entries)) {
+        return false;
+    }
+
+    qCDebug(cr) << "Storing index of" << entries.size() << "sections of"
+                << filePath;
+
+    return save(filePath, entries);
+}
@@ -0,0 +1,157 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERRICHCOREINDEX_H
+#define CREPORTERRICHCOREINDEX_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+#include "creporterexport.h"
+
+/*!
+ * @class CReporterRichCoreIndex
+ * @brief Index of sections in lzop compressed rich cores.
+ *
+ * The index is kept next to the rich core, in a file in the
+ * CReporter::IndexDirName subdirectory of its directory, so the report
+ * itself is uploaded unchanged. For every section the index records the
+ * lzop block where the section data starts, so a reader can decompress
+ * just the blocks of the sections it needs.
+ *
+ * The index also records the size of the rich core. Appending anything to
+ * the report, like user comments, or reducing its core dump makes the
+ * index stale; it is then not used and has to be built again.
+ */
+class CREPORTER_EXPORT CReporterRichCoreIndex
+{
+public:
+    /*!
+     * @brief Location of one section.
+     */
+    struct Entry {
+        //! Section name.
+        QString name;
+        //! Offset of section data in the uncompressed rich core.
+        qint64 offset;
+        //! Size of section data.
+        qint64 size;
+        //! File offset of the header of the lzop stream containing the data.
+        qint64 streamOffset;
+        //! File offset of the lzop block where the data start.
+        qint64 blockOffset;
+        //! Offset of the data in the uncompressed block.
+        qint64 blockSkip;
+    };
+
+    typedef QList<Entry> Entries;
+
+    /*!
+     * @class Builder
+     * @brief Creates index from the blocks of a rich core as they are
+     *        decoded, so that other readers of the whole file can build the
+     *        index on the way.
+     */
+    class CREPORTER_EXPORT Builder
+    {
+    public:
+        Builder();
+
+        /*!
+         * @brief Adds next uncompressed block of the rich core.
+         *
+         * @param data Uncompressed block.
+         * @param streamOffset File offset of the header of the lzop stream
+         *                     containing the block.
+         * @param blockOffset File offset of the block.
+         */
+        void addBlock(const QByteArray &data, qint64 streamOffset,
+                      qint64 blockOffset);
+
+        /*!
+         * @brief Sections found in the blocks added so far.
+         */
+        Entries entries() const;
+
+    private:
+        struct Block {
+            qint64 decodedOffset;
+            qint64 streamOffset;
+            qint64 blockOffset;
+        };
+
+        //! @arg Blocks added so far.
+        QList<Block> blocks;
+        //! @arg Sections found so far, without block locations.
+        Entries sections;
+        //! @arg Data that may still contain the beginning of a section header.
+        QByteArray window;
+        //! @arg Offset of the window in the uncompressed rich core.
+        qint64 windowOffset;
+        //! @arg Size of the blocks added so far.
+        qint64 decodedSize;
+    };
+
+    /*!
+     * @brief Path of the index file of a rich core.
+     *
+     * @param filePath Path to *.rcore.lzo file.
+     */
+    static QString indexPath(const QString &filePath);
+
+    /*!
+     * @brief Reads the index of a rich core.
+     *
+     * @param filePath Path to *.rcore.lzo file.
+     * @param entries Receives the sections.
+     * @return False if the file has no current index.
+     */
+    static bool load(const QString &filePath, Entries *entries);
+
+    /*!
+     * @brief Creates index by reading through a rich core.
+     *
+     * @param filePath Path to *.rcore.lzo file.
+     * @param entries Receives the sections.
+     */
+    static bool build(const QString &filePath, Entries *entries);
+
+    /*!
+     * @brief Stores index of a rich core.
+     *
+     * Indexes of reports that no longer exist are removed at the same time.
+     *
+     * @param filePath Path to *.rcore.lzo file.
+     * @param entries Sections of the rich core in its current state.
+     */
+    static bool save(const QString &filePath, const Entries &entries);
+
+    /*!
+     * @brief Makes sure a rich core has a current index, building and
+     *        storing it if it's missing.
+     *
+     * Reads the whole rich core if the index has to be built, so this should
+     * be done off the main thread.
+     */
+    static bool ensure(const QString &filePath);
+};
+
+#endif // CREPORTERRICHCOREINDEX_H
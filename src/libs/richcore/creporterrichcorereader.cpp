@@ -0,0 +1,437 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creporterrichcorereader.h"
+#include "creporterrichcorereader_p.h"
+
+#include <QFile>
+#include <QIODevice>
+
+#include "creporterlzoreader.h"
+#include "creportersectionscanner.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+
+const QByteArray SECTION_MARKER("\n[---rich-core: ");
+const QByteArray SECTION_HEADER_END("---]\n");
+
+}
+
+/*!
+ * @class CReporterRichCoreSectionDevice
+ * @brief Sequential device reading the current rich core section.
+ */
+class CReporterRichCoreSectionDevice : public QIODevice
+{
+public:
+    CReporterRichCoreSectionDevice(CReporterRichCoreReader *reader,
+                                   CReporterRichCoreReaderPrivate *d)
+        : reader(reader), d(d) {}
+
+    virtual bool isSequential() const {
+        return true;
+    }
+
+    virtual qint64 bytesAvailable() const {
+        return qMax(0, d->dataEnd - d->pos) + QIODevice::bytesAvailable();
+    }
+
+    virtual bool atEnd() const {
+        return QIODevice::bytesAvailable() == 0 && !d->findSectionData();
+    }
+
+protected:
+    virtual qint64 readData(char *data, qint64 maxSize) {
+        QByteArray chunk = reader->readSectionChunk(maxSize);
+        memcpy(data, chunk.constData(), chunk.size());
+        return chunk.size();
+    }
+
+    virtual qint64 writeData(const char *, qint64) {
+        return -1;
+    }
+
+private:
+    CReporterRichCoreReader *reader;
+    CReporterRichCoreReaderPrivate *d;
+};
+
+// ******** Class CReporterRichCoreReaderPrivate ********
+
+CReporterRichCoreReaderPrivate::CReporterRichCoreReaderPrivate()
+    : device(0), lzo(0), file(0), section(0), bufferOffset(0), pos(0),
+      dataEnd(0), markerFound(false), eof(false), started(false),
+      inSection(false), indexLoaded(false)
+{
+}
+
+CReporterRichCoreReaderPrivate::~CReporterRichCoreReaderPrivate()
+{
+    delete section;
+    if (file) {
+        // The reader opened the file, so it also owns the decompressor.
+        delete lzo;
+        delete file;
+    }
+}
+
+bool CReporterRichCoreReaderPrivate::fill()
+{
+    if (eof) {
+        return false;
+    }
+
+    pos = qMin(pos, buffer.size());
+    if (pos == buffer.size()) {
+        buffer.clear();
+    } else if (pos > 0) {
+        buffer.remove(0, pos);
+    }
+    bufferOffset += pos;
+    dataEnd = qMax(0, dataEnd - pos);
+    pos = 0;
+
+    QByteArray data;
+    if (lzo) {
+        data = lzo->readBlock();
+        if (lzo->hasError()) {
+            fail(lzo->errorString());
+        }
+    } else {
+        data = device->read(RICHCORE_READ_CHUNK_SIZE);
+        while (data.isEmpty() && device->isSequential() &&
+               device->waitForReadyRead(-1)) {
+            data = device->read(RICHCORE_READ_CHUNK_SIZE);
+        }
+    }
+
+    if (data.isEmpty()) {
+        eof = true;
+        return false;
+    }
+
+    if (buffer.isEmpty()) {
+        // Share the decompressed block instead of copying it.
+        buffer = data;
+    } else {
+        buffer.append(data);
+    }
+
+    return true;
+}
+
+bool CReporterRichCoreReaderPrivate::findSectionData()
+{
+    while (inSection && pos >= dataEnd) {
+        if (markerFound) {
+            return false;
+        }
+
+        int marker = CReporterSectionScanner::indexOf(buffer, SECTION_MARKER, dataEnd);
+        if (marker >= 0) {
+            dataEnd = marker;
+            markerFound = true;
+            continue;
+        }
+
+        // Tail of the buffer may hold the beginning of a marker.
+        int safeEnd = eof ? buffer.size() :
+                      buffer.size() - (SECTION_MARKER.size() - 1);
+        if (safeEnd > dataEnd) {
+            dataEnd = safeEnd;
+            continue;
+        }
+
+        if (eof) {
+            return false;
+        }
+        fill();
+    }
+
+    return inSection;
+}
+
+bool CReporterRichCoreReaderPrivate::jumpToSection(
+        const CReporterRichCoreIndex::Entry &entry)
+{
+    buffer.clear();
+    bufferOffset = entry.offset - entry.blockSkip;
+    pos = 0;
+    eof = false;
+    started = true;
+
+    if (!lzo->seekBlock(entry.streamOffset, entry.blockOffset)) {
+        fail(lzo->errorString());
+        return false;
+    }
+
+    fill();
+    if (buffer.size() < entry.blockSkip) {
+        fail("Section index doesn't match the file");
+        return false;
+    }
+
+    name = entry.name;
+    pos = entry.blockSkip;
+    dataEnd = pos;
+    markerFound = false;
+    inSection = true;
+    return true;
+}
+
+void CReporterRichCoreReaderPrivate::fail(const QString &message)
+{
+    if (error.isEmpty()) {
+        error = message;
+        qCWarning(cr) << "Error reading rich core:" << message;
+    }
+    eof = true;
+    inSection = false;
+}
+
+// ******** Class CReporterRichCoreReader ********
+
+CReporterRichCoreReader::CReporterRichCoreReader(QIODevice *device)
+    : d_ptr(new CReporterRichCoreReaderPrivate)
+{
+    Q_D(CReporterRichCoreReader);
+
+    d->device = device;
+    d->lzo = qobject_cast<CReporterLzoReader *>(device);
+
+    if (!device->isOpen() && !device->open(QIODevice::ReadOnly)) {
+        d->fail(device->errorString());
+    }
+}
+
+CReporterRichCoreReader::CReporterRichCoreReader(const QString &filePath)
+    : d_ptr(new CReporterRichCoreReaderPrivate)
+{
+    Q_D(CReporterRichCoreReader);
+
+    d->file = new QFile(filePath);
+    d->device = d->file;
+
+    if (!d->file->open(QIODevice::ReadOnly)) {
+        d->fail(QString("Cannot open %1: %2").arg(filePath)
+                .arg(d->file->errorString()));
+        return;
+    }
+
+    if (CReporterLzoReader::isLzoStream(d->file->peek(9))) {
+        d->lzo = new CReporterLzoReader(d->file);
+        d->device = d->lzo;
+        if (!d->lzo->open(QIODevice::ReadOnly)) {
+            d->fail(QString("Cannot decompress %1: %2").arg(filePath)
+                    .arg(d->lzo->errorString()));
+        }
+    }
+}
+
+CReporterRichCoreReader::~CReporterRichCoreReader()
+{
+    delete d_ptr;
+    d_ptr = 0;
+}
+
+bool CReporterRichCoreReader::nextSection()
+{
+    Q_D(CReporterRichCoreReader);
+
+    // Skip what is left of the current section.
+    while (d->findSectionData()) {
+        d->pos = d->dataEnd;
+    }
+
+    d->inSection = false;
+    d->name.clear();
+    if (d->section) {
+        d->section->close();
+    }
+
+    if (!d->error.isEmpty()) {
+        return false;
+    }
+
+    if (!d->started) {
+        // The very first marker isn't preceded by a newline.
+        while (d->buffer.isEmpty() && d->fill()) {
+        }
+        if (!d->buffer.startsWith('\n')) {
+            d->buffer.prepend('\n');
+            d->bufferOffset = -1;
+        }
+        d->started = true;
+    }
+
+    forever {
+        int available = d->buffer.size() - d->pos;
+
+        if (available >= SECTION_MARKER.size()) {
+            if (memcmp(d->buffer.constData() + d->pos,
+                       SECTION_MARKER.constData(), SECTION_MARKER.size()) != 0) {
+                d->fail("Section marker expected");
+                return false;
+            }
+
+            int nameStart = d->pos + SECTION_MARKER.size();
+            int nameEnd = CReporterSectionScanner::indexOf(d->buffer, SECTION_HEADER_END,
+                                                          nameStart);
+            int headerSize = nameEnd + SECTION_HEADER_END.size() - d->pos;
+            if (nameEnd >= 0 && headerSize <= RICHCORE_MAX_HEADER_SIZE) {
+                d->name = QString::fromUtf8(d->buffer.constData() + nameStart,
+                                            nameEnd - nameStart);
+                d->pos = nameEnd + SECTION_HEADER_END.size();
+                d->dataEnd = d->pos;
+                d->markerFound = false;
+                d->inSection = true;
+                return true;
+            }
+            if (nameEnd >= 0 || available >= RICHCORE_MAX_HEADER_SIZE) {
+                d->fail("Section header too long");
+                return false;
+            }
+        }
+
+        if (!d->fill()) {
+            if (!d->error.isEmpty()) {
+                return false;
+            }
+            if (available > 0) {
+                d->fail("Truncated section header");
+            }
+            return false;
+        }
+    }
+}
+
+bool CReporterRichCoreReader::seekSection(const QString &name)
+{
+    Q_D(CReporterRichCoreReader);
+
+    if (d->lzo && d->file && d->error.isEmpty()) {
+        if (!d->indexLoaded) {
+            d->indexLoaded = true;
+            CReporterRichCoreIndex::load(d->file->fileName(), &d->index);
+        }
+
+        // Jump over the sections in between, if the section is indexed.
+        qint64 current = d->bufferOffset + d->pos;
+        foreach (const CReporterRichCoreIndex::Entry &entry, d->index) {
+            if (entry.name == name && entry.offset > current) {
+                if (d->section) {
+                    d->section->close();
+                }
+                return d->jumpToSection(entry);
+            }
+        }
+
+        if (!d->index.isEmpty()) {
+            // Index lists all sections of the file.
+            return false;
+        }
+    }
+
+    while (nextSection()) {
+        if (sectionName() == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QString CReporterRichCoreReader::sectionName() const
+{
+    return d_ptr->name;
+}
+
+QByteArray CReporterRichCoreReader::readSectionChunk(qint64 maxSize)
+{
+    Q_D(CReporterRichCoreReader);
+
+    if (!d->findSectionData()) {
+        return QByteArray();
+    }
+
+    int size = d->dataEnd - d->pos;
+    if (maxSize >= 0 && maxSize < size) {
+        size = maxSize;
+    }
+
+    QByteArray chunk = QByteArray::fromRawData(d->buffer.constData() + d->pos,
+                                               size);
+    d->pos += size;
+    return chunk;
+}
+
+QByteArray CReporterRichCoreReader::readSection(qint64 maxSize)
+{
+    QByteArray data;
+
+    forever {
+        qint64 left = (maxSize < 0) ? -1 : maxSize - data.size();
+        if (left == 0) {
+            break;
+        }
+        QByteArray chunk = readSectionChunk(left);
+        if (chunk.isEmpty()) {
+            break;
+        }
+        data.append(chunk.constData(), chunk.size());
+    }
+
+    return data;
+}
+
+QIODevice *CReporterRichCoreReader::sectionDevice()
+{
+    Q_D(CReporterRichCoreReader);
+
+    if (!d->section) {
+        d->section = new CReporterRichCoreSectionDevice(this, d);
+    }
+    if (d->inSection && !d->section->isOpen()) {
+        d->section->open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    }
+
+    return d->section;
+}
+
+void CReporterRichCoreReader::setDecodingThreads(int threads)
+{
+    Q_D(CReporterRichCoreReader);
+
+    if (d->lzo) {
+        d->lzo->setDecodingThreads(threads);
+    }
+}
+
+bool CReporterRichCoreReader::hasError() const
+{
+    return !d_ptr->error.isEmpty();
+}
+
+QString CReporterRichCoreReader::errorString() const
+{
+    return d_ptr->error;
+}
@@ -0,0 +1,148 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERRICHCOREREADER_H
+#define CREPORTERRICHCOREREADER_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "creporterexport.h"
+
+class QIODevice;
+class CReporterRichCoreReaderPrivate;
+
+/*!
+ * @class CReporterRichCoreReader
+ * @brief Sequential parser of rich core sections.
+ *
+ * Rich core is a sequence of sections, each introduced by a line
+ * [---rich-core: NAME---]. The reader walks the sections in one pass with
+ * bounded memory and gives access to their contents either as views into
+ * its internal buffer or through a QIODevice.
+ *
+ * @code
+ * CReporterRichCoreReader reader(filePath);
+ * while (reader.nextSection()) {
+ *     if (reader.sectionName() == "packagelist") {
+ *         QByteArray packages = reader.readSection();
+ *     }
+ * }
+ * @endcode
+ */
+class CREPORTER_EXPORT CReporterRichCoreReader
+{
+public:
+    /*!
+     * @brief Creates reader of uncompressed rich core data.
+     *
+     * @param device Device with rich core data. May be CReporterLzoReader.
+     *               Must stay valid during the lifetime of the reader.
+     */
+    explicit CReporterRichCoreReader(QIODevice *device);
+
+    /*!
+     * @brief Creates reader of a rich core file.
+     *
+     * @param filePath Path to the file, either lzop compressed or plain.
+     */
+    explicit CReporterRichCoreReader(const QString &filePath);
+
+    ~CReporterRichCoreReader();
+
+    /*!
+     * @brief Advances to the next section.
+     *
+     * Unread data of the current section are skipped.
+     *
+     * @return False at the end of the rich core or on error.
+     */
+    bool nextSection();
+
+    /*!
+     * @brief Advances to the next section with given name.
+     *
+     * If the reader was created for an lzop compressed file that has a
+     * section index, the sections in between are not decompressed at all,
+     * and a section missing from the index isn't searched for.
+     *
+     * @return False if no such section follows the current one.
+     * @sa CReporterRichCoreIndex
+     */
+    bool seekSection(const QString &name);
+
+    /*!
+     * @brief Name of the current section.
+     */
+    QString sectionName() const;
+
+    /*!
+     * @brief Returns next part of the current section data.
+     *
+     * The returned array refers to the internal buffer of the reader
+     * without a copy and is valid only until the next call to the reader.
+     *
+     * @param maxSize Maximum size of the returned data, -1 for no limit.
+     * @return Section data, or empty array at the end of the section.
+     */
+    QByteArray readSectionChunk(qint64 maxSize = -1);
+
+    /*!
+     * @brief Returns a copy of the remaining data of the current section.
+     *
+     * @param maxSize Maximum size of the returned data, -1 for no limit.
+     */
+    QByteArray readSection(qint64 maxSize = -1);
+
+    /*!
+     * @brief Returns the current section as a sequential device.
+     *
+     * The device is owned by the reader and is valid until nextSection() is
+     * called.
+     */
+    QIODevice *sectionDevice();
+
+    /*!
+     * @brief Decodes lzop compressed rich core on multiple threads.
+     *
+     * Has no effect on uncompressed rich cores.
+     *
+     * @sa CReporterLzoReader::setDecodingThreads()
+     */
+    void setDecodingThreads(int threads);
+
+    /*!
+     * @brief Whether parsing stopped because of an error.
+     */
+    bool hasError() const;
+
+    /*!
+     * @brief Description of the last error.
+     */
+    QString errorString() const;
+
+private:
+    Q_DISABLE_COPY(CReporterRichCoreReader)
+    Q_DECLARE_PRIVATE(CReporterRichCoreReader)
+
+    CReporterRichCoreReaderPrivate *d_ptr;
+};
+
+#endif // CREPORTERRICHCOREREADER_H
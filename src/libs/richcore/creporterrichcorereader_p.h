@@ -0,0 +1,114 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERRICHCOREREADER_P_H
+#define CREPORTERRICHCOREREADER_P_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "creporterrichcoreindex.h"
+
+class QFile;
+class QIODevice;
+class CReporterLzoReader;
+class CReporterRichCoreSectionDevice;
+
+//! Size of data read at once from uncompressed sources.
+#define RICHCORE_READ_CHUNK_SIZE (256 * 1024)
+
+//! Longest accepted section header line.
+#define RICHCORE_MAX_HEADER_SIZE 1024
+
+/*!
+ * @class CReporterRichCoreReaderPrivate
+ * @brief Private CReporterRichCoreReader class.
+ *
+ * Buffer positions are indexes to @a buffer. Data in front of @a pos were
+ * already consumed and get dropped at the next refill.
+ *
+ * @sa CReporterRichCoreReader
+ */
+class CReporterRichCoreReaderPrivate
+{
+public:
+    CReporterRichCoreReaderPrivate();
+    ~CReporterRichCoreReaderPrivate();
+
+    //! @arg Device the rich core data are read from.
+    QIODevice *device;
+    //! @arg Decompressing device, if the source is lzop compressed.
+    CReporterLzoReader *lzo;
+    //! @arg File opened by the reader.
+    QFile *file;
+    //! @arg Device of the current section.
+    CReporterRichCoreSectionDevice *section;
+    //! @arg Buffered rich core data.
+    QByteArray buffer;
+    //! @arg Offset of the buffer in the uncompressed rich core.
+    qint64 bufferOffset;
+    //! @arg Start of unconsumed data.
+    int pos;
+    //! @arg End of data known to belong to the current section.
+    int dataEnd;
+    //! @arg Whether the marker of the next section is at @a dataEnd.
+    bool markerFound;
+    //! @arg Whether the source has no more data.
+    bool eof;
+    //! @arg Whether the first section header was reached.
+    bool started;
+    //! @arg Whether the reader is inside a section.
+    bool inSection;
+    //! @arg Name of the current section.
+    QString name;
+    //! @arg Description of the error that stopped parsing.
+    QString error;
+    //! @arg Whether loading of the section index was attempted.
+    bool indexLoaded;
+    //! @arg Section index of the file, if it has one.
+    CReporterRichCoreIndex::Entries index;
+
+    /*!
+     * Drops consumed data and appends next data from the source.
+     *
+     * @return False if the source has no more data.
+     */
+    bool fill();
+
+    /*!
+     * Makes sure there are unconsumed data of the current section in the
+     * buffer, i.e. that @a pos is before @a dataEnd.
+     *
+     * @return False at the end of the section.
+     */
+    bool findSectionData();
+
+    /*!
+     * Continues reading at the section described by index @a entry.
+     */
+    bool jumpToSection(const CReporterRichCoreIndex::Entry &entry);
+
+    /*!
+     * Stops parsing because of an error.
+     */
+    void fail(const QString &message);
+};
+
+#endif // CREPORTERRICHCOREREADER_P_H
@@ -0,0 +1,381 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creportersectionencoder.h"
+
+#include <QBuffer>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QRegularExpression>
+#include <QVector>
+
+#include <string.h>
+
+#include <zdict.h>
+#include <zstd.h>
+
+#include "creporterlzowriter.h"
+#include "creporterrichcorereader.h"
+#include "creportertriagerecord.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+
+const QByteArray SECTION_MARKER("\n[---rich-core: ");
+const QByteArray SECTION_HEADER_END("---]\n");
+
+const QString COREDUMP_SECTION("coredump");
+const QString REDUCTION_SECTION("core-reduction");
+
+//! Number at the end of the file name of a raw content dictionary.
+const QRegularExpression RAW_DICTIONARY_ID("-(\\d+)\\.dict$");
+
+//! Sections shorter than this don't gain anything from encoding.
+const int MIN_ENCODED_SIZE = 64;
+//! Dictionary does most of the work, higher levels don't pay off.
+const int COMPRESSION_LEVEL = 9;
+//! Amount of data copied at once.
+const qint64 COPY_CHUNK_SIZE = 256 * 1024;
+
+bool writeSectionHeader(CReporterLzoWriter *writer, const QString &name)
+{
+    return writer->write(SECTION_MARKER + name.toUtf8() + SECTION_HEADER_END);
+}
+
+bool copySection(CReporterRichCoreReader *reader, CReporterLzoWriter *writer)
+{
+    QByteArray chunk;
+    while (!(chunk = reader->readSectionChunk(COPY_CHUNK_SIZE)).isEmpty()) {
+        if (!writer->write(chunk)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+const char *CReporterSectionEncoder::EncodedSuffix = ".zst";
+
+/*!
+ * @class CReporterSectionEncoderPrivate
+ * @brief Private CReporterSectionEncoder class.
+ *
+ * @sa CReporterSectionEncoder
+ */
+class CReporterSectionEncoderPrivate
+{
+public:
+    CReporterSectionEncoderPrivate();
+    ~CReporterSectionEncoderPrivate();
+
+    void loadDictionaries(const QString &directory);
+
+    /*!
+     * Writes the report with text sections encoded.
+     *
+     * @return Number of encoded sections, or -1 on error.
+     */
+    int writeEncoded(const QString &filePath, QIODevice *device) const;
+
+    //! @arg Dictionary used for encoding.
+    ZSTD_CDict *cdict;
+    //! @arg Id of the encoding dictionary.
+    quint32 dictionaryId;
+    //! @arg All dictionaries by their ids.
+    QHash<quint32, ZSTD_DDict *> ddicts;
+
+    const CReporterSectionEncoder *q_ptr;
+};
+
+CReporterSectionEncoderPrivate::CReporterSectionEncoderPrivate()
+    : cdict(0), dictionaryId(0), q_ptr(0)
+{
+}
+
+CReporterSectionEncoderPrivate::~CReporterSectionEncoderPrivate()
+{
+    ZSTD_freeCDict(cdict);
+    foreach (ZSTD_DDict *ddict, ddicts) {
+        ZSTD_freeDDict(ddict);
+    }
+}
+
+void CReporterSectionEncoderPrivate::loadDictionaries(const QString &directory)
+{
+    QStringList files = QDir(directory).entryList(QStringList() << "*.dict",
+                                                  QDir::Files, QDir::Name);
+
+    foreach (const QString &fileName, files) {
+        QFile file(directory + '/' + fileName);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qCWarning(cr) << "Couldn't open" << file.fileName() << ":" << file.errorString();
+            continue;
+        }
+        QByteArray dictionary = file.readAll();
+
+        quint32 id = ZSTD_getDictID_fromDict(dictionary.constData(), dictionary.size());
+        if (id == 0) {
+            // Raw content, the id comes from the file name.
+            QRegularExpressionMatch rawId = RAW_DICTIONARY_ID.match(fileName);
+            if (rawId.hasMatch()) {
+                id = rawId.captured(1).toUInt();
+            }
+        }
+        if (id == 0 || dictionary.isEmpty()) {
+            qCWarning(cr) << file.fileName() << "is not a zstd dictionary and"
+                          << "its name doesn't tell the id of raw content.";
+            continue;
+        }
+
+        ZSTD_DDict *ddict = ZSTD_createDDict(dictionary.constData(), dictionary.size());
+        ZSTD_CDict *compressionDict =
+            ZSTD_createCDict(dictionary.constData(), dictionary.size(), COMPRESSION_LEVEL);
+        if (!ddict || !compressionDict) {
+            ZSTD_freeDDict(ddict);
+            ZSTD_freeCDict(compressionDict);
+            continue;
+        }
+
+        ZSTD_freeDDict(ddicts.value(id));
+        ddicts.insert(id, ddict);
+
+        // The last dictionary in name order is the current one.
+        ZSTD_freeCDict(cdict);
+        cdict = compressionDict;
+        dictionaryId = id;
+    }
+}
+
+int CReporterSectionEncoderPrivate::writeEncoded(const QString &filePath,
+                                                 QIODevice *device) const
+{
+    QFileInfo fi(filePath);
+    CReporterRichCoreReader reader(filePath);
+    CReporterLzoWriter writer(device);
+    int encoded = 0;
+
+    if (!writer.open(fi.completeBaseName(), fi.lastModified().toUTC())) {
+        return -1;
+    }
+
+    while (reader.nextSection()) {
+        QString name = reader.sectionName();
+
+        if (!CReporterSectionEncoder::isEncodable(name, QByteArray())) {
+            if (!writeSectionHeader(&writer, name) || !copySection(&reader, &writer)) {
+                return -1;
+            }
+            continue;
+        }
+
+        QByteArray data = reader.readSection(CReporterSectionEncoder::MaxSectionSize + 1);
+        QByteArray frame;
+        if (data.size() <= CReporterSectionEncoder::MaxSectionSize &&
+                CReporterSectionEncoder::isEncodable(name, data)) {
+            frame = q_ptr->encode(data);
+        }
+
+        if (!frame.isEmpty() && frame.size() < data.size()) {
+            if (!writeSectionHeader(&writer, name + CReporterSectionEncoder::EncodedSuffix) ||
+                    !writer.write(frame)) {
+                return -1;
+            }
+            ++encoded;
+        } else if (!writeSectionHeader(&writer, name) || !writer.write(data) ||
+                   !copySection(&reader, &writer)) {
+            return -1;
+        }
+    }
+
+    if (reader.hasError()) {
+        qCWarning(cr) << "Failed to read" << filePath << ":" << reader.errorString();
+        return -1;
+    }
+
+    if (!writer.close()) {
+        qCWarning(cr) << "Writing of encoded report failed:" << writer.errorString();
+        return -1;
+    }
+
+    return encoded;
+}
+
+CReporterSectionEncoder::CReporterSectionEncoder(const QString &directory)
+    : d_ptr(new CReporterSectionEncoderPrivate)
+{
+    d_ptr->q_ptr = this;
+    d_ptr->loadDictionaries(directory);
+}
+
+CReporterSectionEncoder::~CReporterSectionEncoder()
+{
+    delete d_ptr;
+    d_ptr = 0;
+}
+
+quint32 CReporterSectionEncoder::dictionaryId() const
+{
+    Q_D(const CReporterSectionEncoder);
+    return d->dictionaryId;
+}
+
+QByteArray CReporterSectionEncoder::encode(const QByteArray &data) const
+{
+    Q_D(const CReporterSectionEncoder);
+
+    if (!d->cdict) {
+        return QByteArray();
+    }
+
+    QByteArray frame(ZSTD_compressBound(data.size()), Qt::Uninitialized);
+    ZSTD_CCtx *cctx = ZSTD_createCCtx();
+    size_t size = ZSTD_compress_usingCDict(cctx, frame.data(), frame.size(),
+                                           data.constData(), data.size(), d->cdict);
+    ZSTD_freeCCtx(cctx);
+
+    if (ZSTD_isError(size)) {
+        qCWarning(cr) << "Section compression failed:" << ZSTD_getErrorName(size);
+        return QByteArray();
+    }
+
+    frame.resize(size);
+    return frame;
+}
+
+QByteArray CReporterSectionEncoder::decode(const QByteArray &frame,
+                                           quint32 dictionaryId) const
+{
+    Q_D(const CReporterSectionEncoder);
+
+    quint32 id = dictionaryIdOf(frame);
+    if (id == 0) {
+        id = dictionaryId;
+    }
+    ZSTD_DDict *ddict = d->ddicts.value(id);
+    if (id != 0 && !ddict) {
+        qCDebug(cr) << "Dictionary" << id << "is not available.";
+        return QByteArray();
+    }
+
+    unsigned long long size = ZSTD_getFrameContentSize(frame.constData(), frame.size());
+    if (size == ZSTD_CONTENTSIZE_UNKNOWN || size == ZSTD_CONTENTSIZE_ERROR ||
+            size > quint64(MaxSectionSize)) {
+        qCDebug(cr) << "Invalid encoded section.";
+        return QByteArray();
+    }
+
+    QByteArray data(int(size), Qt::Uninitialized);
+    ZSTD_DCtx *dctx = ZSTD_createDCtx();
+    size_t result = ddict
+        ? ZSTD_decompress_usingDDict(dctx, data.data(), data.size(),
+                                     frame.constData(), frame.size(), ddict)
+        : ZSTD_decompressDCtx(dctx, data.data(), data.size(),
+                              frame.constData(), frame.size());
+    ZSTD_freeDCtx(dctx);
+
+    if (ZSTD_isError(result) || result != size) {
+        qCDebug(cr) << "Section decompression failed:"
+                    << (ZSTD_isError(result) ? ZSTD_getErrorName(result) : "size mismatch");
+        return QByteArray();
+    }
+
+    return data;
+}
+
+QByteArray CReporterSectionEncoder::encodeReport(const QString &filePath) const
+{
+    Q_D(const CReporterSectionEncoder);
+
+    if (!d->cdict || !filePath.endsWith(".lzo")) {
+        return QByteArray();
+    }
+
+    qint64 originalSize = QFileInfo(filePath).size();
+    if (originalSize > MaxReportSize) {
+        return QByteArray();
+    }
+
+    QByteArray report;
+    QBuffer buffer(&report);
+    buffer.open(QIODevice::WriteOnly);
+
+    int encoded = d->writeEncoded(filePath, &buffer);
+    if (encoded <= 0) {
+        return QByteArray();
+    }
+
+    qCDebug(cr) << "Encoded" << encoded << "sections of" << filePath << "with dictionary"
+                << d->dictionaryId << ", size" << originalSize << "->"
+                << report.size() << "bytes.";
+    return report;
+}
+
+bool CReporterSectionEncoder::isEncodable(const QString &name, const QByteArray &data)
+{
+    if (name == COREDUMP_SECTION || name == REDUCTION_SECTION ||
+            name.endsWith(EncodedSuffix)) {
+        return false;
+    }
+
+    // Sections read on the device stay plain.
+    if (CReporterTriageRecord::isTriageSection(name)) {
+        return false;
+    }
+
+    if (data.isNull()) {
+        return true;
+    }
+
+    return data.size() >= MIN_ENCODED_SIZE &&
+           !memchr(data.constData(), '\0', data.size());
+}
+
+quint32 CReporterSectionEncoder::dictionaryIdOf(const QByteArray &frame)
+{
+    return ZSTD_getDictID_fromFrame(frame.constData(), frame.size());
+}
+
+QByteArray CReporterSectionEncoder::trainDictionary(const QList<QByteArray> &samples,
+                                                    int maxSize)
+{
+    QByteArray buffer;
+    QVector<size_t> sizes;
+    foreach (const QByteArray &sample, samples) {
+        buffer += sample;
+        sizes << sample.size();
+    }
+
+    QByteArray dictionary(maxSize, Qt::Uninitialized);
+    size_t size = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(),
+                                        buffer.constData(), sizes.constData(),
+                                        sizes.size());
+    if (ZDICT_isError(size)) {
+        qCWarning(cr) << "Dictionary training failed:" << ZDICT_getErrorName(size);
+        return QByteArray();
+    }
+
+    dictionary.resize(size);
+    return dictionary;
+}
@@ -0,0 +1,147 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERSECTIONENCODER_H
+#define CREPORTERSECTIONENCODER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+#include "creporterexport.h"
+#include "creporternamespace.h"
+
+class CReporterSectionEncoderPrivate;
+
+/*!
+ * @class CReporterSectionEncoder
+ * @brief Encodes text sections of rich cores with zstd dictionaries.
+ *
+ * Logs, package lists and files from /proc make up most of small reports
+ * and they compress poorly as individual LZO blocks. For the upload, each
+ * such section can be replaced by a zstd frame compressed with a dictionary
+ * known to the server, and ".zst" is appended to its name. Reports on the
+ * device are never changed.
+ *
+ * Dictionaries are read from *.dict files in a directory; the last one in
+ * name order is used for encoding, all of them for decoding. A file is
+ * either a dictionary in zstd format, which carries its id, or raw content,
+ * whose id is the number at the end of the file name, e.g. 1 for
+ * "sections-1.dict". Frames compressed with raw content have no dictionary
+ * id in their header, the id is sent along with the report instead.
+ */
+class CREPORTER_EXPORT CReporterSectionEncoder
+{
+public:
+    //! Appended to names of encoded sections.
+    static const char *EncodedSuffix;
+
+    //! Reports larger than this are not encoded by encodeReport().
+    static const qint64 MaxReportSize = 4 * 1024 * 1024;
+
+    //! Sections larger than this are left as they are.
+    static const int MaxSectionSize = 1024 * 1024;
+
+    //! Default size of a trained dictionary.
+    static const int DefaultDictionarySize = 64 * 1024;
+
+    /*!
+     * @brief Creates encoder using dictionaries from @a directory.
+     *
+     * @param directory Directory with *.dict files.
+     */
+    explicit CReporterSectionEncoder(
+        const QString &directory = CReporter::SectionDictionaryLocation);
+
+    ~CReporterSectionEncoder();
+
+    /*!
+     * @brief Id of the dictionary used for encoding.
+     *
+     * @return Dictionary id, or 0 if no dictionary is available.
+     */
+    quint32 dictionaryId() const;
+
+    /*!
+     * @brief Compresses section data with the current dictionary.
+     *
+     * @param data Section data.
+     * @return zstd frame, or empty array if there is no dictionary.
+     */
+    QByteArray encode(const QByteArray &data) const;
+
+    /*!
+     * @brief Decompresses section data.
+     *
+     * @param frame zstd frame produced by encode().
+     * @param dictionaryId Id of the dictionary the frame was compressed
+     *        with, if the frame doesn't tell it.
+     * @return Section data, or empty array if the dictionary the frame was
+     *         compressed with is not available or the frame is corrupted.
+     */
+    QByteArray decode(const QByteArray &frame, quint32 dictionaryId = 0) const;
+
+    /*!
+     * @brief Returns a rich core with its text sections encoded.
+     *
+     * The file itself is left as it is. Sections read on the device, e.g.
+     * the stack trace, stay plain.
+     *
+     * @param filePath Path to *.rcore.lzo file.
+     * @return lzop compressed rich core, or empty array if there is no
+     *         dictionary, the report is larger than MaxReportSize or none
+     *         of its sections could be encoded.
+     */
+    QByteArray encodeReport(const QString &filePath) const;
+
+    /*!
+     * @brief Whether section is text suitable for encoding.
+     *
+     * @param name Section name.
+     * @param data Section data, or null array to check only the name.
+     */
+    static bool isEncodable(const QString &name, const QByteArray &data);
+
+    /*!
+     * @brief Reads id of the dictionary a frame was compressed with.
+     *
+     * @param frame zstd frame.
+     * @return Dictionary id, or 0 if none was used.
+     */
+    static quint32 dictionaryIdOf(const QByteArray &frame);
+
+    /*!
+     * @brief Trains a dictionary from sample section data.
+     *
+     * @param samples Data of text sections of past reports.
+     * @param maxSize Maximum size of the dictionary.
+     * @return Dictionary in zstd format, or empty array if training failed.
+     */
+    static QByteArray trainDictionary(const QList<QByteArray> &samples,
+                                      int maxSize = DefaultDictionarySize);
+
+private:
+    Q_DISABLE_COPY(CReporterSectionEncoder)
+    Q_DECLARE_PRIVATE(CReporterSectionEncoder)
+
+    CReporterSectionEncoderPrivate *d_ptr;
+};
+
+#endif // CREPORTERSECTIONENCODER_H
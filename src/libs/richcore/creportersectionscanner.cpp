@@ -0,0 +1,235 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creportersectionscanner.h"
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CREPORTER_SCANNER_AVX2
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CREPORTER_SCANNER_NEON
+#endif
+
+namespace {
+
+typedef const char *(*FindFunction)(const char *data, size_t size,
+                                    const char *needle, size_t needleSize);
+
+const char *findScalar(const char *data, size_t size,
+                       const char *needle, size_t needleSize)
+{
+    const char *end = data + size - needleSize + 1;
+    const char *pos = data;
+
+    while (pos < end) {
+        pos = static_cast<const char *>(memchr(pos, needle[0], end - pos));
+        if (!pos) {
+            return 0;
+        }
+        if (memcmp(pos + 1, needle + 1, needleSize - 1) == 0) {
+            return pos;
+        }
+        ++pos;
+    }
+
+    return 0;
+}
+
+/*
+ * Vectorized variants compare the block at each position with the first
+ * byte of the needle and the block shifted by needleSize - 1 with its last
+ * byte. Bits set in both masks are candidates for a match.
+ */
+
+#if defined(__SSE2__)
+const char *findSse2(const char *data, size_t size,
+                     const char *needle, size_t needleSize)
+{
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[needleSize - 1]);
+
+    size_t i = 0;
+    for (; i + needleSize - 1 + 16 <= size; i += 16) {
+        __m128i blockFirst = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(data + i));
+        __m128i blockLast = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(data + i + needleSize - 1));
+
+        unsigned mask = _mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(blockFirst, first),
+                          _mm_cmpeq_epi8(blockLast, last)));
+        while (mask) {
+            size_t candidate = i + __builtin_ctz(mask);
+            if (memcmp(data + candidate + 1, needle + 1, needleSize - 2) == 0) {
+                return data + candidate;
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    return findScalar(data + i, size - i, needle, needleSize);
+}
+#endif
+
+#if defined(CREPORTER_SCANNER_AVX2)
+__attribute__((target("avx2")))
+const char *findAvx2(const char *data, size_t size,
+                     const char *needle, size_t needleSize)
+{
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[needleSize - 1]);
+
+    size_t i = 0;
+    for (; i + needleSize - 1 + 32 <= size; i += 32) {
+        __m256i blockFirst = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(data + i));
+        __m256i blockLast = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(data + i + needleSize - 1));
+
+        unsigned mask = _mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first),
+                             _mm256_cmpeq_epi8(blockLast, last)));
+        while (mask) {
+            size_t candidate = i + __builtin_ctz(mask);
+            if (memcmp(data + candidate + 1, needle + 1, needleSize - 2) == 0) {
+                return data + candidate;
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    return findScalar(data + i, size - i, needle, needleSize);
+}
+#endif
+
+#if defined(CREPORTER_SCANNER_NEON)
+const char *findNeon(const char *data, size_t size,
+                     const char *needle, size_t needleSize)
+{
+    const uint8x16_t first = vdupq_n_u8(needle[0]);
+    const uint8x16_t last = vdupq_n_u8(needle[needleSize - 1]);
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+
+    size_t i = 0;
+    for (; i + needleSize - 1 + 16 <= size; i += 16) {
+        uint8x16_t matches = vandq_u8(
+            vceqq_u8(vld1q_u8(bytes + i), first),
+            vceqq_u8(vld1q_u8(bytes + i + needleSize - 1), last));
+
+        // There is no movemask, test for any match first.
+        uint64x2_t halves = vreinterpretq_u64_u8(matches);
+        if ((vgetq_lane_u64(halves, 0) | vgetq_lane_u64(halves, 1)) == 0) {
+            continue;
+        }
+
+        uint8_t mask[16];
+        vst1q_u8(mask, matches);
+        for (size_t bit = 0; bit < 16; ++bit) {
+            if (mask[bit] && memcmp(data + i + bit + 1, needle + 1,
+                                    needleSize - 2) == 0) {
+                return data + i + bit;
+            }
+        }
+    }
+
+    return findScalar(data + i, size - i, needle, needleSize);
+}
+#endif
+
+struct Implementation {
+    FindFunction find;
+    const char *name;
+};
+
+Implementation selectImplementation()
+{
+#if defined(CREPORTER_SCANNER_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        Implementation avx2 = { findAvx2, "avx2" };
+        return avx2;
+    }
+#endif
+#if defined(__SSE2__)
+    Implementation sse2 = { findSse2, "sse2" };
+    return sse2;
+#elif defined(CREPORTER_SCANNER_NEON)
+    Implementation neon = { findNeon, "neon" };
+    return neon;
+#else
+    Implementation scalar = { findScalar, "scalar" };
+    return scalar;
+#endif
+}
+
+const Implementation &implementation()
+{
+    static const Implementation selected = selectImplementation();
+    return selected;
+}
+
+}
+
+qint64 CReporterSectionScanner::find(const char *data, qint64 size,
+                                     const char *needle, int needleSize)
+{
+    if (needleSize <= 0) {
+        return 0;
+    }
+    if (size < needleSize) {
+        return -1;
+    }
+
+    const char *match;
+    if (needleSize == 1) {
+        match = static_cast<const char *>(memchr(data, needle[0], size));
+    } else {
+        match = ::implementation().find(data, size, needle, needleSize);
+    }
+
+    return match ? match - data : -1;
+}
+
+int CReporterSectionScanner::indexOf(const QByteArray &data,
+                                     const QByteArray &needle, int from)
+{
+    if (from < 0) {
+        from = qMax(from + data.size(), 0);
+    }
+    if (from > data.size()) {
+        return -1;
+    }
+
+    qint64 pos = find(data.constData() + from, data.size() - from,
+                      needle.constData(), needle.size());
+    return pos < 0 ? -1 : int(from + pos);
+}
+
+const char *CReporterSectionScanner::implementation()
+{
+    return ::implementation().name;
+}
@@ -0,0 +1,74 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERSECTIONSCANNER_H
+#define CREPORTERSECTIONSCANNER_H
+
+#include <QByteArray>
+
+#include "creporterexport.h"
+
+/*!
+ * @class CReporterSectionScanner
+ * @brief Fast search of section markers and header fields in rich cores.
+ *
+ * Candidate positions are found by comparing the first and the last byte
+ * of the searched string at 16 or 32 positions at once, only those are then
+ * compared fully. SSE2 and NEON are used when the library is built for
+ * them, AVX2 when the CPU supports it; other targets use memchr().
+ */
+class CREPORTER_EXPORT CReporterSectionScanner
+{
+public:
+    /*!
+     * @brief Finds the first occurrence of @a needle in @a data.
+     *
+     * @param data Data to search.
+     * @param size Size of @a data.
+     * @param needle String to search for.
+     * @param needleSize Size of @a needle.
+     * @return Offset of the occurrence in @a data, or -1 if not found.
+     */
+    static qint64 find(const char *data, qint64 size,
+                       const char *needle, int needleSize);
+
+    /*!
+     * @brief Same as QByteArray::indexOf(), but faster on long data.
+     *
+     * @param data Data to search.
+     * @param needle String to search for.
+     * @param from Position in @a data where to start.
+     * @return Position of the occurrence, or -1 if not found.
+     */
+    static int indexOf(const QByteArray &data, const QByteArray &needle,
+                       int from = 0);
+
+    /*!
+     * @brief Name of the implementation used on this CPU.
+     *
+     * @return "avx2", "sse2", "neon" or "scalar".
+     */
+    static const char *implementation();
+
+private:
+    CReporterSectionScanner();
+};
+
+#endif // CREPORTERSECTIONSCANNER_H
@@ -0,0 +1,255 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creporterstacksignature.h"
+
+#include <QList>
+#include <QSet>
+
+#include "creporterrichcorereader.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+
+const QString STACK_TRACE_SECTION("stack-trace");
+const QByteArray SIGNAL_HANDLER_FRAME("<signal handler called>");
+
+//! Upper limit of stack trace text that is examined.
+const int MAX_STACK_TRACE_SIZE = 256 * 1024;
+
+//! Functions of abort and signal delivery that are not part of the bug.
+QSet<QByteArray> ignoredFunctions()
+{
+    static QSet<QByteArray> ignored = QSet<QByteArray>()
+        << "raise" << "__GI_raise" << "abort" << "__GI_abort"
+        << "pthread_kill" << "__pthread_kill" << "__pthread_kill_implementation"
+        << "__libc_message" << "__assert_fail" << "__assert_fail_base"
+        << "__fortify_fail" << "__stack_chk_fail" << "__kernel_vsyscall"
+        << "qt_message_fatal" << "QMessageLogger::fatal" << "qFatal";
+    return ignored;
+}
+
+//! Header line of the frames of one thread, "Thread 2 (LWP 2214):".
+const QByteArray THREAD_PREFIX("Thread ");
+//! gdb's note of the thread it selected, "[Current thread is 1 (LWP 2213)]".
+const QByteArray CURRENT_THREAD_PREFIX("[Current thread is ");
+
+//! Normalized frames of one thread of a stack trace.
+struct Thread {
+    //! gdb's number of the thread, 0 if the trace has no thread headers.
+    int number;
+    //! Normalized frames, innermost first.
+    QList<QByteArray> frames;
+    //! Whether the function of each frame is known.
+    QList<bool> resolved;
+};
+
+int threadNumber(const QByteArray &text)
+{
+    int end = 0;
+    while (end < text.size() && isdigit(text.at(end))) {
+        ++end;
+    }
+    return text.left(end).toInt();
+}
+
+/*!
+ * The crashed thread is the one that received the signal. Without a
+ * signal handler frame in the trace, the thread gdb selected is used, then
+ * Thread 1, which is the one that received the signal in a core dump.
+ * gdb prints the threads from the highest number down, so it's usually the
+ * last one.
+ */
+const Thread *findCrashedThread(const QList<Thread> &threads, int currentThread)
+{
+    foreach (const Thread &thread, threads) {
+        if (thread.frames.contains(SIGNAL_HANDLER_FRAME)) {
+            return &thread;
+        }
+    }
+
+    const Thread *first = 0;
+    foreach (const Thread &thread, threads) {
+        if (currentThread > 0 && thread.number == currentThread) {
+            return &thread;
+        }
+        if (thread.number == 1 && !first) {
+            first = &thread;
+        }
+    }
+    if (first) {
+        return first;
+    }
+
+    return threads.isEmpty() ? 0 : &threads.first();
+}
+
+QByteArray moduleName(const QByteArray &path)
+{
+    QByteArray name = path.mid(path.lastIndexOf('/') + 1);
+
+    // Drop the library version, libc.so.6 -> libc.so.
+    int so = name.indexOf(".so.");
+    if (so >= 0) {
+        name.truncate(so + 3);
+    }
+    return name;
+}
+
+}
+
+QByteArray CReporterStackSignature::normalizeFrame(const QByteArray &line)
+{
+    QByteArray frame = line.trimmed();
+    if (!frame.startsWith('#')) {
+        return QByteArray();
+    }
+
+    int i = 1;
+    while (i < frame.size() && isdigit(frame.at(i))) {
+        ++i;
+    }
+    if (i == 1) {
+        return QByteArray();
+    }
+    frame = frame.mid(i).trimmed();
+
+    // Program counter.
+    if (frame.startsWith("0x")) {
+        int in = frame.indexOf(" in ");
+        if (in < 0) {
+            return QByteArray();
+        }
+        frame = frame.mid(in + 4);
+    }
+
+    if (frame.startsWith('<')) {
+        return frame;
+    }
+
+    QByteArray module;
+    int from = frame.lastIndexOf(" from ");
+    if (from >= 0) {
+        module = moduleName(frame.mid(from + 6).trimmed());
+        frame.truncate(from);
+    }
+
+    // Arguments and source location.
+    int args = frame.indexOf(" (");
+    if (args >= 0) {
+        frame.truncate(args);
+    } else {
+        int at = frame.indexOf(" at ");
+        if (at >= 0) {
+            frame.truncate(at);
+        }
+    }
+    frame = frame.trimmed();
+
+    if (frame.isEmpty() || frame == "??") {
+        return module.isEmpty() ? QByteArray("??") : module;
+    }
+
+    return frame;
+}
+
+QByteArray CReporterStackSignature::fromStackTrace(const QByteArray &trace,
+        int frames)
+{
+    QList<Thread> threads;
+    int currentThread = 0;
+
+    foreach (const QByteArray &line, trace.split('\n')) {
+        if (line.startsWith(CURRENT_THREAD_PREFIX)) {
+            currentThread = threadNumber(line.mid(CURRENT_THREAD_PREFIX.size()));
+            continue;
+        }
+
+        if (line.startsWith(THREAD_PREFIX)) {
+            Thread thread;
+            thread.number = threadNumber(line.mid(THREAD_PREFIX.size()));
+            threads << thread;
+            continue;
+        }
+
+        QByteArray frame = normalizeFrame(line);
+        if (frame.isEmpty()) {
+            continue;
+        }
+        if (threads.isEmpty() ||
+                (line.trimmed().startsWith("#0 ") && !threads.last().frames.isEmpty())) {
+            // Trace of a single thread without a header, or a new one.
+            Thread thread;
+            thread.number = 0;
+            threads << thread;
+        }
+        threads.last().frames << frame;
+        threads.last().resolved << !(frame == "??" || line.contains("?? ("));
+    }
+
+    const Thread *crashed = findCrashedThread(threads, currentThread);
+    if (!crashed) {
+        return QByteArray();
+    }
+
+    // Frames above the signal handler belong to the crash handler.
+    int first = crashed->frames.lastIndexOf(SIGNAL_HANDLER_FRAME) + 1;
+
+    const QSet<QByteArray> &ignored = ignoredFunctions();
+
+    QByteArray signature;
+    bool resolved = false;
+    int count = 0;
+    for (int i = first; i < crashed->frames.size() && count < frames; ++i) {
+        const QByteArray &frame = crashed->frames.at(i);
+        if (ignored.contains(frame)) {
+            continue;
+        }
+        if (count++ > 0) {
+            signature += '\n';
+        }
+        signature += frame;
+        resolved = resolved || crashed->resolved.at(i);
+    }
+
+    // Frames of unknown functions are the same in every program built
+    // without symbols.
+    return resolved ? signature : QByteArray();
+}
+
+QByteArray CReporterStackSignature::fromRichCore(const QString &filePath,
+        int frames)
+{
+    CReporterRichCoreReader reader(filePath);
+    QByteArray trace;
+
+    if (reader.seekSection(STACK_TRACE_SECTION)) {
+        trace = reader.readSection(MAX_STACK_TRACE_SIZE);
+    }
+
+    if (trace.isEmpty()) {
+        qCDebug(cr) << "No stack trace found in" << filePath;
+        return QByteArray();
+    }
+
+    return fromStackTrace(trace, frames);
+}
@@ -0,0 +1,87 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERSTACKSIGNATURE_H
+#define CREPORTERSTACKSIGNATURE_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "creporterexport.h"
+
+/*!
+ * @class CReporterStackSignature
+ * @brief Derives a crash signature from the stack trace of a rich core.
+ *
+ * The signature consists of the top frames of the crashed thread with
+ * addresses, arguments and source locations removed, so that crashes of the
+ * same bug have equal signatures regardless of the binary that reached it.
+ * The crashed thread is the one with the signal handler frame, or else the
+ * thread gdb selected or Thread 1.
+ */
+class CREPORTER_EXPORT CReporterStackSignature
+{
+public:
+    //! Number of frames the signature is computed from by default.
+    static const int DefaultFrameCount = 5;
+
+    /*!
+     * @brief Computes signature from the text of a stack trace.
+     *
+     * Frames of the signal handling and abort machinery are skipped. Frames
+     * of unknown functions are represented by the name of their module.
+     *
+     * @param trace Stack trace as printed by gdb.
+     * @param frames Maximum number of frames to include.
+     * @return Normalized frames separated by newlines, or empty array if
+     *         @a trace contains no frames or none of the included frames
+     *         has a known function.
+     */
+    static QByteArray fromStackTrace(const QByteArray &trace,
+                                     int frames = DefaultFrameCount);
+
+    /*!
+     * @brief Computes signature from the stack-trace section of a rich core.
+     *
+     * The section is found through the section index of the report if it
+     * has one, otherwise the whole report may have to be decompressed, so
+     * this should be done off the main thread.
+     *
+     * @param filePath Path to *.rcore.lzo or *.rcore file.
+     * @param frames Maximum number of frames to include.
+     * @return Signature, or empty array if the report has no stack trace.
+     */
+    static QByteArray fromRichCore(const QString &filePath,
+                                   int frames = DefaultFrameCount);
+
+    /*!
+     * @brief Normalizes single frame of a stack trace.
+     *
+     * @param line Frame line, e.g. "#1  0x4002a1b4 in foo (x=1) at foo.c:12".
+     * @return Normalized frame, e.g. "foo", or empty array if @a line is not
+     *         a frame.
+     */
+    static QByteArray normalizeFrame(const QByteArray &line);
+
+private:
+    CReporterStackSignature();
+};
+
+#endif // CREPORTERSTACKSIGNATURE_H
@@ -0,0 +1,205 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "creportertriagerecord.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+
+#include <string.h>
+
+#include "creporterlzowriter.h"
+#include "creporterrichcorereader.h"
+#include "creportersectionscanner.h"
+#include "creporterstacksignature.h"
+#include "creporterutils.h"
+
+using CReporter::LoggingCategory::cr;
+
+namespace {
+
+const QByteArray SECTION_MARKER("\n[---rich-core: ");
+const QByteArray SECTION_HEADER_END("---]\n");
+
+const QString STACK_TRACE_SECTION("stack-trace");
+const QString COREDUMP_SECTION("coredump");
+const QString PACKAGELIST_SECTION("packagelist");
+const QString STACK_SIGNATURE_SECTION("stack-signature");
+
+//! Upper limit of the package list searched for the application package.
+const int MAX_PACKAGELIST_SIZE = 1024 * 1024;
+
+void appendSection(QByteArray *record, const QString &name,
+                   const QByteArray &data)
+{
+    *record += SECTION_MARKER;
+    *record += name.toUtf8();
+    *record += SECTION_HEADER_END;
+    *record += data;
+}
+
+/*!
+ * Looks up "name version" line of the first of @a names in the package list.
+ */
+QByteArray findPackage(const QByteArray &packages, const QStringList &names)
+{
+    foreach (const QString &name, names) {
+        if (name.isEmpty()) {
+            continue;
+        }
+
+        QByteArray prefix = name.toUtf8() + ' ';
+        int pos = packages.startsWith(prefix)
+                  ? 0 : CReporterSectionScanner::indexOf(packages, '\n' + prefix);
+        if (pos < 0) {
+            continue;
+        }
+        if (pos > 0) {
+            ++pos;
+        }
+
+        int end = packages.indexOf('\n', pos);
+        return packages.mid(pos, end < 0 ? -1 : end - pos);
+    }
+
+    return QByteArray();
+}
+
+}
+
+const char *CReporterTriageRecord::SectionName = "triage";
+
+QByteArray CReporterTriageRecord::create(const QString &filePath)
+{
+    QFileInfo fi(filePath);
+
+    QByteArray hash = contentHash(filePath);
+    if (hash.isEmpty()) {
+        return QByteArray();
+    }
+
+    CReporterRichCoreReader reader(filePath);
+    QByteArray sections;
+    QByteArray stackTrace;
+    QByteArray packages;
+    QByteArray executable;
+
+    while (reader.nextSection()) {
+        QString name = reader.sectionName();
+
+        if (name == COREDUMP_SECTION) {
+            // The stack trace and appended notes follow the core dump.
+            continue;
+        }
+        if (name == PACKAGELIST_SECTION) {
+            packages = reader.readSection(MAX_PACKAGELIST_SIZE);
+            continue;
+        }
+        if (!isTriageSection(name)) {
+            continue;
+        }
+
+        QByteArray data = reader.readSection(MaxSectionSize);
+        if (name == STACK_TRACE_SECTION) {
+            stackTrace = data;
+        } else if (name.endsWith("/cmdline")) {
+            // Arguments are separated by '\0', the first is the executable.
+            executable = data.left(data.indexOf('\0'));
+        }
+        appendSection(&sections, name, data);
+    }
+
+    if (reader.hasError()) {
+        qCWarning(cr) << "Failed to read" << filePath << ":" << reader.errorString();
+        return QByteArray();
+    }
+
+    QStringList info = CReporterUtils::parseCrashInfoFromFilename(filePath);
+    QString application = info.value(0);
+    int signum = info.value(2).toInt();
+
+    QStringList names;
+    names << application
+          << QFileInfo(QString::fromLocal8Bit(executable)).fileName();
+    QByteArray package = findPackage(packages, names);
+
+    QByteArray triage;
+    triage += "report: " + fi.fileName().toUtf8() + '\n';
+    triage += "size: " + QByteArray::number(fi.size()) + '\n';
+    triage += "sha1: " + hash + '\n';
+    triage += "application: " + application.toUtf8() + '\n';
+    triage += "signal: " + QByteArray::number(signum);
+    if (signum > 0) {
+        triage += QByteArray(" (") + strsignal(signum) + ')';
+    }
+    triage += '\n';
+    triage += "pid: " + info.value(3).toUtf8() + '\n';
+    if (!package.isEmpty()) {
+        triage += "package: " + package + '\n';
+    }
+
+    QByteArray record;
+    appendSection(&record, SectionName, triage);
+    record += sections;
+
+    QByteArray signature = CReporterStackSignature::fromStackTrace(stackTrace);
+    if (!signature.isEmpty()) {
+        appendSection(&record, STACK_SIGNATURE_SECTION, signature + '\n');
+    }
+
+    qCDebug(cr) << "Triage record of" << fi.fileName() << "has" << record.size()
+                << "bytes.";
+
+    // Name the stored file like the report it summarizes, without .lzo.
+    return CReporterLzoWriter::compress(record, fi.completeBaseName());
+}
+
+QByteArray CReporterTriageRecord::contentHash(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(cr) << "Couldn't open" << filePath << ":" << file.errorString();
+        return QByteArray();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(&file)) {
+        qCWarning(cr) << "Couldn't read" << filePath << ":" << file.errorString();
+        return QByteArray();
+    }
+
+    return hash.result().toHex();
+}
+
+bool CReporterTriageRecord::isTriageSection(const QString &name)
+{
+    static QStringList metadata = QStringList()
+        << "date" << "/tmp/osso_software_version" << "/proc/component_version"
+        << "/tmp/osso-product-info" << STACK_TRACE_SECTION;
+
+    if (metadata.contains(name)) {
+        return true;
+    }
+
+    // Command line of the crashed process, /proc/PID/cmdline.
+    return name.startsWith("/proc/") && name.endsWith("/cmdline");
+}
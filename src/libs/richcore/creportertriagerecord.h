@@ -0,0 +1,80 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef CREPORTERTRIAGERECORD_H
+#define CREPORTERTRIAGERECORD_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "creporterexport.h"
+
+/*!
+ * @class CReporterTriageRecord
+ * @brief Extracts a small summary of a crash report for early upload.
+ *
+ * The triage record is itself an lzop compressed rich core. It contains the
+ * metadata sections of the report, its stack trace and a triage section
+ * with the crashed application, signal, package version and a hash of the
+ * report file, which is enough for the server to group the crash before
+ * the full report, dominated by the core dump, is uploaded.
+ */
+class CREPORTER_EXPORT CReporterTriageRecord
+{
+public:
+    //! Name of the section the record adds.
+    static const char *SectionName;
+
+    //! Upper limit of data taken from one section of the report.
+    static const int MaxSectionSize = 64 * 1024;
+
+    /*!
+     * @brief Creates triage record of a crash report.
+     *
+     * The core dump is skipped, sections following it, like the stack
+     * trace of rich-core-dumper and appended notes, are included.
+     *
+     * @param filePath Path to *.rcore.lzo or *.rcore file.
+     * @return Compressed triage record, or empty array if the report could
+     *         not be read.
+     */
+    static QByteArray create(const QString &filePath);
+
+    /*!
+     * @brief Computes the hash identifying the report.
+     *
+     * @param filePath Path to the report file.
+     * @return Hex encoded SHA-1 of the file contents, or empty array if the
+     *         file couldn't be read.
+     */
+    static QByteArray contentHash(const QString &filePath);
+
+    /*!
+     * @brief Whether the section is copied into the triage record.
+     *
+     * @param name Section name.
+     */
+    static bool isTriageSection(const QString &name);
+
+private:
+    CReporterTriageRecord();
+};
+
+#endif // CREPORTERTRIAGERECORD_H
@@ -52,6 +52,12 @@ const QString AutomaticSending("Settings/automaticsending");
 const QString NoticeAccepted("Settings/privacy-notice-accepted");
 //! When true, crash-reporter can use mobile connection for data transfers.
 const QString AllowMobileData("Settings/allow-mobile-data");
+/*!
+ * When true and no unpaid network connection is available, small triage
+ * records of crash reports are uploaded through a mobile connection. The full
+ * reports wait for an unpaid connection.
+ */
+const QString TriageUpload("Settings/triage-upload");
 }
 
 /*!
@@ -71,6 +77,12 @@ const QString IncludeStackTrace("Privacy/INCLUDE_STACK_TRACE");
  * the crash reporter.
  */
 const QString ReduceCore("Privacy/REDUCE_CORE");
+/*!
+ * If set to true, the daemon reduces core dumps of new crash reports. The
+ * rich-core-dumper reduces them already if REDUCE_CORE is set, so enabling
+ * both only costs a decompression and recompression of every core.
+ */
+const QString ReduceCoreInDaemon("Privacy/REDUCE_CORE_IN_DAEMON");
 /*!
  * If set to true, rich-core-dumper will attempt to download missing debug
  * symbols before generating a stack trace.
@@ -195,11 +207,21 @@ bool CReporterPrivacySettingsModel::allowMobileData() const
     return value(Settings::AllowMobileData, QVariant(false)).toBool();
 }
 
+bool CReporterPrivacySettingsModel::triageUploadEnabled() const
+{
+    return value(Settings::TriageUpload, QVariant(false)).toBool();
+}
+
 bool CReporterPrivacySettingsModel::reduceCore() const
 {
     return value(Privacy::ReduceCore, QVariant(true)).toBool();
 }
 
+bool CReporterPrivacySettingsModel::reduceCoreInDaemon() const
+{
+    return value(Privacy::ReduceCoreInDaemon, QVariant(false)).toBool();
+}
+
 void CReporterPrivacySettingsModel::setCoreDumpingEnabled(bool value)
 {
     if (setValue(Settings::CoreDumping, QVariant(value)))
@@ -298,6 +320,12 @@ void CReporterPrivacySettingsModel::setAllowMobileData(bool value)
         emit allowMobileDataChanged();
 }
 
+void CReporterPrivacySettingsModel::setTriageUploadEnabled(bool value)
+{
+    if (setValue(Settings::TriageUpload, QVariant(value)))
+        emit triageUploadEnabledChanged();
+}
+
 void CReporterPrivacySettingsModel::setReduceCore(bool value)
 {
     setValue(Privacy::ReduceCore, QVariant(value));
@@ -52,6 +52,7 @@ class CREPORTER_EXPORT CReporterPrivacySettingsModel : public CReporterSettingsB
     Q_PROPERTY(bool downloadDebuginfo READ downloadDebuginfo WRITE setDownloadDebuginfo NOTIFY downloadDebuginfoChanged)
     Q_PROPERTY(bool privacyNoticeAccepted READ privacyNoticeAccepted WRITE setPrivacyNoticeAccepted NOTIFY privacyNoticeAcceptedChanged)
     Q_PROPERTY(bool allowMobileData READ allowMobileData WRITE setAllowMobileData NOTIFY allowMobileDataChanged)
+    Q_PROPERTY(bool triageUpload READ triageUploadEnabled WRITE setTriageUploadEnabled NOTIFY triageUploadEnabledChanged)
 
 public:
     /*!
@@ -154,6 +155,17 @@ public:
       */
     bool reduceCore() const;
 
+    /*!
+      * @brief Reads setting value for reducing core size in the daemon.
+      *
+      * @note The daemon reduces core dumps of new crash reports with
+      *    CReporterCoreReducer. Meant for devices whose rich-core-dumper
+      *    doesn't reduce the cores itself, see reduceCore().
+      * @return Returns true, if the daemon should shrink core dumps.
+      *    False if value doesn't exist.
+      */
+    bool reduceCoreInDaemon() const;
+
     /*!
       * @brief Reads setting value for including list of installed packages and returns it.
       *
@@ -194,6 +206,15 @@ public:
      */
     bool allowMobileData() const;
 
+    /*!
+     * Checks whether triage records of crash reports are uploaded through
+     * a mobile network, while the full reports wait for an unpaid one.
+     *
+     * @return @c true if triage records are uploaded; otherwise false.
+     *    False if value doesn't exist.
+     */
+    bool triageUploadEnabled() const;
+
     /*!
     * @brief Enables or disables core dumping.
     *
@@ -302,6 +323,14 @@ public:
      */
     void setAllowMobileData(bool value);
 
+    /*!
+     * Enables or disables upload of crash report triage records.
+     *
+     * @param value @c true to upload triage records first; @c false to
+     *  upload only whole reports.
+     */
+    void setTriageUploadEnabled(bool value);
+
     /*!
       * @brief Enables or disables core-dump size shrinking.
       *
@@ -321,6 +350,7 @@ signals:
     void downloadDebuginfoChanged();
     void privacyNoticeAcceptedChanged();
     void allowMobileDataChanged();
+    void triageUploadEnabledChanged();
 
 protected:
     CReporterPrivacySettingsModel();
@@ -30,6 +30,7 @@ const QString CrashNotificationId = "SavedState/crash_notification_id";
 const QString UploadSuccessNotificationId = "SavedState/upload_success_notification_id";
 const QString UploadFailedNotificationId = "SavedState/upload_failed_notification_id";
 const QString UploadSuccessCount = "SavedState/upload_success_count";
+const QString TriagedReports = "SavedState/triaged_reports";
 }
 
 class CReporterSavedStatePrivate
@@ -143,3 +144,15 @@ void CReporterSavedState::setUploadSuccessCount(int count)
         emit uploadSuccessCountChanged();
     }
 }
+
+QStringList CReporterSavedState::triagedReports() const
+{
+    return value(SavedState::TriagedReports, QStringList()).toStringList();
+}
+
+void CReporterSavedState::setTriagedReports(const QStringList &reports)
+{
+    if (setValue(SavedState::TriagedReports, reports)) {
+        emit triagedReportsChanged();
+    }
+}
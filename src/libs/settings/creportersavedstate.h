@@ -21,6 +21,8 @@
 #ifndef CREPORTERSAVEDSTATE_H
 #define CREPORTERSAVEDSTATE_H
 
+#include <QStringList>
+
 #include "creportersettingsbase.h"
 
 class CReporterSavedStatePrivate;
@@ -37,6 +39,7 @@ class CReporterSavedState: public CReporterSettingsBase
     Q_PROPERTY(quint32 uploadSuccessNotificationId READ uploadSuccessNotificationId WRITE setUploadSuccessNotificationId NOTIFY uploadSuccessNotificationIdChanged)
     Q_PROPERTY(quint32 uploadFailedNotificationId READ uploadFailedNotificationId WRITE setUploadFailedNotificationId NOTIFY uploadFailedNotificationIdChanged)
     Q_PROPERTY(int uploadSuccessCount READ uploadSuccessCount WRITE setUploadSuccessCount NOTIFY uploadSuccessCountChanged)
+    Q_PROPERTY(QStringList triagedReports READ triagedReports WRITE setTriagedReports NOTIFY triagedReportsChanged)
 
 public:
     /**
@@ -65,11 +68,18 @@ public:
     int uploadSuccessCount() const;
     void setUploadSuccessCount(int count);
 
+    /**
+     * Paths to the reports whose triage records have been uploaded.
+     */
+    QStringList triagedReports() const;
+    void setTriagedReports(const QStringList &reports);
+
 signals:
     void crashNotificationIdChanged();
     void uploadSuccessNotificationIdChanged();
     void uploadFailedNotificationIdChanged();
     void uploadSuccessCountChanged();
+    void triagedReportsChanged();
 
 private:
     CReporterSavedState();
@@ -40,6 +40,7 @@
 
 #include "creporterutils.h"
 
+#include "creporterlzowriter.h"
 #include "creporternamespace.h"
 #include "../autouploader_interface.h" // generated
 #include "../ssu_interface.h" // generated
@@ -52,7 +53,7 @@ Q_LOGGING_CATEGORY(cr, "creporter", QtInfoMsg)
 
 using CReporter::LoggingCategory::cr;
 
-const QString richCoreTmpNoteFile = "/tmp/rich-core-note.txt";
+const QString richCoreNoteName = "rich-core-note.txt";
 const QString coreSuffixRcore = "rcore";
 const QString coreSuffixRcoreLzo = "rcore.lzo";
 
@@ -150,27 +151,10 @@ QStringList CReporterUtils::parseCrashInfoFromFilename(const QString &filePath)
 
 bool CReporterUtils::appendToLzo(const QString &text, const QString &filePath)
 {
-    QFile tmpFile(richCoreTmpNoteFile);
-    // Create local temp file, where comments are written.
-    if (!tmpFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qCWarning(cr) << "Unable to open file:" << filePath;
-        return false;
-    }
-
-    QTextStream out(&tmpFile);
-    out << text;
-    tmpFile.close();
-
-    // Append to *.lzo.
-    QString cmd = QString("/usr/bin/lzop -c %1 >> %2").arg(richCoreTmpNoteFile).arg(filePath) ;
-    int res = system(qstringToChar(cmd));
-    qCDebug(cr) << "System returned:"  << res;
-
-    // Remove temp file.
-    if (!tmpFile.remove()) {
-        qCWarning(cr) << "Unable to remove file:" << richCoreTmpNoteFile;
-    }
-    return true;
+    // Appended as a separate lzop stream, which lzop decompresses as a part
+    // of the same file.
+    return CReporterLzoWriter::appendToFile(filePath, text.toUtf8(),
+                                            richCoreNoteName);
 }
 
 QString CReporterUtils::deviceUid()
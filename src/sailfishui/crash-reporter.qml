@@ -157,6 +157,16 @@ Page {
                 onClicked: PrivacySettings.allowMobileData = !PrivacySettings.allowMobileData
             }
 
+            TextSwitch {
+                automaticCheck: false
+                checked: PrivacySettings.triageUpload
+                //% "Send crash summary first"
+                text: qsTrId("settings_crash-reporter_triage_upload")
+                //% "A small summary of each crash report is sent right away through mobile network. The full report follows when WLAN connection is available."
+                description: qsTrId("settings_crash-reporter_triage_upload_description")
+                onClicked: PrivacySettings.triageUpload = !PrivacySettings.triageUpload
+            }
+
             SectionHeader {
                 //% "Stack trace"
                 text: qsTrId("settings_crash-reporter_stack_trace")
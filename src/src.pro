@@ -8,6 +8,9 @@ SUBDIRS += \
     autouploader \
     sailfishui \
     endurancecollect \
+    endurancepack \
+    endurancedecoder \
     richcorehelper \
     journalspy \
     servicehelper \
+    dicttrainer \
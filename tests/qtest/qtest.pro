@@ -1,11 +1,30 @@
 TEMPLATE = subdirs
 
 SUBDIRS =  ut_creporterdaemonmonitor \
+          ut_creporterduplicatetracker \
+          ut_creporterstacksignature \
+          ut_creporterrichcorereader \
+          ut_creportersectionscanner \
+          ut_creporterchecksum \
+          ut_creportersectionencoder \
+          ut_creporterlzowriter \
+          ut_creporterenduranceanalyzer \
+          ut_creporterendurancepacker \
+          ut_creportersnapshotdelta \
+          ut_creportersnapshotstore \
+          ut_endurancecollect \
+          ut_journalmatcher \
+          ut_creporterrichcoreindex \
+          ut_creportertriagerecord \
+          ut_creportercorereducer \
+          ut_creporterintegritychecker \
           ut_creporterdaemon \
           ut_creporterdaemonproxy \
           ut_creportercoreregistry \
           ut_creportersettingsobserver \
           ut_creportercoredir \
+          ut_creportercorescanner \
+          ut_creportermounttracker \
           ut_creporterutils \
           ut_creporternwsessionmgr \
           ut_creporteruploaditem \
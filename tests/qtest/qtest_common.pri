@@ -1,7 +1,7 @@
 include(../../crash-reporter-conf.pri)
 
 TEMPLATE = app
-QT += testlib dbus
+QT += testlib dbus concurrent
 CONFIG += debug
 
 CREPORTER_SRC_DIR = ../../../src
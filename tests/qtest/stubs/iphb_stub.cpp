@@ -0,0 +1,84 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "iphb_stub.h"
+
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#include <QtGlobal>
+
+int IphbStub::fd = -1;
+int IphbStub::waitCount = 0;
+unsigned short IphbStub::minTime = 0;
+unsigned short IphbStub::maxTime = 0;
+bool IphbStub::failWait = false;
+
+void IphbStub::reset()
+{
+    waitCount = 0;
+    minTime = maxTime = 0;
+    failWait = false;
+}
+
+void IphbStub::wakeUp()
+{
+    uint64_t value = 1;
+    if (write(fd, &value, sizeof(value)) != sizeof(value)) {
+        qWarning("Couldn't wake up iphb stub");
+    }
+}
+
+extern "C" {
+
+iphb_t iphb_open(int *dummy)
+{
+    Q_UNUSED(dummy);
+    IphbStub::fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    return &IphbStub::fd;
+}
+
+int iphb_get_fd(iphb_t iphbh)
+{
+    return iphbh ? *static_cast<int *>(iphbh) : -1;
+}
+
+time_t iphb_wait(iphb_t iphbh, unsigned short mintime, unsigned short maxtime,
+                 int must_wait)
+{
+    Q_UNUSED(iphbh);
+    Q_UNUSED(must_wait);
+
+    ++IphbStub::waitCount;
+    IphbStub::minTime = mintime;
+    IphbStub::maxTime = maxtime;
+    return IphbStub::failWait ? -1 : 0;
+}
+
+iphb_t iphb_close(iphb_t iphbh)
+{
+    Q_UNUSED(iphbh);
+    close(IphbStub::fd);
+    IphbStub::fd = -1;
+    return 0;
+}
+
+}
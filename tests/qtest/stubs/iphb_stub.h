@@ -0,0 +1,48 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef IPHB_STUB_H
+#define IPHB_STUB_H
+
+#include "endurancecollect.h"
+
+/*!
+ * @brief Stand-in for the iphb daemon.
+ *
+ * The descriptor of the handle is an eventfd, IphbStub::wakeUp() makes it
+ * readable like a heartbeat from the daemon would.
+ */
+struct IphbStub
+{
+    static void reset();
+    static void wakeUp();
+
+    //! @arg Descriptor returned by iphb_get_fd().
+    static int fd;
+    //! @arg Number of iphb_wait() calls.
+    static int waitCount;
+    //! @arg Arguments of the last iphb_wait() call.
+    static unsigned short minTime;
+    static unsigned short maxTime;
+    //! @arg Whether iphb_wait() fails.
+    static bool failWait;
+};
+
+#endif // IPHB_STUB_H
@@ -0,0 +1,39 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef MCE_STUB_H
+#define MCE_STUB_H
+
+#include "mce.h"
+
+/*!
+ * @brief Stand-in for the MCE requests of the endurance daemon.
+ */
+struct MceStub
+{
+    static void reset();
+
+    //! @arg Number of CPU keepalive requests.
+    static int keepaliveStarts;
+    //! @arg Number of CPU keepalive cancellations.
+    static int keepaliveStops;
+};
+
+#endif // MCE_STUB_H
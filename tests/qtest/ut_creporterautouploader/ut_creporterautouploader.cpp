@@ -67,9 +67,10 @@ int CReporterNotification::timeout() const
 }
 
 // CReporterUploadItem mock object.
-CReporterUploadItem::CReporterUploadItem(const QString &file)
+CReporterUploadItem::CReporterUploadItem(const QString &file, ItemContent content)
 {
     Q_UNUSED(file);
+    Q_UNUSED(content);
 }
 
 CReporterUploadItem::~CReporterUploadItem()
@@ -89,8 +90,9 @@ CReporterUploadQueue::~CReporterUploadQueue()
 {
 }
 
-void CReporterUploadQueue::enqueue(CReporterUploadItem *item)
+void CReporterUploadQueue::enqueue(CReporterUploadItem *item, bool prioritized)
 {
+    Q_UNUSED(prioritized);
     delete item;
     itemsAddedCount++;
 }
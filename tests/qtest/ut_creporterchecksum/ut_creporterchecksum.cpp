@@ -0,0 +1,123 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#include <lzo/lzoconf.h>
+
+#include "ut_creporterchecksum.h"
+#include "creporterchecksum.h"
+
+namespace {
+
+QByteArray randomData(int size, uint seed)
+{
+    qsrand(seed);
+    QByteArray data(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i) {
+        data[i] = char(qrand());
+    }
+    return data;
+}
+
+}
+
+void Ut_CReporterChecksum::testKnownValues_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<uint>("crc32");
+    QTest::addColumn<uint>("adler32");
+
+    QTest::newRow("empty") << QByteArray() << 0u << 1u;
+    QTest::newRow("check") << QByteArray("123456789") << 0xcbf43926u << 0x091e01deu;
+    QTest::newRow("wikipedia") << QByteArray("Wikipedia") << 0xadaac02eu << 0x11e60398u;
+    // Long enough to overflow unreduced Adler-32 sums.
+    QTest::newRow("ones") << QByteArray(100000, '\xff') << 0x68c6cec4u << 0x149a302cu;
+}
+
+void Ut_CReporterChecksum::testKnownValues()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(uint, crc32);
+    QFETCH(uint, adler32);
+
+    QCOMPARE(uint(CReporterChecksum::crc32(0, data.constData(), data.size())), crc32);
+    QCOMPARE(uint(CReporterChecksum::adler32(1, data.constData(), data.size())), adler32);
+}
+
+void Ut_CReporterChecksum::testIncremental()
+{
+    QByteArray data = randomData(70000, 1);
+    quint32 crc = CReporterChecksum::crc32(0, data.constData(), data.size());
+    quint32 adler = CReporterChecksum::adler32(1, data.constData(), data.size());
+
+    // Split at unaligned positions, across vector blocks.
+    quint32 partCrc = 0;
+    quint32 partAdler = 1;
+    int pos = 0;
+    for (int size = 1; pos < data.size(); size = size * 3 + 1) {
+        int n = qMin(size, data.size() - pos);
+        partCrc = CReporterChecksum::crc32(partCrc, data.constData() + pos, n);
+        partAdler = CReporterChecksum::adler32(partAdler, data.constData() + pos, n);
+        pos += n;
+    }
+
+    QCOMPARE(partCrc, crc);
+    QCOMPARE(partAdler, adler);
+}
+
+void Ut_CReporterChecksum::testMatchesLzo()
+{
+    QByteArray data = randomData(300000, 2);
+
+    for (int i = 0; i < 200; ++i) {
+        int offset = qrand() % 64;
+        int size = qrand() % (i < 20 ? data.size() - offset : 2000);
+        const char *start = data.constData() + offset;
+        const lzo_bytep bytes = reinterpret_cast<const lzo_bytep>(start);
+
+        QCOMPARE(CReporterChecksum::crc32(0, start, size),
+                 quint32(lzo_crc32(0, bytes, size)));
+        QCOMPARE(CReporterChecksum::adler32(1, start, size),
+                 quint32(lzo_adler32(1, bytes, size)));
+    }
+}
+
+void Ut_CReporterChecksum::benchmarkChecksum_data()
+{
+    QTest::addColumn<bool>("crc");
+
+    QTest::newRow("crc32") << true;
+    QTest::newRow("adler32") << false;
+}
+
+void Ut_CReporterChecksum::benchmarkChecksum()
+{
+    QFETCH(bool, crc);
+
+    QByteArray data = randomData(16 * 1024 * 1024, 3);
+    quint32 checksum = 0;
+    QBENCHMARK {
+        checksum = crc ? CReporterChecksum::crc32(0, data.constData(), data.size())
+                       : CReporterChecksum::adler32(1, data.constData(), data.size());
+    }
+    Q_UNUSED(checksum);
+}
+
+QTEST_MAIN(Ut_CReporterChecksum)
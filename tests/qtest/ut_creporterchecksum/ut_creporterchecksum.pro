@@ -0,0 +1,25 @@
+include(../ut_common_top.pri)
+
+TARGET = ut_creporterchecksum
+
+LIBS += ../../../lib/libcrashreporter.so
+
+CONFIG += link_pkgconfig
+PKGCONFIG += lzo2
+
+INCLUDEPATH += . \
+               $${CREPORTER_SRC_DIR}/libs/richcore \
+               $${CREPORTER_SRC_DIR}/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/richcore/creporterchecksum.cpp \
+
+HEADERS += $${CREPORTER_SRC_DIR}/libs/richcore/creporterchecksum.h \
+           ut_creporterchecksum.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_creporterchecksum.cpp \
+
+include(../ut_coverage.pri)
@@ -108,9 +108,81 @@ void Ut_CReporterCoreDir::testCheckDirectoryForNewCrashReport()
     richCore.open(QIODevice::ReadWrite);
     richCore.close();
 
-    QString newFile = dir->checkDirectoryForCores();
+    QStringList newFiles = dir->checkDirectoryForCores();
 
-    QVERIFY(newFile == coreDirectory.append("/rich-core-application.rcore.lzo"));
+    QCOMPARE(newFiles, QStringList() << coreDirectory + "/rich-core-application.rcore.lzo");
+    QVERIFY(dir->checkDirectoryForCores().isEmpty());
+}
+
+void Ut_CReporterCoreDir::testCheckDirectoryForManyCrashReports()
+{
+    // All new cores are returned from one scan of the directory.
+    dir = new CReporterCoreDir(testMountPoint2);
+
+    QString coreDirectory = QString(testMountPoint2);
+    coreDirectory.append("/core-dumps");
+    dir->setDirectory(coreDirectory);
+    dir->createCoreDirectory();
+
+    QDir::setCurrent(coreDirectory);
+
+    QStringList expected;
+    for (int i = 0; i < 10; ++i) {
+        QFile richCore(QString("application%1.rcore.lzo").arg(i));
+        richCore.open(QIODevice::ReadWrite);
+        richCore.close();
+        expected << coreDirectory + '/' + richCore.fileName();
+    }
+
+    QStringList newFiles = dir->checkDirectoryForCores();
+    newFiles.sort();
+    expected.sort();
+    QCOMPARE(newFiles, expected);
+
+    QVERIFY(dir->checkDirectoryForCores().isEmpty());
+
+    // Deleted core is forgotten, so a new one by the same name is reported.
+    QVERIFY(QFile::remove("application0.rcore.lzo"));
+    QVERIFY(dir->checkDirectoryForCores().isEmpty());
+
+    QFile richCore("application0.rcore.lzo");
+    richCore.open(QIODevice::ReadWrite);
+    richCore.close();
+    QCOMPARE(dir->checkDirectoryForCores(),
+             QStringList() << coreDirectory + "/application0.rcore.lzo");
+}
+
+void Ut_CReporterCoreDir::testReplacedCoreIsNotNew()
+{
+    dir = new CReporterCoreDir(testMountPoint2);
+
+    QString coreDirectory = QString(testMountPoint2);
+    coreDirectory.append("/core-dumps");
+    dir->setDirectory(coreDirectory);
+    dir->createCoreDirectory();
+
+    QDir::setCurrent(coreDirectory);
+    QFile richCore;
+    richCore.setFileName("rich-core-application.rcore");
+    richCore.open(QIODevice::ReadWrite);
+    richCore.close();
+
+    QCOMPARE(dir->checkDirectoryForCores(),
+             QStringList() << coreDirectory + "/rich-core-application.rcore");
+
+    dir->replaceCore("rich-core-application.rcore",
+                     "rich-core-application.rcore.lzo");
+    QVERIFY(QFile::rename("rich-core-application.rcore",
+                          "rich-core-application.rcore.lzo"));
+
+    QVERIFY(dir->checkDirectoryForCores().isEmpty());
+
+    richCore.setFileName("rich-core-other.rcore.lzo");
+    richCore.open(QIODevice::ReadWrite);
+    richCore.close();
+
+    QCOMPARE(dir->checkDirectoryForCores(),
+             QStringList() << coreDirectory + "/rich-core-other.rcore.lzo");
 }
 
 void Ut_CReporterCoreDir::cleanupTestCase()
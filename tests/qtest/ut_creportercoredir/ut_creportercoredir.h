@@ -40,6 +40,8 @@ private slots:
     void testCreationOfDirectoryForCores();
     void testCollectingCrashReportsFromDirectory();
     void testCheckDirectoryForNewCrashReport();
+    void testCheckDirectoryForManyCrashReports();
+    void testReplacedCoreIsNotNew();
     void cleanupTestCase();
     void cleanup();
 
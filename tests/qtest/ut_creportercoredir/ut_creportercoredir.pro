@@ -16,8 +16,10 @@ INCLUDEPATH += . \
 DEPENDPATH += $$INCLUDEPATH \
 
 TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.cpp \
+                $${CREPORTER_SRC_DIR}/libs/coredir/creportercorescanner.cpp \
 
 HEADERS += $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.h \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercorescanner.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir_p.h \
            ut_creportercoredir.h \
 
@@ -0,0 +1,163 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+
+#include "ut_creportercorereducer.h"
+#include "creportercorereducer.h"
+#include "creporterlzowriter.h"
+#include "creporterrichcorereader.h"
+
+namespace {
+
+const QString CRASHER_CORE("/usr/lib/crash-reporter-tests/testdata/"
+                           "crasher-0287-11-2213.rcore.lzo");
+
+//! PT_NOTE segment of the crasher core.
+const int NOTES_OFFSET = 0xd14;
+const int NOTES_SIZE = 0x1d4;
+//! Stack pointer of the crashed thread and the segment containing it.
+const int STACK_OFFSET = 0x8b000;
+const quint32 STACK_START = 0x7ebc2000;
+const quint32 STACK_POINTER = 0x7ebd6c50;
+
+typedef QMap<QString, QByteArray> Sections;
+
+Sections readSections(const QString &filePath, QStringList *order = 0)
+{
+    Sections sections;
+    CReporterRichCoreReader reader(filePath);
+    while (reader.nextSection()) {
+        sections.insert(reader.sectionName(), reader.readSection());
+        if (order) {
+            *order << reader.sectionName();
+        }
+    }
+    return sections;
+}
+
+QByteArray readFile(const QString &filePath)
+{
+    QFile file(filePath);
+    file.open(QIODevice::ReadOnly);
+    return file.readAll();
+}
+
+}
+
+void Ut_CReporterCoreReducer::init()
+{
+    tempDir = new QTemporaryDir;
+    QVERIFY(tempDir->isValid());
+}
+
+void Ut_CReporterCoreReducer::cleanup()
+{
+    delete tempDir;
+    tempDir = 0;
+}
+
+QString Ut_CReporterCoreReducer::copyCrasher()
+{
+    QString filePath = tempDir->path() + "/crasher-0287-11-2213.rcore.lzo";
+    QFile::copy(CRASHER_CORE, filePath);
+    return filePath;
+}
+
+void Ut_CReporterCoreReducer::testCrasher()
+{
+    QString filePath = copyCrasher();
+
+    QStringList originalOrder;
+    Sections original = readSections(filePath, &originalOrder);
+    QByteArray originalCore = original.value("coredump");
+    QCOMPARE(originalCore.size(), 655360);
+
+    QVERIFY(CReporterCoreReducer::reduce(filePath));
+    QVERIFY(QFileInfo(filePath).size() < QFileInfo(CRASHER_CORE).size());
+    QVERIFY(!QFile::exists(filePath + ".reduce"));
+
+    QStringList order;
+    Sections reduced = readSections(filePath, &order);
+
+    // Statistics come right before the core dump, other sections are intact.
+    QStringList expectedOrder(originalOrder);
+    expectedOrder.insert(expectedOrder.indexOf("coredump"), "core-reduction");
+    QCOMPARE(order, expectedOrder);
+    foreach (const QString &name, originalOrder) {
+        if (name != "coredump") {
+            QCOMPARE(reduced.value(name), original.value(name));
+        }
+    }
+
+    QByteArray statistics = reduced.value("core-reduction");
+    QVERIFY(statistics.contains("original-size: 655360\n"));
+    QVERIFY(statistics.contains("trimmed-stacks: 1\n"));
+
+    QByteArray core = reduced.value("coredump");
+    QVERIFY(core.size() < originalCore.size());
+    QVERIFY(statistics.contains("reduced-size: " + QByteArray::number(core.size()) + '\n'));
+    QVERIFY(core.startsWith(originalCore.left(16)));
+
+    // Registers and the stack in use are what a backtrace needs.
+    QVERIFY(core.contains(originalCore.mid(NOTES_OFFSET, NOTES_SIZE)));
+    QVERIFY(core.contains(originalCore.mid(STACK_OFFSET + STACK_POINTER - STACK_START,
+                                           1024)));
+}
+
+void Ut_CReporterCoreReducer::testAlreadyReduced()
+{
+    QString filePath = copyCrasher();
+    QVERIFY(CReporterCoreReducer::reduce(filePath));
+
+    QByteArray reduced = readFile(filePath);
+    QVERIFY(!CReporterCoreReducer::reduce(filePath));
+    QCOMPARE(readFile(filePath), reduced);
+}
+
+void Ut_CReporterCoreReducer::testNoCoreDump()
+{
+    QString filePath = tempDir->path() + "/viewer-0287-11-100.rcore.lzo";
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(CReporterLzoWriter::compress(
+                   "\n[---rich-core: date---]\nThu Jan  1 00:00:00 UTC 2015\n"));
+    file.close();
+
+    QByteArray content = readFile(filePath);
+    QVERIFY(!CReporterCoreReducer::reduce(filePath));
+    QCOMPARE(readFile(filePath), content);
+}
+
+void Ut_CReporterCoreReducer::testUncompressed()
+{
+    QString filePath = tempDir->path() + "/crasher-0287-11-2213.rcore";
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(readSections(CRASHER_CORE).value("coredump"));
+    file.close();
+
+    QVERIFY(!CReporterCoreReducer::reduce(filePath));
+    QCOMPARE(QFileInfo(filePath).size(), Q_INT64_C(655360));
+}
+
+QTEST_MAIN(Ut_CReporterCoreReducer)
@@ -0,0 +1,26 @@
+include(../ut_common_top.pri)
+
+TARGET = ut_creportercorereducer
+
+LIBS += ../../../lib/libcrashreporter.so
+
+CONFIG += link_pkgconfig
+PKGCONFIG += lzo2
+
+INCLUDEPATH += . \
+               $${CREPORTER_SRC_DIR}/libs/richcore \
+               $${CREPORTER_SRC_DIR}/libs/utils \
+               $${CREPORTER_SRC_DIR}/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/richcore/creportercorereducer.cpp \
+
+HEADERS += $${CREPORTER_SRC_DIR}/libs/richcore/creportercorereducer.h \
+           ut_creportercorereducer.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_creportercorereducer.cpp \
+
+include(../ut_coverage.pri)
@@ -19,18 +19,23 @@ TEST_STUBS += $${CREPORTER_STUBS_DIR}/mgconfitem_stub.cpp \
 
 # unit
 TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.cpp \
+                $${CREPORTER_SRC_DIR}/libs/coredir/creportercorescanner.cpp \
 	
 HEADERS += $${CREPORTER_STUBS_DIR}/mgconfitem_stub.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.h \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercorescanner.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir_p.h \
 		   $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.h \
+		   $${CREPORTER_SRC_DIR}/libs/coredir/creportermounttracker.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry_p.h \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportermounttracker_p.h \
 		   ut_creportercoreregistry.h \
 
 # unit test and sources
 SOURCES += $$TEST_SOURCES \
            $$TEST_STUBS \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.cpp \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportermounttracker.cpp \
 		   ut_creportercoreregistry.cpp \
 
 include(../ut_coverage.pri)
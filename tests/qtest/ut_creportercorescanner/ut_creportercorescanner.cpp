@@ -0,0 +1,205 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+
+#include "ut_creportercorescanner.h"
+#include "creportercorescanner.h"
+
+void Ut_CReporterCoreScanner::initTestCase()
+{
+    QVERIFY(tmpDir.isValid());
+}
+
+void Ut_CReporterCoreScanner::createFile(const QString &path)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+}
+
+void Ut_CReporterCoreScanner::testCoreFileName_data()
+{
+    QTest::addColumn<QByteArray>("name");
+    QTest::addColumn<bool>("isCore");
+
+    QTest::newRow("rcore") << QByteArray("app-0287-11-2213.rcore") << true;
+    QTest::newRow("rcore.lzo") << QByteArray("app-0287-11-2213.rcore.lzo") << true;
+    QTest::newRow("upper case") << QByteArray("APP.RCORE.LZO") << true;
+    QTest::newRow("suffix only") << QByteArray(".rcore") << false;
+    QTest::newRow("lzo") << QByteArray("app.lzo") << false;
+    QTest::newRow("partial") << QByteArray("app.rcore.lz") << false;
+    QTest::newRow("uploadlog") << QByteArray("uploadlog") << false;
+}
+
+void Ut_CReporterCoreScanner::testCoreFileName()
+{
+    QFETCH(QByteArray, name);
+    QFETCH(bool, isCore);
+
+    QCOMPARE(CReporterCoreScanner::isCoreFileName(name.constData(), name.size()), isCore);
+}
+
+void Ut_CReporterCoreScanner::testScanDirectory()
+{
+    QString dir = tmpDir.path() + "/scan";
+    QVERIFY(QDir().mkpath(dir + "/subdir.rcore"));
+
+    createFile(dir + "/crasher-0287-11-2213.rcore.lzo");
+    createFile(dir + "/crashapplication-0287-11-2260.rcore");
+    createFile(dir + "/.hidden-0287-11-1.rcore.lzo");
+    createFile(dir + "/uploadlog");
+    QVERIFY(QFile::link(dir + "/crasher-0287-11-2213.rcore.lzo",
+                        dir + "/link-0287-11-3.rcore.lzo"));
+    QVERIFY(QFile::link(dir + "/missing", dir + "/dangling-0287-11-4.rcore.lzo"));
+
+    QStringList names;
+    QVERIFY(CReporterCoreScanner::scanDirectory(dir, names));
+    names.sort();
+
+    QCOMPARE(names, QStringList()
+             << "crashapplication-0287-11-2260.rcore"
+             << "crasher-0287-11-2213.rcore.lzo"
+             << "link-0287-11-3.rcore.lzo");
+}
+
+void Ut_CReporterCoreScanner::testScanMissingDirectory()
+{
+    QStringList names;
+    QVERIFY(!CReporterCoreScanner::scanDirectory(tmpDir.path() + "/missing", names));
+    QVERIFY(names.isEmpty());
+}
+
+void Ut_CReporterCoreScanner::testCollectCoreFiles()
+{
+    QStringList dirs;
+    for (int i = 0; i < 4; ++i) {
+        QString dir = tmpDir.path() + QString("/collect%1").arg(i);
+        QVERIFY(QDir().mkpath(dir));
+        createFile(dir + QString("/app-0287-11-%1.rcore.lzo").arg(i));
+        dirs << dir;
+    }
+    dirs << tmpDir.path() + "/missing";
+
+    QStringList files = CReporterCoreScanner::collectCoreFiles(dirs);
+
+    QCOMPARE(files.count(), 4);
+    for (int i = 0; i < 4; ++i) {
+        QCOMPARE(files.at(i), dirs.at(i) + QString("/app-0287-11-%1.rcore.lzo").arg(i));
+    }
+}
+
+QString Ut_CReporterCoreScanner::directoryWithEntries(int entries)
+{
+    if (benchmarkDirs.contains(entries)) {
+        return benchmarkDirs.value(entries);
+    }
+
+    QString dir = tmpDir.path() + QString("/bench%1").arg(entries);
+    QDir().mkpath(dir);
+
+    // Every tenth entry is something else than a rich core.
+    for (int i = 0; i < entries; ++i) {
+        QString name = (i % 10) ? QString("/app%1-0287-11-%2.rcore.lzo").arg(i % 97).arg(i)
+                                : QString("/note%1.txt").arg(i);
+        QFile file(dir + name);
+        file.open(QIODevice::WriteOnly);
+    }
+
+    benchmarkDirs.insert(entries, dir);
+    return dir;
+}
+
+void Ut_CReporterCoreScanner::addBenchmarkRows()
+{
+    QTest::addColumn<int>("entries");
+
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+}
+
+void Ut_CReporterCoreScanner::benchmarkScanner_data()
+{
+    addBenchmarkRows();
+}
+
+void Ut_CReporterCoreScanner::benchmarkScanner()
+{
+    QFETCH(int, entries);
+    QString dir = directoryWithEntries(entries);
+
+    QStringList names;
+    QBENCHMARK {
+        names.clear();
+        CReporterCoreScanner::scanDirectory(dir, names);
+    }
+    QCOMPARE(names.count(), entries - entries / 10);
+}
+
+void Ut_CReporterCoreScanner::benchmarkParallelScanner_data()
+{
+    addBenchmarkRows();
+}
+
+void Ut_CReporterCoreScanner::benchmarkParallelScanner()
+{
+    QFETCH(int, entries);
+
+    // Same number of entries spread over four locations.
+    QStringList dirs;
+    for (int i = 0; i < 4; ++i) {
+        dirs << directoryWithEntries(entries / 4 + i);
+    }
+
+    QStringList files;
+    QBENCHMARK {
+        files = CReporterCoreScanner::collectCoreFiles(dirs);
+    }
+    QVERIFY(!files.isEmpty());
+}
+
+void Ut_CReporterCoreScanner::benchmarkDirIterator_data()
+{
+    addBenchmarkRows();
+}
+
+void Ut_CReporterCoreScanner::benchmarkDirIterator()
+{
+    QFETCH(int, entries);
+    QString dir = directoryWithEntries(entries);
+
+    // The way core directories were scanned before.
+    QStringList filters;
+    filters << "*.rcore" << "*.rcore.lzo";
+
+    QStringList files;
+    QBENCHMARK {
+        files.clear();
+        QDirIterator iter(dir, filters, QDir::Files | QDir::NoDotAndDotDot);
+        while (iter.hasNext()) {
+            files << iter.next();
+        }
+    }
+    QCOMPARE(files.count(), entries - entries / 10);
+}
+
+QTEST_MAIN(Ut_CReporterCoreScanner)
@@ -0,0 +1,57 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef UT_CREPORTERCORESCANNER_H
+#define UT_CREPORTERCORESCANNER_H
+
+#include <QHash>
+#include <QTemporaryDir>
+#include <QTest>
+
+class Ut_CReporterCoreScanner : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void testCoreFileName_data();
+    void testCoreFileName();
+    void testScanDirectory();
+    void testScanMissingDirectory();
+    void testCollectCoreFiles();
+
+    void benchmarkScanner_data();
+    void benchmarkScanner();
+    void benchmarkParallelScanner_data();
+    void benchmarkParallelScanner();
+    void benchmarkDirIterator_data();
+    void benchmarkDirIterator();
+
+private:
+    void createFile(const QString &path);
+    QString directoryWithEntries(int entries);
+    void addBenchmarkRows();
+
+    QTemporaryDir tmpDir;
+    QHash<int, QString> benchmarkDirs;
+};
+
+#endif // UT_CREPORTERCORESCANNER_H
@@ -28,12 +28,17 @@ HEADERS += $${CREPORTER_STUBS_DIR}/mgconfitem_stub.h \
     $${DAEMON_SRC_DIR}/creporterdaemonadaptor.h \
     $${DAEMON_SRC_DIR}/creporterdaemonmonitor.h \
     $${DAEMON_SRC_DIR}/creporterdaemonmonitor_p.h \
+    $${DAEMON_SRC_DIR}/creportercorecompressor.h \
+    $${DAEMON_SRC_DIR}/creporterduplicatetracker.h \
     $${CREPORTER_SRC_DIR}/dialogserver/creporterdialogserverdbusadaptor.h \
     $${CREPORTER_SRC_DIR}/libs/autouploader_interface.h \
     $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.h \
+    $${CREPORTER_SRC_DIR}/libs/coredir/creportercorescanner.h \
     $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir_p.h \
     $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.h \
+    $${CREPORTER_SRC_DIR}/libs/coredir/creportermounttracker.h \
     $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry_p.h \
+    $${CREPORTER_SRC_DIR}/libs/coredir/creportermounttracker_p.h \
     $${CREPORTER_SRC_DIR}/libs/httpclient/creporternwsessionmgr.h \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersavedstate.h \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsbase.h \
@@ -51,10 +56,14 @@ SOURCES += $$TEST_SOURCES \
     $$TEST_STUBS \
     $${DAEMON_SRC_DIR}/creporterdaemonadaptor.cpp \
     $${DAEMON_SRC_DIR}/creporterdaemonmonitor.cpp \
+    $${DAEMON_SRC_DIR}/creportercorecompressor.cpp \
+    $${DAEMON_SRC_DIR}/creporterduplicatetracker.cpp \
     $${CREPORTER_SRC_DIR}/dialogserver/creporterdialogserverdbusadaptor.cpp \
     $${CREPORTER_SRC_DIR}/libs/autouploader_interface.cpp \
     $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.cpp \
+    $${CREPORTER_SRC_DIR}/libs/coredir/creportercorescanner.cpp \
     $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.cpp \
+    $${CREPORTER_SRC_DIR}/libs/coredir/creportermounttracker.cpp \
     $${CREPORTER_SRC_DIR}/libs/httpclient/creporternwsessionmgr.cpp \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersavedstate.cpp \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsinit.cpp \
@@ -63,4 +72,5 @@ SOURCES += $$TEST_SOURCES \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsobserver.cpp \
     $${CREPORTER_SRC_DIR}/libs/utils/creporterutils.cpp \
     ut_creporterdaemon.cpp
+include(../ut_richcore.pri)
 include(../ut_coverage.pri)
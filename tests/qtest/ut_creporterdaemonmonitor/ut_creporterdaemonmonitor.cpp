@@ -36,7 +36,9 @@
 #include "creporternamespace.h"
 #include "creporterdialogserverdbusadaptor.h"
 #include "creporterdaemonmonitor_p.h"
+#include "creporterlzoreader.h"
 #include "creporternotification.h"
+#include "creporterprivacysettingsmodel.h"
 
 static bool notificationCreated;
 static bool notificationUpdated;
@@ -143,13 +145,22 @@ void Ut_CReporterDaemonMonitor::init()
 
     paths = CReporterCoreRegistry::instance()->getCoreLocationPaths();
 
+    monitor = 0;
+    stateDir = new QTemporaryDir();
+    QVERIFY(stateDir->isValid());
+
     testDialogServer = new TestDialogServer();
 }
 
+QString Ut_CReporterDaemonMonitor::handledCoresFile() const
+{
+    return stateDir->path() + "/handled-cores.dat";
+}
+
 void Ut_CReporterDaemonMonitor::testNewCoreFileFoundNotified()
 {
     // Check that rich-core file is sent to the UI.
-    monitor = new CReporterDaemonMonitor(this);
+    monitor = new CReporterDaemonMonitor(handledCoresFile(), this);
 
     QSignalSpy richCoreNotifySpy(monitor, SIGNAL(richCoreNotify(QString)));
 
@@ -176,7 +187,7 @@ void Ut_CReporterDaemonMonitor::testNewCoreFileFoundNotified()
 
 void Ut_CReporterDaemonMonitor::testNewCoreFileFoundInvalidFile()
 {
-    monitor = new CReporterDaemonMonitor(this);
+    monitor = new CReporterDaemonMonitor(handledCoresFile(), this);
 
     QString filePath(paths.at(0));
     filePath.append("/application-4321-10-1111.txt");
@@ -195,7 +206,7 @@ void Ut_CReporterDaemonMonitor::testNewCoreFileFoundInvalidFile()
 
 void Ut_CReporterDaemonMonitor::testNewCoreFileFoundByTheSameName()
 {
-    monitor = new CReporterDaemonMonitor(this);
+    monitor = new CReporterDaemonMonitor(handledCoresFile(), this);
 
     QString filePath(paths.at(0));
     filePath.append("/mytest-1234-11-4321.rcore.lzo");
@@ -240,9 +251,33 @@ void Ut_CReporterDaemonMonitor::testNewCoreFileFoundByTheSameName()
     QCOMPARE(argument, dubFilePath);
 }
 
+void Ut_CReporterDaemonMonitor::testCrashStormCoalesced()
+{
+    // Check that every core of a crash storm gets handled, even though
+    // directory events are processed in batches.
+    monitor = new CReporterDaemonMonitor(handledCoresFile(), this);
+
+    QSignalSpy richCoreNotifySpy(monitor, SIGNAL(richCoreNotify(QString)));
+
+    QDir::setCurrent(paths.at(0));
+
+    const int numCores = 200;
+    for (int i = 0; i < numCores; ++i) {
+        QFile file(QString("storm%1-1234-11-%2.rcore.lzo").arg(i).arg(4321 + i));
+        file.open(QIODevice::ReadWrite);
+        file.close();
+    }
+
+    QTest::qWait(50);
+    // Nothing is processed before the coalescing window has elapsed.
+    QCOMPARE(richCoreNotifySpy.count(), 0);
+
+    QTRY_COMPARE(richCoreNotifySpy.count(), numCores);
+}
+
 void Ut_CReporterDaemonMonitor::testDirectoryDeletedNotNotified()
 {
-    monitor = new CReporterDaemonMonitor(this);
+    monitor = new CReporterDaemonMonitor(handledCoresFile(), this);
 
     CReporterTestUtils::removeDirectory(paths.at(0));
 
@@ -252,27 +287,84 @@ void Ut_CReporterDaemonMonitor::testDirectoryDeletedNotNotified()
 
 void Ut_CReporterDaemonMonitor::testAutoDeleteDublicateCores()
 {
-    // Check, that file is deleted automatically after it has handled maximum number of times (10).
-    monitor = new CReporterDaemonMonitor(this);
-    monitor->setAutoDelete(true);
+    // Check, that file is deleted automatically after the crash has been
+    // handled maximum number of times.
+    CReporterPrivacySettingsModel::instance()->setAutoDeleteDuplicates(true);
+    monitor = new CReporterDaemonMonitor(handledCoresFile(), this);
+    monitor->setAutoDeleteMaxSimilarCores(3);
 
-    QVERIFY(monitor->autoDeleteEnabled() == true);
+    QSignalSpy richCoreNotifySpy(monitor, SIGNAL(richCoreNotify(QString)));
 
-    QString filePath(paths.at(0));
-    filePath.append("/crashapplication-0287-11-2260.rcore.lzo");
+    // Same crash in processes with different PIDs.
+    const QString testData("/usr/lib/crash-reporter-tests/testdata/crashapplication-0287-11-2260.rcore.lzo");
+    for (int i = 0; i <= monitor->autoDeleteMaxSimilarCores(); ++i) {
+        QString filePath(QString("%1/crashapplication-0287-11-%2.rcore.lzo")
+                         .arg(paths.at(0)).arg(2260 + i));
+        QVERIFY(QFile::copy(testData, filePath));
+
+        QTRY_COMPARE(richCoreNotifySpy.count(), i + 1);
+        if (i < monitor->autoDeleteMaxSimilarCores()) {
+            QVERIFY(QFile::exists(filePath));
+        } else {
+            QTRY_VERIFY(!QFile::exists(filePath));
+        }
+    }
+}
 
-    int counter = 1;
-    while (counter <= monitor->autoDeleteMaxSimilarCores()) {
-        QFile::remove(filePath);
-        QTest::qWait(100);
-        QFile::copy("/usr/lib/crash-reporter-tests/testdata/crashapplication-0287-11-2260.rcore.lzo", filePath);
+void Ut_CReporterDaemonMonitor::testBrokenCoreQuarantined()
+{
+    // Truncated report is moved away before it could be uploaded.
+    monitor = new CReporterDaemonMonitor(handledCoresFile(), this);
+
+    QFile testData("/usr/lib/crash-reporter-tests/testdata/crasher-0287-11-2213.rcore.lzo");
+    QVERIFY(testData.open(QIODevice::ReadOnly));
+    QByteArray data = testData.read(testData.size() / 2);
+
+    QString fileName("crasher-0287-11-2213.rcore.lzo");
+    QString filePath(paths.at(0) + '/' + fileName);
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(data);
+    file.close();
 
-        QVERIFY(QFile::exists(filePath) == true);
-        counter++;
-        QTest::qWait(500);
-    }
+    QString quarantined(paths.at(0) + '/' + CReporter::QuarantineDirName + '/' + fileName);
+    QTRY_VERIFY(QFile::exists(quarantined));
+    QVERIFY(!QFile::exists(filePath));
+    QVERIFY(QFile::exists(quarantined + ".reason"));
+}
+
+void Ut_CReporterDaemonMonitor::testPlainCoreCompressedWhenIdle()
+{
+    // Uncompressed report is replaced by compressed one without being
+    // reported again.
+    monitor = new CReporterDaemonMonitor(handledCoresFile(), this);
+    monitor->d_ptr->compressor.setIdleDelay(200);
+
+    QSignalSpy newCoreSpy(monitor, SIGNAL(richCoreNotify(const QString &)));
+    QSignalSpy compressedSpy(&monitor->d_ptr->compressor,
+                             SIGNAL(coreCompressed(const QString &, const QString &)));
+
+    QByteArray data("[---rich-core: cmdline---]\n/usr/bin/test\n");
+    QString filePath(paths.at(0) + "/test-1234-11-4321.rcore");
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(data);
+    file.close();
 
-    QVERIFY(QFile::exists(filePath) == false);
+    QTRY_COMPARE(compressedSpy.count(), 1);
+    QCOMPARE(compressedSpy.at(0).at(0).toString(), filePath);
+    QCOMPARE(compressedSpy.at(0).at(1).toString(), filePath + ".lzo");
+    QVERIFY(!QFile::exists(filePath));
+
+    QFile compressed(filePath + ".lzo");
+    QVERIFY(compressed.open(QIODevice::ReadOnly));
+    CReporterLzoReader lzo(&compressed);
+    QVERIFY(lzo.open(QIODevice::ReadOnly));
+    QCOMPARE(lzo.readAll(), data);
+
+    QTest::qWait(1000);
+    QCOMPARE(newCoreSpy.count(), 1);
+    QCOMPARE(newCoreSpy.at(0).at(0).toString(), filePath);
 }
 
 void Ut_CReporterDaemonMonitor::testUIFailedToLaunch()
@@ -284,7 +376,7 @@ void Ut_CReporterDaemonMonitor::testUIFailedToLaunch()
     delete testDialogServer;
     testDialogServer = 0;
 
-    monitor = new CReporterDaemonMonitor(this);
+    monitor = new CReporterDaemonMonitor(handledCoresFile(), this);
 
     QString filePath(paths.at(0));
     filePath.append("/test-1234-11-4321.rcore.lzo");
@@ -309,6 +401,12 @@ void Ut_CReporterDaemonMonitor::cleanup()
 {
     CReporterTestUtils::removeDirectories(paths);
 
+    // Monitor saves the handled cores when destroyed.
+    delete monitor;
+    monitor = 0;
+    delete stateDir;
+    stateDir = 0;
+
     if (testDialogServer != 0) {
         delete testDialogServer;
         testDialogServer = 0;
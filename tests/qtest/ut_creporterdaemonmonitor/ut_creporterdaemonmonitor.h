@@ -30,6 +30,7 @@
 #include <QDBusError>
 #include <QVariantList>
 #include <QDBusMessage>
+#include <QTemporaryDir>
 
 class CReporterDaemonMonitor;
 class CReporterCoreRegistry;
@@ -68,16 +69,22 @@ private slots:
     void testNewCoreFileFoundNotified();
     void testNewCoreFileFoundInvalidFile();
     void testNewCoreFileFoundByTheSameName();
+    void testCrashStormCoalesced();
     void testDirectoryDeletedNotNotified();
     void testAutoDeleteDublicateCores();
+    void testBrokenCoreQuarantined();
+    void testPlainCoreCompressedWhenIdle();
     void testUIFailedToLaunch();
 
     void cleanupTestCase();
     void cleanup();
 
 private:
+    QString handledCoresFile() const;
 
     QStringList paths;
+    //! Keeps the handled cores file of each test out of the user's config.
+    QTemporaryDir *stateDir;
     CReporterDaemonMonitor *monitor;
     TestDialogServer *testDialogServer;
 };
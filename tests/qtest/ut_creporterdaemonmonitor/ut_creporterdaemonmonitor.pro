@@ -24,18 +24,25 @@ TEST_STUBS += $${CREPORTER_STUBS_DIR}/mgconfitem_stub.cpp \
 
 # unit
 TEST_SOURCES += $${DAEMON_SRC_DIR}/creporterdaemonmonitor.cpp \
+                $${DAEMON_SRC_DIR}/creportercorecompressor.cpp \
+                $${DAEMON_SRC_DIR}/creporterduplicatetracker.cpp \
 	
 HEADERS += $${CREPORTER_STUBS_DIR}/mgconfitem_stub.h \
            $${CREPORTER_STUBS_DIR}/qnetworkconfigmanager.h \
            $${CREPORTER_STUBS_DIR}/qnetworksession.h \
            $${DAEMON_SRC_DIR}/creporterdaemonmonitor.h \
            $${DAEMON_SRC_DIR}/creporterdaemonmonitor_p.h \
+           $${DAEMON_SRC_DIR}/creportercorecompressor.h \
+           $${DAEMON_SRC_DIR}/creporterduplicatetracker.h \
            $${CREPORTER_SRC_DIR}/dialogserver/creporterdialogserverdbusadaptor.h \
     $${CREPORTER_SRC_DIR}/libs/autouploader_interface.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.h \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercorescanner.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir_p.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.h \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportermounttracker.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry_p.h \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportermounttracker_p.h \
            $${CREPORTER_SRC_DIR}/libs/httpclient/creporternwsessionmgr.h \
            $${CREPORTER_SRC_DIR}/libs/utils/creporterutils.h \
            $${CREPORTER_SRC_DIR}/libs/notification/creporternotification.h \
@@ -54,7 +61,9 @@ SOURCES += $$TEST_SOURCES \
     $${CREPORTER_SRC_DIR}/libs/autouploader_interface.cpp \
            $${CREPORTER_SRC_DIR}/dialogserver/creporterdialogserverdbusadaptor.cpp \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.cpp \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercorescanner.cpp \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.cpp \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportermounttracker.cpp \
            $${CREPORTER_SRC_DIR}/libs/httpclient/creporternwsessionmgr.cpp \
            $${CREPORTER_SRC_DIR}/libs/utils/creporterutils.cpp \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersavedstate.cpp \
@@ -64,4 +73,5 @@ SOURCES += $$TEST_SOURCES \
     $${CREPORTER_SRC_DIR}/libs/settings/creportersettingsobserver.cpp \
            ut_creporterdaemonmonitor.cpp \
 
+include(../ut_richcore.pri)
 include(../ut_coverage.pri)
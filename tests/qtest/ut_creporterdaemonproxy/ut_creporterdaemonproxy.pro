@@ -15,6 +15,7 @@ INCLUDEPATH += . \
                $${CREPORTER_SRC_DIR}/libs/utils \
                $${CREPORTER_SRC_DIR}/libs \
                $${CREPORTER_SRC_DIR}/libs/notification \
+               $${CREPORTER_SRC_DIR}/libs/richcore \
 	
 DEPENDPATH += $$INCLUDEPATH \
 
@@ -29,10 +30,15 @@ HEADERS += $${CREPORTER_STUBS_DIR}/mgconfitem_stub.h \
            $${DAEMON_SRC_DIR}/creporterdaemonadaptor.h \
            $${DAEMON_SRC_DIR}/creporterdaemonmonitor.h \
            $${DAEMON_SRC_DIR}/creporterdaemonmonitor_p.h \
+           $${DAEMON_SRC_DIR}/creportercorecompressor.h \
+           $${DAEMON_SRC_DIR}/creporterduplicatetracker.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir_p.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry_p.h \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportermounttracker_p.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.h \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercorescanner.h \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.h \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportermounttracker.h \
            $${CREPORTER_SRC_DIR}/libs/httpclient/creporternwsessionmgr.h \
            $${CREPORTER_SRC_DIR}/libs/notification/creporternotification.h \
            ut_creporterdaemonproxy.h \
@@ -42,8 +48,12 @@ SOURCES += $$TEST_SOURCES \
            $$TEST_STUBS \
            $${DAEMON_SRC_DIR}/creporterdaemon.cpp \
            $${DAEMON_SRC_DIR}/creporterdaemonmonitor.cpp \
+           $${DAEMON_SRC_DIR}/creportercorecompressor.cpp \
+           $${DAEMON_SRC_DIR}/creporterduplicatetracker.cpp \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoredir.cpp \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportercorescanner.cpp \
            $${CREPORTER_SRC_DIR}/libs/coredir/creportercoreregistry.cpp \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportermounttracker.cpp \
            ut_creporterdaemonproxy.cpp \
 
 include(../ut_coverage.pri)
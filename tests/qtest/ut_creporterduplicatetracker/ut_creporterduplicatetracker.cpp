@@ -0,0 +1,147 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "ut_creporterduplicatetracker.h"
+#include "creporterduplicatetracker.h"
+
+namespace {
+
+const QDateTime START = QDateTime::fromString("2015-03-02T10:15:00Z", Qt::ISODate);
+
+quint64 key(const char *signature)
+{
+    return CReporterDuplicateTracker::key(signature);
+}
+
+}
+
+void Ut_CReporterDuplicateTracker::testCountsWithinWindow()
+{
+    CReporterDuplicateTracker tracker;
+
+    QCOMPARE(tracker.hit(key("app/11"), START), 1);
+    QCOMPARE(tracker.hit(key("app/11"), START.addSecs(60)), 2);
+    QCOMPARE(tracker.hit(key("app/6"), START.addSecs(120)), 1);
+    QCOMPARE(tracker.hit(key("app/11"), START.addSecs(23 * 3600)), 3);
+
+    QCOMPARE(tracker.count(key("app/11"), START.addSecs(23 * 3600)), 3);
+    QCOMPARE(tracker.count(key("other/11"), START), 0);
+    QCOMPARE(tracker.size(), 2);
+    QVERIFY(tracker.isDirty());
+}
+
+void Ut_CReporterDuplicateTracker::testWindowSlides()
+{
+    CReporterDuplicateTracker tracker;
+
+    tracker.hit(key("app/11"), START);
+    tracker.hit(key("app/11"), START);
+    tracker.hit(key("app/11"), START.addSecs(12 * 3600));
+
+    // The two oldest occurrences fall out of the window one by one.
+    QCOMPARE(tracker.count(key("app/11"), START.addSecs(23 * 3600)), 3);
+    QCOMPARE(tracker.count(key("app/11"), START.addSecs(24 * 3600)), 1);
+    QCOMPARE(tracker.hit(key("app/11"), START.addSecs(25 * 3600)), 2);
+    QCOMPARE(tracker.count(key("app/11"), START.addSecs(60 * 3600)), 0);
+    QCOMPARE(tracker.hit(key("app/11"), START.addSecs(60 * 3600)), 1);
+}
+
+void Ut_CReporterDuplicateTracker::testClockGoingBackwards()
+{
+    CReporterDuplicateTracker tracker;
+
+    tracker.hit(key("app/11"), START);
+    QCOMPARE(tracker.hit(key("app/11"), START.addSecs(-48 * 3600)), 2);
+    QCOMPARE(tracker.count(key("app/11"), START), 2);
+}
+
+void Ut_CReporterDuplicateTracker::testLeastRecentlyUsedEvicted()
+{
+    CReporterDuplicateTracker tracker(3);
+
+    tracker.hit(key("a"), START);
+    tracker.hit(key("b"), START);
+    tracker.hit(key("c"), START);
+    // Touch "a" so that "b" becomes the least recently used.
+    tracker.hit(key("a"), START);
+    tracker.hit(key("d"), START);
+
+    QCOMPARE(tracker.size(), 3);
+    QCOMPARE(tracker.count(key("a"), START), 2);
+    QCOMPARE(tracker.count(key("b"), START), 0);
+    QCOMPARE(tracker.count(key("c"), START), 1);
+    QCOMPARE(tracker.count(key("d"), START), 1);
+}
+
+void Ut_CReporterDuplicateTracker::testSaveAndLoad()
+{
+    QTemporaryDir dir;
+    QString path = dir.path() + "/settings/handled-cores.dat";
+
+    CReporterDuplicateTracker tracker(3);
+    tracker.hit(key("a"), START);
+    tracker.hit(key("b"), START);
+    tracker.hit(key("b"), START.addSecs(3600));
+    tracker.hit(key("c"), START);
+    tracker.hit(key("a"), START);
+    QVERIFY(tracker.save(path));
+    QVERIFY(!tracker.isDirty());
+
+    CReporterDuplicateTracker restored(3);
+    QVERIFY(restored.load(path));
+    QCOMPARE(restored.size(), 3);
+    QCOMPARE(restored.count(key("a"), START.addSecs(3600)), 2);
+    QCOMPARE(restored.count(key("b"), START.addSecs(3600)), 2);
+    QCOMPARE(restored.count(key("c"), START.addSecs(3600)), 1);
+
+    // Recently used order is preserved, "b" is evicted first.
+    restored.hit(key("d"), START.addSecs(3600));
+    QCOMPARE(restored.count(key("b"), START.addSecs(3600)), 0);
+    QCOMPARE(restored.count(key("a"), START.addSecs(3600)), 2);
+
+    // Loading into a smaller table keeps the most recently used entries.
+    CReporterDuplicateTracker small(1);
+    QVERIFY(small.load(path));
+    QCOMPARE(small.size(), 1);
+    QCOMPARE(small.count(key("a"), START), 2);
+}
+
+void Ut_CReporterDuplicateTracker::testLoadInvalidFile()
+{
+    QTemporaryDir dir;
+    QString path = dir.path() + "/handled-cores.dat";
+
+    CReporterDuplicateTracker tracker;
+    QVERIFY(!tracker.load(path));
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("garbage");
+    file.close();
+
+    QVERIFY(!tracker.load(path));
+    QCOMPARE(tracker.size(), 0);
+    QCOMPARE(tracker.hit(key("app/11"), START), 1);
+}
+
+QTEST_MAIN(Ut_CReporterDuplicateTracker)
@@ -0,0 +1,25 @@
+include(../ut_common_top.pri)
+
+TARGET = ut_creporterduplicatetracker
+
+DAEMON_SRC_DIR = $${CREPORTER_SRC_DIR}/daemon
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $${DAEMON_SRC_DIR} \
+               $${CREPORTER_SRC_DIR}/libs \
+               $${CREPORTER_SRC_DIR}/libs/utils \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+TEST_SOURCES += $${DAEMON_SRC_DIR}/creporterduplicatetracker.cpp \
+
+HEADERS += $${DAEMON_SRC_DIR}/creporterduplicatetracker.h \
+           ut_creporterduplicatetracker.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_creporterduplicatetracker.cpp \
+
+include(../ut_coverage.pri)
@@ -0,0 +1,256 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDir>
+#include <QFile>
+
+#include "ut_creporterenduranceanalyzer.h"
+#include "creporterenduranceanalyzer.h"
+#include "creporterlzowriter.h"
+
+namespace {
+
+const QByteArray Header("pid,name,state,threads,vm_size_kb,vm_rss_kb,fds\n");
+const QByteArray SummaryHeader("pid,name,samples,anomalous,rss_kb,rss_kb_per_hour,"
+                               "fds,fds_per_hour,threads,threads_per_hour\n");
+const int Hour = 3600;
+
+QByteArray process(int pid, const char *name, long threads, long rssKb, long fds)
+{
+    return QString("%1,\"%2\",S,%3,%4,%5,%6\n").arg(pid).arg(name).arg(threads)
+           .arg(rssKb * 2).arg(rssKb).arg(fds).toUtf8();
+}
+
+bool writeFile(const QString &filePath, const QByteArray &data)
+{
+    QFile file(filePath);
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+}
+
+void Ut_CReporterEnduranceAnalyzer::init()
+{
+    tempDir = new QTemporaryDir;
+    QVERIFY(tempDir->isValid());
+}
+
+void Ut_CReporterEnduranceAnalyzer::cleanup()
+{
+    delete tempDir;
+    tempDir = 0;
+}
+
+void Ut_CReporterEnduranceAnalyzer::testSteadyLeak()
+{
+    CReporterEnduranceAnalyzer analyzer;
+    for (int i = 0; i < 6; ++i) {
+        analyzer.addProcesses(Header + process(1, "init", 1, 2000, 20) +
+                              process(100, "leaker", 3, 10000 + 2048 * i, 10),
+                              500 + i * Hour);
+    }
+
+    QCOMPARE(analyzer.snapshotCount(), 6);
+    QVERIFY(analyzer.isAnomalous());
+
+    // Processes that don't grow are left out.
+    QCOMPARE(analyzer.summary(),
+             QByteArray("snapshots: 6\n"
+                        "span: 18000\n"
+                        "processes: 2\n"
+                        "anomalous: yes\n") + SummaryHeader +
+             "100,\"leaker\",6,1,20240,2048.0,10,0.0,3,0.0\n");
+}
+
+void Ut_CReporterEnduranceAnalyzer::testIdleSession()
+{
+    CReporterEnduranceAnalyzer analyzer;
+    for (int i = 0; i < 12; ++i) {
+        // Small fluctuations go both ways.
+        analyzer.addProcesses(Header + process(1, "init", 1, 2000 + (i % 2) * 100, 20) +
+                              process(200, "idle", 4, 50000 - (i % 3) * 300, 30),
+                              i * Hour);
+    }
+
+    QVERIFY(!analyzer.isAnomalous());
+    QVERIFY(analyzer.summary().contains("anomalous: no\n"));
+}
+
+void Ut_CReporterEnduranceAnalyzer::testSpike()
+{
+    CReporterEnduranceAnalyzer analyzer;
+    for (int i = 0; i < 8; ++i) {
+        analyzer.addProcesses(Header + process(300, "spiky", 2, i == 3 ? 90000 : 10000, 5),
+                              i * Hour);
+    }
+
+    // A one-off jump is not a leak.
+    QVERIFY(!analyzer.isAnomalous());
+}
+
+void Ut_CReporterEnduranceAnalyzer::testMinSamples()
+{
+    CReporterEnduranceAnalyzer analyzer;
+    for (int i = 0; i < 3; ++i) {
+        analyzer.addProcesses(Header + process(100, "leaker", 3, 10000 + 8192 * i, 10),
+                              i * Hour);
+    }
+    QVERIFY(!analyzer.isAnomalous());
+
+    analyzer.setMinSamples(3);
+    QVERIFY(analyzer.isAnomalous());
+}
+
+void Ut_CReporterEnduranceAnalyzer::testFdAndThreadGrowth()
+{
+    CReporterEnduranceAnalyzer fds;
+    CReporterEnduranceAnalyzer threads;
+    for (int i = 0; i < 5; ++i) {
+        fds.addProcesses(Header + process(100, "fdleak", 3, 10000, 20 + 15 * i), i * Hour);
+        threads.addProcesses(Header + process(100, "threadleak", 3 + 3 * i, 10000, 20),
+                             i * Hour);
+    }
+
+    QVERIFY(fds.isAnomalous());
+    QVERIFY(fds.summary().contains("100,\"fdleak\",5,1,10000,0.0,80,15.0,3,0.0\n"));
+    QVERIFY(threads.isAnomalous());
+    QVERIFY(threads.summary().contains("100,\"threadleak\",5,1,10000,0.0,20,0.0,15,3.0\n"));
+}
+
+void Ut_CReporterEnduranceAnalyzer::testThresholds()
+{
+    CReporterEnduranceAnalyzer analyzer;
+    for (int i = 0; i < 6; ++i) {
+        analyzer.addProcesses(Header + process(100, "leaker", 3, 10000 + 2048 * i, 10),
+                              i * Hour);
+    }
+    QVERIFY(analyzer.isAnomalous());
+
+    analyzer.setThresholds(4096, 10, 2);
+    QVERIFY(!analyzer.isAnomalous());
+
+    // Slow growth is still listed in the summary.
+    QVERIFY(analyzer.summary().contains("100,\"leaker\",6,0,20240,2048.0,"));
+}
+
+void Ut_CReporterEnduranceAnalyzer::testPidReuse()
+{
+    CReporterEnduranceAnalyzer analyzer;
+    for (int i = 0; i < 6; ++i) {
+        // Short-lived processes get the same pid, none of them grows.
+        const char *name = i % 2 ? "small" : "large";
+        analyzer.addProcesses(Header + process(400, name, 1, i % 2 ? 1000 : 80000, 5),
+                              i * Hour);
+    }
+
+    QVERIFY(!analyzer.isAnomalous());
+    QVERIFY(analyzer.summary().contains("processes: 2\n"));
+}
+
+void Ut_CReporterEnduranceAnalyzer::testSummaryLength()
+{
+    CReporterEnduranceAnalyzer analyzer;
+    for (int i = 0; i < 6; ++i) {
+        QByteArray processes(Header);
+        for (int pid = 1; pid <= 50; ++pid) {
+            // Slow growth, the faster the higher the pid.
+            processes += process(pid, "app", 2, 10000 + pid * i, 10);
+        }
+        // One leaking process.
+        processes += process(1000, "leaker", 2, 10000 + 4096 * i, 10);
+        analyzer.addProcesses(processes, i * Hour);
+    }
+
+    QByteArray summary(analyzer.summary());
+    QList<QByteArray> lines = summary.split('\n');
+    int header = lines.indexOf(SummaryHeader.trimmed());
+    QVERIFY(header >= 0);
+
+    // Anomalous processes first, then the ten fastest growing ones.
+    QCOMPARE(lines.size() - header - 2, 11);
+    QVERIFY(lines.at(header + 1).startsWith("1000,\"leaker\",6,1,"));
+    QVERIFY(lines.at(header + 2).startsWith("50,\"app\",6,0,"));
+    QVERIFY(lines.at(header + 11).startsWith("41,\"app\",6,0,"));
+}
+
+void Ut_CReporterEnduranceAnalyzer::testAddSnapshot()
+{
+    CReporterEnduranceAnalyzer analyzer;
+    for (int i = 0; i < 5; ++i) {
+        QString dir = QString("%1/%2").arg(tempDir->path()).arg(i, 3, 10, QChar('0'));
+        QVERIFY(QDir().mkpath(dir));
+
+        QByteArray processes(Header + process(100, "leaker", 3, 10000 + 2048 * i, 10));
+        QByteArray uptime(QString("%1.25 %2.50\n").arg(7200 + i * Hour).arg(i).toUtf8());
+        // Files compressed by endurance-collect-daemon and plain ones.
+        if (i % 2) {
+            QVERIFY(writeFile(dir + "/processes.csv.lzo", CReporterLzoWriter::compress(processes)));
+            QVERIFY(writeFile(dir + "/uptime.lzo", CReporterLzoWriter::compress(uptime)));
+        } else {
+            QVERIFY(writeFile(dir + "/processes.csv", processes));
+            QVERIFY(writeFile(dir + "/uptime", uptime));
+        }
+
+        QVERIFY(analyzer.addSnapshot(dir));
+    }
+
+    QCOMPARE(analyzer.snapshotCount(), 5);
+    QVERIFY(analyzer.isAnomalous());
+    QVERIFY(analyzer.summary().contains("span: 14400\n"));
+    QVERIFY(analyzer.summary().contains("100,\"leaker\",5,1,18192,2048.0,"));
+}
+
+void Ut_CReporterEnduranceAnalyzer::testLegacySnapshot()
+{
+    // Snapshot of endurance-snapshot has no per-process summary.
+    QString dir = tempDir->path() + "/000";
+    QVERIFY(QDir().mkpath(dir));
+    QVERIFY(writeFile(dir + "/stat", "cpu  1000 0 500 9000 0 0 0\nbtime 1444000000\n"));
+
+    CReporterEnduranceAnalyzer analyzer;
+    QVERIFY(!analyzer.addSnapshot(dir));
+    QVERIFY(!analyzer.addSnapshot(tempDir->path() + "/missing"));
+    QCOMPARE(analyzer.snapshotCount(), 0);
+    QVERIFY(!analyzer.isAnomalous());
+}
+
+void Ut_CReporterEnduranceAnalyzer::benchmarkAddProcesses()
+{
+    // A day of hourly snapshots of a busy device.
+    QList<QByteArray> snapshots;
+    for (int i = 0; i < 24; ++i) {
+        QByteArray processes(Header);
+        for (int pid = 1; pid <= 300; ++pid) {
+            processes += process(pid, "process", 1 + pid % 20, 1000 + pid * 10 + i,
+                                 10 + pid % 50);
+        }
+        snapshots << processes;
+    }
+
+    QBENCHMARK {
+        CReporterEnduranceAnalyzer analyzer;
+        for (int i = 0; i < snapshots.size(); ++i) {
+            analyzer.addProcesses(snapshots.at(i), i * Hour);
+        }
+        QVERIFY(!analyzer.summary().isEmpty());
+    }
+}
+
+QTEST_MAIN(Ut_CReporterEnduranceAnalyzer)
@@ -0,0 +1,24 @@
+include(../ut_common_top.pri)
+
+TARGET = ut_creporterenduranceanalyzer
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $${CREPORTER_SRC_DIR}/libs/endurance \
+               $${CREPORTER_SRC_DIR}/libs/richcore \
+               $${CREPORTER_SRC_DIR}/libs/utils \
+               $${CREPORTER_SRC_DIR}/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/endurance/creporterenduranceanalyzer.cpp \
+
+HEADERS += $${CREPORTER_SRC_DIR}/libs/endurance/creporterenduranceanalyzer.h \
+           ut_creporterenduranceanalyzer.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_creporterenduranceanalyzer.cpp \
+
+include(../ut_coverage.pri)
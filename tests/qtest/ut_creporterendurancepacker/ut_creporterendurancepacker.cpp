@@ -0,0 +1,496 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QProcess>
+#include <QThread>
+
+#include <stdlib.h>
+
+#include <lzma.h>
+
+#include "ut_creporterendurancepacker.h"
+#include "creporterenduranceanalyzer.h"
+#include "creporterendurancepacker.h"
+#include "creporterlzowriter.h"
+#include "creporterrichcorereader.h"
+#include "creportersnapshotdelta.h"
+#include "creportersnapshotstore.h"
+
+namespace {
+
+struct TarEntry
+{
+    char type;
+    QByteArray data;
+};
+
+typedef QMap<QString, TarEntry> TarEntries;
+
+QByteArray unxz(const QByteArray &data)
+{
+    lzma_stream xz = LZMA_STREAM_INIT;
+    if (lzma_stream_decoder(&xz, UINT64_MAX, 0) != LZMA_OK) {
+        return QByteArray();
+    }
+
+    QByteArray result;
+    QByteArray buffer(64 * 1024, Qt::Uninitialized);
+    xz.next_in = reinterpret_cast<const uint8_t *>(data.constData());
+    xz.avail_in = data.size();
+
+    lzma_ret ret;
+    do {
+        xz.next_out = reinterpret_cast<uint8_t *>(buffer.data());
+        xz.avail_out = buffer.size();
+        ret = lzma_code(&xz, LZMA_FINISH);
+        result.append(buffer.constData(), buffer.size() - xz.avail_out);
+    } while (ret == LZMA_OK);
+
+    lzma_end(&xz);
+    return (ret == LZMA_STREAM_END) ? result : QByteArray();
+}
+
+/*!
+ * Parses ustar archive, verifying header checksums.
+ */
+bool untar(const QByteArray &tar, TarEntries *entries)
+{
+    int pos = 0;
+    while (pos + 512 <= tar.size()) {
+        const char *h = tar.constData() + pos;
+        if (h[0] == '\0') {
+            return true;
+        }
+
+        uint checksum = 0;
+        for (int i = 0; i < 512; ++i) {
+            checksum += (i >= 148 && i < 156) ? ' ' : static_cast<uchar>(h[i]);
+        }
+        if (checksum != QByteArray(h + 148, 7).toUInt(0, 8) ||
+                QByteArray(h + 257, 5) != "ustar") {
+            return false;
+        }
+
+        QByteArray name(h, qstrnlen(h, 100));
+        QByteArray prefix(h + 345, qstrnlen(h + 345, 155));
+        if (!prefix.isEmpty()) {
+            name = prefix + '/' + name;
+        }
+        int size = QByteArray(h + 124, 11).toInt(0, 8);
+
+        TarEntry entry;
+        entry.type = h[156];
+        entry.data = tar.mid(pos + 512, size);
+        entries->insert(QString::fromUtf8(name), entry);
+
+        pos += 512 + (size + 511) / 512 * 512;
+    }
+    return false;
+}
+
+QByteArray snapshotSection(const QString &reportPath,
+                           const char *name = CReporterEndurancePacker::SnapshotPackSection)
+{
+    CReporterRichCoreReader reader(reportPath);
+    if (!reader.seekSection(name)) {
+        return QByteArray();
+    }
+    return reader.readSection();
+}
+
+QByteArray smaps(int index)
+{
+    QByteArray text;
+    for (int i = 0; text.size() < 512 * 1024; ++i) {
+        text += QString("Name: /usr/lib/libfoo%1.so\nRss: %2 kB\nPss: %3 kB\n")
+                .arg(i % 50).arg(i * 4 + index).arg(i * 2).toUtf8();
+    }
+    return text;
+}
+
+QByteArray procStat(int index)
+{
+    return QString("cpu  %1 0 %2 9000 0 0 0\nbtime 1444000000\n")
+           .arg(1000 + index).arg(500 + index).toUtf8();
+}
+
+bool writeFile(const QString &filePath, const QByteArray &data)
+{
+    QFile file(filePath);
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+/*!
+ * Creates snapshot directory the way endurance-snapshot does: plain text
+ * files and larger ones compressed with lzop.
+ */
+QString createSnapshot(const QString &dir, int index)
+{
+    QString path = QString("%1/%2").arg(dir).arg(index, 3, 10, QChar('0'));
+    QDir().mkpath(path);
+    writeFile(path + "/stat", procStat(index));
+    writeFile(path + "/smaps.cap.lzo", CReporterLzoWriter::compress(smaps(index)));
+    return path;
+}
+
+}
+
+void Ut_CReporterEndurancePacker::init()
+{
+    tempDir = new QTemporaryDir;
+    QVERIFY(tempDir->isValid());
+}
+
+void Ut_CReporterEndurancePacker::cleanup()
+{
+    delete tempDir;
+    tempDir = 0;
+}
+
+void Ut_CReporterEndurancePacker::testPack()
+{
+    QString snapshots = tempDir->path() + "/endurance";
+    QStringList dirs;
+    dirs << createSnapshot(snapshots, 0) << createSnapshot(snapshots, 1);
+
+    QString report = tempDir->path() + "/Endurance-hwid-1444000100-1444000000.rcore.lzo";
+    CReporterEndurancePacker packer;
+    packer.setDeviceUid("1234567890");
+    packer.setBootTime("1444000000");
+    QVERIFY(packer.pack(dirs, report));
+    QVERIFY(!QFile::exists(report + ".tmp"));
+
+    CReporterRichCoreReader reader(report);
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString("device-uid"));
+    QCOMPARE(reader.readSection(), QByteArray("1234567890\n"));
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString("boot-time"));
+    QCOMPARE(reader.readSection(), QByteArray("1444000000\n"));
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(),
+             QString(CReporterEndurancePacker::SnapshotPackSection));
+    QByteArray pack = reader.readSection();
+    QVERIFY(!reader.nextSection());
+    QVERIFY(!reader.hasError());
+
+    TarEntries entries;
+    QVERIFY(untar(unxz(pack), &entries));
+    QCOMPARE(entries.keys(), QStringList() << "000/" << "000/smaps.cap" << "000/stat"
+                                           << "001/" << "001/smaps.cap" << "001/stat");
+    QCOMPARE(entries["000/"].type, '5');
+    QCOMPARE(entries["000/stat"].type, '0');
+    QCOMPARE(entries["000/stat"].data, procStat(0));
+    QCOMPARE(entries["000/smaps.cap"].data, smaps(0));
+    QCOMPARE(entries["001/smaps.cap"].data, smaps(1));
+
+    // Snapshots are left for the caller to remove.
+    QVERIFY(QFile::exists(dirs.at(0) + "/smaps.cap.lzo"));
+}
+
+void Ut_CReporterEndurancePacker::testTarReadable()
+{
+    if (!QFile::exists("/bin/tar") && !QFile::exists("/usr/bin/tar")) {
+        QSKIP("tar is not installed");
+    }
+
+    QString snapshots = tempDir->path() + "/endurance";
+    QStringList dirs;
+    dirs << createSnapshot(snapshots, 0);
+
+    QString report = tempDir->path() + "/Endurance.rcore.lzo";
+    CReporterEndurancePacker packer;
+    QVERIFY(packer.pack(dirs, report));
+
+    QProcess tar;
+    tar.start("tar", QStringList() << "-t");
+    QVERIFY(tar.waitForStarted());
+    tar.write(unxz(snapshotSection(report)));
+    tar.closeWriteChannel();
+    QVERIFY(tar.waitForFinished());
+    QCOMPARE(tar.exitCode(), 0);
+    QCOMPARE(tar.readAllStandardOutput(), QByteArray("000/\n000/smaps.cap\n000/stat\n"));
+}
+
+void Ut_CReporterEndurancePacker::testLongNames()
+{
+    QString name(QString(80, 'a') + '/' + QString(90, 'b'));
+    QString dir = tempDir->path() + "/endurance/000";
+    QVERIFY(QDir().mkpath(dir + '/' + QString(80, 'a')));
+    QVERIFY(writeFile(dir + '/' + name, "data"));
+
+    QString report = tempDir->path() + "/Endurance.rcore.lzo";
+    CReporterEndurancePacker packer;
+    QVERIFY(packer.pack(QStringList() << dir, report));
+
+    TarEntries entries;
+    QVERIFY(untar(unxz(snapshotSection(report)), &entries));
+    QVERIFY(entries.contains("000/" + name));
+    QCOMPARE(entries["000/" + name].data, QByteArray("data"));
+}
+
+void Ut_CReporterEndurancePacker::testBrokenLzoFile()
+{
+    QString snapshots = tempDir->path() + "/endurance";
+    QString dir = createSnapshot(snapshots, 0);
+
+    QFile file(dir + "/smaps.cap.lzo");
+    QVERIFY(file.resize(file.size() / 2));
+
+    QString report = tempDir->path() + "/Endurance.rcore.lzo";
+    CReporterEndurancePacker packer;
+    QVERIFY(!packer.pack(QStringList() << dir, report));
+    QVERIFY(!packer.errorString().isEmpty());
+    QVERIFY(!QFile::exists(report));
+    QVERIFY(!QFile::exists(report + ".tmp"));
+}
+
+void Ut_CReporterEndurancePacker::testMissingSnapshot()
+{
+    QString report = tempDir->path() + "/Endurance.rcore.lzo";
+    CReporterEndurancePacker packer;
+    QVERIFY(!packer.pack(QStringList() << tempDir->path() + "/missing", report));
+    QVERIFY(!QFile::exists(report));
+}
+
+void Ut_CReporterEndurancePacker::testDeltaEncoding()
+{
+    QString snapshots = tempDir->path() + "/endurance";
+    QStringList dirs;
+    for (int i = 0; i < 3; ++i) {
+        dirs << createSnapshot(snapshots, i);
+    }
+    // Files missing from the previous snapshot are stored in full.
+    QVERIFY(writeFile(dirs.at(2) + "/new", "new\n"));
+
+    QString plainReport = tempDir->path() + "/Plain.rcore.lzo";
+    CReporterEndurancePacker packer;
+    QVERIFY(packer.pack(dirs, plainReport));
+
+    QString deltaReport = tempDir->path() + "/Delta.rcore.lzo";
+    packer.setDeltaEncoding(true);
+    QVERIFY(packer.pack(dirs, deltaReport));
+
+    QVERIFY(snapshotSection(deltaReport).isEmpty());
+    TarEntries entries;
+    QVERIFY(untar(unxz(snapshotSection(deltaReport,
+                                       CReporterSnapshotDelta::DeltaPackSection)),
+                  &entries));
+    // stat is so short that its delta would be larger than the file.
+    QCOMPARE(entries.keys(), QStringList()
+             << "000/" << "000/smaps.cap" << "000/stat"
+             << "001/" << "001/smaps.cap.delta" << "001/stat"
+             << "002/" << "002/new" << "002/smaps.cap.delta" << "002/stat");
+    QCOMPARE(entries["000/smaps.cap"].data, smaps(0));
+    QCOMPARE(entries["002/new"].data, QByteArray("new\n"));
+
+    QByteArray smaps2;
+    QVERIFY(CReporterSnapshotDelta::decode(smaps(1), entries["002/smaps.cap.delta"].data,
+                                           &smaps2));
+    QCOMPARE(smaps2, smaps(2));
+
+    QVERIFY(QFileInfo(deltaReport).size() < QFileInfo(plainReport).size());
+}
+
+void Ut_CReporterEndurancePacker::testParallelCompression()
+{
+    QString snapshots = tempDir->path() + "/endurance";
+    QStringList dirs;
+    for (int i = 0; i < 12; ++i) {
+        dirs << createSnapshot(snapshots, i);
+    }
+
+    QString serialReport = tempDir->path() + "/Serial.rcore.lzo";
+    CReporterEndurancePacker packer;
+    QVERIFY(packer.pack(dirs, serialReport));
+
+    QString parallelReport = tempDir->path() + "/Parallel.rcore.lzo";
+    packer.setCompressionThreads(4);
+    QVERIFY(packer.pack(dirs, parallelReport));
+
+    // Blocks of the xz stream differ, the archive in it doesn't.
+    QByteArray tar = unxz(snapshotSection(serialReport));
+    QVERIFY(!tar.isEmpty());
+    QCOMPARE(unxz(snapshotSection(parallelReport)), tar);
+
+    TarEntries entries;
+    QVERIFY(untar(tar, &entries));
+    QCOMPARE(entries["011/smaps.cap"].data, smaps(11));
+}
+
+void Ut_CReporterEndurancePacker::testSummary()
+{
+    QString snapshots = tempDir->path() + "/endurance";
+    QStringList dirs;
+    dirs << createSnapshot(snapshots, 0) << createSnapshot(snapshots, 1);
+
+    QByteArray summary("snapshots: 2\nanomalous: yes\n");
+    QString report = tempDir->path() + "/Endurance-hwid-1444000100-1444000000.rcore.lzo";
+    CReporterEndurancePacker packer;
+    packer.setSummary(summary);
+    QVERIFY(packer.pack(dirs, report));
+
+    // Summary comes before the pack, so it can be read without the pack.
+    CReporterRichCoreReader reader(report);
+    QVERIFY(reader.seekSection(CReporterEnduranceAnalyzer::SummarySection));
+    QCOMPARE(reader.readSection(), summary);
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(),
+             QString(CReporterEndurancePacker::SnapshotPackSection));
+
+    TarEntries entries;
+    QVERIFY(untar(unxz(reader.readSection()), &entries));
+    QCOMPARE(entries["001/stat"].data, procStat(1));
+}
+
+void Ut_CReporterEndurancePacker::testSummaryOnly()
+{
+    QByteArray summary("snapshots: 12\nanomalous: no\n");
+    QString report = tempDir->path() + "/Endurance-hwid-1444000100-1444000000.rcore.lzo";
+    CReporterEndurancePacker packer;
+    packer.setDeviceUid("1234567890");
+    packer.setBootTime("1444000000");
+    packer.setSummary(summary);
+    QVERIFY(packer.pack(QStringList(), report));
+
+    CReporterRichCoreReader reader(report);
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString("device-uid"));
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString("boot-time"));
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString(CReporterEnduranceAnalyzer::SummarySection));
+    QCOMPARE(reader.readSection(), summary);
+    QVERIFY(!reader.nextSection());
+    QVERIFY(!reader.hasError());
+
+    // Small enough to upload for every session.
+    QVERIFY(QFileInfo(report).size() < 1024);
+}
+
+void Ut_CReporterEndurancePacker::testSnapshotStore()
+{
+    QString snapshots = tempDir->path() + "/endurance";
+    QStringList dirs;
+    dirs << createSnapshot(snapshots, 0) << createSnapshot(snapshots, 1);
+
+    QString store = snapshots + "/" + CReporterSnapshotStore::FileName;
+    QVERIFY(writeFile(store, "segments"));
+
+    QString report = tempDir->path() + "/Endurance.rcore.lzo";
+    CReporterEndurancePacker packer;
+    packer.setSnapshotStore(store);
+    QVERIFY(packer.pack(dirs, report));
+
+    // The store follows the snapshots.
+    TarEntries entries;
+    QVERIFY(untar(unxz(snapshotSection(report)), &entries));
+    QVERIFY(entries.contains("001/stat"));
+    QVERIFY(entries.contains(CReporterSnapshotStore::FileName));
+    QCOMPARE(entries[CReporterSnapshotStore::FileName].data, QByteArray("segments"));
+}
+
+void Ut_CReporterEndurancePacker::testSnapshotFormat()
+{
+    QString snapshots = tempDir->path() + "/endurance";
+    QStringList dirs;
+    dirs << createSnapshot(snapshots, 0) << createSnapshot(snapshots, 1);
+
+    // endurance-collect-daemon writes the file compressed.
+    QByteArray format("crash-reporter-native 1\n");
+    foreach (const QString &dir, dirs) {
+        QVERIFY(writeFile(dir + '/' + CReporterEndurancePacker::FormatFile + ".lzo",
+                          CReporterLzoWriter::compress(format)));
+    }
+
+    QString report = tempDir->path() + "/Endurance.rcore.lzo";
+    CReporterEndurancePacker packer;
+    QVERIFY(packer.pack(dirs, report));
+
+    // Format is known before the pack is read.
+    CReporterRichCoreReader reader(report);
+    QVERIFY(reader.seekSection(CReporterEndurancePacker::FormatSection));
+    QCOMPARE(reader.readSection(), format);
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(),
+             QString(CReporterEndurancePacker::SnapshotPackSection));
+
+    TarEntries entries;
+    QVERIFY(untar(unxz(reader.readSection()), &entries));
+    QCOMPARE(entries[QString("001/") + CReporterEndurancePacker::FormatFile].data,
+             format);
+}
+
+void Ut_CReporterEndurancePacker::benchmarkPack_data()
+{
+    QTest::addColumn<bool>("native");
+    QTest::addColumn<int>("threads");
+
+    QTest::newRow("native") << true << 1;
+    QTest::newRow("native, 2 threads") << true << 2;
+    QTest::newRow("native, ideal thread count") << true << QThread::idealThreadCount();
+    QTest::newRow("shell pipeline") << false << 1;
+}
+
+void Ut_CReporterEndurancePacker::benchmarkPack()
+{
+    QFETCH(bool, native);
+    QFETCH(int, threads);
+
+    if (!native && (!QFile::exists("/usr/bin/lzop") || !QFile::exists("/usr/bin/xz"))) {
+        QSKIP("lzop or xz is not installed");
+    }
+
+    QString snapshots = tempDir->path() + "/endurance";
+    QStringList dirs;
+    for (int i = 0; i < 12; ++i) {
+        dirs << createSnapshot(snapshots, i);
+    }
+
+    QString report = tempDir->path() + "/Endurance.rcore.lzo";
+    QString workDir = tempDir->path() + "/work";
+
+    QBENCHMARK {
+        if (native) {
+            CReporterEndurancePacker packer;
+            packer.setCompressionThreads(threads);
+            QVERIFY(packer.pack(dirs, report));
+        } else {
+            // What endurance-collect used to do, without moving the
+            // snapshots away.
+            QString cmd = QString(
+                "rm -rf %1 && cp -a %2 %1 && cd %1 && "
+                "for f in */*.lzo; do lzop -d $f && rm -f $f; done && "
+                "(printf '\\n[---rich-core: %3---]\\n'; tar c * | xz -0 --stdout) "
+                "| lzop > %4.tmp && mv %4.tmp %4")
+                .arg(workDir).arg(snapshots)
+                .arg(CReporterEndurancePacker::SnapshotPackSection).arg(report);
+            QCOMPARE(system(cmd.toLocal8Bit().constData()), 0);
+        }
+    }
+
+    QVERIFY(QFileInfo(report).size() > 0);
+}
+
+QTEST_MAIN(Ut_CReporterEndurancePacker)
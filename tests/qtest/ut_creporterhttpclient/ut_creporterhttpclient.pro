@@ -21,7 +21,6 @@ TEST_STUBS += $${CREPORTER_STUBS_DIR}/qnetworkreply.cpp \
 
 TEST_SOURCES += $${CLIENT_SRC_DIR}/creporterhttpclient.cpp \
 
-
 HEADERS +=  $${CLIENT_SRC_DIR}/creporterhttpclient.h \
             $${CLIENT_SRC_DIR}/creporterhttpclient_p.h \
             $${CREPORTER_SRC_DIR}/libs/utils/creporterutils.h \
@@ -39,4 +38,5 @@ SOURCES += $$TEST_SOURCES \
            $${CREPORTER_SRC_DIR}/libs/utils/creporterutils.cpp \
            ut_creporterhttpclient.cpp \
 
+include(../ut_richcore.pri)
 include(../ut_coverage.pri)
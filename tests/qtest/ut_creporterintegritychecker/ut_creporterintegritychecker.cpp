@@ -0,0 +1,206 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include <utime.h>
+
+#include "ut_creporterintegritychecker.h"
+#include "creporterintegritychecker.h"
+#include "creporterlzowriter.h"
+#include "creporternamespace.h"
+
+namespace {
+
+const QString CRASHER_CORE("/usr/lib/crash-reporter-tests/testdata/"
+                           "crasher-0287-11-2213.rcore.lzo");
+
+const QByteArray PLAIN_REPORT("[---rich-core: date---]\n"
+                              "Sat Jan  1 06:47:21 UTC 2000\n");
+
+QByteArray readFile(const QString &filePath)
+{
+    QFile file(filePath);
+    file.open(QIODevice::ReadOnly);
+    return file.readAll();
+}
+
+}
+
+void Ut_CReporterIntegrityChecker::init()
+{
+    tempDir = new QTemporaryDir;
+    QVERIFY(tempDir->isValid());
+}
+
+void Ut_CReporterIntegrityChecker::cleanup()
+{
+    delete tempDir;
+    tempDir = 0;
+}
+
+QString Ut_CReporterIntegrityChecker::writeReport(const QString &fileName,
+                                                  const QByteArray &data)
+{
+    QString filePath = tempDir->path() + '/' + fileName;
+    QFile file(filePath);
+    file.open(QIODevice::WriteOnly);
+    file.write(data);
+    return filePath;
+}
+
+void Ut_CReporterIntegrityChecker::testValidReport()
+{
+    QString reason;
+    QVERIFY(CReporterIntegrityChecker::check(CRASHER_CORE, &reason));
+    QVERIFY(reason.isEmpty());
+}
+
+void Ut_CReporterIntegrityChecker::testWrittenReport()
+{
+    // Compressed data of the blocks have checksums too.
+    QString filePath = writeReport("viewer-0287-11-100.rcore.lzo",
+                                   CReporterLzoWriter::compress(PLAIN_REPORT));
+
+    QString reason;
+    QVERIFY(CReporterIntegrityChecker::check(filePath, &reason));
+}
+
+void Ut_CReporterIntegrityChecker::testTruncatedReport()
+{
+    QByteArray data = readFile(CRASHER_CORE);
+    data.truncate(data.size() - 100);
+    QString filePath = writeReport("crasher-0287-11-2213.rcore.lzo", data);
+
+    QString reason;
+    QVERIFY(!CReporterIntegrityChecker::check(filePath, &reason));
+    QVERIFY(reason.startsWith("Truncated"));
+}
+
+void Ut_CReporterIntegrityChecker::testCorruptedReport()
+{
+    QByteArray data = readFile(CRASHER_CORE);
+    data[data.size() / 2] = data.at(data.size() / 2) ^ 0x10;
+    QString filePath = writeReport("crasher-0287-11-2213.rcore.lzo", data);
+
+    QString reason;
+    QVERIFY(!CReporterIntegrityChecker::check(filePath, &reason));
+    QVERIFY(!reason.isEmpty());
+}
+
+void Ut_CReporterIntegrityChecker::testEmptyReport_data()
+{
+    QTest::addColumn<QString>("fileName");
+
+    QTest::newRow("compressed") << "crasher-0287-11-2213.rcore.lzo";
+    QTest::newRow("plain") << "crasher-0287-11-2213.rcore";
+}
+
+void Ut_CReporterIntegrityChecker::testEmptyReport()
+{
+    QFETCH(QString, fileName);
+
+    QString filePath = writeReport(fileName, QByteArray());
+
+    QString reason;
+    QVERIFY(!CReporterIntegrityChecker::check(filePath, &reason));
+    QVERIFY(!reason.isEmpty());
+}
+
+void Ut_CReporterIntegrityChecker::testPlainReport()
+{
+    QString reason;
+    QVERIFY(CReporterIntegrityChecker::check(
+                writeReport("viewer-0287-11-100.rcore", PLAIN_REPORT), &reason));
+
+    QVERIFY(!CReporterIntegrityChecker::check(
+                writeReport("viewer-0287-11-101.rcore", "garbage\n"), &reason));
+    QCOMPARE(reason, QString("Not a rich core"));
+}
+
+void Ut_CReporterIntegrityChecker::testIndex()
+{
+    QString reason;
+    CReporterRichCoreIndex::Entries index;
+    QVERIFY(CReporterIntegrityChecker::check(CRASHER_CORE, &reason, &index));
+
+    CReporterRichCoreIndex::Entries built;
+    QVERIFY(CReporterRichCoreIndex::build(CRASHER_CORE, &built));
+    QCOMPARE(index.size(), built.size());
+    for (int i = 0; i < index.size(); ++i) {
+        QCOMPARE(index.at(i).name, built.at(i).name);
+        QCOMPARE(index.at(i).offset, built.at(i).offset);
+        QCOMPARE(index.at(i).blockOffset, built.at(i).blockOffset);
+        QCOMPARE(index.at(i).blockSkip, built.at(i).blockSkip);
+    }
+
+    // Plain reports have no index.
+    QVERIFY(CReporterIntegrityChecker::check(
+                writeReport("viewer-0287-11-100.rcore", PLAIN_REPORT), &reason,
+                &index));
+    QVERIFY(index.isEmpty());
+}
+
+void Ut_CReporterIntegrityChecker::testQuarantine()
+{
+    QString filePath = writeReport("crasher-0287-11-2213.rcore.lzo", "broken");
+
+    QString quarantined =
+        CReporterIntegrityChecker::quarantine(filePath, "Not an lzop stream");
+    QCOMPARE(quarantined, tempDir->path() + '/' + CReporter::QuarantineDirName +
+             "/crasher-0287-11-2213.rcore.lzo");
+
+    QVERIFY(!QFile::exists(filePath));
+    QCOMPARE(readFile(quarantined), QByteArray("broken"));
+    QVERIFY(readFile(quarantined + ".reason").endsWith("\nNot an lzop stream\n"));
+
+    // Reports in the quarantine are not found by core directory scans.
+    QDir dir(tempDir->path());
+    QCOMPARE(dir.entryList(QStringList() << "*.rcore.lzo", QDir::Files),
+             QStringList());
+}
+
+void Ut_CReporterIntegrityChecker::testQuarantineLimit()
+{
+    const int count = CReporterIntegrityChecker::MaxQuarantinedReports + 3;
+
+    for (int i = 0; i < count; ++i) {
+        QString filePath = writeReport(QString("app%1-0287-11-100.rcore.lzo").arg(i),
+                                       "broken");
+        // Later reports are newer.
+        struct utimbuf times;
+        times.actime = times.modtime = 1000000000 + i * 60;
+        QCOMPARE(utime(QFile::encodeName(filePath).constData(), &times), 0);
+
+        QVERIFY(!CReporterIntegrityChecker::quarantine(filePath, "broken").isEmpty());
+    }
+
+    QDir quarantine(tempDir->path() + '/' + CReporter::QuarantineDirName);
+    QStringList reports =
+        quarantine.entryList(QStringList() << "*.rcore.lzo", QDir::Files);
+    QCOMPARE(reports.count(), CReporterIntegrityChecker::MaxQuarantinedReports);
+    QVERIFY(!reports.contains("app0-0287-11-100.rcore.lzo"));
+    QVERIFY(!quarantine.exists("app0-0287-11-100.rcore.lzo.reason"));
+    QVERIFY(reports.contains(QString("app%1-0287-11-100.rcore.lzo").arg(count - 1)));
+}
+
+QTEST_MAIN(Ut_CReporterIntegrityChecker)
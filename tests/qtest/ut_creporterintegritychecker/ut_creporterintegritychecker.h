@@ -0,0 +1,52 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef UT_CREPORTERINTEGRITYCHECKER_H
+#define UT_CREPORTERINTEGRITYCHECKER_H
+
+#include <QTest>
+#include <QTemporaryDir>
+
+class Ut_CReporterIntegrityChecker : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testValidReport();
+    void testWrittenReport();
+    void testTruncatedReport();
+    void testCorruptedReport();
+    void testEmptyReport_data();
+    void testEmptyReport();
+    void testPlainReport();
+    void testIndex();
+    void testQuarantine();
+    void testQuarantineLimit();
+
+private:
+    QString writeReport(const QString &fileName, const QByteArray &data);
+
+    QTemporaryDir *tempDir;
+};
+
+#endif // UT_CREPORTERINTEGRITYCHECKER_H
@@ -0,0 +1,26 @@
+include(../ut_common_top.pri)
+
+TARGET = ut_creporterintegritychecker
+
+LIBS += ../../../lib/libcrashreporter.so
+
+CONFIG += link_pkgconfig
+PKGCONFIG += lzo2
+
+INCLUDEPATH += . \
+               $${CREPORTER_SRC_DIR}/libs/richcore \
+               $${CREPORTER_SRC_DIR}/libs/utils \
+               $${CREPORTER_SRC_DIR}/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/richcore/creporterintegritychecker.cpp \
+
+HEADERS += $${CREPORTER_SRC_DIR}/libs/richcore/creporterintegritychecker.h \
+           ut_creporterintegritychecker.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_creporterintegritychecker.cpp \
+
+include(../ut_coverage.pri)
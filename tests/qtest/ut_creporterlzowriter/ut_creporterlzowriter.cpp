@@ -0,0 +1,367 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QBuffer>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <stdlib.h>
+
+#include "ut_creporterlzowriter.h"
+#include "creporterlzoreader.h"
+#include "creporterlzowriter.h"
+#include "creporterrichcorereader.h"
+
+namespace {
+
+const QString CRASHER_CORE("/usr/lib/crash-reporter-tests/testdata/"
+                           "crasher-0287-11-2213.rcore.lzo");
+
+QByteArray decompress(QIODevice *device)
+{
+    CReporterLzoReader lzo(device);
+    if (!lzo.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    QByteArray data = lzo.readAll();
+    return lzo.hasError() ? QByteArray() : data;
+}
+
+QByteArray decompress(const QByteArray &stream)
+{
+    QByteArray copy(stream);
+    QBuffer buffer(&copy);
+    return decompress(&buffer);
+}
+
+QByteArray note(int i)
+{
+    return QString("\n[---rich-core: note-%1---]\ncomment %1").arg(i).toUtf8();
+}
+
+/*!
+ * Compresses @a data written in chunks of @a chunkSize bytes.
+ */
+QByteArray compressWithThreads(const QByteArray &data, int threads, int chunkSize)
+{
+    QByteArray stream;
+    QBuffer buffer(&stream);
+    buffer.open(QIODevice::WriteOnly);
+
+    CReporterLzoWriter writer(&buffer);
+    writer.setCompressionThreads(threads);
+    if (!writer.open("test.txt", QDateTime::fromTime_t(1444000000))) {
+        return QByteArray();
+    }
+    for (int pos = 0; pos < data.size(); pos += chunkSize) {
+        if (!writer.write(data.mid(pos, chunkSize))) {
+            return QByteArray();
+        }
+    }
+    return writer.close() ? stream : QByteArray();
+}
+
+QByteArray mixedData(int size)
+{
+    QByteArray data;
+    qsrand(1);
+    for (int line = 0; data.size() < size; ++line) {
+        data += "/usr/lib/libQt5Core.so.5 r-xp 00000000 b3:10 1234\n";
+        // Incompressible runs make some blocks stored as they are.
+        if (line % 10000 == 9999) {
+            for (int i = 0; i < 64 * 1024; ++i) {
+                data += char(qrand());
+            }
+        }
+    }
+    data.resize(size);
+    return data;
+}
+
+struct NoteAppender
+{
+    typedef void result_type;
+
+    NoteAppender(const QString &filePath) : filePath(filePath) {}
+
+    void operator()(int &i) const {
+        CReporterLzoWriter::appendToFile(filePath, note(i));
+    }
+
+    QString filePath;
+};
+
+}
+
+void Ut_CReporterLzoWriter::init()
+{
+    tempDir = new QTemporaryDir;
+    QVERIFY(tempDir->isValid());
+}
+
+void Ut_CReporterLzoWriter::cleanup()
+{
+    delete tempDir;
+    tempDir = 0;
+}
+
+void Ut_CReporterLzoWriter::testRoundTrip_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    QByteArray text;
+    while (text.size() < 600 * 1024) {
+        text += "/usr/lib/libQt5Core.so.5 r-xp 00000000 b3:10 1234\n";
+    }
+
+    QByteArray random(300 * 1024, Qt::Uninitialized);
+    qsrand(1);
+    for (int i = 0; i < random.size(); ++i) {
+        random[i] = char(qrand());
+    }
+
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("short") << QByteArray("x");
+    QTest::newRow("several blocks") << text;
+    QTest::newRow("incompressible") << random;
+}
+
+void Ut_CReporterLzoWriter::testRoundTrip()
+{
+    QFETCH(QByteArray, data);
+
+    QByteArray stream = CReporterLzoWriter::compress(data, "test.txt");
+    QVERIFY(CReporterLzoReader::isLzoStream(stream));
+    QCOMPARE(decompress(stream), data);
+}
+
+void Ut_CReporterLzoWriter::testSmallWrites()
+{
+    QByteArray data;
+    for (int i = 0; i < 1000; ++i) {
+        data += QByteArray::number(i) + ' ';
+    }
+
+    QByteArray stream;
+    QBuffer buffer(&stream);
+    buffer.open(QIODevice::WriteOnly);
+
+    CReporterLzoWriter writer(&buffer, 100);
+    QVERIFY(writer.open());
+    for (int pos = 0; pos < data.size(); pos += 37) {
+        QVERIFY(writer.write(data.mid(pos, 37)));
+    }
+    QVERIFY(writer.close());
+
+    QCOMPARE(decompress(stream), data);
+}
+
+void Ut_CReporterLzoWriter::testWriteBeforeOpen()
+{
+    QByteArray stream;
+    QBuffer buffer(&stream);
+    buffer.open(QIODevice::WriteOnly);
+
+    CReporterLzoWriter writer(&buffer);
+    QVERIFY(!writer.write("data"));
+    QVERIFY(!writer.close());
+    QVERIFY(!writer.errorString().isEmpty());
+}
+
+void Ut_CReporterLzoWriter::testAppendToRichCore()
+{
+    QString filePath = tempDir->path() + "/crasher-0287-11-2213.rcore.lzo";
+    QVERIFY(QFile::copy(CRASHER_CORE, filePath));
+
+    QVERIFY(CReporterLzoWriter::appendToFile(
+                filePath, "\n[---rich-core: user-comments---]\nIt crashed.\n"));
+
+    CReporterRichCoreReader reader(filePath);
+    QVERIFY(reader.seekSection("coredump"));
+    QCOMPARE(reader.readSection().size(), 655360);
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString("user-comments"));
+    QCOMPARE(reader.readSection(), QByteArray("It crashed.\n"));
+    QVERIFY(!reader.nextSection());
+    QVERIFY(!reader.hasError());
+}
+
+void Ut_CReporterLzoWriter::testConcurrentAppends()
+{
+    QString filePath = tempDir->path() + "/notes.lzo";
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(CReporterLzoWriter::compress(note(0)));
+    file.close();
+
+    QList<int> notes;
+    for (int i = 1; i <= 32; ++i) {
+        notes << i;
+    }
+    QtConcurrent::blockingMap(notes, NoteAppender(filePath));
+
+    CReporterRichCoreReader reader(filePath);
+    QSet<QString> names;
+    while (reader.nextSection()) {
+        QString name = reader.sectionName();
+        QCOMPARE(QByteArray("comment " + name.mid(5).toUtf8()),
+                 reader.readSection());
+        names << name;
+    }
+    QVERIFY(!reader.hasError());
+    QCOMPARE(names.size(), 33);
+}
+
+void Ut_CReporterLzoWriter::testAppendToMissingFile()
+{
+    QString filePath = tempDir->path() + "/missing.rcore.lzo";
+    QVERIFY(!CReporterLzoWriter::appendToFile(filePath, "text"));
+    QVERIFY(!QFile::exists(filePath));
+}
+
+void Ut_CReporterLzoWriter::testCompressFile()
+{
+    QFile core(CRASHER_CORE);
+    QVERIFY(core.open(QIODevice::ReadOnly));
+    QByteArray data = decompress(&core);
+    QCOMPARE(data.size(), 775980);
+
+    QString sourcePath = tempDir->path() + "/crasher-0287-11-2213.rcore";
+    QFile source(sourcePath);
+    QVERIFY(source.open(QIODevice::WriteOnly));
+    source.write(data);
+    source.close();
+    QVERIFY(source.setPermissions(QFile::ReadOwner | QFile::WriteOwner));
+
+    QDateTime mtime = QFileInfo(sourcePath).lastModified();
+
+    QString targetPath = sourcePath + ".lzo";
+    QVERIFY(CReporterLzoWriter::compressFile(sourcePath, targetPath));
+
+    QFileInfo target(targetPath);
+    QVERIFY(target.size() < data.size());
+    QCOMPARE(target.lastModified(), mtime);
+    QCOMPARE(target.permissions() & QFile::ReadOther, QFile::Permissions(0));
+
+    QFile compressed(targetPath);
+    QVERIFY(compressed.open(QIODevice::ReadOnly));
+    QCOMPARE(decompress(&compressed), data);
+    QVERIFY(QFile::exists(sourcePath));
+}
+
+void Ut_CReporterLzoWriter::testCompressMissingFile()
+{
+    QString targetPath = tempDir->path() + "/missing.rcore.lzo";
+    QVERIFY(!CReporterLzoWriter::compressFile(tempDir->path() + "/missing.rcore",
+                                              targetPath));
+    QVERIFY(!QFile::exists(targetPath));
+}
+
+void Ut_CReporterLzoWriter::benchmarkAppend_data()
+{
+    QTest::addColumn<bool>("native");
+
+    QTest::newRow("native") << true;
+    QTest::newRow("lzop process") << false;
+}
+
+void Ut_CReporterLzoWriter::benchmarkAppend()
+{
+    QFETCH(bool, native);
+
+    if (!native && !QFile::exists("/usr/bin/lzop")) {
+        QSKIP("lzop is not installed");
+    }
+
+    QString filePath = tempDir->path() + "/crasher-0287-11-2213.rcore.lzo";
+    QVERIFY(QFile::copy(CRASHER_CORE, filePath));
+
+    QByteArray text("\n[---rich-core: user-comments---]\n"
+                    "Application crashed while scrolling the list.\n");
+    QString tmpNote = tempDir->path() + "/rich-core-note.txt";
+
+    QBENCHMARK {
+        if (native) {
+            QVERIFY(CReporterLzoWriter::appendToFile(filePath, text));
+        } else {
+            // What appending used to cost: temporary file and a shell.
+            QFile note(tmpNote);
+            QVERIFY(note.open(QIODevice::WriteOnly));
+            note.write(text);
+            note.close();
+            QString cmd = QString("/usr/bin/lzop -c %1 >> %2")
+                          .arg(tmpNote).arg(filePath);
+            QCOMPARE(system(cmd.toLocal8Bit().constData()), 0);
+            note.remove();
+        }
+    }
+}
+
+void Ut_CReporterLzoWriter::testParallelCompression_data()
+{
+    QTest::addColumn<int>("threads");
+    QTest::addColumn<int>("chunkSize");
+
+    QTest::newRow("2 threads") << 2 << 1024 * 1024;
+    QTest::newRow("4 threads") << 4 << 1024 * 1024;
+    QTest::newRow("4 threads, small writes") << 4 << 1000;
+    QTest::newRow("16 threads") << 16 << 3 * 1024 * 1024;
+}
+
+void Ut_CReporterLzoWriter::testParallelCompression()
+{
+    QFETCH(int, threads);
+    QFETCH(int, chunkSize);
+
+    QByteArray data(mixedData(5 * 1024 * 1024 + 123));
+
+    QByteArray serial(compressWithThreads(data, 1, chunkSize));
+    QByteArray parallel(compressWithThreads(data, threads, chunkSize));
+    QVERIFY(!serial.isEmpty());
+    // The output format doesn't depend on the number of threads.
+    QCOMPARE(parallel.size(), serial.size());
+    QVERIFY(parallel == serial);
+    QCOMPARE(decompress(parallel), data);
+}
+
+void Ut_CReporterLzoWriter::benchmarkParallelCompression_data()
+{
+    QTest::addColumn<int>("threads");
+
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("ideal thread count") << QThread::idealThreadCount();
+}
+
+void Ut_CReporterLzoWriter::benchmarkParallelCompression()
+{
+    QFETCH(int, threads);
+
+    QByteArray data(mixedData(32 * 1024 * 1024));
+
+    QBENCHMARK {
+        QVERIFY(!compressWithThreads(data, threads,
+                                     CReporterLzoWriter::DefaultBlockSize).isEmpty());
+    }
+}
+
+QTEST_MAIN(Ut_CReporterLzoWriter)
@@ -0,0 +1,27 @@
+include(../ut_common_top.pri)
+
+TARGET = ut_creporterlzowriter
+
+LIBS += ../../../lib/libcrashreporter.so
+
+CONFIG += link_pkgconfig
+PKGCONFIG += lzo2
+
+INCLUDEPATH += . \
+               $${CREPORTER_SRC_DIR}/libs/richcore \
+               $${CREPORTER_SRC_DIR}/libs/utils \
+               $${CREPORTER_SRC_DIR}/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/richcore/creporterlzowriter.cpp \
+
+HEADERS += $${CREPORTER_SRC_DIR}/libs/richcore/creporterlzowriter.h \
+           $${CREPORTER_SRC_DIR}/libs/richcore/creporterlzop_p.h \
+           ut_creporterlzowriter.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_creporterlzowriter.cpp \
+
+include(../ut_coverage.pri)
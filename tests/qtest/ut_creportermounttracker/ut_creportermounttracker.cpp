@@ -0,0 +1,199 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+
+#include "ut_creportermounttracker.h"
+#include "creportermounttracker.h"
+
+namespace {
+
+const QByteArray MOUNTINFO(
+    "17 1 179:28 / / rw,relatime shared:1 - ext4 /dev/mmcblk0p28 rw,data=ordered\n"
+    "18 17 0:16 / /proc rw,nosuid,nodev,noexec,relatime shared:2 - proc proc rw\n"
+    "19 17 0:17 / /tmp rw,nosuid,nodev shared:3 - tmpfs tmpfs rw\n"
+    "20 17 253:1 / /home rw,relatime shared:4 - ext4 /dev/mapper/sailfish-home rw\n"
+    "21 20 253:1 /defaultuser /home/nemo/My\\040Docs rw,relatime shared:4 - ext4 /dev/mapper/sailfish-home rw\n"
+    "22 17 179:17 / /firmware ro,relatime - vfat /dev/mmcblk0p17 ro\n");
+
+const QByteArray CARD_MOUNT(
+    "23 17 179:33 / /run/media/nemo/card rw,relatime - vfat /dev/mmcblk1p1 rw\n");
+
+}
+
+void Ut_CReporterMountTracker::init()
+{
+    tmpDir = new QTemporaryDir;
+    mountInfoPath = tmpDir->path() + "/mountinfo";
+    writeMountInfo(MOUNTINFO);
+}
+
+void Ut_CReporterMountTracker::writeMountInfo(const QByteArray &content)
+{
+    QFile file(mountInfoPath);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(content);
+}
+
+void Ut_CReporterMountTracker::testParseMountInfo()
+{
+    QList<CReporterMountTracker::Mount> mounts =
+        CReporterMountTracker::parseMountInfo(MOUNTINFO + "garbage line\n");
+
+    QCOMPARE(mounts.count(), 6);
+
+    QCOMPARE(mounts.at(0).mountPoint, QString("/"));
+    QCOMPARE(mounts.at(0).fsType, QString("ext4"));
+    QCOMPARE(mounts.at(0).source, QString("/dev/mmcblk0p28"));
+    QCOMPARE(mounts.at(0).major, 179u);
+    QCOMPARE(mounts.at(0).minor, 28u);
+    QVERIFY(!mounts.at(0).readOnly);
+
+    QCOMPARE(mounts.at(4).mountPoint, QString("/home/nemo/My Docs"));
+    QCOMPARE(mounts.at(4).root, QString("/defaultuser"));
+
+    QCOMPARE(mounts.at(5).mountPoint, QString("/firmware"));
+    QVERIFY(mounts.at(5).readOnly);
+}
+
+void Ut_CReporterMountTracker::testMountForPath()
+{
+    CReporterMountTracker tracker(mountInfoPath);
+    CReporterMountTracker::Mount mount;
+
+    QVERIFY(tracker.mountForPath("/home/nemo/My Docs/core-dumps", &mount));
+    QCOMPARE(mount.mountPoint, QString("/home/nemo/My Docs"));
+
+    QVERIFY(tracker.mountForPath("/home/nemo", &mount));
+    QCOMPARE(mount.mountPoint, QString("/home"));
+
+    QVERIFY(tracker.mountForPath("/var/cache/core-dumps", &mount));
+    QCOMPARE(mount.mountPoint, QString("/"));
+
+    QVERIFY(tracker.mountForPath("/tmpfile", &mount));
+    QCOMPARE(mount.mountPoint, QString("/"));
+
+    QVERIFY(tracker.isMountPoint("/home/"));
+    QVERIFY(!tracker.isMountPoint("/var/cache"));
+}
+
+void Ut_CReporterMountTracker::testMountAddedAndRemoved()
+{
+    CReporterMountTracker tracker(mountInfoPath);
+    QSignalSpy addedSpy(&tracker, SIGNAL(mountAdded(QString)));
+    QSignalSpy removedSpy(&tracker, SIGNAL(mountRemoved(QString)));
+
+    QCOMPARE(tracker.mounts().count(), 6);
+
+    writeMountInfo(MOUNTINFO + CARD_MOUNT);
+    tracker.refresh();
+
+    QCOMPARE(addedSpy.count(), 1);
+    QCOMPARE(addedSpy.at(0).at(0).toString(), QString("/run/media/nemo/card"));
+    QCOMPARE(removedSpy.count(), 0);
+    QVERIFY(tracker.isMountPoint("/run/media/nemo/card"));
+
+    writeMountInfo(MOUNTINFO);
+    tracker.refresh();
+
+    QCOMPARE(addedSpy.count(), 1);
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(removedSpy.at(0).at(0).toString(), QString("/run/media/nemo/card"));
+    QVERIFY(!tracker.isMountPoint("/run/media/nemo/card"));
+}
+
+void Ut_CReporterMountTracker::testClassifyByFileSystem()
+{
+    QList<CReporterMountTracker::Mount> mounts =
+        CReporterMountTracker::parseMountInfo(MOUNTINFO);
+    QString sysfs = tmpDir->path() + "/sys";
+
+    QCOMPARE(CReporterMountTracker::classify(mounts.at(1), sysfs),
+             CReporterMountTracker::UnknownDevice);
+    QCOMPARE(CReporterMountTracker::classify(mounts.at(2), sysfs),
+             CReporterMountTracker::RamDisk);
+
+    CReporterMountTracker::Mount nfs = mounts.at(0);
+    nfs.fsType = "nfs4";
+    QCOMPARE(CReporterMountTracker::classify(nfs, sysfs),
+             CReporterMountTracker::NetworkStorage);
+
+    // Block device not present in sysfs.
+    QCOMPARE(CReporterMountTracker::classify(mounts.at(0), sysfs),
+             CReporterMountTracker::UnknownDevice);
+}
+
+void Ut_CReporterMountTracker::testClassifyMemoryCard()
+{
+    QString sysfs = tmpDir->path() + "/sys";
+    QString host = sysfs + "/devices/soc/mmc_host";
+    QDir root;
+
+    // Internal eMMC and SD card, as laid out by the mmc driver.
+    QVERIFY(root.mkpath(host + "/mmc0/mmc0:0001/block/mmcblk0/mmcblk0p28"));
+    QVERIFY(root.mkpath(host + "/mmc1/mmc1:aaaa/block/mmcblk1/mmcblk1p1"));
+    QVERIFY(root.mkpath(sysfs + "/dev/block"));
+
+    QFile::link("../..", host + "/mmc0/mmc0:0001/block/mmcblk0/device");
+    QFile::link("../..", host + "/mmc1/mmc1:aaaa/block/mmcblk1/device");
+    QFile(host + "/mmc0/mmc0:0001/block/mmcblk0/mmcblk0p28/partition").open(QIODevice::WriteOnly);
+    QFile(host + "/mmc1/mmc1:aaaa/block/mmcblk1/mmcblk1p1/partition").open(QIODevice::WriteOnly);
+
+    QFile type0(host + "/mmc0/mmc0:0001/type");
+    QVERIFY(type0.open(QIODevice::WriteOnly));
+    type0.write("MMC\n");
+    type0.close();
+    QFile type1(host + "/mmc1/mmc1:aaaa/type");
+    QVERIFY(type1.open(QIODevice::WriteOnly));
+    type1.write("SD\n");
+    type1.close();
+
+    QVERIFY(QFile::link(host + "/mmc0/mmc0:0001/block/mmcblk0/mmcblk0p28",
+                        sysfs + "/dev/block/179:28"));
+    QVERIFY(QFile::link(host + "/mmc1/mmc1:aaaa/block/mmcblk1/mmcblk1p1",
+                        sysfs + "/dev/block/179:33"));
+
+    CReporterMountTracker::Mount internal =
+        CReporterMountTracker::parseMountInfo(MOUNTINFO).at(0);
+    CReporterMountTracker::Mount card =
+        CReporterMountTracker::parseMountInfo(CARD_MOUNT).at(0);
+
+    QCOMPARE(CReporterMountTracker::classify(internal, sysfs),
+             CReporterMountTracker::InternalFlash);
+    QCOMPARE(CReporterMountTracker::classify(card, sysfs),
+             CReporterMountTracker::RemovableCard);
+}
+
+void Ut_CReporterMountTracker::testFreeSpace()
+{
+    QVERIFY(CReporterMountTracker::freeSpace(tmpDir->path()) >= 0);
+    QCOMPARE(CReporterMountTracker::freeSpace(tmpDir->path() + "/nonexistent"),
+             qint64(-1));
+}
+
+void Ut_CReporterMountTracker::cleanup()
+{
+    delete tmpDir;
+    tmpDir = 0;
+}
+
+QTEST_MAIN(Ut_CReporterMountTracker)
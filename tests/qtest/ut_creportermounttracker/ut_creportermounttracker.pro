@@ -0,0 +1,26 @@
+include(../ut_common_top.pri)
+
+QT -= gui
+
+TARGET = ut_creportermounttracker
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $$CREPORTER_SRC_DIR/libs/coredir \
+               $$CREPORTER_SRC_DIR/libs/utils \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/coredir/creportermounttracker.cpp \
+
+HEADERS += $${CREPORTER_SRC_DIR}/libs/coredir/creportermounttracker.h \
+           $${CREPORTER_SRC_DIR}/libs/coredir/creportermounttracker_p.h \
+           ut_creportermounttracker.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_creportermounttracker.cpp \
+
+include(../ut_coverage.pri)
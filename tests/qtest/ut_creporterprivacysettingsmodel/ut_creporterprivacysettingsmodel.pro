@@ -22,7 +22,9 @@ HEADERS += $${SETTINGS_SRC_DIR}/creporterprivacysettingsmodel.h \
             $${SETTINGS_SRC_DIR}/creportersettingsbase.h \
            $$CREPORTER_SRC_DIR/libs/autouploader_interface.h \
            $$CREPORTER_SRC_DIR/libs/coredir/creportercoredir.h \
+           $$CREPORTER_SRC_DIR/libs/coredir/creportercorescanner.h \
            $$CREPORTER_SRC_DIR/libs/coredir/creportercoreregistry.h \
+           $$CREPORTER_SRC_DIR/libs/coredir/creportermounttracker.h \
            $$CREPORTER_SRC_DIR/libs/utils/creporterutils.h \
             ut_creporterprivacysettingsmodel.h \
 
@@ -31,7 +33,10 @@ SOURCES += \
 	ut_creporterprivacysettingsmodel.cpp \
 	$$CREPORTER_SRC_DIR/libs/autouploader_interface.cpp \
 	$$CREPORTER_SRC_DIR/libs/coredir/creportercoredir.cpp \
+	$$CREPORTER_SRC_DIR/libs/coredir/creportercorescanner.cpp \
 	$$CREPORTER_SRC_DIR/libs/coredir/creportercoreregistry.cpp \
+	$$CREPORTER_SRC_DIR/libs/coredir/creportermounttracker.cpp \
 	$$CREPORTER_SRC_DIR/libs/utils/creporterutils.cpp \
 
+include(../ut_richcore.pri)
 include(../ut_coverage.pri)
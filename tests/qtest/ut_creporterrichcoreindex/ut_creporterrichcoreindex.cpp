@@ -0,0 +1,235 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QFile>
+#include <QFileInfo>
+
+#include "ut_creporterrichcoreindex.h"
+#include "creporterlzowriter.h"
+#include "creporternamespace.h"
+#include "creporterrichcoreindex.h"
+#include "creporterrichcorereader.h"
+
+namespace {
+
+const QString CRASHER_CORE("/usr/lib/crash-reporter-tests/testdata/"
+                           "crasher-0287-11-2213.rcore.lzo");
+
+QByteArray readFile(const QString &filePath)
+{
+    QFile file(filePath);
+    file.open(QIODevice::ReadOnly);
+    return file.readAll();
+}
+
+}
+
+void Ut_CReporterRichCoreIndex::init()
+{
+    tempDir = new QTemporaryDir;
+    QVERIFY(tempDir->isValid());
+}
+
+void Ut_CReporterRichCoreIndex::cleanup()
+{
+    delete tempDir;
+    tempDir = 0;
+}
+
+QString Ut_CReporterRichCoreIndex::copyTestCore()
+{
+    QString filePath = tempDir->path() + "/crasher-0287-11-2213.rcore.lzo";
+    QFile::copy(CRASHER_CORE, filePath);
+    QFile::setPermissions(filePath, QFile::ReadOwner | QFile::WriteOwner);
+    return filePath;
+}
+
+void Ut_CReporterRichCoreIndex::testBuild()
+{
+    CReporterRichCoreIndex::Entries entries;
+    QVERIFY(CReporterRichCoreIndex::build(CRASHER_CORE, &entries));
+
+    QCOMPARE(entries.size(), 14);
+
+    QCOMPARE(entries.first().name, QString("date"));
+    QCOMPARE(entries.first().offset, qint64(25));
+    QCOMPARE(entries.first().size, qint64(29));
+
+    QCOMPARE(entries.last().name, QString("coredump"));
+    QCOMPARE(entries.last().size, qint64(655360));
+    QCOMPARE(entries.last().offset + entries.last().size, qint64(775980));
+
+    foreach (const CReporterRichCoreIndex::Entry &entry, entries) {
+        QVERIFY(entry.blockOffset > entry.streamOffset);
+        QVERIFY(entry.blockSkip >= 0);
+        QVERIFY(entry.blockSkip < 256 * 1024);
+    }
+}
+
+void Ut_CReporterRichCoreIndex::testSaveAndLoad()
+{
+    QString filePath = copyTestCore();
+    QByteArray original = readFile(filePath);
+
+    CReporterRichCoreIndex::Entries built;
+    QVERIFY(CReporterRichCoreIndex::build(filePath, &built));
+    QVERIFY(CReporterRichCoreIndex::save(filePath, built));
+    QCOMPARE(CReporterRichCoreIndex::indexPath(filePath),
+             tempDir->path() + '/' + CReporter::IndexDirName +
+             "/crasher-0287-11-2213.rcore.lzo.index");
+    QVERIFY(QFile::exists(CReporterRichCoreIndex::indexPath(filePath)));
+
+    // Report itself stays as it was.
+    QCOMPARE(readFile(filePath), original);
+
+    CReporterRichCoreIndex::Entries loaded;
+    QVERIFY(CReporterRichCoreIndex::load(filePath, &loaded));
+    QCOMPARE(loaded.size(), built.size());
+    for (int i = 0; i < loaded.size(); ++i) {
+        QCOMPARE(loaded.at(i).name, built.at(i).name);
+        QCOMPARE(loaded.at(i).offset, built.at(i).offset);
+        QCOMPARE(loaded.at(i).size, built.at(i).size);
+        QCOMPARE(loaded.at(i).streamOffset, built.at(i).streamOffset);
+        QCOMPARE(loaded.at(i).blockOffset, built.at(i).blockOffset);
+        QCOMPARE(loaded.at(i).blockSkip, built.at(i).blockSkip);
+    }
+
+    CReporterRichCoreReader reader(filePath);
+    QVERIFY(reader.seekSection("coredump"));
+    QCOMPARE(reader.readSection().size(), 655360);
+    QVERIFY(!reader.nextSection());
+    QVERIFY(!reader.hasError());
+
+    // Current index is not built again.
+    QVERIFY(CReporterRichCoreIndex::save(filePath, built.mid(0, 3)));
+    QVERIFY(CReporterRichCoreIndex::ensure(filePath));
+    QVERIFY(CReporterRichCoreIndex::load(filePath, &loaded));
+    QCOMPARE(loaded.size(), 3);
+}
+
+void Ut_CReporterRichCoreIndex::testNoIndex()
+{
+    CReporterRichCoreIndex::Entries entries;
+    QVERIFY(!CReporterRichCoreIndex::load(CRASHER_CORE, &entries));
+    QVERIFY(entries.isEmpty());
+    QVERIFY(!CReporterRichCoreIndex::load("/nonexistent.rcore.lzo", &entries));
+}
+
+void Ut_CReporterRichCoreIndex::testSeekWithIndex()
+{
+    QString filePath = tempDir->path() + "/sections.rcore.lzo";
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+
+    // Small stored blocks, so that each section spans several of them.
+    CReporterLzoWriter writer(&file, 64);
+    writer.setCompressionEnabled(false);
+    QVERIFY(writer.open());
+    QVERIFY(writer.write("\n[---rich-core: a---]\n" + QByteArray(200, 'a') +
+                         "\n[---rich-core: b---]\n" + QByteArray(200, 'b') +
+                         "\n[---rich-core: c---]\n" + QByteArray(200, 'c')));
+    QVERIFY(writer.close());
+    file.close();
+
+    QVERIFY(CReporterRichCoreIndex::ensure(filePath));
+
+    CReporterRichCoreIndex::Entries entries;
+    QVERIFY(CReporterRichCoreIndex::load(filePath, &entries));
+    QCOMPARE(entries.size(), 3);
+
+    // Break the block where section b starts.
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.seek(entries.at(1).blockOffset));
+    file.write(QByteArray(4, '\xff'));
+    file.close();
+
+    CReporterRichCoreReader sequential(filePath);
+    QVERIFY(sequential.nextSection());
+    QVERIFY(!sequential.nextSection());
+    QVERIFY(sequential.hasError());
+
+    // Section c is read without touching the blocks before it.
+    CReporterRichCoreReader indexed(filePath);
+    QVERIFY(indexed.seekSection("c"));
+    QCOMPARE(indexed.sectionName(), QString("c"));
+    QCOMPARE(indexed.readSection(), QByteArray(200, 'c'));
+    QVERIFY(!indexed.nextSection());
+    QVERIFY(!indexed.hasError());
+}
+
+void Ut_CReporterRichCoreIndex::testStaleIndex()
+{
+    QString filePath = copyTestCore();
+
+    QVERIFY(CReporterRichCoreIndex::ensure(filePath));
+    QVERIFY(CReporterLzoWriter::appendToFile(
+                filePath, "\n[---rich-core: user-comments---]\nIt crashed.\n"));
+
+    CReporterRichCoreIndex::Entries entries;
+    QVERIFY(!CReporterRichCoreIndex::load(filePath, &entries));
+
+    // Rebuilt index covers the appended section.
+    QVERIFY(CReporterRichCoreIndex::ensure(filePath));
+    QVERIFY(CReporterRichCoreIndex::load(filePath, &entries));
+    QCOMPARE(entries.size(), 15);
+    QCOMPARE(entries.last().name, QString("user-comments"));
+
+    CReporterRichCoreReader reader(filePath);
+    QVERIFY(reader.seekSection("user-comments"));
+    QCOMPARE(reader.readSection(), QByteArray("It crashed.\n"));
+}
+
+void Ut_CReporterRichCoreIndex::testBrokenIndex()
+{
+    QString filePath = copyTestCore();
+    QVERIFY(CReporterRichCoreIndex::ensure(filePath));
+
+    QFile file(CReporterRichCoreIndex::indexPath(filePath));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.seek(file.size() - 2));
+    file.write("g");
+    file.close();
+
+    CReporterRichCoreIndex::Entries entries;
+    QVERIFY(!CReporterRichCoreIndex::load(filePath, &entries));
+
+    // Broken index is replaced.
+    QVERIFY(CReporterRichCoreIndex::ensure(filePath));
+    QVERIFY(CReporterRichCoreIndex::load(filePath, &entries));
+    QCOMPARE(entries.size(), 14);
+}
+
+void Ut_CReporterRichCoreIndex::testRemovedReport()
+{
+    QString filePath = copyTestCore();
+    QVERIFY(CReporterRichCoreIndex::ensure(filePath));
+    QString indexPath = CReporterRichCoreIndex::indexPath(filePath);
+
+    QString otherPath = tempDir->path() + "/crasher-0287-11-2214.rcore.lzo";
+    QVERIFY(QFile::rename(filePath, otherPath));
+    QVERIFY(QFile::exists(indexPath));
+
+    // Index of the report that is gone is removed with the next one stored.
+    QVERIFY(CReporterRichCoreIndex::ensure(otherPath));
+    QVERIFY(QFile::exists(CReporterRichCoreIndex::indexPath(otherPath)));
+    QVERIFY(!QFile::exists(indexPath));
+}
+
+QTEST_MAIN(Ut_CReporterRichCoreIndex)
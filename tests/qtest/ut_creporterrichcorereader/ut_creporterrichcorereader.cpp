@@ -0,0 +1,474 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QTemporaryFile>
+#include <QThread>
+
+#include "ut_creporterrichcorereader.h"
+#include "creporterlzoreader.h"
+#include "creporterlzowriter.h"
+#include "creporterrichcorereader.h"
+#include "creporterrichcorereader_p.h"
+
+namespace {
+
+const QString TESTDATA_DIR("/usr/lib/crash-reporter-tests/testdata/");
+const QString CRASHER_CORE(TESTDATA_DIR + "crasher-0287-11-2213.rcore.lzo");
+
+QByteArray sha1(const QByteArray &data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+}
+
+QByteArray readFile(const QString &filePath)
+{
+    QFile file(filePath);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+//! Decodes the whole stream, noting offsets of each block.
+QByteArray decodeBlocks(QByteArray stream, int threads, QList<qint64> *offsets)
+{
+    QBuffer buffer(&stream);
+    CReporterLzoReader lzo(&buffer);
+    lzo.setDecodingThreads(threads);
+    if (!lzo.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+
+    QByteArray data;
+    QByteArray block;
+    while (!(block = lzo.readBlock()).isEmpty()) {
+        *offsets << lzo.streamOffset() << lzo.blockOffset();
+        data += block;
+    }
+    *offsets << lzo.compressedPos() << lzo.hasError();
+    return data;
+}
+
+}
+
+void Ut_CReporterRichCoreReader::testLzoDecodesFile_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<int>("size");
+    QTest::addColumn<QByteArray>("hash");
+
+    QTest::newRow("crasher")
+            << "crasher-0287-11-2213.rcore.lzo" << 775980
+            << QByteArray("b6a3a11a91ca09f2b3ac464c63c0409b0c09d371");
+    QTest::newRow("crashapplication")
+            << "crashapplication-0287-11-2260.rcore.lzo" << 776047
+            << QByteArray("4df7fb3a690dc6e17af53ac7ef4ebccfe42befab");
+}
+
+void Ut_CReporterRichCoreReader::testLzoDecodesFile()
+{
+    QFETCH(QString, fileName);
+    QFETCH(int, size);
+    QFETCH(QByteArray, hash);
+
+    CReporterLzoReader lzo(TESTDATA_DIR + fileName);
+    QVERIFY(lzo.open(QIODevice::ReadOnly));
+
+    QByteArray data = lzo.readAll();
+    QVERIFY(!lzo.hasError());
+    QVERIFY(lzo.atEnd());
+    QCOMPARE(data.size(), size);
+    QCOMPARE(sha1(data), hash);
+    QCOMPARE(lzo.compressedPos(), QFile(TESTDATA_DIR + fileName).size());
+}
+
+void Ut_CReporterRichCoreReader::testLzoReadBlock()
+{
+    CReporterLzoReader lzo(CRASHER_CORE);
+    QVERIFY(lzo.open(QIODevice::ReadOnly));
+
+    // Mixing read() and readBlock() continues where the other stopped.
+    QByteArray data = lzo.read(100);
+    QCOMPARE(data.size(), 100);
+
+    QByteArray block;
+    while (!(block = lzo.readBlock()).isEmpty()) {
+        QVERIFY(block.size() <= 256 * 1024);
+        data += block;
+    }
+
+    QVERIFY(!lzo.hasError());
+    QCOMPARE(sha1(data), QByteArray("b6a3a11a91ca09f2b3ac464c63c0409b0c09d371"));
+}
+
+void Ut_CReporterRichCoreReader::testLzoRejectsPlainData()
+{
+    QByteArray plain("\n[---rich-core: date---]\nSat Jan  1 06:47:21 UTC 2000\n");
+    QBuffer buffer(&plain);
+
+    QVERIFY(!CReporterLzoReader::isLzoStream(plain));
+
+    CReporterLzoReader lzo(&buffer);
+    QVERIFY(!lzo.open(QIODevice::ReadOnly));
+}
+
+void Ut_CReporterRichCoreReader::testLzoTruncatedStream()
+{
+    QFile file(CRASHER_CORE);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QByteArray compressed = file.readAll();
+    QVERIFY(CReporterLzoReader::isLzoStream(compressed));
+
+    compressed.truncate(compressed.size() / 2);
+    QBuffer buffer(&compressed);
+
+    CReporterLzoReader lzo(&buffer);
+    QVERIFY(lzo.open(QIODevice::ReadOnly));
+
+    QByteArray data = lzo.readAll();
+    QVERIFY(lzo.hasError());
+    QVERIFY(data.size() < 775980);
+}
+
+void Ut_CReporterRichCoreReader::testLzoUncompressedSize()
+{
+    QCOMPARE(CReporterLzoReader::uncompressedSize(CRASHER_CORE), qint64(775980));
+
+    QTemporaryFile plain;
+    QVERIFY(plain.open());
+    plain.write("[---rich-core: cmdline---]\n/usr/bin/test\n");
+    plain.close();
+    QCOMPARE(CReporterLzoReader::uncompressedSize(plain.fileName()), qint64(-1));
+
+    QTemporaryFile truncated;
+    QVERIFY(truncated.open());
+    truncated.write(readFile(CRASHER_CORE).left(100000));
+    truncated.close();
+    QCOMPARE(CReporterLzoReader::uncompressedSize(truncated.fileName()), qint64(-1));
+}
+
+void Ut_CReporterRichCoreReader::testLzoVerifyChecksums_data()
+{
+    QTest::addColumn<int>("threads");
+
+    QTest::newRow("serial") << 1;
+    QTest::newRow("parallel") << 4;
+}
+
+void Ut_CReporterRichCoreReader::testLzoVerifyChecksums()
+{
+    QFETCH(int, threads);
+
+    QByteArray stream = readFile(CRASHER_CORE);
+    {
+        QBuffer buffer(&stream);
+        CReporterLzoReader lzo(&buffer);
+        lzo.setVerifyChecksums(true);
+        lzo.setDecodingThreads(threads);
+        QVERIFY(lzo.open(QIODevice::ReadOnly));
+        QCOMPARE(lzo.readAll().size(), 775980);
+        QVERIFY(!lzo.hasError());
+    }
+
+    // Last byte of the last block.
+    stream[stream.size() - 5] = stream.at(stream.size() - 5) ^ 0x01;
+
+    QBuffer buffer(&stream);
+    CReporterLzoReader lzo(&buffer);
+    lzo.setVerifyChecksums(true);
+    lzo.setDecodingThreads(threads);
+    QVERIFY(lzo.open(QIODevice::ReadOnly));
+    lzo.readAll();
+    QVERIFY(lzo.hasError());
+}
+
+void Ut_CReporterRichCoreReader::testLzoParallelDecode_data()
+{
+    QTest::addColumn<int>("threads");
+
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("16 threads") << 16;
+}
+
+void Ut_CReporterRichCoreReader::testLzoParallelDecode()
+{
+    QFETCH(int, threads);
+
+    // Another stream appended, as with notes added to a rich core.
+    QByteArray stream = readFile(CRASHER_CORE);
+    stream += CReporterLzoWriter::compress(QByteArray(300 * 1024, 'x'));
+
+    QList<qint64> serialOffsets;
+    QByteArray serial = decodeBlocks(stream, 1, &serialOffsets);
+    QCOMPARE(serial.size(), 775980 + 300 * 1024);
+
+    QList<qint64> parallelOffsets;
+    QByteArray parallel = decodeBlocks(stream, threads, &parallelOffsets);
+    QCOMPARE(sha1(parallel), sha1(serial));
+    QCOMPARE(parallelOffsets, serialOffsets);
+    QCOMPARE(parallelOffsets.last(), qint64(false));
+    QCOMPARE(parallelOffsets.at(parallelOffsets.size() - 2), qint64(stream.size()));
+}
+
+void Ut_CReporterRichCoreReader::testLzoParallelTruncatedStream()
+{
+    QByteArray stream = readFile(CRASHER_CORE);
+    stream.truncate(stream.size() * 3 / 4);
+
+    QList<qint64> serialOffsets;
+    QByteArray serial = decodeBlocks(stream, 1, &serialOffsets);
+    QCOMPARE(serialOffsets.last(), qint64(true));
+
+    // Blocks decoded before the broken one are still delivered.
+    QList<qint64> parallelOffsets;
+    QByteArray parallel = decodeBlocks(stream, 4, &parallelOffsets);
+    QCOMPARE(parallelOffsets.last(), qint64(true));
+    QCOMPARE(parallel, serial);
+}
+
+void Ut_CReporterRichCoreReader::testLzoParallelSeekBlock()
+{
+    CReporterLzoReader lzo(CRASHER_CORE);
+    lzo.setDecodingThreads(4);
+    QVERIFY(lzo.open(QIODevice::ReadOnly));
+
+    QList<QByteArray> blocks;
+    QList<QPair<qint64, qint64> > offsets;
+    QByteArray block;
+    while (!(block = lzo.readBlock()).isEmpty()) {
+        blocks << block;
+        offsets << qMakePair(lzo.streamOffset(), lzo.blockOffset());
+    }
+    QVERIFY(blocks.size() > 2);
+
+    // Seeking back drops the blocks decoded ahead.
+    QVERIFY(lzo.seekBlock(offsets.at(1).first, offsets.at(1).second));
+    QCOMPARE(lzo.readBlock(), blocks.at(1));
+    QVERIFY(lzo.seekBlock(offsets.at(0).first, offsets.at(0).second));
+    QCOMPARE(lzo.readBlock(), blocks.at(0));
+    QCOMPARE(lzo.readBlock(), blocks.at(1));
+    lzo.close();
+}
+
+void Ut_CReporterRichCoreReader::testParallelSectionContents()
+{
+    CReporterRichCoreReader serial(CRASHER_CORE);
+    CReporterRichCoreReader parallel(CRASHER_CORE);
+    parallel.setDecodingThreads(4);
+
+    while (serial.nextSection()) {
+        QVERIFY(parallel.nextSection());
+        QCOMPARE(parallel.sectionName(), serial.sectionName());
+        QCOMPARE(parallel.readSection(), serial.readSection());
+    }
+    QVERIFY(!parallel.nextSection());
+    QVERIFY(!parallel.hasError());
+}
+
+void Ut_CReporterRichCoreReader::benchmarkLzoDecode_data()
+{
+    QTest::addColumn<int>("threads");
+
+    QTest::newRow("serial") << 1;
+    QTest::newRow("ideal thread count") << QThread::idealThreadCount();
+}
+
+void Ut_CReporterRichCoreReader::benchmarkLzoDecode()
+{
+    QFETCH(int, threads);
+
+    // Some 64 MB of core dump like data.
+    QByteArray core = readFile(CRASHER_CORE);
+    QByteArray data;
+    while (data.size() < 64 * 1024 * 1024) {
+        data += core;
+    }
+    QByteArray stream = CReporterLzoWriter::compress(data);
+
+    qint64 size = 0;
+    QBENCHMARK {
+        QBuffer buffer(&stream);
+        CReporterLzoReader lzo(&buffer);
+        lzo.setDecodingThreads(threads);
+        QVERIFY(lzo.open(QIODevice::ReadOnly));
+
+        size = 0;
+        QByteArray block;
+        while (!(block = lzo.readBlock()).isEmpty()) {
+            size += block.size();
+        }
+    }
+    QCOMPARE(size, qint64(data.size()));
+}
+
+void Ut_CReporterRichCoreReader::testSectionNames()
+{
+    CReporterRichCoreReader reader(CRASHER_CORE);
+
+    QStringList names;
+    while (reader.nextSection()) {
+        names << reader.sectionName();
+    }
+
+    QVERIFY(!reader.hasError());
+    QCOMPARE(names, QStringList()
+             << "date" << "/tmp/osso_software_version"
+             << "/proc/component_version" << "ifconfig" << "df" << "ls_proc"
+             << "/proc/2213/cmdline" << "fd" << "/proc/2213/smaps"
+             << "/proc/slabinfo" << "proc2csv" << "packagelist"
+             << "/tmp/osso-product-info" << "coredump");
+}
+
+void Ut_CReporterRichCoreReader::testSectionContents()
+{
+    CReporterRichCoreReader reader(CRASHER_CORE);
+
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString("date"));
+    QCOMPARE(reader.readSection(), QByteArray("Sat Jan  1 06:47:21 UTC 2000\n"));
+    QVERIFY(reader.readSection().isEmpty());
+
+    QVERIFY(reader.seekSection("coredump"));
+    QByteArray core = reader.readSection();
+    QCOMPARE(core.size(), 655360);
+    QVERIFY(core.startsWith("\x7f" "ELF"));
+
+    QVERIFY(!reader.nextSection());
+    QVERIFY(!reader.hasError());
+}
+
+void Ut_CReporterRichCoreReader::testChunkedRead()
+{
+    CReporterRichCoreReader whole(CRASHER_CORE);
+    CReporterRichCoreReader chunked(CRASHER_CORE);
+
+    while (whole.nextSection()) {
+        QVERIFY(chunked.nextSection());
+        QCOMPARE(chunked.sectionName(), whole.sectionName());
+
+        QByteArray data;
+        QByteArray chunk;
+        while (!(chunk = chunked.readSectionChunk(7)).isEmpty()) {
+            QVERIFY(chunk.size() <= 7);
+            data += chunk;
+        }
+        QCOMPARE(data, whole.readSection());
+    }
+    QVERIFY(!chunked.nextSection());
+}
+
+void Ut_CReporterRichCoreReader::testSectionDevice()
+{
+    CReporterRichCoreReader reader(CRASHER_CORE);
+
+    QVERIFY(reader.seekSection("/proc/2213/cmdline"));
+    QIODevice *device = reader.sectionDevice();
+    QVERIFY(device->isOpen());
+    QVERIFY(!device->atEnd());
+    QByteArray cmdline = device->readAll();
+    QCOMPARE(cmdline.size(), 38);
+    QVERIFY(device->atEnd());
+
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString("fd"));
+    QVERIFY(!device->isOpen());
+
+    // Section device reads the same as the reader itself.
+    QByteArray lines;
+    device = reader.sectionDevice();
+    while (!device->atEnd()) {
+        lines += device->readLine();
+    }
+    QCOMPARE(lines.size(), 216);
+}
+
+void Ut_CReporterRichCoreReader::testSeekSection()
+{
+    CReporterRichCoreReader reader(CRASHER_CORE);
+
+    QVERIFY(reader.seekSection("packagelist"));
+    QCOMPARE(reader.readSection().size(), 17150);
+
+    // Only sections after the current one are searched.
+    QVERIFY(!reader.seekSection("date"));
+    QVERIFY(!reader.hasError());
+}
+
+void Ut_CReporterRichCoreReader::testPlainStream()
+{
+    QByteArray plain("[---rich-core: first---]\nline 1\n"
+                     "\n[---rich-core: empty---]\n"
+                     "\n[---rich-core: last---]\n[---rich-core: not a marker");
+    QBuffer buffer(&plain);
+
+    CReporterRichCoreReader reader(&buffer);
+
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString("first"));
+    QCOMPARE(reader.readSection(), QByteArray("line 1\n"));
+
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString("empty"));
+    QVERIFY(reader.readSection().isEmpty());
+
+    QVERIFY(reader.nextSection());
+    QCOMPARE(reader.sectionName(), QString("last"));
+    QCOMPARE(reader.readSection(), QByteArray("[---rich-core: not a marker"));
+
+    QVERIFY(!reader.nextSection());
+    QVERIFY(!reader.hasError());
+}
+
+void Ut_CReporterRichCoreReader::testMarkerAcrossReadBoundary()
+{
+    const QByteArray header("\n[---rich-core: big---]\n");
+
+    // Next marker starts around the end of the first read from the buffer.
+    for (int offset = -20; offset <= 5; ++offset) {
+        QByteArray filler(RICHCORE_READ_CHUNK_SIZE - header.size() + offset, 'x');
+        QByteArray plain = header + filler + "\n[---rich-core: small---]\ndata";
+        QBuffer buffer(&plain);
+
+        CReporterRichCoreReader reader(&buffer);
+        QVERIFY(reader.nextSection());
+        QCOMPARE(reader.readSection(), filler);
+        QVERIFY(reader.nextSection());
+        QCOMPARE(reader.sectionName(), QString("small"));
+        QCOMPARE(reader.readSection(), QByteArray("data"));
+        QVERIFY(!reader.nextSection());
+    }
+}
+
+void Ut_CReporterRichCoreReader::testInvalidData()
+{
+    QByteArray garbage("no sections here");
+    QBuffer buffer(&garbage);
+
+    CReporterRichCoreReader reader(&buffer);
+    QVERIFY(!reader.nextSection());
+    QVERIFY(reader.hasError());
+
+    CReporterRichCoreReader missing("/nonexistent.rcore.lzo");
+    QVERIFY(!missing.nextSection());
+    QVERIFY(missing.hasError());
+}
+
+QTEST_MAIN(Ut_CReporterRichCoreReader)
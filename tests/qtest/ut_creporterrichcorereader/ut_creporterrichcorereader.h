@@ -0,0 +1,56 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef UT_CREPORTERRICHCOREREADER_H
+#define UT_CREPORTERRICHCOREREADER_H
+
+#include <QTest>
+
+class Ut_CReporterRichCoreReader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testLzoDecodesFile_data();
+    void testLzoDecodesFile();
+    void testLzoReadBlock();
+    void testLzoRejectsPlainData();
+    void testLzoTruncatedStream();
+    void testLzoUncompressedSize();
+    void testLzoVerifyChecksums_data();
+    void testLzoVerifyChecksums();
+    void testLzoParallelDecode_data();
+    void testLzoParallelDecode();
+    void testLzoParallelTruncatedStream();
+    void testLzoParallelSeekBlock();
+    void testParallelSectionContents();
+    void benchmarkLzoDecode_data();
+    void benchmarkLzoDecode();
+    void testSectionNames();
+    void testSectionContents();
+    void testChunkedRead();
+    void testSectionDevice();
+    void testSeekSection();
+    void testPlainStream();
+    void testMarkerAcrossReadBoundary();
+    void testInvalidData();
+};
+
+#endif // UT_CREPORTERRICHCOREREADER_H
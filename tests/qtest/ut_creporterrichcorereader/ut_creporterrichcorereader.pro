@@ -0,0 +1,31 @@
+include(../ut_common_top.pri)
+
+TARGET = ut_creporterrichcorereader
+
+LIBS += ../../../lib/libcrashreporter.so
+
+CONFIG += link_pkgconfig
+PKGCONFIG += lzo2
+
+INCLUDEPATH += . \
+               $${CREPORTER_SRC_DIR}/libs/richcore \
+               $${CREPORTER_SRC_DIR}/libs/utils \
+               $${CREPORTER_SRC_DIR}/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/richcore/creporterlzoreader.cpp \
+                $${CREPORTER_SRC_DIR}/libs/richcore/creporterrichcorereader.cpp \
+
+HEADERS += $${CREPORTER_SRC_DIR}/libs/richcore/creporterlzoreader.h \
+           $${CREPORTER_SRC_DIR}/libs/richcore/creporterlzop_p.h \
+           $${CREPORTER_SRC_DIR}/libs/richcore/creporterlzoreader_p.h \
+           $${CREPORTER_SRC_DIR}/libs/richcore/creporterrichcorereader.h \
+           $${CREPORTER_SRC_DIR}/libs/richcore/creporterrichcorereader_p.h \
+           ut_creporterrichcorereader.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_creporterrichcorereader.cpp \
+
+include(../ut_coverage.pri)
@@ -0,0 +1,334 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+
+#include "ut_creportersectionencoder.h"
+#include "creporterlzowriter.h"
+#include "creporterrichcorereader.h"
+#include "creportersectionencoder.h"
+
+namespace {
+
+const int DICTIONARY_SIZE = 16 * 1024;
+
+typedef QMap<QString, QByteArray> Sections;
+
+//! Journal excerpt resembling the ones in JournalSpy reports.
+QByteArray journal(int lines)
+{
+    static const char *units[] = {
+        "ofono", "connman", "lipstick", "mce", "dsme", "pulseaudio",
+        "ngfd", "systemd", "kernel", "sensorfwd", "usb-moded", "timed",
+    };
+    static const char *words[] = {
+        "failed", "to", "open", "device", "connection", "state", "changed",
+        "timed", "out", "battery", "level", "display", "power", "resume",
+        "suspend", "modem", "network", "interface", "sim", "card",
+        "registered", "roaming", "signal", "strength", "audio", "route",
+        "headset", "plugged", "charger", "wakelock", "released", "acquired",
+    };
+    const int unitCount = sizeof(units) / sizeof(units[0]);
+    const int wordCount = sizeof(words) / sizeof(words[0]);
+    const int messageCount = 80;
+
+    QByteArray text;
+    for (int i = 0; i < lines; ++i) {
+        // Fixed set of messages, so that the dictionary can learn them.
+        int message = qrand() % messageCount;
+        QByteArray phrase;
+        for (int w = 0; w < 4 + message % 6; ++w) {
+            phrase += words[(message * 7 + w * 11) % wordCount];
+            phrase += ' ';
+        }
+
+        int unit = qrand() % unitCount;
+        text += QString("Oct 19 12:%1:%2 Sailfish %3[%4]: %5\n")
+                .arg(qrand() % 60, 2, 10, QChar('0')).arg(qrand() % 60, 2, 10, QChar('0'))
+                .arg(units[unit]).arg(100 + unit * 37)
+                .arg(QString::fromLatin1(phrase.trimmed()))
+                .toLatin1();
+    }
+    return text;
+}
+
+QByteArray packageList()
+{
+    QByteArray text;
+    for (int i = 0; i < 300; ++i) {
+        text += QString("package-%1 1.%2.%3-1\n").arg(i).arg(i % 7).arg(i % 13).toLatin1();
+    }
+    return text;
+}
+
+QByteArray section(const QByteArray &name, const QByteArray &data)
+{
+    return "\n[---rich-core: " + name + "---]\n" + data;
+}
+
+Sections readSections(const QString &filePath)
+{
+    Sections sections;
+    CReporterRichCoreReader reader(filePath);
+    while (reader.nextSection()) {
+        sections.insert(reader.sectionName(), reader.readSection());
+    }
+    return sections;
+}
+
+}
+
+void Ut_CReporterSectionEncoder::initTestCase()
+{
+    qsrand(1);
+
+    QList<QByteArray> samples;
+    for (int i = 0; i < 400; ++i) {
+        samples << journal(10 + qrand() % 30);
+    }
+    samples << packageList();
+
+    dictionary = CReporterSectionEncoder::trainDictionary(samples, DICTIONARY_SIZE);
+    QVERIFY(!dictionary.isEmpty());
+    QVERIFY(dictionary.size() <= DICTIONARY_SIZE);
+}
+
+void Ut_CReporterSectionEncoder::init()
+{
+    tempDir = new QTemporaryDir;
+    QVERIFY(tempDir->isValid());
+    QDir().mkpath(tempDir->path() + "/dictionaries");
+}
+
+void Ut_CReporterSectionEncoder::cleanup()
+{
+    delete tempDir;
+    tempDir = 0;
+}
+
+QString Ut_CReporterSectionEncoder::writeDictionary(const QString &fileName, int seed)
+{
+    QByteArray data = dictionary;
+    if (seed) {
+        // Different id, the contents don't matter.
+        QList<QByteArray> samples;
+        qsrand(seed);
+        for (int i = 0; i < 400; ++i) {
+            samples << journal(30);
+        }
+        data = CReporterSectionEncoder::trainDictionary(samples, DICTIONARY_SIZE);
+    }
+
+    QString dir = tempDir->path() + "/dictionaries";
+    QFile file(dir + '/' + fileName);
+    file.open(QIODevice::WriteOnly);
+    file.write(data);
+    return dir;
+}
+
+QString Ut_CReporterSectionEncoder::writeReport(const QByteArray &content)
+{
+    QString filePath = tempDir->path() + "/JournalSpy-ofono-1234-0-5678.rcore.lzo";
+    QFile file(filePath);
+    file.open(QIODevice::WriteOnly);
+    file.write(CReporterLzoWriter::compress(content));
+    return filePath;
+}
+
+void Ut_CReporterSectionEncoder::testEncodeDecode()
+{
+    CReporterSectionEncoder encoder(writeDictionary("sections.dict", 0));
+    QVERIFY(encoder.dictionaryId() != 0);
+
+    QByteArray data = journal(50);
+    QByteArray frame = encoder.encode(data);
+    QVERIFY(!frame.isEmpty());
+    QVERIFY(frame.size() * 4 < data.size());
+    QCOMPARE(CReporterSectionEncoder::dictionaryIdOf(frame), encoder.dictionaryId());
+
+    QCOMPARE(encoder.decode(frame), data);
+    QVERIFY(encoder.decode(frame.left(frame.size() / 2)).isEmpty());
+}
+
+void Ut_CReporterSectionEncoder::testMissingDictionary()
+{
+    CReporterSectionEncoder encoder(writeDictionary("sections.dict", 0));
+    QByteArray frame = encoder.encode(journal(10));
+
+    CReporterSectionEncoder empty(tempDir->path());
+    QCOMPARE(empty.dictionaryId(), quint32(0));
+    QVERIFY(empty.encode(journal(10)).isEmpty());
+    QVERIFY(empty.decode(frame).isEmpty());
+}
+
+void Ut_CReporterSectionEncoder::testLatestDictionary()
+{
+    CReporterSectionEncoder older(writeDictionary("sections-20150101.dict", 0));
+    QByteArray frame = older.encode(journal(10));
+
+    CReporterSectionEncoder encoder(writeDictionary("sections-20151001.dict", 2));
+    QVERIFY(encoder.dictionaryId() != older.dictionaryId());
+
+    // Old reports can still be decoded.
+    QVERIFY(!encoder.decode(frame).isEmpty());
+    QCOMPARE(CReporterSectionEncoder::dictionaryIdOf(encoder.encode(journal(10))),
+             encoder.dictionaryId());
+}
+
+void Ut_CReporterSectionEncoder::testIsEncodable_data()
+{
+    QTest::addColumn<QString>("name");
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<bool>("encodable");
+
+    QByteArray text = journal(5);
+
+    QTest::newRow("journal") << "journal" << text << true;
+    QTest::newRow("name only") << "packagelist" << QByteArray() << true;
+    QTest::newRow("too short") << "journal" << QByteArray("x\n") << false;
+    QTest::newRow("binary") << "journal" << text + '\0' << false;
+    QTest::newRow("coredump") << "coredump" << QByteArray() << false;
+    QTest::newRow("stack trace") << "stack-trace" << text << false;
+    QTest::newRow("cmdline") << "/proc/100/cmdline" << QByteArray() << false;
+    QTest::newRow("encoded") << "journal.zst" << QByteArray() << false;
+}
+
+void Ut_CReporterSectionEncoder::testIsEncodable()
+{
+    QFETCH(QString, name);
+    QFETCH(QByteArray, data);
+    QFETCH(bool, encodable);
+
+    QCOMPARE(CReporterSectionEncoder::isEncodable(name, data), encodable);
+}
+
+void Ut_CReporterSectionEncoder::testRawDictionary()
+{
+    QString dir = tempDir->path() + "/dictionaries";
+    QFile file(dir + "/sections-7.dict");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(journal(200));
+    file.close();
+
+    CReporterSectionEncoder encoder(dir);
+    QCOMPARE(encoder.dictionaryId(), quint32(7));
+
+    QByteArray data = journal(20);
+    QByteArray frame = encoder.encode(data);
+    QVERIFY(!frame.isEmpty());
+    QCOMPARE(CReporterSectionEncoder::dictionaryIdOf(frame), quint32(0));
+    QCOMPARE(encoder.decode(frame, 7), data);
+
+    // Raw content without id in the name is ignored.
+    QVERIFY(QFile::rename(file.fileName(), dir + "/sections.dict"));
+    QCOMPARE(CReporterSectionEncoder(dir).dictionaryId(), quint32(0));
+}
+
+void Ut_CReporterSectionEncoder::testInstalledDictionary()
+{
+    CReporterSectionEncoder encoder;
+    QVERIFY(encoder.dictionaryId() != 0);
+
+    QFile status("/proc/self/status");
+    QVERIFY(status.open(QIODevice::ReadOnly));
+    QByteArray data = status.readAll();
+
+    QByteArray frame = encoder.encode(data);
+    QVERIFY(!frame.isEmpty());
+    QCOMPARE(encoder.decode(frame, encoder.dictionaryId()), data);
+}
+
+void Ut_CReporterSectionEncoder::testEncodeReport()
+{
+    CReporterSectionEncoder encoder(writeDictionary("sections.dict", 0));
+
+    QByteArray journalText = journal(100);
+    QByteArray packages = packageList();
+    QByteArray cmdline("/usr/sbin/ofonod\0-n\0", 20);
+    QString filePath = writeReport(
+        section("date", "Mon Oct 19 12:00:00 UTC 2015\n") +
+        section("/proc/100/cmdline", cmdline) +
+        section("journal", journalText) +
+        section("packagelist", packages));
+    QByteArray original = readFile(filePath);
+
+    QByteArray encoded = encoder.encodeReport(filePath);
+    QVERIFY(!encoded.isEmpty());
+
+    // Report on the device is left as it is.
+    QCOMPARE(readFile(filePath), original);
+
+    Sections sections = readSections(writeEncodedReport(encoded));
+    QCOMPARE(sections.keys(), QStringList() << "/proc/100/cmdline" << "date"
+             << "journal.zst" << "packagelist.zst");
+    QCOMPARE(sections.value("date"), QByteArray("Mon Oct 19 12:00:00 UTC 2015\n"));
+    QCOMPARE(sections.value("/proc/100/cmdline"), cmdline);
+    QCOMPARE(encoder.decode(sections.value("journal.zst")), journalText);
+    QCOMPARE(encoder.decode(sections.value("packagelist.zst")), packages);
+}
+
+void Ut_CReporterSectionEncoder::testSmallReport()
+{
+    CReporterSectionEncoder encoder(writeDictionary("sections.dict", 0));
+
+    QString filePath = writeReport(
+        section("date", "Mon Oct 19 12:00:00 UTC 2015\n") +
+        section("journal", journal(30)));
+    qint64 originalSize = QFileInfo(filePath).size();
+
+    // Short text compresses poorly on its own, the dictionary helps.
+    qint64 encodedSize = encoder.encodeReport(filePath).size();
+    QVERIFY(encodedSize > 0);
+    QVERIFY2(encodedSize * 2 < originalSize,
+             qPrintable(QString("%1 -> %2").arg(originalSize).arg(encodedSize)));
+}
+
+void Ut_CReporterSectionEncoder::testEncodeReportTwice()
+{
+    CReporterSectionEncoder encoder(writeDictionary("sections.dict", 0));
+    QString filePath = writeReport(section("journal", journal(100)));
+
+    QByteArray encoded = encoder.encodeReport(filePath);
+    QVERIFY(!encoded.isEmpty());
+
+    // Nothing is left to encode.
+    QVERIFY(encoder.encodeReport(writeEncodedReport(encoded)).isEmpty());
+}
+
+QString Ut_CReporterSectionEncoder::writeEncodedReport(const QByteArray &report)
+{
+    QString filePath = tempDir->path() + "/JournalSpy-ofono-1234-0-5679.rcore.lzo";
+    QFile file(filePath);
+    file.open(QIODevice::WriteOnly);
+    file.write(report);
+    return filePath;
+}
+
+QByteArray Ut_CReporterSectionEncoder::readFile(const QString &filePath)
+{
+    QFile file(filePath);
+    file.open(QIODevice::ReadOnly);
+    return file.readAll();
+}
+
+QTEST_MAIN(Ut_CReporterSectionEncoder)
@@ -0,0 +1,57 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef UT_CREPORTERSECTIONENCODER_H
+#define UT_CREPORTERSECTIONENCODER_H
+
+#include <QTest>
+#include <QTemporaryDir>
+
+class Ut_CReporterSectionEncoder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void testEncodeDecode();
+    void testMissingDictionary();
+    void testLatestDictionary();
+    void testIsEncodable_data();
+    void testIsEncodable();
+    void testRawDictionary();
+    void testInstalledDictionary();
+    void testEncodeReport();
+    void testSmallReport();
+    void testEncodeReportTwice();
+
+private:
+    QString writeDictionary(const QString &fileName, int seed);
+    QString writeReport(const QByteArray &content);
+    QString writeEncodedReport(const QByteArray &report);
+    QByteArray readFile(const QString &filePath);
+
+    QByteArray dictionary;
+    QTemporaryDir *tempDir;
+};
+
+#endif // UT_CREPORTERSECTIONENCODER_H
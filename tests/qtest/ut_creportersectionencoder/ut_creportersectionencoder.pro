@@ -0,0 +1,26 @@
+include(../ut_common_top.pri)
+
+TARGET = ut_creportersectionencoder
+
+LIBS += ../../../lib/libcrashreporter.so
+
+CONFIG += link_pkgconfig
+PKGCONFIG += lzo2 libzstd
+
+INCLUDEPATH += . \
+               $${CREPORTER_SRC_DIR}/libs/richcore \
+               $${CREPORTER_SRC_DIR}/libs/utils \
+               $${CREPORTER_SRC_DIR}/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/richcore/creportersectionencoder.cpp \
+
+HEADERS += $${CREPORTER_SRC_DIR}/libs/richcore/creportersectionencoder.h \
+           ut_creportersectionencoder.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_creportersectionencoder.cpp \
+
+include(../ut_coverage.pri)
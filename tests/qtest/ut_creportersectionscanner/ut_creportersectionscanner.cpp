@@ -0,0 +1,143 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QElapsedTimer>
+
+#include "ut_creportersectionscanner.h"
+#include "creportersectionscanner.h"
+
+namespace {
+
+const QByteArray SECTION_MARKER("\n[---rich-core: ");
+
+//! Text resembling the contents of rich core sections.
+QByteArray sectionLikeData(int size)
+{
+    const char alphabet[] = "abc \n[-=()0x";
+
+    QByteArray data(size, Qt::Uninitialized);
+    qsrand(1);
+    for (int i = 0; i < size; ++i) {
+        // Every fourth byte is binary as in core dumps.
+        data[i] = (qrand() % 4 == 0) ? char(qrand())
+                                     : alphabet[qrand() % (sizeof(alphabet) - 1)];
+    }
+    return data;
+}
+
+}
+
+void Ut_CReporterSectionScanner::testIndexOf_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QByteArray>("needle");
+    QTest::addColumn<int>("from");
+
+    QTest::newRow("empty data") << QByteArray() << SECTION_MARKER << 0;
+    QTest::newRow("empty needle") << QByteArray("abc") << QByteArray() << 1;
+    QTest::newRow("single byte") << QByteArray("abc\ndef") << QByteArray("\n") << 0;
+    QTest::newRow("two bytes") << QByteArray("abc---]def") << QByteArray("-]") << 0;
+    QTest::newRow("at start") << SECTION_MARKER + "date---]\n" << SECTION_MARKER << 0;
+    QTest::newRow("at end") << QByteArray(100, 'x') + SECTION_MARKER << SECTION_MARKER << 0;
+    QTest::newRow("partial") << QByteArray(40, 'x') + "\n[---rich-core:" << SECTION_MARKER << 0;
+    QTest::newRow("first and last match")
+            << QByteArray(40, 'x') + "\n[---rich-xore: " + SECTION_MARKER
+            << SECTION_MARKER << 0;
+    QTest::newRow("after from") << SECTION_MARKER + "x" + SECTION_MARKER << SECTION_MARKER << 1;
+    QTest::newRow("negative from") << SECTION_MARKER + "x" + SECTION_MARKER << SECTION_MARKER << -16;
+    QTest::newRow("from beyond end") << SECTION_MARKER << SECTION_MARKER << 17;
+    QTest::newRow("header end") << QByteArray("stack-trace---]\n#0") << QByteArray("---]\n") << 0;
+}
+
+void Ut_CReporterSectionScanner::testIndexOf()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QByteArray, needle);
+    QFETCH(int, from);
+
+    QCOMPARE(CReporterSectionScanner::indexOf(data, needle, from),
+             data.indexOf(needle, from));
+}
+
+void Ut_CReporterSectionScanner::testBlockBoundaries()
+{
+    // Matches straddling 16 and 32 byte blocks and the scalar tail.
+    for (int size = SECTION_MARKER.size(); size < 100; ++size) {
+        for (int pos = 0; pos + SECTION_MARKER.size() <= size; ++pos) {
+            QByteArray data(size, '\n');
+            data.replace(pos, SECTION_MARKER.size(), SECTION_MARKER);
+            QCOMPARE(CReporterSectionScanner::indexOf(data, SECTION_MARKER), pos);
+
+            data[pos + SECTION_MARKER.size() - 1] = 'x';
+            QCOMPARE(CReporterSectionScanner::indexOf(data, SECTION_MARKER), -1);
+        }
+    }
+}
+
+void Ut_CReporterSectionScanner::testRandomData()
+{
+    QByteArray data = sectionLikeData(1024 * 1024);
+    for (int i = 1; i < 64; ++i) {
+        data.replace(i * 16384 + i, SECTION_MARKER.size(), SECTION_MARKER);
+    }
+
+    QList<QByteArray> needles;
+    needles << SECTION_MARKER << "---]\n" << "\n[" << "x\n" << "abc";
+
+    foreach (const QByteArray &needle, needles) {
+        int expected = -1;
+        do {
+            int from = expected + 1;
+            expected = data.indexOf(needle, from);
+            QCOMPARE(CReporterSectionScanner::indexOf(data, needle, from), expected);
+        } while (expected >= 0);
+    }
+}
+
+void Ut_CReporterSectionScanner::benchmarkScan_data()
+{
+    QTest::addColumn<bool>("scanner");
+
+    QTest::newRow("section scanner") << true;
+    QTest::newRow("QByteArray::indexOf") << false;
+}
+
+void Ut_CReporterSectionScanner::benchmarkScan()
+{
+    QFETCH(bool, scanner);
+
+    const int size = 64 * 1024 * 1024;
+    const int rounds = 8;
+    QByteArray data = sectionLikeData(size - SECTION_MARKER.size()) + SECTION_MARKER;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < rounds; ++i) {
+        int pos = scanner ? CReporterSectionScanner::indexOf(data, SECTION_MARKER)
+                          : data.indexOf(SECTION_MARKER);
+        QCOMPARE(pos, size - SECTION_MARKER.size());
+    }
+
+    qreal seconds = qMax<qint64>(timer.nsecsElapsed(), 1) / 1e9;
+    qreal bytesPerSecond = qreal(size) * rounds / seconds;
+    QTest::setBenchmarkResult(bytesPerSecond, QTest::BytesPerSecond);
+}
+
+QTEST_MAIN(Ut_CReporterSectionScanner)
@@ -0,0 +1,22 @@
+include(../ut_common_top.pri)
+
+TARGET = ut_creportersectionscanner
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $${CREPORTER_SRC_DIR}/libs/richcore \
+               $${CREPORTER_SRC_DIR}/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/richcore/creportersectionscanner.cpp \
+
+HEADERS += $${CREPORTER_SRC_DIR}/libs/richcore/creportersectionscanner.h \
+           ut_creportersectionscanner.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_creportersectionscanner.cpp \
+
+include(../ut_coverage.pri)
@@ -0,0 +1,244 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include <lzma.h>
+
+#include "ut_creportersnapshotdelta.h"
+#include "creporterendurancepacker.h"
+#include "creporterlzowriter.h"
+#include "creporterrichcorereader.h"
+#include "creportersnapshotdelta.h"
+
+namespace {
+
+QByteArray unxz(const QByteArray &data)
+{
+    lzma_stream xz = LZMA_STREAM_INIT;
+    if (lzma_stream_decoder(&xz, UINT64_MAX, 0) != LZMA_OK) {
+        return QByteArray();
+    }
+
+    QByteArray result;
+    QByteArray buffer(64 * 1024, Qt::Uninitialized);
+    xz.next_in = reinterpret_cast<const uint8_t *>(data.constData());
+    xz.avail_in = data.size();
+
+    lzma_ret ret;
+    do {
+        xz.next_out = reinterpret_cast<uint8_t *>(buffer.data());
+        xz.avail_out = buffer.size();
+        ret = lzma_code(&xz, LZMA_FINISH);
+        result.append(buffer.constData(), buffer.size() - xz.avail_out);
+    } while (ret == LZMA_OK);
+
+    lzma_end(&xz);
+    return (ret == LZMA_STREAM_END) ? result : QByteArray();
+}
+
+QStringList sectionNames(const QString &reportPath)
+{
+    QStringList names;
+    CReporterRichCoreReader reader(reportPath);
+    while (reader.nextSection()) {
+        names << reader.sectionName();
+    }
+    return names;
+}
+
+QByteArray section(const QString &reportPath, const QString &name)
+{
+    CReporterRichCoreReader reader(reportPath);
+    if (!reader.seekSection(name)) {
+        return QByteArray();
+    }
+    return reader.readSection();
+}
+
+QByteArray meminfo(int index)
+{
+    QByteArray text;
+    for (int i = 0; i < 2000; ++i) {
+        text += QString("Line%1: %2 kB\n").arg(i).arg(i % 10 == 0 ? i + index : i).toUtf8();
+    }
+    return text;
+}
+
+bool writeFile(const QString &filePath, const QByteArray &data)
+{
+    QFile file(filePath);
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+QString createSnapshot(const QString &dir, int index)
+{
+    QString path = QString("%1/%2").arg(dir).arg(index, 3, 10, QChar('0'));
+    QDir().mkpath(path + "/proc");
+    writeFile(path + "/proc/meminfo", meminfo(index));
+    writeFile(path + "/smaps.cap.lzo", CReporterLzoWriter::compress(meminfo(index * 2)));
+    return path;
+}
+
+}
+
+void Ut_CReporterSnapshotDelta::init()
+{
+    tempDir = new QTemporaryDir;
+    QVERIFY(tempDir->isValid());
+}
+
+void Ut_CReporterSnapshotDelta::cleanup()
+{
+    delete tempDir;
+    tempDir = 0;
+}
+
+void Ut_CReporterSnapshotDelta::testRoundTrip_data()
+{
+    QTest::addColumn<QByteArray>("base");
+    QTest::addColumn<QByteArray>("data");
+
+    QTest::newRow("empty") << QByteArray() << QByteArray();
+    QTest::newRow("empty base") << QByteArray() << QByteArray("a\nb\n");
+    QTest::newRow("empty data") << QByteArray("a\nb\n") << QByteArray();
+    QTest::newRow("changed line") << QByteArray("a\nb\nc\n") << QByteArray("a\nx\nc\n");
+    QTest::newRow("removed lines") << QByteArray("a\nb\nc\nd\n") << QByteArray("a\nd\n");
+    QTest::newRow("added lines") << QByteArray("a\nd\n") << QByteArray("a\nb\nc\nd\n");
+    QTest::newRow("no final newline") << QByteArray("a\nb") << QByteArray("a\nb\nc");
+    QTest::newRow("final newline added") << QByteArray("a\nb") << QByteArray("a\nb\n");
+    QTest::newRow("repeated lines") << QByteArray("x\nx\ny\nx\nx\n")
+                                    << QByteArray("x\ny\nx\nx\nx\ny\n");
+    QTest::newRow("snapshots") << meminfo(0) << meminfo(1);
+}
+
+void Ut_CReporterSnapshotDelta::testRoundTrip()
+{
+    QFETCH(QByteArray, base);
+    QFETCH(QByteArray, data);
+
+    QByteArray decoded("garbage");
+    QVERIFY(CReporterSnapshotDelta::decode(base, CReporterSnapshotDelta::encode(base, data),
+                                           &decoded));
+    QCOMPARE(decoded, data);
+}
+
+void Ut_CReporterSnapshotDelta::testUnchangedFile()
+{
+    QByteArray data(meminfo(0));
+    QByteArray delta(CReporterSnapshotDelta::encode(data, data));
+    QVERIFY(delta.size() < 32);
+
+    // Only every tenth line changes.
+    delta = CReporterSnapshotDelta::encode(data, meminfo(1));
+    QVERIFY(delta.size() < data.size() / 5);
+}
+
+void Ut_CReporterSnapshotDelta::testBrokenDelta_data()
+{
+    QTest::addColumn<QByteArray>("delta");
+
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("no magic") << QByteArray("=1\n");
+    QTest::newRow("unknown operation") << QByteArray("snapshot-delta 1\n?1\n");
+    QTest::newRow("bad count") << QByteArray("snapshot-delta 1\n=x\n");
+    QTest::newRow("negative count") << QByteArray("snapshot-delta 1\n=-1\n");
+    QTest::newRow("copy past base") << QByteArray("snapshot-delta 1\n=3\n");
+    QTest::newRow("skip past base") << QByteArray("snapshot-delta 1\n-3\n");
+    QTest::newRow("missing lines") << QByteArray("snapshot-delta 1\n+2\nx\n");
+    QTest::newRow("truncated") << QByteArray("snapshot-delta 1\n=1");
+}
+
+void Ut_CReporterSnapshotDelta::testBrokenDelta()
+{
+    QFETCH(QByteArray, delta);
+
+    QByteArray data;
+    QVERIFY(!CReporterSnapshotDelta::decode("a\nb\n", delta, &data));
+}
+
+void Ut_CReporterSnapshotDelta::testDecodeReport()
+{
+    QString snapshots = tempDir->path() + "/endurance";
+    QStringList dirs;
+    for (int i = 0; i < 4; ++i) {
+        dirs << createSnapshot(snapshots, i);
+    }
+
+    CReporterEndurancePacker packer;
+    packer.setDeviceUid("1234567890");
+    packer.setBootTime("1444000000");
+
+    QString plainReport = tempDir->path() + "/Plain.rcore.lzo";
+    QVERIFY(packer.pack(dirs, plainReport));
+
+    QString deltaReport = tempDir->path() + "/Delta.rcore.lzo";
+    packer.setDeltaEncoding(true);
+    QVERIFY(packer.pack(dirs, deltaReport));
+    QVERIFY(QFileInfo(deltaReport).size() < QFileInfo(plainReport).size());
+
+    QString decodedReport = tempDir->path() + "/Decoded.rcore.lzo";
+    QString error;
+    QVERIFY2(CReporterSnapshotDelta::decodeReport(deltaReport, decodedReport, &error),
+             qPrintable(error));
+    QVERIFY(!QFile::exists(decodedReport + ".tmp"));
+
+    QCOMPARE(sectionNames(decodedReport), sectionNames(plainReport));
+    QCOMPARE(section(decodedReport, "device-uid"), QByteArray("1234567890\n"));
+
+    // The restored archive is identical to the one packed without deltas.
+    QByteArray tar = unxz(section(plainReport, CReporterEndurancePacker::SnapshotPackSection));
+    QVERIFY(!tar.isEmpty());
+    QCOMPARE(unxz(section(decodedReport, CReporterEndurancePacker::SnapshotPackSection)), tar);
+}
+
+void Ut_CReporterSnapshotDelta::testDecodePlainReport()
+{
+    QString report = tempDir->path() + "/Plain.rcore.lzo";
+    CReporterEndurancePacker packer;
+    QVERIFY(packer.pack(QStringList() << createSnapshot(tempDir->path(), 0), report));
+
+    QString decodedReport = tempDir->path() + "/Decoded.rcore.lzo";
+    QVERIFY(CReporterSnapshotDelta::decodeReport(report, decodedReport));
+
+    QCOMPARE(sectionNames(decodedReport), sectionNames(report));
+    QCOMPARE(section(decodedReport, CReporterEndurancePacker::SnapshotPackSection),
+             section(report, CReporterEndurancePacker::SnapshotPackSection));
+}
+
+void Ut_CReporterSnapshotDelta::testDecodeBrokenReport()
+{
+    QString report = tempDir->path() + "/Delta.rcore.lzo";
+    QByteArray data("\n[---rich-core: ");
+    data += CReporterSnapshotDelta::DeltaPackSection;
+    data += "---]\nnot xz data";
+    QVERIFY(writeFile(report, CReporterLzoWriter::compress(data)));
+
+    QString decodedReport = tempDir->path() + "/Decoded.rcore.lzo";
+    QString error;
+    QVERIFY(!CReporterSnapshotDelta::decodeReport(report, decodedReport, &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!QFile::exists(decodedReport));
+    QVERIFY(!QFile::exists(decodedReport + ".tmp"));
+}
+
+QTEST_MAIN(Ut_CReporterSnapshotDelta)
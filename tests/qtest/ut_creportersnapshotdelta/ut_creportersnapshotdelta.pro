@@ -0,0 +1,29 @@
+include(../ut_common_top.pri)
+
+TARGET = ut_creportersnapshotdelta
+
+LIBS += ../../../lib/libcrashreporter.so
+
+CONFIG += link_pkgconfig
+PKGCONFIG += liblzma
+
+INCLUDEPATH += . \
+               $${CREPORTER_SRC_DIR}/libs/endurance \
+               $${CREPORTER_SRC_DIR}/libs/richcore \
+               $${CREPORTER_SRC_DIR}/libs/utils \
+               $${CREPORTER_SRC_DIR}/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/endurance/creportersnapshotdelta.cpp \
+                $${CREPORTER_SRC_DIR}/libs/endurance/creportertararchive.cpp \
+
+HEADERS += $${CREPORTER_SRC_DIR}/libs/endurance/creportersnapshotdelta.h \
+           $${CREPORTER_SRC_DIR}/libs/endurance/creportertararchive_p.h \
+           ut_creportersnapshotdelta.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_creportersnapshotdelta.cpp \
+
+include(../ut_coverage.pri)
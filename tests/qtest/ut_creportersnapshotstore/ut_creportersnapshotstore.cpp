@@ -0,0 +1,312 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QFile>
+#include <QtEndian>
+
+#include <unistd.h>
+
+#include "ut_creportersnapshotstore.h"
+#include "creporterchecksum.h"
+#include "creportersnapshotstore.h"
+#include "creportersnapshotstore_p.h"
+#include "snapshot.h"
+
+namespace {
+
+struct Process
+{
+    quint32 pid;
+    const char *name;
+    char state;
+    quint16 threads;
+    quint32 vmSizeKb;
+    quint32 vmRssKb;
+    quint16 fds;
+};
+
+const Process Processes[] = {
+    { 1, "systemd", 'S', 1, 9000, 4000, 60 },
+    { 427, "lipstick", 'S', 21, 250000, 80000, 130 },
+    { 1202, "kworker/0:1", 'I', 1, 0, 0, SNAPSHOT_STORE_FDS_UNKNOWN },
+};
+const int ProcessCount = sizeof(Processes) / sizeof(Processes[0]);
+
+void appendU16(QByteArray *data, quint16 value)
+{
+    uchar bytes[2];
+    qToLittleEndian(value, bytes);
+    data->append(reinterpret_cast<const char *>(bytes), sizeof bytes);
+}
+
+void appendU32(QByteArray *data, quint32 value)
+{
+    uchar bytes[4];
+    qToLittleEndian(value, bytes);
+    data->append(reinterpret_cast<const char *>(bytes), sizeof bytes);
+}
+
+void pad(QByteArray *data)
+{
+    while (data->size() % 4) {
+        data->append('\0');
+    }
+}
+
+// Encodes segment the way endurance-collect-daemon does.
+QByteArray segment(quint32 number, quint32 time, const Process *processes, int count)
+{
+    QByteArray names;
+    for (int i = 0; i < count; ++i) {
+        names += processes[i].name;
+        names += '\0';
+    }
+
+    QByteArray data;
+    appendU32(&data, SNAPSHOT_STORE_MAGIC);
+    appendU32(&data, 0);
+    appendU32(&data, number);
+    appendU32(&data, 3600 + number);
+    appendU32(&data, time);
+    appendU32(&data, count);
+    appendU32(&data, names.size());
+    for (int i = 0; i < count; ++i) {
+        appendU32(&data, processes[i].pid);
+    }
+    for (int i = 0; i < count; ++i) {
+        appendU32(&data, processes[i].vmRssKb);
+    }
+    for (int i = 0; i < count; ++i) {
+        appendU32(&data, processes[i].vmSizeKb);
+    }
+    for (int i = 0; i < count; ++i) {
+        appendU16(&data, processes[i].threads);
+    }
+    for (int i = 0; i < count; ++i) {
+        appendU16(&data, processes[i].fds);
+    }
+    for (int i = 0; i < count; ++i) {
+        data += processes[i].state;
+    }
+    pad(&data);
+    data += names;
+    pad(&data);
+
+    qToLittleEndian<quint32>(data.size() + 4,
+                             reinterpret_cast<uchar *>(data.data()) + SNAPSHOT_STORE_SIZE);
+    appendU32(&data, CReporterChecksum::adler32(1, data.constData(), data.size()));
+    return data;
+}
+
+QByteArray segment(quint32 number)
+{
+    return segment(number, 1444000000 + number * 3600, Processes, ProcessCount);
+}
+
+bool writeFile(const QString &filePath, const QByteArray &data)
+{
+    QFile file(filePath);
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+}
+
+void Ut_CReporterSnapshotStore::init()
+{
+    tempDir = new QTemporaryDir;
+    QVERIFY(tempDir->isValid());
+}
+
+void Ut_CReporterSnapshotStore::cleanup()
+{
+    delete tempDir;
+    tempDir = 0;
+}
+
+void Ut_CReporterSnapshotStore::testRead()
+{
+    QString path = tempDir->path() + "/" + CReporterSnapshotStore::FileName;
+    QVERIFY(writeFile(path, segment(0) + segment(1) + segment(2)));
+
+    CReporterSnapshotStore store;
+    QVERIFY(store.open(path));
+    QCOMPARE(store.segmentCount(), 3);
+
+    for (int i = 0; i < 3; ++i) {
+        QCOMPARE(store.snapshotNumber(i), i);
+        QCOMPARE(store.uptime(i), quint32(3600 + i));
+        QCOMPARE(store.time(i), quint32(1444000000 + i * 3600));
+        QCOMPARE(store.processCount(i), ProcessCount);
+    }
+
+    QCOMPARE(store.value(1, CReporterSnapshotStore::Pid, 1), qint64(427));
+    QCOMPARE(store.value(1, CReporterSnapshotStore::VmRssKb, 1), qint64(80000));
+    QCOMPARE(store.value(1, CReporterSnapshotStore::VmSizeKb, 1), qint64(250000));
+    QCOMPARE(store.value(1, CReporterSnapshotStore::Threads, 1), qint64(21));
+    QCOMPARE(store.value(1, CReporterSnapshotStore::Fds, 1), qint64(130));
+    QCOMPARE(store.state(1, 1), 'S');
+    QCOMPARE(store.name(1, 1), QByteArray("lipstick"));
+    QCOMPARE(store.name(2, 2), QByteArray("kworker/0:1"));
+}
+
+void Ut_CReporterSnapshotStore::testExport()
+{
+    CReporterSnapshotStore store;
+    store.setData(segment(5));
+    QCOMPARE(store.segmentCount(), 1);
+    QCOMPARE(store.snapshotNumber(0), 5);
+
+    // Same as processes.csv written by the collection script.
+    QCOMPARE(store.exportProcesses(0),
+             QByteArray("pid,name,state,threads,vm_size_kb,vm_rss_kb,fds\n"
+                        "1,\"systemd\",S,1,9000,4000,60\n"
+                        "427,\"lipstick\",S,21,250000,80000,130\n"
+                        "1202,\"kworker/0:1\",I,1,0,0,-1\n"));
+}
+
+void Ut_CReporterSnapshotStore::testUnknownFds()
+{
+    CReporterSnapshotStore store;
+    store.setData(segment(0));
+    QCOMPARE(store.value(0, CReporterSnapshotStore::Fds, 2), qint64(-1));
+    QCOMPARE(store.value(0, CReporterSnapshotStore::Fds, 0), qint64(60));
+}
+
+void Ut_CReporterSnapshotStore::testEmptyStore()
+{
+    QString path = tempDir->path() + "/empty.store";
+    QVERIFY(writeFile(path, QByteArray()));
+
+    CReporterSnapshotStore store;
+    QVERIFY(store.open(path));
+    QCOMPARE(store.segmentCount(), 0);
+
+    // Snapshot without any processes.
+    store.setData(segment(0, 1444000000, Processes, 0));
+    QCOMPARE(store.segmentCount(), 1);
+    QCOMPARE(store.processCount(0), 0);
+    QCOMPARE(store.exportProcesses(0), QByteArray(CReporterSnapshotStore::ProcessesHeader));
+}
+
+void Ut_CReporterSnapshotStore::testMissingFile()
+{
+    CReporterSnapshotStore store;
+    store.setData(segment(0));
+    QVERIFY(!store.open(tempDir->path() + "/missing.store"));
+    QCOMPARE(store.segmentCount(), 0);
+}
+
+void Ut_CReporterSnapshotStore::testTornTail_data()
+{
+    QTest::addColumn<int>("tailSize");
+
+    QTest::newRow("part of header") << 10;
+    QTest::newRow("header") << SNAPSHOT_STORE_HEADER_SIZE + 4;
+    QTest::newRow("without checksum") << segment(2).size() - 4;
+    QTest::newRow("one byte short") << segment(2).size() - 1;
+}
+
+void Ut_CReporterSnapshotStore::testTornTail()
+{
+    QFETCH(int, tailSize);
+
+    // Append of the third snapshot was interrupted.
+    QString path = tempDir->path() + "/" + CReporterSnapshotStore::FileName;
+    QVERIFY(writeFile(path, segment(0) + segment(1) + segment(2).left(tailSize)));
+
+    CReporterSnapshotStore store;
+    QVERIFY(store.open(path));
+    QCOMPARE(store.segmentCount(), 2);
+    QCOMPARE(store.snapshotNumber(1), 1);
+}
+
+void Ut_CReporterSnapshotStore::testBrokenSegment()
+{
+    QByteArray broken(segment(1));
+    broken[SNAPSHOT_STORE_HEADER_SIZE + 5] = broken.at(SNAPSHOT_STORE_HEADER_SIZE + 5) ^ 0x40;
+
+    CReporterSnapshotStore store;
+    store.setData(segment(0) + broken + segment(2));
+
+    // Checksum doesn't match, the segments around it are intact.
+    QCOMPARE(store.segmentCount(), 2);
+    QCOMPARE(store.snapshotNumber(0), 0);
+    QCOMPARE(store.snapshotNumber(1), 2);
+}
+
+void Ut_CReporterSnapshotStore::testCollector()
+{
+    struct snapshot_collector collector;
+    QCOMPARE(snapshot_collector_init(&collector), 0);
+
+    QByteArray dir(tempDir->path().toLocal8Bit());
+    QCOMPARE(snapshot_collector_collect(&collector, dir.constData()), 0);
+    QCOMPARE(snapshot_collector_collect(&collector, dir.constData()), 1);
+    snapshot_collector_cleanup(&collector);
+
+    CReporterSnapshotStore store;
+    QVERIFY(store.open(tempDir->path() + "/" + CReporterSnapshotStore::FileName));
+    QCOMPARE(store.segmentCount(), 2);
+    QCOMPARE(store.snapshotNumber(0), 0);
+    QCOMPARE(store.snapshotNumber(1), 1);
+    QVERIFY(store.uptime(1) > 0);
+    QVERIFY(store.time(1) >= store.time(0));
+
+    // The test itself is among the processes.
+    int self = -1;
+    for (int i = 0; i < store.processCount(1); ++i) {
+        if (store.value(1, CReporterSnapshotStore::Pid, i) == getpid()) {
+            self = i;
+        }
+    }
+    QVERIFY(self >= 0);
+    // The kernel truncates the names to 15 characters.
+    QVERIFY(!store.name(1, self).isEmpty());
+    QVERIFY(QByteArray("ut_creportersnapshotstore").startsWith(store.name(1, self)));
+    QVERIFY(store.value(1, CReporterSnapshotStore::VmRssKb, self) > 0);
+    QVERIFY(store.value(1, CReporterSnapshotStore::Threads, self) > 0);
+    QVERIFY(store.value(1, CReporterSnapshotStore::Fds, self) > 0);
+}
+
+void Ut_CReporterSnapshotStore::benchmarkExport()
+{
+    // Twelve snapshots of a device with some 300 processes.
+    QVector<Process> processes;
+    for (int i = 0; i < 300; ++i) {
+        Process process = Processes[i % ProcessCount];
+        process.pid = i + 1;
+        processes << process;
+    }
+
+    QByteArray data;
+    for (int i = 0; i < 12; ++i) {
+        data += segment(i, 1444000000 + i * 3600, processes.constData(), processes.size());
+    }
+
+    QBENCHMARK {
+        CReporterSnapshotStore store;
+        store.setData(data);
+        for (int i = 0; i < store.segmentCount(); ++i) {
+            store.exportProcesses(i);
+        }
+    }
+}
+
+QTEST_MAIN(Ut_CReporterSnapshotStore)
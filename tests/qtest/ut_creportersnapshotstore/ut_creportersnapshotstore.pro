@@ -0,0 +1,34 @@
+include(../ut_common_top.pri)
+
+ENDURANCE_SRC_DIR = $${CREPORTER_SRC_DIR}/endurancecollect
+
+TARGET = ut_creportersnapshotstore
+
+LIBS += ../../../lib/libcrashreporter.so
+
+CONFIG += link_pkgconfig
+PKGCONFIG += lzo2
+
+INCLUDEPATH += . \
+               $${ENDURANCE_SRC_DIR} \
+               $${CREPORTER_SRC_DIR}/libs/endurance \
+               $${CREPORTER_SRC_DIR}/libs/richcore \
+               $${CREPORTER_SRC_DIR}/libs/utils \
+               $${CREPORTER_SRC_DIR}/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+# The native collector writes the stores read in the test.
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/endurance/creportersnapshotstore.cpp \
+                $${ENDURANCE_SRC_DIR}/snapshot.c \
+
+HEADERS += $${CREPORTER_SRC_DIR}/libs/endurance/creportersnapshotstore.h \
+           $${CREPORTER_SRC_DIR}/libs/endurance/creportersnapshotstore_p.h \
+           $${ENDURANCE_SRC_DIR}/snapshot.h \
+           ut_creportersnapshotstore.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_creportersnapshotstore.cpp \
+
+include(../ut_coverage.pri)
@@ -0,0 +1,204 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDir>
+#include <QTemporaryFile>
+
+#include "ut_creporterstacksignature.h"
+#include "creporterstacksignature.h"
+
+void Ut_CReporterStackSignature::testNormalizeFrame_data()
+{
+    QTest::addColumn<QByteArray>("line");
+    QTest::addColumn<QByteArray>("frame");
+
+    QTest::newRow("address")
+            << QByteArray("#2  0x00008544 in crash (x=0) at main.cpp:12")
+            << QByteArray("crash");
+    QTest::newRow("no address")
+            << QByteArray("#0  main (argc=1, argv=0xbefff7b4) at main.cpp:30")
+            << QByteArray("main");
+    QTest::newRow("c++")
+            << QByteArray("#5  0x40a1b2c4 in QObject::event (this=0x1, e=0x2) at kernel/qobject.cpp:1200")
+            << QByteArray("QObject::event");
+    QTest::newRow("library")
+            << QByteArray("#1  0x4012abcd in abort () from /lib/libc.so.6")
+            << QByteArray("abort");
+    QTest::newRow("unknown function")
+            << QByteArray("#4  0x40001000 in ?? () from /usr/lib/libfoo.so.1.2.3")
+            << QByteArray("libfoo.so");
+    QTest::newRow("unknown module")
+            << QByteArray("#4  0x40001000 in ?? ()")
+            << QByteArray("??");
+    QTest::newRow("signal handler")
+            << QByteArray("#3  <signal handler called>")
+            << QByteArray("<signal handler called>");
+    QTest::newRow("not a frame")
+            << QByteArray("Thread 1 (LWP 2213):")
+            << QByteArray();
+    QTest::newRow("continuation")
+            << QByteArray("    at main.cpp:12")
+            << QByteArray();
+}
+
+void Ut_CReporterStackSignature::testNormalizeFrame()
+{
+    QFETCH(QByteArray, line);
+    QFETCH(QByteArray, frame);
+
+    QCOMPARE(CReporterStackSignature::normalizeFrame(line), frame);
+}
+
+void Ut_CReporterStackSignature::testSignatureSkipsSignalHandling()
+{
+    QByteArray trace(
+        "#0  0x4012a000 in __GI_raise (sig=6) at raise.c:56\n"
+        "#1  0x4012abcd in __GI_abort () at abort.c:89\n"
+        "#2  0x00008000 in crashHandler (sig=11) at handler.cpp:10\n"
+        "#3  <signal handler called>\n"
+        "#4  0x00008544 in crash (x=0) at main.cpp:12\n"
+        "#5  0x00008600 in run () at main.cpp:20\n"
+        "#6  0x00008700 in main () at main.cpp:30\n");
+
+    QCOMPARE(CReporterStackSignature::fromStackTrace(trace, 2),
+             QByteArray("crash\nrun"));
+    QCOMPARE(CReporterStackSignature::fromStackTrace(trace),
+             QByteArray("crash\nrun\nmain"));
+}
+
+void Ut_CReporterStackSignature::testSignatureIgnoresAddressesAndArguments()
+{
+    QByteArray first(
+        "#0  0x00008544 in crash (x=0) at main.cpp:12\n"
+        "#1  0x40001000 in ?? () from /usr/lib/libwrapper.so.1\n");
+    QByteArray second(
+        "#0  0x00019544 in crash (x=42) at main.cpp:14\n"
+        "#1  0x50002000 in ?? () from /usr/lib/libwrapper.so.2\n");
+
+    QCOMPARE(CReporterStackSignature::fromStackTrace(first),
+             CReporterStackSignature::fromStackTrace(second));
+}
+
+void Ut_CReporterStackSignature::testSignatureOfCrashedThread()
+{
+    // gdb prints the threads from the highest number down.
+    QByteArray trace(
+        "Thread 3 (LWP 2215):\n"
+        "#0  0x40120000 in poll () from /lib/libc.so.6\n"
+        "#1  0x40300000 in QEventDispatcherUNIX::processEvents () from /usr/lib/libQt5Core.so.5\n"
+        "\n"
+        "Thread 2 (LWP 2214):\n"
+        "#0  0x40121000 in __GI_raise (sig=11) at raise.c:56\n"
+        "#1  0x00008000 in crashHandler (sig=11) at handler.cpp:10\n"
+        "#2  <signal handler called>\n"
+        "#3  0x00008544 in crash (x=0) at main.cpp:12\n"
+        "#4  0x00008700 in worker () at main.cpp:30\n"
+        "\n"
+        "Thread 1 (LWP 2213):\n"
+        "#0  0x40120000 in poll () from /lib/libc.so.6\n"
+        "#1  0x00008800 in main () at main.cpp:40\n");
+
+    QCOMPARE(CReporterStackSignature::fromStackTrace(trace),
+             QByteArray("crash\nworker"));
+}
+
+void Ut_CReporterStackSignature::testSignatureOfThreadOne()
+{
+    // Without a signal handler frame, Thread 1 received the signal.
+    QByteArray trace(
+        "Thread 2 (LWP 2214):\n"
+        "#0  0x40120000 in poll () from /lib/libc.so.6\n"
+        "#1  0x00008700 in worker () at main.cpp:30\n"
+        "\n"
+        "Thread 1 (LWP 2213):\n"
+        "#0  0x00008544 in crash (x=0) at main.cpp:12\n"
+        "#1  0x00008800 in main () at main.cpp:40\n");
+
+    QCOMPARE(CReporterStackSignature::fromStackTrace(trace),
+             QByteArray("crash\nmain"));
+
+    // Unless gdb selected another one.
+    QCOMPARE(CReporterStackSignature::fromStackTrace(
+                 "[Current thread is 2 (LWP 2214)]\n" + trace),
+             QByteArray("poll\nworker"));
+}
+
+void Ut_CReporterStackSignature::testUnresolvedSignature()
+{
+    QByteArray trace(
+        "Thread 1 (LWP 2213):\n"
+        "#0  0x40001000 in ?? () from /lib/libc.so.6\n"
+        "#1  0x40002000 in ?? () from /usr/lib/libQt5Core.so.5\n"
+        "#2  0x00008800 in ?? ()\n");
+
+    QVERIFY(CReporterStackSignature::fromStackTrace(trace).isEmpty());
+
+    // One known function is enough.
+    QCOMPARE(CReporterStackSignature::fromStackTrace(
+                 trace + "#3  0x00008900 in main () at main.cpp:40\n"),
+             QByteArray("libc.so\nlibQt5Core.so\n??\nmain"));
+}
+
+void Ut_CReporterStackSignature::testEmptyTrace()
+{
+    QVERIFY(CReporterStackSignature::fromStackTrace(QByteArray()).isEmpty());
+    QVERIFY(CReporterStackSignature::fromStackTrace("No stack.\n").isEmpty());
+}
+
+void Ut_CReporterStackSignature::testRichCoreWithoutStackTrace()
+{
+    QVERIFY(CReporterStackSignature::fromRichCore(
+                "/usr/lib/crash-reporter-tests/testdata/crasher-0287-11-2213.rcore.lzo")
+            .isEmpty());
+}
+
+void Ut_CReporterStackSignature::testPlainRichCore()
+{
+    QTemporaryFile file(QDir::tempPath() + "/crasher-XXXXXX.rcore");
+    QVERIFY(file.open());
+    file.write("[---rich-core: date---]\nSat Jan  1 06:47:21 UTC 2000\n"
+               "\n[---rich-core: stack-trace---]\n"
+               "Thread 1 (LWP 2213):\n"
+               "#0  0x00008544 in crash (x=0) at main.cpp:12\n"
+               "#1  0x00008800 in main () at main.cpp:40\n"
+               "\n[---rich-core: coredump---]\n\x7f" "ELF");
+    file.close();
+
+    QCOMPARE(CReporterStackSignature::fromRichCore(file.fileName()),
+             QByteArray("crash\nmain"));
+}
+
+void Ut_CReporterStackSignature::testStackTraceAfterCoreDump()
+{
+    QTemporaryFile file(QDir::tempPath() + "/crasher-XXXXXX.rcore");
+    QVERIFY(file.open());
+    file.write("[---rich-core: date---]\nSat Jan  1 06:47:21 UTC 2000\n"
+               "\n[---rich-core: coredump---]\n\x7f" "ELF"
+               "\n[---rich-core: stack-trace---]\n"
+               "Thread 1 (LWP 2213):\n"
+               "#0  0x00008544 in crash (x=0) at main.cpp:12\n"
+               "#1  0x00008800 in main () at main.cpp:40\n");
+    file.close();
+
+    QCOMPARE(CReporterStackSignature::fromRichCore(file.fileName()),
+             QByteArray("crash\nmain"));
+}
+
+QTEST_MAIN(Ut_CReporterStackSignature)
@@ -0,0 +1,23 @@
+include(../ut_common_top.pri)
+
+TARGET = ut_creporterstacksignature
+
+LIBS += ../../../lib/libcrashreporter.so
+
+INCLUDEPATH += . \
+               $${CREPORTER_SRC_DIR}/libs/richcore \
+               $${CREPORTER_SRC_DIR}/libs/utils \
+               $${CREPORTER_SRC_DIR}/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+TEST_SOURCES += $${CREPORTER_SRC_DIR}/libs/richcore/creporterstacksignature.cpp \
+
+HEADERS += $${CREPORTER_SRC_DIR}/libs/richcore/creporterstacksignature.h \
+           ut_creporterstacksignature.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_creporterstacksignature.cpp \
+
+include(../ut_coverage.pri)
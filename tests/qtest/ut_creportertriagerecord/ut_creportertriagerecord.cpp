@@ -0,0 +1,175 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QBuffer>
+#include <QFile>
+#include <QMap>
+
+#include "ut_creportertriagerecord.h"
+#include "creporterlzoreader.h"
+#include "creporterlzowriter.h"
+#include "creporterrichcorereader.h"
+#include "creportertriagerecord.h"
+
+namespace {
+
+const QString CRASHER_CORE("/usr/lib/crash-reporter-tests/testdata/"
+                           "crasher-0287-11-2213.rcore.lzo");
+
+typedef QMap<QString, QByteArray> Sections;
+
+const char VIEWER_CORE[] =
+    "\n[---rich-core: date---]\nThu Jan  1 00:00:00 UTC 2015\n"
+    "\n[---rich-core: /proc/100/cmdline---]\n/usr/bin/viewer\0-f\0"
+    "\n[---rich-core: /proc/100/smaps---]\nsmaps\n"
+    "\n[---rich-core: packagelist---]\n"
+    "libviewer 1.0\nviewer 2.1-1\nviewer-data 2.1-1\n"
+    "\n[---rich-core: stack-trace---]\n"
+    "#0  0x4002a1b4 in render (x=1) at render.c:12\n"
+    "#1  0x4002a2b4 in main () at main.c:5\n"
+    "\n[---rich-core: coredump---]\n\x7f" "ELF";
+
+const char VIEWER_CORE_TRACE_LAST[] =
+    "\n[---rich-core: date---]\nThu Jan  1 00:00:00 UTC 2015\n"
+    "\n[---rich-core: /proc/100/cmdline---]\n/usr/bin/viewer\0-f\0"
+    "\n[---rich-core: coredump---]\n\x7f" "ELF"
+    "\n[---rich-core: packagelist---]\n"
+    "libviewer 1.0\nviewer 2.1-1\nviewer-data 2.1-1\n"
+    "\n[---rich-core: stack-trace---]\n"
+    "#0  0x4002a1b4 in render (x=1) at render.c:12\n"
+    "#1  0x4002a2b4 in main () at main.c:5\n";
+
+Sections readRecord(const QByteArray &record, QStringList *order = 0)
+{
+    QBuffer buffer;
+    buffer.setData(record);
+    CReporterLzoReader lzo(&buffer);
+    lzo.open(QIODevice::ReadOnly);
+
+    Sections sections;
+    CReporterRichCoreReader reader(&lzo);
+    while (reader.nextSection()) {
+        sections.insert(reader.sectionName(), reader.readSection());
+        if (order) {
+            *order << reader.sectionName();
+        }
+    }
+    return sections;
+}
+
+}
+
+void Ut_CReporterTriageRecord::init()
+{
+    tempDir = new QTemporaryDir;
+    QVERIFY(tempDir->isValid());
+}
+
+void Ut_CReporterTriageRecord::cleanup()
+{
+    delete tempDir;
+    tempDir = 0;
+}
+
+void Ut_CReporterTriageRecord::testContentHash()
+{
+    QCOMPARE(CReporterTriageRecord::contentHash(CRASHER_CORE),
+             QByteArray("c4715217f569e3b7cf59806bd3a4d5a4ca82400b"));
+}
+
+void Ut_CReporterTriageRecord::testCrasher()
+{
+    QByteArray record = CReporterTriageRecord::create(CRASHER_CORE);
+    QVERIFY(CReporterLzoReader::isLzoStream(record));
+    // Core dump alone is over 600 kB.
+    QVERIFY(record.size() < 16 * 1024);
+
+    QStringList order;
+    Sections sections = readRecord(record, &order);
+
+    QCOMPARE(order.first(), QString(CReporterTriageRecord::SectionName));
+    QCOMPARE(order, QStringList() << "triage" << "date"
+             << "/tmp/osso_software_version" << "/proc/component_version"
+             << "/proc/2213/cmdline" << "/tmp/osso-product-info");
+
+    QByteArray triage = sections.value("triage");
+    QVERIFY(triage.contains("report: crasher-0287-11-2213.rcore.lzo\n"));
+    QVERIFY(triage.contains("size: 194504\n"));
+    QVERIFY(triage.contains("sha1: c4715217f569e3b7cf59806bd3a4d5a4ca82400b\n"));
+    QVERIFY(triage.contains("application: crasher\n"));
+    QVERIFY(triage.contains("signal: 11 ("));
+    QVERIFY(triage.contains("pid: 2213\n"));
+    QVERIFY(!triage.contains("package:"));
+
+    QCOMPARE(sections.value("/proc/2213/cmdline"),
+             QByteArray("/usr/lib/crash-reporter-tests/crasher\0", 38));
+}
+
+void Ut_CReporterTriageRecord::testPackageAndSignature()
+{
+    QByteArray core(VIEWER_CORE, sizeof(VIEWER_CORE) - 1);
+
+    QString filePath = tempDir->path() + "/viewer-0287-6-100.rcore.lzo";
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(CReporterLzoWriter::compress(core));
+    file.close();
+
+    QStringList order;
+    Sections sections = readRecord(CReporterTriageRecord::create(filePath), &order);
+
+    QCOMPARE(order, QStringList() << "triage" << "date" << "/proc/100/cmdline"
+             << "stack-trace" << "stack-signature");
+
+    QByteArray triage = sections.value("triage");
+    QVERIFY(triage.contains("application: viewer\n"));
+    QVERIFY(triage.contains("signal: 6 ("));
+    QVERIFY(triage.contains("package: viewer 2.1-1\n"));
+
+    QCOMPARE(sections.value("stack-signature"), QByteArray("render\nmain\n"));
+}
+
+void Ut_CReporterTriageRecord::testStackTraceAfterCoreDump()
+{
+    QByteArray core(VIEWER_CORE_TRACE_LAST, sizeof(VIEWER_CORE_TRACE_LAST) - 1);
+
+    QString filePath = tempDir->path() + "/viewer-0287-6-100.rcore.lzo";
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(CReporterLzoWriter::compress(core));
+    file.close();
+
+    QStringList order;
+    Sections sections = readRecord(CReporterTriageRecord::create(filePath), &order);
+
+    QCOMPARE(order, QStringList() << "triage" << "date" << "/proc/100/cmdline"
+             << "stack-trace" << "stack-signature");
+    QVERIFY(sections.value("triage").contains("package: viewer 2.1-1\n"));
+    QCOMPARE(sections.value("stack-signature"), QByteArray("render\nmain\n"));
+}
+
+void Ut_CReporterTriageRecord::testMissingFile()
+{
+    QVERIFY(CReporterTriageRecord::create(tempDir->path() + "/none-0287-11-1.rcore.lzo")
+            .isEmpty());
+    QVERIFY(CReporterTriageRecord::contentHash(tempDir->path() + "/none").isEmpty());
+}
+
+QTEST_MAIN(Ut_CReporterTriageRecord)
@@ -34,9 +34,10 @@
 #include "creporternamespace.h"
 
 // CReporterUploadItem mock object.
-CReporterUploadItem::CReporterUploadItem(const QString &file)
+CReporterUploadItem::CReporterUploadItem(const QString &file, ItemContent content)
 {
     Q_UNUSED(file);
+    Q_UNUSED(content);
 }
 
 CReporterUploadItem::~CReporterUploadItem()
@@ -56,8 +57,9 @@ CReporterUploadQueue::~CReporterUploadQueue()
 {
 }
 
-void CReporterUploadQueue::enqueue(CReporterUploadItem *item)
+void CReporterUploadQueue::enqueue(CReporterUploadItem *item, bool prioritized)
 {
+    Q_UNUSED(prioritized);
     Q_UNUSED(item);
     itemsAddedCount++;
 }
@@ -55,6 +55,17 @@ bool CReporterHttpClient::upload(const QString &file)
     return true;
 }
 
+bool CReporterHttpClient::uploadTriageRecord(const QString &file)
+{
+    Q_UNUSED(file);
+    return true;
+}
+
+bool CReporterHttpClient::coreRequested() const
+{
+    return false;
+}
+
 void CReporterHttpClient::cancel()
 {
 }
@@ -56,6 +56,18 @@ bool CReporterHttpClient::upload(const QString &file)
     return uploadStarted;
 }
 
+bool CReporterHttpClient::uploadTriageRecord(const QString &file)
+{
+    Q_UNUSED(file);
+    uploadCalled = true;
+    return uploadStarted;
+}
+
+bool CReporterHttpClient::coreRequested() const
+{
+    return false;
+}
+
 void CReporterHttpClient::cancel()
 {
     cancelCalled = true;
@@ -31,9 +31,10 @@
 static QList<CReporterUploadItem *> items;
 
 // CReporterUploadItem mock object.
-CReporterUploadItem::CReporterUploadItem(const QString &file)
+CReporterUploadItem::CReporterUploadItem(const QString &file, ItemContent content)
 {
     Q_UNUSED(file);
+    Q_UNUSED(content);
     items.append(this);
 }
 
@@ -85,6 +86,38 @@ void Ut_CReporterUploadQueue::testEnqueueItems()
     QVERIFY(nextItemSpy.count() == 3);
 }
 
+void Ut_CReporterUploadQueue::testPrioritizedItems()
+{
+    // Verify that prioritized items overtake the waiting ones in order.
+    QSignalSpy nextItemSpy(m_Subject, SIGNAL(nextItem(CReporterUploadItem *)));
+
+    CReporterUploadItem *first = new CReporterUploadItem("first");
+    CReporterUploadItem *second = new CReporterUploadItem("second");
+    CReporterUploadItem *third = new CReporterUploadItem("third");
+    CReporterUploadItem *triage1 = new CReporterUploadItem("triage1");
+    CReporterUploadItem *triage2 = new CReporterUploadItem("triage2");
+
+    // First item goes out immediately.
+    m_Subject->enqueue(first);
+    m_Subject->enqueue(second);
+    m_Subject->enqueue(triage1, true);
+    m_Subject->enqueue(third);
+    m_Subject->enqueue(triage2, true);
+
+    QList<CReporterUploadItem *> expected;
+    expected << first << triage1 << triage2 << second << third;
+
+    for (int i = 0; i < expected.size(); ++i) {
+        QCOMPARE(nextItemSpy.count(), i + 1);
+        CReporterUploadItem *item =
+            nextItemSpy.last().at(0).value<CReporterUploadItem *>();
+        QCOMPARE(item, expected.at(i));
+        item->emitDone();
+    }
+
+    QCOMPARE(m_Subject->totalNumberOfItems(), 5);
+}
+
 
 void Ut_CReporterUploadQueue::cleanup()
 {
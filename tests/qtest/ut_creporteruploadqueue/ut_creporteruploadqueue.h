@@ -54,6 +54,7 @@ private Q_SLOTS:
     void init();
 
     void testEnqueueItems();
+    void testPrioritizedItems();
 
     void cleanupTestCase();
     void cleanup();
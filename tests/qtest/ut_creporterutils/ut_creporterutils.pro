@@ -24,4 +24,5 @@ SOURCES += $$TEST_SOURCES \
 	$${CREPORTER_SRC_DIR}/libs/autouploader_interface.cpp \
 	ut_creporterutils.cpp \
 
+include(../ut_richcore.pri)
 include(../ut_coverage.pri)
@@ -0,0 +1,433 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+
+#include <signal.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "ut_endurancecollect.h"
+#include "iphb_stub.h"
+#include "mce_stub.h"
+#include "creportersnapshotstore.h"
+
+namespace {
+
+int countLines(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    return file.readAll().count('\n');
+}
+
+QByteArray readFile(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+QStringList snapshots(const QString &enduranceDir)
+{
+    return QDir(enduranceDir).entryList(QStringList("???"), QDir::Dirs);
+}
+
+}
+
+void Ut_EnduranceCollect::init()
+{
+    tempDir = new QTemporaryDir;
+    QVERIFY(tempDir->isValid());
+
+    IphbStub::reset();
+    MceStub::reset();
+
+    // Every collection appends a line to the snapshots file.
+    command = QString("echo >> %1/snapshots").arg(tempDir->path()).toLocal8Bit();
+
+    iphb = iphb_open(0);
+    QCOMPARE(endurance_collect_init(&ec, iphb, command.constData()), 0);
+}
+
+void Ut_EnduranceCollect::cleanup()
+{
+    if (ec.child_pid != 0) {
+        waitpid(ec.child_pid, 0, 0);
+    }
+    endurance_collect_cleanup(&ec);
+    if (ec.collector) {
+        snapshot_collector_cleanup(ec.collector);
+    }
+    iphb_close(iphb);
+
+    delete tempDir;
+    tempDir = 0;
+}
+
+void Ut_EnduranceCollect::useCollector()
+{
+    QCOMPARE(snapshot_collector_init(&collector), 0);
+    ec.collector = &collector;
+
+    enduranceDir = QString("%1/endurance").arg(tempDir->path()).toLocal8Bit();
+    bootMarkFile = QString("%1/boot-mark").arg(tempDir->path()).toLocal8Bit();
+    packCommand = QString("ls -d %1/??? | wc -l >> %2/packs; rm -rf %1/???")
+            .arg(enduranceDir.constData(), tempDir->path()).toLocal8Bit();
+
+    ec.endurance_dir = enduranceDir.constData();
+    ec.boot_mark_file = bootMarkFile.constData();
+    ec.pack_command = packCommand.constData();
+}
+
+bool Ut_EnduranceCollect::waitForSnapshot(int timeoutMs)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    int waits = IphbStub::waitCount;
+    while (IphbStub::waitCount == waits && timer.elapsed() < timeoutMs) {
+        if (endurance_collect_dispatch(&ec, 100) < 0) {
+            return false;
+        }
+    }
+    return IphbStub::waitCount > waits;
+}
+
+void Ut_EnduranceCollect::testSnapshotOnWakeup()
+{
+    IphbStub::wakeUp();
+    QVERIFY(waitForSnapshot());
+
+    QCOMPARE(countLines(tempDir->path() + "/snapshots"), 1);
+    QCOMPARE(ec.child_pid, 0);
+
+    // CPU is kept awake only while collecting.
+    QCOMPARE(MceStub::keepaliveStarts, 1);
+    QCOMPARE(MceStub::keepaliveStops, 1);
+
+    // Next snapshot in an hour.
+    QCOMPARE(IphbStub::minTime, (unsigned short)(IPHB_GS_WAIT_1_HOUR - 10));
+    QCOMPARE(IphbStub::maxTime, (unsigned short)(IPHB_GS_WAIT_1_HOUR + 10));
+
+    IphbStub::wakeUp();
+    QVERIFY(waitForSnapshot());
+    QCOMPARE(countLines(tempDir->path() + "/snapshots"), 2);
+}
+
+void Ut_EnduranceCollect::testNoSnapshotWhileRunning()
+{
+    command = QString("echo >> %1/snapshots; sleep 0.5").arg(tempDir->path()).toLocal8Bit();
+    ec.command = command.constData();
+
+    IphbStub::wakeUp();
+    QVERIFY(endurance_collect_dispatch(&ec, 1000) > 0);
+    QVERIFY(ec.child_pid != 0);
+
+    // Wakeups during collection don't start another one.
+    IphbStub::wakeUp();
+    QVERIFY(endurance_collect_dispatch(&ec, 1000) > 0);
+    IphbStub::wakeUp();
+
+    QVERIFY(waitForSnapshot());
+    QCOMPARE(countLines(tempDir->path() + "/snapshots"), 1);
+    QCOMPARE(MceStub::keepaliveStops, 1);
+}
+
+void Ut_EnduranceCollect::testWakeupLatency()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    IphbStub::wakeUp();
+    QVERIFY(waitForSnapshot());
+
+    // Events are handled as they come, the loop doesn't sleep.
+    QVERIFY(timer.elapsed() < 1000);
+
+    // Nothing happens until the next wakeup.
+    timer.restart();
+    QCOMPARE(endurance_collect_dispatch(&ec, 200), 0);
+    QVERIFY(timer.elapsed() >= 190);
+}
+
+void Ut_EnduranceCollect::testKeepaliveRenewed()
+{
+    command = "sleep 1.5";
+    ec.command = command.constData();
+    ec.keepalive_period = 1;
+
+    IphbStub::wakeUp();
+    QVERIFY(waitForSnapshot());
+
+    QCOMPARE(MceStub::keepaliveStarts, 2);
+    QCOMPARE(MceStub::keepaliveStops, 1);
+
+    // Timer is stopped with the collection.
+    QCOMPARE(endurance_collect_dispatch(&ec, 1200), 0);
+    QCOMPARE(MceStub::keepaliveStarts, 2);
+}
+
+void Ut_EnduranceCollect::testIphbFailure()
+{
+    IphbStub::failWait = true;
+
+    IphbStub::wakeUp();
+    QElapsedTimer timer;
+    timer.start();
+    int result = 0;
+    while (result >= 0 && timer.elapsed() < 5000) {
+        result = endurance_collect_dispatch(&ec, 100);
+    }
+    QCOMPARE(result, -1);
+}
+
+void Ut_EnduranceCollect::testTerminationSignal()
+{
+    QVERIFY(!ec.quit);
+
+    // The signal is blocked and goes to the signalfd.
+    kill(getpid(), SIGTERM);
+    QVERIFY(endurance_collect_dispatch(&ec, 1000) > 0);
+    QVERIFY(ec.quit);
+}
+
+void Ut_EnduranceCollect::testNativeSnapshot()
+{
+    useCollector();
+
+    IphbStub::wakeUp();
+    QVERIFY(waitForSnapshot());
+
+    // No process is spawned for a snapshot.
+    QVERIFY(!QFile::exists(tempDir->path() + "/snapshots"));
+    QVERIFY(!QFile::exists(tempDir->path() + "/packs"));
+    QCOMPARE(ec.child_pid, 0);
+    QCOMPARE(MceStub::keepaliveStarts, 1);
+    QCOMPARE(MceStub::keepaliveStops, 1);
+
+    // New session was started.
+    QVERIFY(QFile::exists(bootMarkFile));
+    QCOMPARE(readFile(enduranceDir + "/snapshot_count"), QByteArray("1"));
+    QVERIFY(readFile(enduranceDir + "/boot_time").toLong() > 0);
+    QCOMPARE(snapshots(enduranceDir), QStringList("000"));
+
+    QString snapshotDir(enduranceDir + "/000");
+    QVERIFY(QFile::exists(snapshotDir + "/meminfo.lzo"));
+    QVERIFY(QFile::exists(snapshotDir + "/snapshot-format.lzo"));
+
+    QVERIFY(!QFile::exists(snapshotDir + "/processes.csv.lzo"));
+
+    // Per-process data goes to the snapshot store.
+    CReporterSnapshotStore store;
+    QVERIFY(store.open(enduranceDir + "/" + CReporterSnapshotStore::FileName));
+    QCOMPARE(store.segmentCount(), 1);
+    QCOMPARE(store.snapshotNumber(0), 0);
+    QVERIFY(store.processCount(0) > 0);
+
+    QByteArray processes(store.exportProcesses(0));
+    QVERIFY(processes.startsWith(CReporterSnapshotStore::ProcessesHeader));
+
+    // The test itself is among the processes.
+    QVERIFY(processes.contains(QString("\n%1,").arg(getpid()).toLatin1()));
+
+    IphbStub::wakeUp();
+    QVERIFY(waitForSnapshot());
+    QCOMPARE(readFile(enduranceDir + "/snapshot_count"), QByteArray("2"));
+    QCOMPARE(snapshots(enduranceDir), QStringList() << "000" << "001");
+
+    QVERIFY(store.open(enduranceDir + "/" + CReporterSnapshotStore::FileName));
+    QCOMPARE(store.segmentCount(), 2);
+    QCOMPARE(store.snapshotNumber(1), 1);
+}
+
+void Ut_EnduranceCollect::testNativePackAfterReboot()
+{
+    useCollector();
+
+    for (int i = 0; i < 3; ++i) {
+        IphbStub::wakeUp();
+        QVERIFY(waitForSnapshot());
+    }
+
+    // Reboot removes the mark, the old session is packed before the next
+    // snapshot starts a new one.
+    QVERIFY(QFile::remove(bootMarkFile));
+    IphbStub::wakeUp();
+    QVERIFY(waitForSnapshot());
+
+    QCOMPARE(readFile(tempDir->path() + "/packs").trimmed(), QByteArray("3"));
+    QVERIFY(QFile::exists(bootMarkFile));
+    QCOMPARE(readFile(enduranceDir + "/snapshot_count"), QByteArray("1"));
+    QCOMPARE(snapshots(enduranceDir), QStringList("000"));
+    QCOMPARE(MceStub::keepaliveStops, 4);
+}
+
+void Ut_EnduranceCollect::testNativeShortSessionDiscarded()
+{
+    useCollector();
+
+    IphbStub::wakeUp();
+    QVERIFY(waitForSnapshot());
+
+    QVERIFY(QFile::remove(bootMarkFile));
+    IphbStub::wakeUp();
+    QVERIFY(waitForSnapshot());
+
+    // Single snapshot is too short a session to report.
+    QVERIFY(!QFile::exists(tempDir->path() + "/packs"));
+    QCOMPARE(readFile(enduranceDir + "/snapshot_count"), QByteArray("1"));
+    QCOMPARE(snapshots(enduranceDir), QStringList("000"));
+}
+
+void Ut_EnduranceCollect::testNativePackFullSession()
+{
+    useCollector();
+
+    for (int i = 0; i < 11; ++i) {
+        IphbStub::wakeUp();
+        QVERIFY(waitForSnapshot());
+    }
+    QVERIFY(!QFile::exists(tempDir->path() + "/packs"));
+    QCOMPARE(snapshots(enduranceDir).count(), 11);
+
+    IphbStub::wakeUp();
+    QVERIFY(waitForSnapshot());
+    QCOMPARE(readFile(tempDir->path() + "/packs").trimmed(), QByteArray("12"));
+    QVERIFY(snapshots(enduranceDir).isEmpty());
+
+    // Session goes on after packing.
+    IphbStub::wakeUp();
+    QVERIFY(waitForSnapshot());
+    QCOMPARE(readFile(enduranceDir + "/snapshot_count"), QByteArray("13"));
+    QCOMPARE(snapshots(enduranceDir), QStringList("000"));
+}
+
+void Ut_EnduranceCollect::benchmarkNativeSnapshot()
+{
+    useCollector();
+    QCOMPARE(mkdir(enduranceDir.constData(), 0755), 0);
+
+    QBENCHMARK {
+        QVERIFY(snapshot_collector_collect(&collector, enduranceDir.constData()) >= 0);
+    }
+}
+
+void Ut_EnduranceCollect::testNativeSnapshotSummary()
+{
+    useCollector();
+
+    IphbStub::wakeUp();
+    QVERIFY(waitForSnapshot());
+
+    // The test itself uses memory and descriptors.
+    QVERIFY(collector.summary.rss_kb > 0);
+    QVERIFY(collector.summary.fds > 0);
+    QVERIFY(ec.last_snapshot_time > 0);
+    QCOMPARE(ec.last_summary.rss_kb, collector.summary.rss_kb);
+
+    // First snapshot has nothing to compare with.
+    QCOMPARE(ec.interval, (time_t)IPHB_GS_WAIT_1_HOUR);
+}
+
+void Ut_EnduranceCollect::testChangeScore()
+{
+    struct snapshot_summary previous = { 100000, 1000, 50000 };
+    struct snapshot_summary current = previous;
+
+    QCOMPARE(snapshot_change_score(&previous, &current, 3600), 0);
+
+    // 1 % of RSS in an hour.
+    current.rss_kb = 101000;
+    QCOMPARE(snapshot_change_score(&previous, &current, 3600), 10);
+    // Same growth in half the time is faster.
+    QCOMPARE(snapshot_change_score(&previous, &current, 1800), 20);
+
+    // Fastest growing figure counts.
+    current.fds = 1100;
+    QCOMPARE(snapshot_change_score(&previous, &current, 3600), 100);
+    current.slab_kb = 100000;
+    QCOMPARE(snapshot_change_score(&previous, &current, 3600), 1000);
+
+    // Shrinking is not a leak.
+    QCOMPARE(snapshot_change_score(&current, &previous, 3600), 0);
+
+    // Snapshots right after each other don't blow the score up.
+    current = previous;
+    current.rss_kb = 101000;
+    QCOMPARE(snapshot_change_score(&previous, &current, 1),
+             snapshot_change_score(&previous, &current, 60));
+}
+
+void Ut_EnduranceCollect::testAdaptInterval()
+{
+    QCOMPARE(ec.interval, (time_t)IPHB_GS_WAIT_1_HOUR);
+
+    // Idle system is sampled less often, up to the maximum.
+    endurance_collect_adapt_interval(&ec, 0);
+    QCOMPARE(ec.interval, (time_t)(2 * IPHB_GS_WAIT_1_HOUR));
+    endurance_collect_adapt_interval(&ec, 0);
+    endurance_collect_adapt_interval(&ec, 0);
+    QCOMPARE(ec.interval, ec.max_interval);
+
+    // Moderate change keeps the interval.
+    endurance_collect_adapt_interval(&ec, 10);
+    QCOMPARE(ec.interval, ec.max_interval);
+
+    // Fast change is sampled more often, down to the minimum.
+    endurance_collect_adapt_interval(&ec, 100);
+    QCOMPARE(ec.interval, (time_t)(2 * IPHB_GS_WAIT_1_HOUR));
+    for (int i = 0; i < 5; ++i) {
+        endurance_collect_adapt_interval(&ec, 100);
+    }
+    QCOMPARE(ec.interval, ec.min_interval);
+
+    // Next wakeup is requested with the adapted interval.
+    IphbStub::wakeUp();
+    QVERIFY(waitForSnapshot());
+    QCOMPARE(IphbStub::minTime, (unsigned short)(ec.min_interval - 10));
+    QCOMPARE(IphbStub::maxTime, (unsigned short)(ec.min_interval + 10));
+}
+
+void Ut_EnduranceCollect::testIntervalBounds()
+{
+    QCOMPARE(endurance_collect_set_interval_bounds(&ec, 600, 1800), 0);
+    // Current interval is brought within the bounds.
+    QCOMPARE(ec.interval, (time_t)1800);
+
+    endurance_collect_adapt_interval(&ec, 1000);
+    endurance_collect_adapt_interval(&ec, 1000);
+    QCOMPARE(ec.interval, (time_t)600);
+
+    QCOMPARE(endurance_collect_set_interval_bounds(&ec, 1800, 600), -1);
+    QCOMPARE(endurance_collect_set_interval_bounds(&ec, 0, 600), -1);
+    QCOMPARE(endurance_collect_set_interval_bounds(&ec, 600, 100000), -1);
+    QCOMPARE(ec.min_interval, (time_t)600);
+    QCOMPARE(ec.max_interval, (time_t)1800);
+}
+
+QTEST_MAIN(Ut_EnduranceCollect)
@@ -0,0 +1,78 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef UT_ENDURANCECOLLECT_H
+#define UT_ENDURANCECOLLECT_H
+
+#include <QTest>
+#include <QTemporaryDir>
+
+#include "endurancecollect.h"
+#include "snapshot.h"
+
+class Ut_EnduranceCollect : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void testSnapshotOnWakeup();
+    void testNoSnapshotWhileRunning();
+    void testWakeupLatency();
+    void testKeepaliveRenewed();
+    void testIphbFailure();
+    void testTerminationSignal();
+    void testNativeSnapshot();
+    void testNativePackAfterReboot();
+    void testNativeShortSessionDiscarded();
+    void testNativePackFullSession();
+    void benchmarkNativeSnapshot();
+    void testNativeSnapshotSummary();
+    void testChangeScore();
+    void testAdaptInterval();
+    void testIntervalBounds();
+
+private:
+    /*!
+     * Switches @a ec to in-process collection into a temporary endurance
+     * directory. The pack command logs its runs and removes the snapshots.
+     */
+    void useCollector();
+
+    /*!
+     * Dispatches events until the collection command exits, at most for
+     * @a timeoutMs.
+     */
+    bool waitForSnapshot(int timeoutMs = 5000);
+
+    QTemporaryDir *tempDir;
+    iphb_t iphb;
+    struct endurance_collect ec;
+    QByteArray command;
+
+    struct snapshot_collector collector;
+    QByteArray enduranceDir;
+    QByteArray bootMarkFile;
+    QByteArray packCommand;
+};
+
+#endif // UT_ENDURANCECOLLECT_H
@@ -0,0 +1,41 @@
+include(../ut_common_top.pri)
+
+ENDURANCE_SRC_DIR = $${CREPORTER_SRC_DIR}/endurancecollect
+
+QT -= gui
+
+TARGET = ut_endurancecollect
+
+LIBS += ../../../lib/libcrashreporter.so
+
+CONFIG += link_pkgconfig
+PKGCONFIG += lzo2
+
+INCLUDEPATH += . \
+               $${ENDURANCE_SRC_DIR} \
+               $$CREPORTER_SRC_DIR/libs/endurance \
+               $$CREPORTER_SRC_DIR/libs/richcore \
+               $$CREPORTER_SRC_DIR/libs \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+# iphb and MCE are replaced with stand-ins, see IphbStub and MceStub.
+TEST_STUBS += $${CREPORTER_STUBS_DIR}/iphb_stub.cpp \
+              $${CREPORTER_STUBS_DIR}/mce_stub.cpp \
+
+TEST_SOURCES += $${ENDURANCE_SRC_DIR}/endurancecollect.c \
+                $${ENDURANCE_SRC_DIR}/snapshot.c \
+
+HEADERS += $${CREPORTER_STUBS_DIR}/iphb_stub.h \
+           $${CREPORTER_STUBS_DIR}/mce_stub.h \
+           $${ENDURANCE_SRC_DIR}/endurancecollect.h \
+           $${ENDURANCE_SRC_DIR}/mce.h \
+           $${ENDURANCE_SRC_DIR}/snapshot.h \
+           ut_endurancecollect.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           $$TEST_STUBS \
+           ut_endurancecollect.cpp \
+
+include(../ut_coverage.pri)
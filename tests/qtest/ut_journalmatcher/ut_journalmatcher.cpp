@@ -0,0 +1,276 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include "ut_journalmatcher.h"
+#include "journalmatcher.h"
+
+namespace {
+
+typedef QHash<QString, QRegularExpression> Fields;
+
+Fields fields(const QString &field, const QString &pattern)
+{
+    Fields result;
+    result.insert(field, QRegularExpression(pattern));
+    return result;
+}
+
+/*!
+ * Values for @a matcher, fields not in @a entry are missing.
+ */
+QList<QByteArray> values(const JournalMatcher &matcher,
+                         const QHash<QString, QByteArray> &entry)
+{
+    QList<QByteArray> result;
+    foreach (const QString &field, matcher.fields()) {
+        result << entry.value(field);
+    }
+    return result;
+}
+
+QList<QByteArray> message(const QByteArray &text)
+{
+    return QList<QByteArray>() << text;
+}
+
+}
+
+void Ut_JournalMatcher::testPattern_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QByteArray>("text");
+
+    QTest::newRow("literal") << "wlan:" << QByteArray("kernel: wlan: connected");
+    QTest::newRow("literal, no match") << "wlan:" << QByteArray("kernel: wlan0 connected");
+    QTest::newRow("escapes") << "request_suspend_state: sleep \\(\\d->\\d\\)"
+                             << QByteArray("request_suspend_state: sleep (0->3)");
+    QTest::newRow("escapes, no match") << "request_suspend_state: sleep \\(\\d->\\d\\)"
+                                       << QByteArray("request_suspend_state: sleep 0->3");
+    QTest::newRow("wildcard") << "\\[D\\] SettingsModel.* Created"
+                              << QByteArray("[D] SettingsModel::SettingsModel:42 - Created");
+    QTest::newRow("optional character") << "colou?r" << QByteArray("color");
+    QTest::newRow("zero repetitions") << "ab{0}c" << QByteArray("ac");
+    QTest::newRow("repeated character") << "ab+c" << QByteArray("abbbc");
+    QTest::newRow("optional group") << "foo(bar)?baz" << QByteArray("foobaz");
+    QTest::newRow("alternation") << "kernel|lipstick" << QByteArray("lipstick crashed");
+    QTest::newRow("alternation in group") << "(kernel|lipstick) crashed"
+                                          << QByteArray("lipstick crashed");
+    QTest::newRow("character class") << "error [0-9]+" << QByteArray("error 42");
+    QTest::newRow("bracket in class") << "a[]]b" << QByteArray("a]b");
+    QTest::newRow("posix class") << "x[[:digit:]]y" << QByteArray("x5y");
+    QTest::newRow("inline option") << "(?i)oom" << QByteArray("OOM killer");
+    QTest::newRow("anchors") << "^kernel$" << QByteArray("kernel");
+    QTest::newRow("anchors, no match") << "^kernel$" << QByteArray("kernel-foo");
+    QTest::newRow("backreference") << "(a)\\1b" << QByteArray("aab");
+    QTest::newRow("hex escape") << "\\x41BC" << QByteArray("ABC");
+    QTest::newRow("quoted") << "\\Q(a)\\E" << QByteArray("(a)");
+    QTest::newRow("lookahead") << "foo(?=bar)" << QByteArray("foobar");
+    QTest::newRow("empty pattern") << "" << QByteArray("anything");
+    QTest::newRow("empty value") << "a?" << QByteArray("");
+}
+
+void Ut_JournalMatcher::testPattern()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QByteArray, text);
+
+    QRegularExpression rexp(pattern);
+    QVERIFY(rexp.isValid());
+
+    JournalMatcher matcher;
+    QCOMPARE(matcher.addExpression(fields("MESSAGE", pattern)), 0);
+    matcher.compile();
+    QCOMPARE(matcher.fields(), QStringList("MESSAGE"));
+
+    // Same result as evaluating the regular expression alone.
+    bool expected = rexp.match(QString::fromUtf8(text)).hasMatch();
+    QCOMPARE(matcher.match(message(text)), expected ? QList<int>() << 0 : QList<int>());
+}
+
+void Ut_JournalMatcher::testAllFieldsMatch()
+{
+    Fields expression;
+    expression.insert("_COMM", QRegularExpression("^jolla-settings$"));
+    expression.insert("MESSAGE", QRegularExpression("Created SettingsModel"));
+
+    JournalMatcher matcher;
+    matcher.addExpression(expression);
+    matcher.compile();
+
+    QHash<QString, QByteArray> entry;
+    entry.insert("_COMM", "jolla-settings");
+    entry.insert("MESSAGE", "[D] Created SettingsModel instance");
+    QCOMPARE(matcher.match(values(matcher, entry)), QList<int>() << 0);
+
+    entry.insert("_COMM", "lipstick");
+    QVERIFY(matcher.match(values(matcher, entry)).isEmpty());
+}
+
+void Ut_JournalMatcher::testMissingField()
+{
+    Fields expression;
+    expression.insert("SYSLOG_IDENTIFIER", QRegularExpression("kernel"));
+    expression.insert("CODE_FUNC", QRegularExpression(".*"));
+
+    JournalMatcher matcher;
+    matcher.addExpression(expression);
+    matcher.compile();
+
+    QHash<QString, QByteArray> entry;
+    entry.insert("SYSLOG_IDENTIFIER", "kernel");
+    QVERIFY(matcher.match(values(matcher, entry)).isEmpty());
+
+    // Empty value is not a missing one.
+    entry.insert("CODE_FUNC", QByteArray(""));
+    QCOMPARE(matcher.match(values(matcher, entry)), QList<int>() << 0);
+}
+
+void Ut_JournalMatcher::testAllMatches()
+{
+    JournalMatcher matcher;
+    QCOMPARE(matcher.addExpression(fields("MESSAGE", "wlan")), 0);
+    QCOMPARE(matcher.addExpression(fields("SYSLOG_IDENTIFIER", "kernel")), 1);
+    QCOMPARE(matcher.addExpression(fields("MESSAGE", "disconnected")), 2);
+    QCOMPARE(matcher.addExpression(fields("MESSAGE", "connected|up")), 3);
+    QCOMPARE(matcher.addExpression(fields("MESSAGE", "bluetooth")), 4);
+    matcher.compile();
+    QCOMPARE(matcher.fields(), QStringList() << "MESSAGE" << "SYSLOG_IDENTIFIER");
+
+    QHash<QString, QByteArray> entry;
+    entry.insert("MESSAGE", "wlan0 disconnected");
+    entry.insert("SYSLOG_IDENTIFIER", "kernel");
+    QCOMPARE(matcher.match(values(matcher, entry)), QList<int>() << 0 << 1 << 2 << 3);
+}
+
+void Ut_JournalMatcher::testSharedLiterals()
+{
+    // Literals that are suffixes and prefixes of one another.
+    JournalMatcher matcher;
+    matcher.addExpression(fields("MESSAGE", "she"));
+    matcher.addExpression(fields("MESSAGE", "he"));
+    matcher.addExpression(fields("MESSAGE", "hers"));
+    matcher.addExpression(fields("MESSAGE", "his"));
+    matcher.addExpression(fields("MESSAGE", "ushers?"));
+    matcher.compile();
+
+    QCOMPARE(matcher.match(message("ushers")), QList<int>() << 0 << 1 << 2 << 4);
+    QCOMPARE(matcher.match(message("usher")), QList<int>() << 0 << 1 << 4);
+    QCOMPARE(matcher.match(message("this")), QList<int>() << 3);
+    QVERIFY(matcher.match(message("sh")).isEmpty());
+}
+
+void Ut_JournalMatcher::testUtf8()
+{
+    JournalMatcher matcher;
+    matcher.addExpression(fields("MESSAGE", QString::fromUtf8("Käyttäjä \\d+")));
+    matcher.compile();
+
+    QCOMPARE(matcher.match(message("Käyttäjä 100000 kirjautui")), QList<int>() << 0);
+    QVERIFY(matcher.match(message("Kayttaja 100000 kirjautui")).isEmpty());
+}
+
+void Ut_JournalMatcher::benchmarkMatch_data()
+{
+    QTest::addColumn<int>("patterns");
+    QTest::addColumn<bool>("compiled");
+
+    QTest::newRow("10 patterns") << 10 << true;
+    QTest::newRow("10 patterns, one by one") << 10 << false;
+    QTest::newRow("100 patterns") << 100 << true;
+    QTest::newRow("100 patterns, one by one") << 100 << false;
+    QTest::newRow("1000 patterns") << 1000 << true;
+    QTest::newRow("1000 patterns, one by one") << 1000 << false;
+}
+
+void Ut_JournalMatcher::benchmarkMatch()
+{
+    QFETCH(int, patterns);
+    QFETCH(bool, compiled);
+
+    QList<Fields> expressions;
+    for (int i = 0; i < patterns; ++i) {
+        Fields expression(fields("MESSAGE",
+                                 QString("component%1: .* failed with error \\d+").arg(i)));
+        if (i % 3 == 0) {
+            expression.insert("_COMM", QRegularExpression(QString("^daemon%1$").arg(i % 50)));
+        }
+        expressions << expression;
+    }
+
+    JournalMatcher matcher;
+    foreach (const Fields &expression, expressions) {
+        matcher.addExpression(expression);
+    }
+    matcher.compile();
+
+    // Mostly chatter, one entry in hundred matches.
+    QList<QHash<QString, QByteArray> > entries;
+    for (int i = 0; i < 1000; ++i) {
+        QHash<QString, QByteArray> entry;
+        entry.insert("_COMM", QString("daemon%1").arg(i % 50).toUtf8());
+        if (i % 100 == 0) {
+            entry.insert("MESSAGE", QString("component%1: write failed with error 5")
+                         .arg(i % patterns).toUtf8());
+        } else {
+            entry.insert("MESSAGE", QString("component%1: request %2 handled in %3 ms")
+                         .arg(i % patterns).arg(i).arg(i % 17).toUtf8());
+        }
+        entries << entry;
+    }
+
+    QList<QList<QByteArray> > entryValues;
+    foreach (const QHash<QString, QByteArray> &entry, entries) {
+        entryValues << values(matcher, entry);
+    }
+
+    int matches = 0;
+    if (compiled) {
+        QBENCHMARK {
+            matches = 0;
+            foreach (const QList<QByteArray> &entry, entryValues) {
+                matches += matcher.match(entry).size();
+            }
+        }
+    } else {
+        // Every expression and field evaluated on its own, as JournalSpy
+        // did before the matcher.
+        QBENCHMARK {
+            matches = 0;
+            foreach (const QHash<QString, QByteArray> &entry, entries) {
+                foreach (const Fields &expression, expressions) {
+                    bool matched = true;
+                    Fields::const_iterator it;
+                    for (it = expression.constBegin(); matched && it != expression.constEnd();
+                            ++it) {
+                        matched = it.value().match(QString::fromUtf8(entry.value(it.key())))
+                                  .hasMatch();
+                    }
+                    if (matched) {
+                        ++matches;
+                    }
+                }
+            }
+        }
+    }
+
+    QVERIFY(matches > 0);
+}
+
+QTEST_MAIN(Ut_JournalMatcher)
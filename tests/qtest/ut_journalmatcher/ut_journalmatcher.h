@@ -0,0 +1,42 @@
+/*
+ * This file is a part of crash-reporter.
+ *
+ * Copyright (C) 2026 Jolla Ltd.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef UT_JOURNALMATCHER_H
+#define UT_JOURNALMATCHER_H
+
+#include <QTest>
+
+class Ut_JournalMatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testPattern_data();
+    void testPattern();
+    void testAllFieldsMatch();
+    void testMissingField();
+    void testAllMatches();
+    void testSharedLiterals();
+    void testUtf8();
+    void benchmarkMatch_data();
+    void benchmarkMatch();
+};
+
+#endif // UT_JOURNALMATCHER_H
@@ -0,0 +1,23 @@
+include(../ut_common_top.pri)
+
+JOURNALSPY_SRC_DIR = $${CREPORTER_SRC_DIR}/journalspy
+
+QT -= gui
+
+TARGET = ut_journalmatcher
+
+INCLUDEPATH += . \
+               $${JOURNALSPY_SRC_DIR} \
+
+DEPENDPATH += $$INCLUDEPATH \
+
+TEST_SOURCES += $${JOURNALSPY_SRC_DIR}/journalmatcher.cpp \
+
+HEADERS += $${JOURNALSPY_SRC_DIR}/journalmatcher.h \
+           ut_journalmatcher.h \
+
+# unit test and sources
+SOURCES += $$TEST_SOURCES \
+           ut_journalmatcher.cpp \
+
+include(../ut_coverage.pri)
@@ -0,0 +1,37 @@
+# Rich core sources compiled into the tests of code that uses them, instead
+# of linking libcrashreporter.
+
+RICHCORE_SRC_DIR = $${CREPORTER_SRC_DIR}/libs/richcore
+
+INCLUDEPATH += $${RICHCORE_SRC_DIR}
+DEPENDPATH += $${RICHCORE_SRC_DIR}
+
+CONFIG += link_pkgconfig
+PKGCONFIG += lzo2 libzstd
+
+HEADERS += $${RICHCORE_SRC_DIR}/creporterchecksum.h \
+           $${RICHCORE_SRC_DIR}/creportercorereducer.h \
+           $${RICHCORE_SRC_DIR}/creporterintegritychecker.h \
+           $${RICHCORE_SRC_DIR}/creporterlzop_p.h \
+           $${RICHCORE_SRC_DIR}/creporterlzoreader.h \
+           $${RICHCORE_SRC_DIR}/creporterlzoreader_p.h \
+           $${RICHCORE_SRC_DIR}/creporterlzowriter.h \
+           $${RICHCORE_SRC_DIR}/creporterrichcoreindex.h \
+           $${RICHCORE_SRC_DIR}/creporterrichcorereader.h \
+           $${RICHCORE_SRC_DIR}/creporterrichcorereader_p.h \
+           $${RICHCORE_SRC_DIR}/creportersectionencoder.h \
+           $${RICHCORE_SRC_DIR}/creportersectionscanner.h \
+           $${RICHCORE_SRC_DIR}/creporterstacksignature.h \
+           $${RICHCORE_SRC_DIR}/creportertriagerecord.h \
+
+SOURCES += $${RICHCORE_SRC_DIR}/creporterchecksum.cpp \
+           $${RICHCORE_SRC_DIR}/creportercorereducer.cpp \
+           $${RICHCORE_SRC_DIR}/creporterintegritychecker.cpp \
+           $${RICHCORE_SRC_DIR}/creporterlzoreader.cpp \
+           $${RICHCORE_SRC_DIR}/creporterlzowriter.cpp \
+           $${RICHCORE_SRC_DIR}/creporterrichcoreindex.cpp \
+           $${RICHCORE_SRC_DIR}/creporterrichcorereader.cpp \
+           $${RICHCORE_SRC_DIR}/creportersectionencoder.cpp \
+           $${RICHCORE_SRC_DIR}/creportersectionscanner.cpp \
+           $${RICHCORE_SRC_DIR}/creporterstacksignature.cpp \
+           $${RICHCORE_SRC_DIR}/creportertriagerecord.cpp \